@@ -0,0 +1,222 @@
+// Copyright(c) 2023, Matthew Petrin, All rights reserved.
+
+#ifndef CCOMMS_BENCHMARKS_BASELINE_HPP_
+#define CCOMMS_BENCHMARKS_BASELINE_HPP_
+
+#include <map>
+#include <string>
+#include <vector>
+#include <cctype>
+#include <cstddef>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+
+namespace ccomms::bench {
+
+//**************************************************** BASELINE ****************************************************
+
+/**
+ * @brief Time of one benchmark run, in nanoseconds per iteration.
+ */
+struct timing {
+    double real_time = 0;
+    double cpu_time = 0;
+};
+
+/**
+ * @brief Nanoseconds per unit of a Google Benchmark time_unit field.
+ */
+inline double unit_scale(const std::string &unit) {
+    if (unit == "ns")
+        return 1;
+    if (unit == "us")
+        return 1e3;
+    if (unit == "ms")
+        return 1e6;
+    if (unit == "s")
+        return 1e9;
+    throw std::runtime_error("\nERR: unknown benchmark time unit " + unit + "\n");
+}
+
+/**
+ * @class json_reader
+ *
+ * @brief Reads the benchmarks array of a Google Benchmark JSON report, as written by --benchmark_out.
+ *
+ * @ingroup bench
+ *
+ * @details Only flat string and number members of the benchmark entries are kept; everything else in the document is
+ * parsed and skipped. Aggregate entries (mean, median, stddev of repetitions) are ignored so that a baseline compares
+ * like for like with single runs.
+ */
+class json_reader {
+    const std::string &text;
+    std::size_t pos = 0;
+
+public:
+
+    explicit json_reader(const std::string &text) : text(text) {}
+
+    std::map<std::string, timing> benchmarks() {
+        std::map<std::string, timing> result;
+
+        expect('{');
+        if (peek() == '}')
+            return result;
+        do {
+            const std::string key = string();
+            expect(':');
+            if (key != "benchmarks") {
+                skip();
+                continue;
+            }
+
+            expect('[');
+            if (peek() == ']') {
+                pos++;
+                continue;
+            }
+            do {
+                std::map<std::string, std::string> entry = flat_object();
+                if (entry.count("run_type") && entry["run_type"] != "iteration")
+                    continue;
+                const double scale = unit_scale(entry.count("time_unit") ? entry["time_unit"] : "ns");
+                result[entry["name"]] = {std::stod(entry["real_time"]) * scale, std::stod(entry["cpu_time"]) * scale};
+            } while (next(']'));
+        } while (next('}'));
+
+        return result;
+    }
+
+private:
+
+    char peek() {
+        while (pos < text.size() && std::isspace(static_cast<unsigned char>(text[pos])))
+            pos++;
+        if (pos == text.size())
+            throw std::runtime_error("\nERR: unexpected end of benchmark report\n");
+        return text[pos];
+    }
+
+    void expect(const char &c) {
+        if (peek() != c)
+            throw std::runtime_error(std::string("\nERR: malformed benchmark report, expected '") + c + "'\n");
+        pos++;
+    }
+
+    // Consumes a separator, returning false when the closing bracket was reached instead
+    bool next(const char &close) {
+        if (peek() == ',') {
+            pos++;
+            return true;
+        }
+        expect(close);
+        return false;
+    }
+
+    std::string string() {
+        expect('"');
+        std::string result;
+        while (pos < text.size() && text[pos] != '"') {
+            if (text[pos] == '\\' && pos + 1 < text.size())
+                pos++;
+            result += text[pos++];
+        }
+        expect('"');
+        return result;
+    }
+
+    std::string scalar() {
+        if (peek() == '"')
+            return string();
+        const std::size_t start = pos;
+        while (pos < text.size() && text[pos] != ',' && text[pos] != '}' && text[pos] != ']' &&
+               !std::isspace(static_cast<unsigned char>(text[pos])))
+            pos++;
+        return text.substr(start, pos - start);
+    }
+
+    void skip() {
+        const char c = peek();
+        if (c == '{' || c == '[') {
+            const char close = c == '{' ? '}' : ']';
+            pos++;
+            if (peek() == close) {
+                pos++;
+                return;
+            }
+            do {
+                if (close == '}') {
+                    string();
+                    expect(':');
+                }
+                skip();
+            } while (next(close));
+        } else {
+            scalar();
+        }
+    }
+
+    std::map<std::string, std::string> flat_object() {
+        std::map<std::string, std::string> result;
+        expect('{');
+        if (peek() == '}') {
+            pos++;
+            return result;
+        }
+        do {
+            const std::string key = string();
+            expect(':');
+            if (peek() == '{' || peek() == '[')
+                skip();
+            else
+                result[key] = scalar();
+        } while (next('}'));
+        return result;
+    }
+};
+
+/**
+ * @brief Loads the per-benchmark timings of a Google Benchmark JSON report.
+ */
+inline std::map<std::string, timing> load_baseline(const std::string &path) {
+    std::ifstream file(path);
+    if (!file)
+        throw std::runtime_error("\nERR: cannot open benchmark baseline " + path + "\n");
+
+    std::stringstream buffer;
+    buffer << file.rdbuf();
+    const std::string text = buffer.str();
+    return json_reader(text).benchmarks();
+}
+
+/**
+ * @brief Result of comparing one benchmark against its baseline.
+ */
+struct comparison {
+    std::string name;
+    double baseline = 0;
+    double current = 0;
+
+    [[nodiscard]] double change() const { return current / baseline - 1; }
+};
+
+/**
+ * @brief Pairs the CPU times of the current runs with those of the baseline, in the order the runs were made.
+ * Benchmarks missing from either side are left out.
+ */
+inline std::vector<comparison> compare(const std::vector<std::pair<std::string, timing> > &current,
+                                       const std::map<std::string, timing> &baseline) {
+    std::vector<comparison> result;
+    for (const auto &[name, time]: current) {
+        auto found = baseline.find(name);
+        if (found != baseline.end() && found->second.cpu_time > 0)
+            result.push_back({name, found->second.cpu_time, time.cpu_time});
+    }
+    return result;
+}
+
+}
+
+#endif // CCOMMS_BENCHMARKS_BASELINE_HPP_
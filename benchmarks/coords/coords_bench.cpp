@@ -0,0 +1,141 @@
+// Copyright(c) 2023, Matthew Petrin, All rights reserved.
+
+#include <cstdint>
+#include <benchmark/benchmark.h>
+#include "../../include/coords.hpp"
+
+using namespace ccomms;
+
+namespace {
+
+// Sizes 3, 10, 100, ..., 10^7
+void batch_sizes(benchmark::internal::Benchmark *b) {
+    b->RangeMultiplier(10)->Range(3, 10'000'000);
+}
+
+template<typename T>
+geodetic_batch<T> sample_geodetic(const std::size_t &len) {
+    geodetic_batch<T> result(len);
+    for (std::size_t i = 0; i < len; i++) {
+        result.lat()[i] = static_cast<T>(-1.5 + 3.0 * static_cast<double>(i % 997) / 997.0);
+        result.lon()[i] = static_cast<T>(-3.1 + 6.2 * static_cast<double>(i % 991) / 991.0);
+        result.alt()[i] = static_cast<T>(i % 1000);
+    }
+    return result;
+}
+
+void processed(benchmark::State &state) {
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+}
+
+//************************************************** CONSTRUCTION **************************************************
+
+template<typename T>
+void coords_construct_cartesian(benchmark::State &state) {
+    for (auto _: state) {
+        cartesian<T> p(T(1), T(2), T(3));
+        benchmark::DoNotOptimize(p.data());
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+template<typename T>
+void coords_construct_spherical(benchmark::State &state) {
+    for (auto _: state) {
+        spherical<T> p(T(0.5), T(0.25));
+        benchmark::DoNotOptimize(p.data());
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+template<typename T>
+void coords_construct_batch(benchmark::State &state) {
+    const auto len = static_cast<std::size_t>(state.range(0));
+    for (auto _: state) {
+        cartesian_batch<T> batch(len);
+        benchmark::DoNotOptimize(batch.x().data());
+        benchmark::ClobberMemory();
+    }
+    processed(state);
+}
+
+BENCHMARK(coords_construct_cartesian<float>);
+BENCHMARK(coords_construct_cartesian<double>);
+BENCHMARK(coords_construct_spherical<float>);
+BENCHMARK(coords_construct_spherical<double>);
+BENCHMARK(coords_construct_batch<double>)->Apply(batch_sizes);
+
+//*************************************************** CONVERSION ***************************************************
+
+template<typename T>
+void coords_point_to_spherical(benchmark::State &state) {
+    const cartesian<T> p(T(100), T(200), T(50));
+    for (auto _: state) {
+        auto s = cartesian_to_spherical(p);
+        benchmark::DoNotOptimize(s.data());
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+template<typename T>
+void coords_point_geodetic_to_ecef(benchmark::State &state) {
+    const geodetic<T> p(T(0.7), T(-1.2));
+    for (auto _: state) {
+        auto e = geodetic_to_ecef(p, T(100));
+        benchmark::DoNotOptimize(e.data());
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+template<typename T>
+void coords_batch_geodetic_to_ecef(benchmark::State &state) {
+    const auto len = static_cast<std::size_t>(state.range(0));
+    const geodetic_batch<T> in = sample_geodetic<T>(len);
+    cartesian_batch<T> out(len);
+    for (auto _: state) {
+        geodetic_to_ecef(in.lat().data(), in.lon().data(), in.alt().data(),
+                         out.x().data(), out.y().data(), out.z().data(), len);
+        benchmark::DoNotOptimize(out.x().data());
+        benchmark::ClobberMemory();
+    }
+    processed(state);
+}
+
+template<typename T>
+void coords_batch_ecef_to_geodetic(benchmark::State &state) {
+    const auto len = static_cast<std::size_t>(state.range(0));
+    const cartesian_batch<T> in = geodetic_to_ecef(sample_geodetic<T>(len));
+    geodetic_batch<T> out(len);
+    for (auto _: state) {
+        ecef_to_geodetic(in.x().data(), in.y().data(), in.z().data(),
+                         out.lat().data(), out.lon().data(), out.alt().data(), len);
+        benchmark::DoNotOptimize(out.lat().data());
+        benchmark::ClobberMemory();
+    }
+    processed(state);
+}
+
+template<typename T>
+void coords_batch_to_spherical(benchmark::State &state) {
+    const auto len = static_cast<std::size_t>(state.range(0));
+    const cartesian_batch<T> in = geodetic_to_ecef(sample_geodetic<T>(len));
+    spherical_batch<T> out(len);
+    for (auto _: state) {
+        cartesian_to_spherical(in.x().data(), in.y().data(), in.z().data(),
+                               out.az().data(), out.el().data(), out.range().data(), len);
+        benchmark::DoNotOptimize(out.az().data());
+        benchmark::ClobberMemory();
+    }
+    processed(state);
+}
+
+BENCHMARK(coords_point_to_spherical<float>);
+BENCHMARK(coords_point_to_spherical<double>);
+BENCHMARK(coords_point_geodetic_to_ecef<double>);
+BENCHMARK(coords_batch_geodetic_to_ecef<float>)->Apply(batch_sizes);
+BENCHMARK(coords_batch_geodetic_to_ecef<double>)->Apply(batch_sizes);
+BENCHMARK(coords_batch_ecef_to_geodetic<double>)->Apply(batch_sizes);
+BENCHMARK(coords_batch_to_spherical<float>)->Apply(batch_sizes);
+BENCHMARK(coords_batch_to_spherical<double>)->Apply(batch_sizes);
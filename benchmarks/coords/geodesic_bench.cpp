@@ -0,0 +1,118 @@
+// Copyright(c) 2023, Matthew Petrin, All rights reserved.
+
+#include <cmath>
+#include <cstdint>
+#include <benchmark/benchmark.h>
+#include "../../include/coords.hpp"
+
+using namespace ccomms;
+
+namespace {
+
+template<typename T>
+geodetic_batch<T> sample_points(const std::size_t &len, const std::size_t &offset) {
+    geodetic_batch<T> result(len);
+    for (std::size_t i = 0; i < len; i++) {
+        const auto k = static_cast<double>(i + offset);
+        result.lat()[i] = static_cast<T>(-80.0 + 160.0 * std::fmod(k * 0.618034, 1.0));
+        result.lon()[i] = static_cast<T>(-180.0 + 360.0 * std::fmod(k * 0.414214, 1.0));
+        result.alt()[i] = T(0);
+    }
+    return result;
+}
+
+geodesic_method method_of(const benchmark::State &state) {
+    return state.range(1) == 0 ? geodesic_method::haversine : geodesic_method::vincenty;
+}
+
+// Lengths 10^3 to 10^5 with haversine (0) and Vincenty (1)
+void pair_sizes(benchmark::internal::Benchmark *b) {
+    b->ArgsProduct({{1'000, 10'000, 100'000}, {0, 1}});
+}
+
+}
+
+//************************************************** ONE TO MANY ***************************************************
+
+// Arguments: length, method. Items are distances. The baseline solves each pair through the point function.
+template<typename T>
+void geodesic_one_to_many_points(benchmark::State &state) {
+    const auto len = static_cast<std::size_t>(state.range(0));
+    const geodetic_batch<T> b = sample_points<T>(len, 1);
+    const geodetic<T> origin(T(-37.95), T(144.42));
+    vector<T> result(len, T(0));
+    for (auto _: state) {
+        for (std::size_t i = 0; i < len; i++)
+            result[i] = geodesic_distance(origin, b[i], method_of(state));
+        benchmark::DoNotOptimize(result.data());
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+template<typename T, typename P>
+void geodesic_one_to_many(benchmark::State &state, const P &policy) {
+    const auto len = static_cast<std::size_t>(state.range(0));
+    const geodetic_batch<T> b = sample_points<T>(len, 1);
+    const geodetic<T> origin(T(-37.95), T(144.42));
+    for (auto _: state) {
+        auto result = geodesic_distance(policy, origin, b, method_of(state));
+        benchmark::DoNotOptimize(result.data());
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+template<typename T>
+void geodesic_one_to_many_seq(benchmark::State &state) { geodesic_one_to_many<T>(state, execution::seq); }
+
+template<typename T>
+void geodesic_one_to_many_par(benchmark::State &state) { geodesic_one_to_many<T>(state, execution::par); }
+
+BENCHMARK(geodesic_one_to_many_points<double>)->Apply(pair_sizes);
+BENCHMARK(geodesic_one_to_many_seq<double>)->Apply(pair_sizes);
+BENCHMARK(geodesic_one_to_many_par<double>)->Apply(pair_sizes);
+BENCHMARK(geodesic_one_to_many_points<float>)->Apply(pair_sizes);
+BENCHMARK(geodesic_one_to_many_seq<float>)->Apply(pair_sizes);
+BENCHMARK(geodesic_one_to_many_par<float>)->Apply(pair_sizes);
+
+//*************************************************** DESTINATION **************************************************
+
+// Arguments: length, method. Items are destinations.
+template<typename T>
+void geodesic_destination(benchmark::State &state) {
+    const auto len = static_cast<std::size_t>(state.range(0));
+    const geodetic_batch<T> origins = sample_points<T>(len, 1);
+    vector<T> bearing(len, T(0)), distance(len, T(0));
+    for (std::size_t i = 0; i < len; i++) {
+        bearing[i] = static_cast<T>(i % 360);
+        distance[i] = static_cast<T>(1e3 * static_cast<double>(i % 5000));
+    }
+    for (auto _: state) {
+        auto result = destination(origins, bearing, distance, method_of(state));
+        benchmark::DoNotOptimize(result.lat().data());
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+BENCHMARK(geodesic_destination<double>)->Apply(pair_sizes);
+BENCHMARK(geodesic_destination<float>)->Apply(pair_sizes);
+
+//**************************************************** MATRICES ****************************************************
+
+// Arguments: side, method. Items are distances.
+template<typename T>
+void geodesic_distance_matrix(benchmark::State &state) {
+    const auto side = static_cast<std::size_t>(state.range(0));
+    const geodetic_batch<T> a = sample_points<T>(side, 1), b = sample_points<T>(side, 7919);
+    for (auto _: state) {
+        auto result = distance_matrix(a, b, method_of(state));
+        benchmark::DoNotOptimize(result.data());
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0) * state.range(0));
+}
+
+BENCHMARK(geodesic_distance_matrix<double>)->ArgsProduct({{100, 1'000}, {0, 1}});
+BENCHMARK(geodesic_distance_matrix<float>)->ArgsProduct({{100, 1'000}, {0, 1}});
@@ -0,0 +1,110 @@
+// Copyright(c) 2023, Matthew Petrin, All rights reserved.
+
+#include <cmath>
+#include <cstdint>
+#include <sstream>
+#include <benchmark/benchmark.h>
+#include "../../include/coords.hpp"
+
+using namespace ccomms;
+
+namespace {
+
+// Satellites in 24 planes of a low earth shell, from the elements of catalog number 6251
+std::vector<two_line_element> sample_tles(const std::size_t &len) {
+    const two_line_element base = parse_tle("1 06251U 62025E   06176.82412014  .00008885  00000-0  12808-3 0  3985",
+                                            "2 06251  58.0579  54.0425 0030035 139.1568 221.1854 15.56387291  6774");
+    std::vector<two_line_element> result(len, base);
+    for (std::size_t i = 0; i < len; i++) {
+        result[i].raan = static_cast<double>(i % 24) * 15.0;
+        result[i].mean_anomaly = std::fmod(static_cast<double>(i) * 7.3, 360.0);
+        result[i].mean_motion = 14.5 + static_cast<double>(i % 9) * 0.1;
+    }
+    return result;
+}
+
+orbit_model model_of(const benchmark::State &state) {
+    return state.range(1) == 0 ? orbit_model::sgp4 : orbit_model::kepler;
+}
+
+// Constellations of 10^3 and 5 * 10^3 satellites with SGP4 (0) and two body (1) propagation
+void constellation_sizes(benchmark::internal::Benchmark *b) {
+    b->ArgsProduct({{1'000, 5'000}, {0, 1}});
+}
+
+constexpr std::size_t steps = 60;
+
+}
+
+//*************************************************** PROPAGATION **************************************************
+
+// Arguments: satellites, model. Items are satellite states, 60 steps of one second. The baseline propagates the
+// satellites one at a time.
+template<typename T>
+void orbit_propagate_each(benchmark::State &state) {
+    const constellation sats(sample_tles(static_cast<std::size_t>(state.range(0))), model_of(state));
+    T x[6];
+    T *const out[6] = {x, x + 1, x + 2, x + 3, x + 4, x + 5};
+    for (auto _: state)
+        for (std::size_t s = 0; s < steps; s++)
+            for (std::size_t i = 0; i < sats.size(); i++) {
+                propagate_satellites(sats, i, 1, static_cast<double>(s) / 60.0, orbit_frame::teme, 0.0, out);
+                benchmark::DoNotOptimize(x);
+            }
+    state.SetItemsProcessed(state.iterations() * state.range(0) * static_cast<std::int64_t>(steps));
+}
+
+template<typename T, typename P>
+void orbit_propagate(benchmark::State &state, const P &policy) {
+    const constellation sats(sample_tles(static_cast<std::size_t>(state.range(0))), model_of(state));
+    for (auto _: state) {
+        auto result = propagate<T>(policy, sats, sats.epoch(), 1.0, steps, orbit_frame::ecef);
+        benchmark::DoNotOptimize(result.position.x().data());
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0) * static_cast<std::int64_t>(steps));
+}
+
+template<typename T>
+void orbit_propagate_seq(benchmark::State &state) { orbit_propagate<T>(state, execution::seq); }
+
+template<typename T>
+void orbit_propagate_par(benchmark::State &state) { orbit_propagate<T>(state, execution::par); }
+
+BENCHMARK(orbit_propagate_each<double>)->Apply(constellation_sizes);
+BENCHMARK(orbit_propagate_seq<double>)->Apply(constellation_sizes);
+BENCHMARK(orbit_propagate_par<double>)->Apply(constellation_sizes);
+BENCHMARK(orbit_propagate_par<float>)->Apply(constellation_sizes);
+
+//**************************************************** STREAMING ***************************************************
+
+// Arguments: satellites, model. Items are satellite states handed to the consumer.
+template<typename T>
+void orbit_stream(benchmark::State &state) {
+    const constellation sats(sample_tles(static_cast<std::size_t>(state.range(0))), model_of(state));
+    for (auto _: state)
+        propagate<T>(execution::par, sats, sats.epoch(), 1.0, steps, orbit_frame::ecef,
+                     [](std::size_t, const julian_date &, const cartesian_batch<T> &position,
+                        const cartesian_batch<T> &) { benchmark::DoNotOptimize(position.x().data()); });
+    state.SetItemsProcessed(state.iterations() * state.range(0) * static_cast<std::int64_t>(steps));
+}
+
+BENCHMARK(orbit_stream<double>)->Apply(constellation_sizes);
+
+//***************************************************** PARSING ****************************************************
+
+// Items are element sets parsed from a stream.
+void orbit_parse_tles(benchmark::State &state) {
+    std::string text;
+    for (int i = 0; i < 1000; i++)
+        text += "ISS (ZARYA)\n1 06251U 62025E   06176.82412014  .00008885  00000-0  12808-3 0  3985\n"
+                "2 06251  58.0579  54.0425 0030035 139.1568 221.1854 15.56387291  6774\n";
+    for (auto _: state) {
+        std::istringstream in(text);
+        auto result = parse_tles(in);
+        benchmark::DoNotOptimize(result.data());
+    }
+    state.SetItemsProcessed(state.iterations() * 1000);
+}
+
+BENCHMARK(orbit_parse_tles);
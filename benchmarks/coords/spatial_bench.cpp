@@ -0,0 +1,165 @@
+// Copyright(c) 2023, Matthew Petrin, All rights reserved.
+
+#include <cmath>
+#include <cstdint>
+#include <benchmark/benchmark.h>
+#include "../../include/coords.hpp"
+
+using namespace ccomms;
+
+namespace {
+
+// Points spread evenly over the sphere, by the golden angle spiral
+template<typename T>
+geodetic_batch<T> sample_points(const std::size_t &len) {
+    geodetic_batch<T> result(len);
+    for (std::size_t i = 0; i < len; i++) {
+        const double k = static_cast<double>(i) + 0.5;
+        result.lat()[i] = static_cast<T>(std::asin(1.0 - 2.0 * k / static_cast<double>(len)) * rad_to_deg);
+        result.lon()[i] = static_cast<T>(std::fmod(k * 137.50776405, 360.0) - 180.0);
+    }
+    return result;
+}
+
+template<typename T>
+geodetic<T> query_point(const std::size_t &i) {
+    return {static_cast<T>(-60.0 + std::fmod(static_cast<double>(i) * 37.1, 120.0)),
+            static_cast<T>(-180.0 + std::fmod(static_cast<double>(i) * 91.7, 360.0))};
+}
+
+// Indexed point counts 10^5 and 10^6
+void index_sizes(benchmark::internal::Benchmark *b) {
+    b->RangeMultiplier(10)->Range(100'000, 1'000'000);
+}
+
+constexpr double radius = 1e5;
+
+}
+
+//**************************************************** BUILDING ****************************************************
+
+// Arguments: points. Items are points.
+template<typename T>
+void spatial_build_kd_tree(benchmark::State &state) {
+    const auto points = sample_points<T>(static_cast<std::size_t>(state.range(0)));
+    for (auto _: state) {
+        kd_tree<T> index(points);
+        benchmark::DoNotOptimize(index.size());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+template<typename T>
+void spatial_build_grid(benchmark::State &state) {
+    const auto points = sample_points<T>(static_cast<std::size_t>(state.range(0)));
+    for (auto _: state) {
+        geodetic_grid<T> index(points, 0.5);
+        benchmark::DoNotOptimize(index.size());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+BENCHMARK(spatial_build_kd_tree<double>)->Apply(index_sizes);
+BENCHMARK(spatial_build_grid<double>)->Apply(index_sizes);
+
+//************************************************* RADIUS QUERIES *************************************************
+
+// Arguments: points. Items are queries for the points within 100 km. The baseline measures every point through the
+// batch haversine.
+template<typename T>
+void spatial_within_scan(benchmark::State &state) {
+    const auto points = sample_points<T>(static_cast<std::size_t>(state.range(0)));
+    std::size_t i = 0;
+    for (auto _: state) {
+        const auto d = geodesic_distance(execution::seq, query_point<T>(i++), points, geodesic_method::haversine);
+        std::size_t found = 0;
+        for (const auto &value: d)
+            found += value <= static_cast<T>(radius);
+        benchmark::DoNotOptimize(found);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+template<typename T>
+void spatial_within_kd_tree(benchmark::State &state) {
+    const kd_tree<T> index(sample_points<T>(static_cast<std::size_t>(state.range(0))));
+    std::size_t i = 0;
+    for (auto _: state) {
+        auto found = index.within(query_point<T>(i++), static_cast<T>(radius));
+        benchmark::DoNotOptimize(found.data());
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+template<typename T>
+void spatial_within_grid(benchmark::State &state) {
+    const geodetic_grid<T> index(sample_points<T>(static_cast<std::size_t>(state.range(0))), 0.5);
+    std::size_t i = 0;
+    for (auto _: state) {
+        auto found = index.within(query_point<T>(i++), static_cast<T>(radius));
+        benchmark::DoNotOptimize(found.data());
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+BENCHMARK(spatial_within_scan<double>)->Apply(index_sizes);
+BENCHMARK(spatial_within_kd_tree<double>)->Apply(index_sizes);
+BENCHMARK(spatial_within_grid<double>)->Apply(index_sizes);
+BENCHMARK(spatial_within_kd_tree<float>)->Apply(index_sizes);
+BENCHMARK(spatial_within_grid<float>)->Apply(index_sizes);
+
+//************************************************ NEAREST NEIGHBOURS ***********************************************
+
+// Arguments: points. Items are queries for the 8 nearest points.
+template<typename T>
+void spatial_nearest_kd_tree(benchmark::State &state) {
+    const kd_tree<T> index(sample_points<T>(static_cast<std::size_t>(state.range(0))));
+    std::size_t i = 0;
+    for (auto _: state) {
+        auto found = index.nearest(query_point<T>(i++), 8);
+        benchmark::DoNotOptimize(found.data());
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+template<typename T>
+void spatial_nearest_grid(benchmark::State &state) {
+    const geodetic_grid<T> index(sample_points<T>(static_cast<std::size_t>(state.range(0))), 0.5);
+    std::size_t i = 0;
+    for (auto _: state) {
+        auto found = index.nearest(query_point<T>(i++), 8);
+        benchmark::DoNotOptimize(found.data());
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+BENCHMARK(spatial_nearest_kd_tree<double>)->Apply(index_sizes);
+BENCHMARK(spatial_nearest_grid<double>)->Apply(index_sizes);
+
+//**************************************************** MOVEMENT ****************************************************
+
+// Arguments: points. Items are moved points, a hundredth of the index per iteration, rebuilds included.
+template<typename T>
+void spatial_update_kd_tree(benchmark::State &state) {
+    const auto len = static_cast<std::size_t>(state.range(0));
+    kd_tree<T> index(sample_points<T>(len));
+    std::size_t i = 0;
+    for (auto _: state)
+        for (std::size_t j = 0; j < len / 100; j++, i++)
+            index.update((i * 7919) % len, query_point<T>(i));
+    state.SetItemsProcessed(state.iterations() * state.range(0) / 100);
+}
+
+template<typename T>
+void spatial_update_grid(benchmark::State &state) {
+    const auto len = static_cast<std::size_t>(state.range(0));
+    geodetic_grid<T> index(sample_points<T>(len), 0.5);
+    std::size_t i = 0;
+    for (auto _: state)
+        for (std::size_t j = 0; j < len / 100; j++, i++)
+            index.update((i * 7919) % len, query_point<T>(i));
+    state.SetItemsProcessed(state.iterations() * state.range(0) / 100);
+}
+
+BENCHMARK(spatial_update_kd_tree<double>)->Apply(index_sizes);
+BENCHMARK(spatial_update_grid<double>)->Apply(index_sizes);
@@ -0,0 +1,95 @@
+// Copyright(c) 2023, Matthew Petrin, All rights reserved.
+
+#include <cmath>
+#include <cstdint>
+#include <benchmark/benchmark.h>
+#include "../../include/coords.hpp"
+
+using namespace ccomms;
+
+namespace {
+
+// Satellites over several planes and inclinations from the elements of catalog number 6251
+constellation sample_constellation(const std::size_t &len) {
+    const two_line_element base = parse_tle("1 06251U 62025E   06176.82412014  .00008885  00000-0  12808-3 0  3985",
+                                            "2 06251  58.0579  54.0425 0030035 139.1568 221.1854 15.56387291  6774");
+    const double inclinations[4] = {20.0, 58.0579, 85.0, 97.5};
+    std::vector<two_line_element> tles(len, base);
+    for (std::size_t i = 0; i < len; i++) {
+        tles[i].inclination = inclinations[i % 4];
+        tles[i].raan = std::fmod(static_cast<double>(i) * 47.0, 360.0);
+        tles[i].mean_anomaly = std::fmod(static_cast<double>(i) * 71.3, 360.0);
+        tles[i].mean_motion = 14.2 + static_cast<double>(i % 7) * 0.2;
+    }
+    return constellation(tles);
+}
+
+// Stations spread over the sphere, by the golden angle spiral
+geodetic_batch<double> sample_stations(const std::size_t &len) {
+    geodetic_batch<double> result(len);
+    for (std::size_t i = 0; i < len; i++) {
+        const double k = static_cast<double>(i) + 0.5;
+        result.lat()[i] = std::asin(1.0 - 2.0 * k / static_cast<double>(len)) * rad_to_deg;
+        result.lon()[i] = std::fmod(k * 137.50776405, 360.0) - 180.0;
+    }
+    return result;
+}
+
+constexpr double mask = 10.0;
+
+}
+
+//************************************************** ACCESS WINDOWS ************************************************
+
+// Arguments: satellites. Items are station and satellite pairs searched over two hours, from 20 stations. The
+// baseline computes the elevation of every one second state and scans it for runs above the mask.
+void visibility_brute_force(benchmark::State &state) {
+    const constellation sats = sample_constellation(static_cast<std::size_t>(state.range(0)));
+    const auto dense = propagate(sats, sats.epoch(), 1.0, 7201, orbit_frame::ecef);
+    const geodetic_batch<double> stations = sample_stations(20);
+    for (auto _: state) {
+        std::size_t rises = 0;
+        for (std::size_t j = 0; j < stations.size(); j++) {
+            const auto look = cartesian_to_spherical(ecef_to_enu(dense.position, stations[j], stations.alt()[j]));
+            for (std::size_t s = 1; s < dense.steps; s++)
+                for (std::size_t i = 0; i < dense.satellites; i++)
+                    rises += look.el()[dense.index(s, i)] >= mask && look.el()[dense.index(s - 1, i)] < mask;
+        }
+        benchmark::DoNotOptimize(rises);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0) * 20);
+}
+
+template<typename P>
+void visibility_windows(benchmark::State &state, const P &policy) {
+    const constellation sats = sample_constellation(static_cast<std::size_t>(state.range(0)));
+    const auto coarse = propagate(sats, sats.epoch(), 60.0, 121, orbit_frame::ecef);
+    const geodetic_batch<double> stations = sample_stations(20);
+    for (auto _: state) {
+        auto windows = access_windows(policy, stations, coarse, mask);
+        benchmark::DoNotOptimize(windows.data());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0) * 20);
+}
+
+void visibility_windows_seq(benchmark::State &state) { visibility_windows(state, execution::seq); }
+
+void visibility_windows_par(benchmark::State &state) { visibility_windows(state, execution::par); }
+
+BENCHMARK(visibility_brute_force)->Arg(100)->Arg(400);
+BENCHMARK(visibility_windows_seq)->Arg(100)->Arg(400);
+BENCHMARK(visibility_windows_par)->Arg(100)->Arg(400);
+
+// Arguments: satellites. Items are station and satellite pairs searched over a day, from 100 stations.
+void visibility_windows_day(benchmark::State &state) {
+    const constellation sats = sample_constellation(static_cast<std::size_t>(state.range(0)));
+    const auto coarse = propagate(sats, sats.epoch(), 60.0, 1441, orbit_frame::ecef);
+    const geodetic_batch<double> stations = sample_stations(100);
+    for (auto _: state) {
+        auto windows = access_windows(execution::par, stations, coarse, mask);
+        benchmark::DoNotOptimize(windows.data());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0) * 100);
+}
+
+BENCHMARK(visibility_windows_day)->Arg(1'000)->Arg(5'000)->Unit(benchmark::kMillisecond);
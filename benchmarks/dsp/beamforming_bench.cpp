@@ -0,0 +1,122 @@
+// Copyright(c) 2023, Matthew Petrin, All rights reserved.
+
+#include <cmath>
+#include <complex>
+#include <cstdint>
+#include <benchmark/benchmark.h>
+#include "../../include/dsp.hpp"
+#include "../../include/coords.hpp"
+
+using namespace ccomms;
+
+namespace {
+
+// Square array of the given number of elements at half wavelength spacing, for a wavelength of 1 m
+template<typename T = float>
+cartesian_batch<T> square_array(const std::size_t &elements) {
+    const auto side = static_cast<std::size_t>(std::lround(std::sqrt(static_cast<double>(elements))));
+    cartesian_batch<T> positions;
+    for (std::size_t r = 0; r < side; r++)
+        for (std::size_t c = 0; c < side; c++)
+            positions.push_back(T(0.5) * static_cast<T>(c), T(0.5) * static_cast<T>(r), T(0));
+    return positions;
+}
+
+// Axis of count angles spaced by step degrees from first
+vector<float> axis(const std::size_t &count, const float &first, const float &step) {
+    vector<float> result(count, 0.0f);
+    for (std::size_t i = 0; i < count; i++)
+        result[i] = first + step * static_cast<float>(i);
+    return result;
+}
+
+// Pattern by direct evaluation of exp(j phase) per element and grid point, the loop the array replaces
+matrix<float> naive_pattern(const cartesian_batch<float> &positions, const vector<std::complex<float> > &w,
+                            const vector<float> &az, const vector<float> &el) {
+    matrix<float> result(el.size(), az.size());
+    const float k0 = 2 * 3.14159265f;
+    for (std::size_t r = 0; r < el.size(); r++)
+        for (std::size_t c = 0; c < az.size(); c++) {
+            const float a = az[c] * 0.0174532925f, e = el[r] * 0.0174532925f;
+            std::complex<float> sum(0);
+            for (std::size_t i = 0; i < positions.size(); i++) {
+                const float phase = k0 * (positions.x()[i] * std::cos(e) * std::sin(a) +
+                                          positions.y()[i] * std::cos(e) * std::cos(a) +
+                                          positions.z()[i] * std::sin(e));
+                sum += std::conj(w[i]) * std::exp(std::complex<float>(0, phase));
+            }
+            result(r, c) = std::norm(sum);
+        }
+    return result;
+}
+
+}
+
+//**************************************************** STEERING ****************************************************
+
+// Arguments: elements, directions. Items are steering vector elements.
+void beamforming_steering(benchmark::State &state) {
+    dsp::antenna_array<float> array(square_array(static_cast<std::size_t>(state.range(0))), 1.0f);
+    spherical_batch<float> directions;
+    for (std::int64_t d = 0; d < state.range(1); d++)
+        directions.push_back(static_cast<float>(d % 360), static_cast<float>(d % 90), 1.0f);
+    for (auto _: state)
+        benchmark::DoNotOptimize(array.steering(directions).data());
+    state.SetItemsProcessed(state.iterations() * state.range(0) * state.range(1));
+}
+
+BENCHMARK(beamforming_steering)->Args({64, 1024})->Args({256, 1024});
+
+// Arguments: elements. Items are weight vectors, including the factorization of the covariance.
+void beamforming_mvdr(benchmark::State &state) {
+    const auto k = static_cast<std::size_t>(state.range(0));
+    dsp::antenna_array<double> array(square_array<double>(k), 1.0);
+    const vector<std::complex<double> > jammer = array.steering(spherical<double>(70.0, 10.0));
+    matrix<std::complex<double> > covariance(k, k);
+    for (std::size_t i = 0; i < k; i++)
+        for (std::size_t j = 0; j < k; j++)
+            covariance(i, j) = 100.0 * jammer[i] * std::conj(jammer[j]) + (i == j ? 1.0 : 0.0);
+    for (auto _: state)
+        benchmark::DoNotOptimize(array.mvdr_weights(covariance, spherical<double>(30.0, 45.0), 0.1).data());
+}
+
+BENCHMARK(beamforming_mvdr)->Arg(64)->Arg(256)->Unit(benchmark::kMicrosecond);
+
+//***************************************************** PATTERN ****************************************************
+
+// Arguments: elements, azimuths, elevations. Items are grid points.
+void beamforming_pattern(benchmark::State &state) {
+    dsp::antenna_array<float> array(square_array(static_cast<std::size_t>(state.range(0))), 1.0f);
+    const vector<std::complex<float> > w = array.conventional_weights(spherical<float>(30.0f, 45.0f));
+    const vector<float> az = axis(static_cast<std::size_t>(state.range(1)), 0.0f, 360.0f / state.range(1));
+    const vector<float> el = axis(static_cast<std::size_t>(state.range(2)), -90.0f, 180.0f / state.range(2));
+    for (auto _: state)
+        benchmark::DoNotOptimize(array.pattern(w, az, el).data());
+    state.SetItemsProcessed(state.iterations() * state.range(1) * state.range(2));
+}
+
+void beamforming_pattern_sequential(benchmark::State &state) {
+    dsp::antenna_array<float> array(square_array(static_cast<std::size_t>(state.range(0))), 1.0f);
+    const vector<std::complex<float> > w = array.conventional_weights(spherical<float>(30.0f, 45.0f));
+    const vector<float> az = axis(static_cast<std::size_t>(state.range(1)), 0.0f, 360.0f / state.range(1));
+    const vector<float> el = axis(static_cast<std::size_t>(state.range(2)), -90.0f, 180.0f / state.range(2));
+    for (auto _: state)
+        benchmark::DoNotOptimize(array.pattern(execution::seq, w, az, el).data());
+    state.SetItemsProcessed(state.iterations() * state.range(1) * state.range(2));
+}
+
+void beamforming_pattern_naive(benchmark::State &state) {
+    const cartesian_batch<float> positions = square_array(static_cast<std::size_t>(state.range(0)));
+    dsp::antenna_array<float> array(positions, 1.0f);
+    const vector<std::complex<float> > w = array.conventional_weights(spherical<float>(30.0f, 45.0f));
+    const vector<float> az = axis(static_cast<std::size_t>(state.range(1)), 0.0f, 360.0f / state.range(1));
+    const vector<float> el = axis(static_cast<std::size_t>(state.range(2)), -90.0f, 180.0f / state.range(2));
+    for (auto _: state)
+        benchmark::DoNotOptimize(naive_pattern(positions, w, az, el).data());
+    state.SetItemsProcessed(state.iterations() * state.range(1) * state.range(2));
+}
+
+BENCHMARK(beamforming_pattern)->Args({64, 360, 180})->Args({256, 360, 180})->Unit(benchmark::kMillisecond)
+        ->UseRealTime();
+BENCHMARK(beamforming_pattern_sequential)->Args({256, 360, 180})->Unit(benchmark::kMillisecond);
+BENCHMARK(beamforming_pattern_naive)->Args({256, 90, 45})->Unit(benchmark::kMillisecond);
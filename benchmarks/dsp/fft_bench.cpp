@@ -0,0 +1,82 @@
+// Copyright(c) 2023, Matthew Petrin, All rights reserved.
+
+#include <cmath>
+#include <complex>
+#include <cstdint>
+#include <benchmark/benchmark.h>
+#include "../../include/dsp.hpp"
+
+using namespace ccomms;
+
+namespace {
+
+// Powers of two from 64 to 2^20, plus mixed radix lengths
+void fft_sizes(benchmark::internal::Benchmark *b) {
+    b->RangeMultiplier(4)->Range(64, 1 << 20);
+    b->Arg(1000)->Arg(1536)->Arg(48000);
+}
+
+template<typename T>
+vector<std::complex<T> > tone(const std::size_t &len) {
+    vector<std::complex<T> > result(len, std::complex<T>(0));
+    for (std::size_t i = 0; i < len; i++)
+        result[i] = std::polar(T(1), static_cast<T>(0.01 * static_cast<double>(i)));
+    return result;
+}
+
+// Conventional 5 n log2(n) flop count of a complex FFT, reported as items per second
+void fft_flops(benchmark::State &state) {
+    const auto n = static_cast<double>(state.range(0));
+    state.counters["flops"] = benchmark::Counter(5 * n * std::log2(n), benchmark::Counter::kIsIterationInvariantRate);
+}
+
+}
+
+//**************************************************** TRANSFORMS **************************************************
+
+template<typename T>
+void fft_out_of_place(benchmark::State &state) {
+    const auto len = static_cast<std::size_t>(state.range(0));
+    const vector<std::complex<T> > x = tone<T>(len);
+    vector<std::complex<T> > out(len, std::complex<T>(0));
+    for (auto _: state) {
+        dsp::fft(x, out);
+        benchmark::DoNotOptimize(out.data());
+        benchmark::ClobberMemory();
+    }
+    fft_flops(state);
+}
+
+template<typename T>
+void fft_in_place(benchmark::State &state) {
+    const auto len = static_cast<std::size_t>(state.range(0));
+    vector<std::complex<T> > x = tone<T>(len);
+    for (auto _: state) {
+        dsp::fft_in_place(x);
+        benchmark::DoNotOptimize(x.data());
+        benchmark::ClobberMemory();
+    }
+    fft_flops(state);
+}
+
+template<typename T>
+void fft_real(benchmark::State &state) {
+    const auto len = static_cast<std::size_t>(state.range(0));
+    vector<T> x(len, T(0));
+    for (std::size_t i = 0; i < len; i++)
+        x[i] = static_cast<T>(std::sin(0.01 * static_cast<double>(i)));
+    const auto plan = dsp::real_fft_plan<T>::cached(len);
+    vector<std::complex<T> > out(plan->bins(), std::complex<T>(0));
+    for (auto _: state) {
+        plan->forward(x.data(), out.data());
+        benchmark::DoNotOptimize(out.data());
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+BENCHMARK(fft_out_of_place<float>)->Apply(fft_sizes);
+BENCHMARK(fft_out_of_place<double>)->Apply(fft_sizes);
+BENCHMARK(fft_in_place<float>)->Apply(fft_sizes);
+BENCHMARK(fft_real<float>)->Apply(fft_sizes);
+BENCHMARK(fft_real<double>)->Apply(fft_sizes);
@@ -0,0 +1,45 @@
+// Copyright(c) 2023, Matthew Petrin, All rights reserved.
+
+#include <cmath>
+#include <complex>
+#include <cstdint>
+#include <benchmark/benchmark.h>
+#include "../../include/dsp.hpp"
+
+using namespace ccomms;
+
+namespace {
+
+constexpr std::size_t block_size = 4096;
+
+vector<float> lowpass(const std::size_t &ntaps) {
+    vector<float> h(ntaps, 0.0f);
+    for (std::size_t k = 0; k < ntaps; k++)
+        h[k] = static_cast<float>(0.5 - 0.5 * std::cos(2 * 3.141592653589793 * static_cast<double>(k) /
+                                                        static_cast<double>(ntaps - 1))) / static_cast<float>(ntaps);
+    return h;
+}
+
+}
+
+//***************************************************** FILTERS ****************************************************
+
+// Arguments: taps, up factor, down factor. Items are input samples.
+template<typename S>
+void fir_resample(benchmark::State &state) {
+    dsp::resampler<S, float> filter(lowpass(static_cast<std::size_t>(state.range(0))),
+                                    static_cast<std::size_t>(state.range(1)),
+                                    static_cast<std::size_t>(state.range(2)));
+    const vector<S> in(block_size, S(1));
+    vector<S> out(filter.output_size(block_size) + 1, S(0));
+    for (auto _: state) {
+        benchmark::DoNotOptimize(filter.process(in, out));
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(block_size));
+}
+
+BENCHMARK(fir_resample<float>)->Args({16, 1, 1})->Args({64, 1, 1})->Args({256, 1, 1})->Args({64, 1, 8})
+        ->Args({64, 4, 1})->Args({96, 3, 2});
+BENCHMARK(fir_resample<std::complex<float> >)->Args({16, 1, 1})->Args({64, 1, 1})->Args({256, 1, 1})
+        ->Args({64, 1, 8})->Args({64, 4, 1})->Args({96, 3, 2});
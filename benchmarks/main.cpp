@@ -0,0 +1,100 @@
+// Copyright(c) 2023, Matthew Petrin, All rights reserved.
+//
+// Entry point of ccomms_bench. Every Google Benchmark flag is accepted; in particular
+//
+//     ccomms_bench --benchmark_out=results.json --benchmark_out_format=json
+//
+// writes a JSON report. Passing a previous report as --baseline=<file> compares the CPU time of each benchmark against
+// it and exits with status 1 when any benchmark is slower by more than --regression_threshold (a fraction, 0.10 by
+// default). Use --benchmark_filter to limit a run, e.g. --benchmark_filter=vector to skip the coords benchmarks.
+
+#include <map>
+#include <string>
+#include <vector>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <exception>
+#include <benchmark/benchmark.h>
+
+#include "baseline.hpp"
+
+namespace {
+
+// Console output as usual, while keeping the per-iteration time of every run for the baseline comparison
+class recording_reporter : public benchmark::ConsoleReporter {
+public:
+    std::vector<std::pair<std::string, ccomms::bench::timing> > runs;
+
+    void ReportRuns(const std::vector<Run> &reports) override {
+        for (const auto &run: reports) {
+            if (run.run_type != Run::RT_Iteration || run.error_occurred)
+                continue;
+            const double scale = ccomms::bench::unit_scale(benchmark::GetTimeUnitString(run.time_unit));
+            runs.emplace_back(run.benchmark_name(),
+                              ccomms::bench::timing{run.GetAdjustedRealTime() * scale,
+                                                    run.GetAdjustedCPUTime() * scale});
+        }
+        ConsoleReporter::ReportRuns(reports);
+    }
+};
+
+bool take_flag(const char *arg, const char *flag, std::string &value) {
+    const std::size_t len = std::strlen(flag);
+    if (std::strncmp(arg, flag, len) != 0 || arg[len] != '=')
+        return false;
+    value = arg + len + 1;
+    return true;
+}
+
+}
+
+int main(int argc, char **argv) {
+    std::string baseline_path;
+    std::string threshold = "0.10";
+
+    // Strip the flags handled here before Google Benchmark sees the command line
+    int kept = 1;
+    for (int i = 1; i < argc; i++)
+        if (!take_flag(argv[i], "--baseline", baseline_path) &&
+            !take_flag(argv[i], "--regression_threshold", threshold))
+            argv[kept++] = argv[i];
+    argc = kept;
+
+    benchmark::Initialize(&argc, argv);
+    if (benchmark::ReportUnrecognizedArguments(argc, argv))
+        return 1;
+
+    std::map<std::string, ccomms::bench::timing> baseline;
+    double limit = 0;
+    try {
+        if (!baseline_path.empty())
+            baseline = ccomms::bench::load_baseline(baseline_path);
+        limit = std::stod(threshold);
+    } catch (const std::exception &e) {
+        std::cerr << e.what();
+        return 1;
+    }
+
+    recording_reporter reporter;
+    benchmark::RunSpecifiedBenchmarks(&reporter);
+    benchmark::Shutdown();
+
+    if (baseline_path.empty())
+        return 0;
+
+    const auto results = ccomms::bench::compare(reporter.runs, baseline);
+    std::size_t regressions = 0;
+
+    std::printf("\n%-60s %14s %14s %9s\n", "Comparison with baseline", "Baseline (ns)", "Current (ns)", "Change");
+    for (const auto &result: results) {
+        const bool regressed = result.change() > limit;
+        regressions += regressed;
+        std::printf("%-60s %14.1f %14.1f %+8.1f%%%s\n", result.name.c_str(), result.baseline, result.current,
+                    100 * result.change(), regressed ? "  REGRESSION" : "");
+    }
+    std::printf("\n%zu of %zu benchmarks slower than baseline by more than %.1f%%\n", regressions, results.size(),
+                100 * limit);
+
+    return regressions ? 1 : 0;
+}
@@ -0,0 +1,66 @@
+// Copyright(c) 2023, Matthew Petrin, All rights reserved.
+
+#include <complex>
+#include <cstdint>
+#include <benchmark/benchmark.h>
+#include "../../include/tensor.hpp"
+#include "../../include/stream.hpp"
+
+using namespace ccomms;
+
+namespace {
+
+// Samples pushed through the graph per iteration
+constexpr std::size_t stream_samples = 1 << 18;
+
+void block_sizes(benchmark::internal::Benchmark *b) {
+    b->RangeMultiplier(4)->Range(256, 16384);
+}
+
+// Source, two scaling stages and a sink, moving complex samples in blocks of the given size
+template<typename R>
+void run_chain(benchmark::State &state, R &&run) {
+    using cf = std::complex<float>;
+    const auto block = static_cast<std::size_t>(state.range(0));
+
+    for (auto _: state) {
+        stream::graph g;
+        std::size_t produced = 0;
+        auto &src = g.source<cf>("source", block, [&](vector_view<cf> out) {
+            const std::size_t n = std::min(out.size(), stream_samples - produced);
+            out.subview(0, n).fill(cf(1, -1));
+            produced += n;
+            return n;
+        });
+        auto scale = [](vector_view<const cf> in, vector_view<cf> out) {
+            out.subview(0, in.size()) = in * cf(0.5f, 0.5f);
+            return in.size();
+        };
+        auto &first = g.transform<cf, cf>("first", block, scale);
+        auto &second = g.transform<cf, cf>("second", block, scale);
+        cf total(0);
+        auto &snk = g.sink<cf>("sink", [&](vector_view<const cf> in) { total += in[0]; });
+
+        g.connect(src.out, first.in);
+        g.connect(first.out, second.in);
+        g.connect(second.out, snk.in);
+        run(g);
+        benchmark::DoNotOptimize(total);
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(stream_samples));
+}
+
+}
+
+//****************************************************** GRAPH *****************************************************
+
+void graph_chain_pool(benchmark::State &state) {
+    run_chain(state, [](stream::graph &g) { g.run(); });
+}
+
+void graph_chain_pinned(benchmark::State &state) {
+    run_chain(state, [](stream::graph &g) { g.run_pinned(); });
+}
+
+BENCHMARK(graph_chain_pool)->Apply(block_sizes)->UseRealTime();
+BENCHMARK(graph_chain_pinned)->Apply(block_sizes)->UseRealTime();
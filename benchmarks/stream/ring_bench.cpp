@@ -0,0 +1,164 @@
+// Copyright(c) 2023, Matthew Petrin, All rights reserved.
+
+#include <deque>
+#include <mutex>
+#include <atomic>
+#include <thread>
+#include <complex>
+#include <cstdint>
+#include <benchmark/benchmark.h>
+#include "../../include/tensor.hpp"
+#include "../../include/stream.hpp"
+
+using namespace ccomms;
+
+namespace {
+
+constexpr std::size_t ring_samples = 1 << 16;
+
+// Blocks moved per iteration of the threaded benchmarks
+constexpr std::size_t transfer_blocks = 64;
+
+void block_sizes(benchmark::internal::Benchmark *b) {
+    b->RangeMultiplier(4)->Range(64, 4096);
+}
+
+void processed(benchmark::State &state) {
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+}
+
+//*************************************************** SINGLE THREAD ************************************************
+
+// Claims, fills and commits one block, then claims and commits it on the read side. Items are samples.
+template<typename T>
+void ring_spsc_claim(benchmark::State &state) {
+    const auto block = static_cast<std::size_t>(state.range(0));
+    stream::spsc_ring<T> ring(ring_samples);
+    for (auto _: state) {
+        vector_view<T> region = ring.claim_write(block);
+        region.fill(T(1));
+        ring.commit_write(region.size());
+        vector_view<const T> readable = ring.claim_read(block);
+        benchmark::DoNotOptimize(readable.data());
+        ring.commit_read(readable.size());
+    }
+    processed(state);
+}
+
+template<typename T>
+void ring_spsc_copy(benchmark::State &state) {
+    const auto block = static_cast<std::size_t>(state.range(0));
+    stream::spsc_ring<T> ring(ring_samples);
+    const vector<T> in(block, T(1));
+    vector<T> out(block, T(0));
+    for (auto _: state) {
+        benchmark::DoNotOptimize(ring.write(in));
+        benchmark::DoNotOptimize(ring.read(out));
+    }
+    processed(state);
+}
+
+template<typename T>
+void ring_mpmc_copy(benchmark::State &state) {
+    const auto block = static_cast<std::size_t>(state.range(0));
+    stream::mpmc_ring<T> ring(ring_samples / block, block);
+    const vector<T> in(block, T(1));
+    vector<T> out(block, T(0));
+    for (auto _: state) {
+        benchmark::DoNotOptimize(ring.try_push(in));
+        benchmark::DoNotOptimize(ring.try_pop(out));
+    }
+    processed(state);
+}
+
+BENCHMARK(ring_spsc_claim<float>)->Apply(block_sizes);
+BENCHMARK(ring_spsc_claim<std::complex<float> >)->Apply(block_sizes);
+BENCHMARK(ring_spsc_copy<std::complex<float> >)->Apply(block_sizes);
+BENCHMARK(ring_mpmc_copy<std::complex<float> >)->Apply(block_sizes);
+
+//*************************************************** TWO THREADS **************************************************
+
+// A consumer thread drains blocks while the benchmark thread produces them. Items are samples.
+template<typename T>
+void ring_spsc_transfer(benchmark::State &state) {
+    const auto block = static_cast<std::size_t>(state.range(0));
+    stream::spsc_ring<T> ring(ring_samples);
+    std::atomic<bool> stop{false};
+
+    std::thread consumer([&] {
+        while (!stop.load(std::memory_order_relaxed)) {
+            vector_view<const T> region = ring.claim_read(block);
+            if (region.empty())
+                std::this_thread::yield();
+            ring.commit_read(region.size());
+        }
+    });
+
+    for (auto _: state) {
+        for (std::size_t b = 0; b < transfer_blocks; b++) {
+            std::size_t done = 0;
+            while (done < block) {
+                vector_view<T> region = ring.claim_write(block - done);
+                if (region.empty())
+                    std::this_thread::yield();
+                region.fill(T(1));
+                ring.commit_write(region.size());
+                done += region.size();
+            }
+        }
+    }
+
+    stop = true;
+    consumer.join();
+    state.SetItemsProcessed(state.iterations() * state.range(0) * static_cast<std::int64_t>(transfer_blocks));
+}
+
+// The mutex-guarded queue of vectors the rings replace, for comparison
+template<typename T>
+void ring_mutex_transfer(benchmark::State &state) {
+    const auto block = static_cast<std::size_t>(state.range(0));
+    std::mutex lock;
+    std::deque<vector<T> > queue;
+    std::atomic<bool> stop{false};
+
+    std::thread consumer([&] {
+        while (!stop.load(std::memory_order_relaxed)) {
+            vector<T> taken;
+            {
+                std::lock_guard<std::mutex> guard(lock);
+                if (!queue.empty()) {
+                    taken = std::move(queue.front());
+                    queue.pop_front();
+                }
+            }
+            if (taken.size() == 0)
+                std::this_thread::yield();
+            benchmark::DoNotOptimize(taken.data());
+        }
+    });
+
+    for (auto _: state) {
+        for (std::size_t b = 0; b < transfer_blocks; b++) {
+            vector<T> filled(block, T(1));
+            while (true) {
+                {
+                    std::lock_guard<std::mutex> guard(lock);
+                    if (queue.size() < ring_samples / block) {
+                        queue.push_back(std::move(filled));
+                        break;
+                    }
+                }
+                std::this_thread::yield();
+            }
+        }
+    }
+
+    stop = true;
+    consumer.join();
+    state.SetItemsProcessed(state.iterations() * state.range(0) * static_cast<std::int64_t>(transfer_blocks));
+}
+
+BENCHMARK(ring_spsc_transfer<std::complex<float> >)->Apply(block_sizes)->UseRealTime();
+BENCHMARK(ring_mutex_transfer<std::complex<float> >)->Apply(block_sizes)->UseRealTime();
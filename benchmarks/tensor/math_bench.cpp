@@ -0,0 +1,153 @@
+// Copyright(c) 2023, Matthew Petrin, All rights reserved.
+
+#include <cmath>
+#include <cstdint>
+#include <benchmark/benchmark.h>
+#include "../../include/tensor.hpp"
+
+using namespace ccomms;
+using simd::accuracy;
+
+namespace {
+
+// Each function provides its argument range, the standard library loop it replaces and the SIMD kernel. aux is the
+// second input of atan2 and the cosine output of sincos.
+
+struct exp_function {
+    static double sample(const std::size_t &i) { return static_cast<double>(i % 1000) * 0.1 - 50; }
+
+    template<typename T>
+    static void libm(T *dst, const T *src, T *, const std::size_t &n) {
+        for (std::size_t i = 0; i < n; i++)
+            dst[i] = std::exp(src[i]);
+    }
+
+    template<accuracy A, typename T>
+    static void kernel(T *dst, const T *src, T *, const std::size_t &n) { simd::exp<A>(dst, src, n); }
+};
+
+struct log_function {
+    static double sample(const std::size_t &i) { return static_cast<double>(i % 1000) * 0.37 + 1e-3; }
+
+    template<typename T>
+    static void libm(T *dst, const T *src, T *, const std::size_t &n) {
+        for (std::size_t i = 0; i < n; i++)
+            dst[i] = std::log(src[i]);
+    }
+
+    template<accuracy A, typename T>
+    static void kernel(T *dst, const T *src, T *, const std::size_t &n) { simd::log<A>(dst, src, n); }
+};
+
+struct rsqrt_function {
+    static double sample(const std::size_t &i) { return static_cast<double>(i % 1000) * 0.37 + 1e-3; }
+
+    template<typename T>
+    static void libm(T *dst, const T *src, T *, const std::size_t &n) {
+        for (std::size_t i = 0; i < n; i++)
+            dst[i] = T(1) / std::sqrt(src[i]);
+    }
+
+    template<accuracy A, typename T>
+    static void kernel(T *dst, const T *src, T *, const std::size_t &n) { simd::rsqrt<A>(dst, src, n); }
+};
+
+struct sincos_function {
+    static double sample(const std::size_t &i) { return static_cast<double>(i % 1000) * 0.37 - 180; }
+
+    template<typename T>
+    static void libm(T *dst, const T *src, T *aux, const std::size_t &n) {
+        for (std::size_t i = 0; i < n; i++) {
+            dst[i] = std::sin(src[i]);
+            aux[i] = std::cos(src[i]);
+        }
+    }
+
+    template<accuracy A, typename T>
+    static void kernel(T *dst, const T *src, T *aux, const std::size_t &n) { simd::sincos<A>(dst, aux, src, n); }
+};
+
+struct atan2_function {
+    static double sample(const std::size_t &i) { return static_cast<double>(i % 1000) * 0.37 - 180; }
+
+    template<typename T>
+    static void libm(T *dst, const T *src, T *aux, const std::size_t &n) {
+        for (std::size_t i = 0; i < n; i++)
+            dst[i] = std::atan2(src[i], aux[i]);
+    }
+
+    template<accuracy A, typename T>
+    static void kernel(T *dst, const T *src, T *aux, const std::size_t &n) { simd::atan2<A>(dst, src, aux, n); }
+};
+
+template<typename F, typename T>
+struct operands {
+    vector<T> src, aux, dst;
+
+    explicit operands(const std::size_t &len) : src(len, T(0)), aux(len, T(0)), dst(len, T(0)) {
+        for (std::size_t i = 0; i < len; i++) {
+            src[i] = static_cast<T>(F::sample(i));
+            aux[i] = static_cast<T>(F::sample(i * 7 + 3));
+        }
+    }
+};
+
+}
+
+//*************************************************** ELEMENTWISE **************************************************
+
+// Arguments: length. Items are elements.
+template<typename F, typename T>
+void math_libm(benchmark::State &state) {
+    const auto len = static_cast<std::size_t>(state.range(0));
+    operands<F, T> x(len);
+    for (auto _: state) {
+        F::libm(x.dst.data(), x.src.data(), x.aux.data(), len);
+        benchmark::DoNotOptimize(x.dst.data());
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+template<typename F, typename T, accuracy A>
+void math_simd(benchmark::State &state) {
+    const auto len = static_cast<std::size_t>(state.range(0));
+    operands<F, T> x(len);
+    for (auto _: state) {
+        F::template kernel<A>(x.dst.data(), x.src.data(), x.aux.data(), len);
+        benchmark::DoNotOptimize(x.dst.data());
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+BENCHMARK(math_libm<exp_function, float>)->Arg(4096);
+BENCHMARK(math_simd<exp_function, float, accuracy::precise>)->Arg(4096);
+BENCHMARK(math_simd<exp_function, float, accuracy::fast>)->Arg(4096);
+BENCHMARK(math_libm<exp_function, double>)->Arg(4096);
+BENCHMARK(math_simd<exp_function, double, accuracy::precise>)->Arg(4096);
+BENCHMARK(math_simd<exp_function, double, accuracy::fast>)->Arg(4096);
+BENCHMARK(math_libm<log_function, float>)->Arg(4096);
+BENCHMARK(math_simd<log_function, float, accuracy::precise>)->Arg(4096);
+BENCHMARK(math_simd<log_function, float, accuracy::fast>)->Arg(4096);
+BENCHMARK(math_libm<log_function, double>)->Arg(4096);
+BENCHMARK(math_simd<log_function, double, accuracy::precise>)->Arg(4096);
+BENCHMARK(math_simd<log_function, double, accuracy::fast>)->Arg(4096);
+BENCHMARK(math_libm<rsqrt_function, float>)->Arg(4096);
+BENCHMARK(math_simd<rsqrt_function, float, accuracy::precise>)->Arg(4096);
+BENCHMARK(math_simd<rsqrt_function, float, accuracy::fast>)->Arg(4096);
+BENCHMARK(math_libm<rsqrt_function, double>)->Arg(4096);
+BENCHMARK(math_simd<rsqrt_function, double, accuracy::precise>)->Arg(4096);
+BENCHMARK(math_simd<rsqrt_function, double, accuracy::fast>)->Arg(4096);
+BENCHMARK(math_libm<sincos_function, float>)->Arg(4096);
+BENCHMARK(math_simd<sincos_function, float, accuracy::precise>)->Arg(4096);
+BENCHMARK(math_simd<sincos_function, float, accuracy::fast>)->Arg(4096);
+BENCHMARK(math_libm<sincos_function, double>)->Arg(4096);
+BENCHMARK(math_simd<sincos_function, double, accuracy::precise>)->Arg(4096);
+BENCHMARK(math_simd<sincos_function, double, accuracy::fast>)->Arg(4096);
+BENCHMARK(math_libm<atan2_function, float>)->Arg(4096);
+BENCHMARK(math_simd<atan2_function, float, accuracy::precise>)->Arg(4096);
+BENCHMARK(math_simd<atan2_function, float, accuracy::fast>)->Arg(4096);
+BENCHMARK(math_libm<atan2_function, double>)->Arg(4096);
+BENCHMARK(math_simd<atan2_function, double, accuracy::precise>)->Arg(4096);
+BENCHMARK(math_simd<atan2_function, double, accuracy::fast>)->Arg(4096);
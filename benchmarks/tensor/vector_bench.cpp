@@ -0,0 +1,248 @@
+// Copyright(c) 2023, Matthew Petrin, All rights reserved.
+
+#include <complex>
+#include <cstdint>
+#include <benchmark/benchmark.h>
+#include "../../include/tensor.hpp"
+
+using namespace ccomms;
+
+namespace {
+
+constexpr std::int64_t smallest = 3;
+constexpr std::int64_t largest = 10'000'000;
+
+// Sizes 3, 10, 100, ..., 10^7
+void sizes(benchmark::internal::Benchmark *b) {
+    b->RangeMultiplier(10)->Range(smallest, largest);
+}
+
+template<typename T>
+T sample(const std::size_t &i) {
+    if constexpr (is_complex_v<T>)
+        return T(static_cast<typename T::value_type>(i % 7 + 1), static_cast<typename T::value_type>(i % 5));
+    else
+        return static_cast<T>(i % 7 + 1);
+}
+
+template<typename T>
+vector<T> filled(const std::size_t &len) {
+    vector<T> result(len, T(0));
+    for (std::size_t i = 0; i < len; i++)
+        result[i] = sample<T>(i);
+    return result;
+}
+
+template<typename T>
+void processed(benchmark::State &state, const std::size_t &streams) {
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+    state.SetBytesProcessed(state.iterations() * state.range(0) * static_cast<std::int64_t>(streams * sizeof(T)));
+}
+
+}
+
+//************************************************** CONSTRUCTION **************************************************
+
+template<typename T, std::size_t N>
+void vector_construct_fixed(benchmark::State &state) {
+    for (auto _: state) {
+        vector<T, N> v(N, T(1));
+        benchmark::DoNotOptimize(v.data());
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(N));
+}
+
+template<typename T>
+void vector_construct_dynamic(benchmark::State &state) {
+    const auto len = static_cast<std::size_t>(state.range(0));
+    for (auto _: state) {
+        vector<T> v(len, T(1));
+        benchmark::DoNotOptimize(v.data());
+        benchmark::ClobberMemory();
+    }
+    processed<T>(state, 1);
+}
+
+template<typename T>
+void vector_copy_dynamic(benchmark::State &state) {
+    const vector<T> source = filled<T>(static_cast<std::size_t>(state.range(0)));
+    for (auto _: state) {
+        vector<T> v(source);
+        benchmark::DoNotOptimize(v.data());
+        benchmark::ClobberMemory();
+    }
+    processed<T>(state, 2);
+}
+
+BENCHMARK(vector_construct_fixed<float, 3>);
+BENCHMARK(vector_construct_fixed<float, 16>);
+BENCHMARK(vector_construct_fixed<double, 3>);
+BENCHMARK(vector_construct_fixed<double, 16>);
+BENCHMARK(vector_construct_dynamic<float>)->Apply(sizes);
+BENCHMARK(vector_construct_dynamic<double>)->Apply(sizes);
+BENCHMARK(vector_copy_dynamic<float>)->Apply(sizes);
+BENCHMARK(vector_copy_dynamic<double>)->Apply(sizes);
+
+//*************************************************** OPERATORS ****************************************************
+
+template<typename T, typename Op>
+void vector_binary(benchmark::State &state) {
+    const auto len = static_cast<std::size_t>(state.range(0));
+    const vector<T> a = filled<T>(len), b = filled<T>(len);
+    vector<T> out(len, T(0));
+    for (auto _: state) {
+        if constexpr (std::is_same_v<Op, ops::add>)
+            out = a + b;
+        else if constexpr (std::is_same_v<Op, ops::sub>)
+            out = a - b;
+        else if constexpr (std::is_same_v<Op, ops::mul>)
+            out = a * b;
+        else
+            out = a / b;
+        benchmark::DoNotOptimize(out.data());
+        benchmark::ClobberMemory();
+    }
+    processed<T>(state, 3);
+}
+
+template<typename T>
+void vector_scale(benchmark::State &state) {
+    const auto len = static_cast<std::size_t>(state.range(0));
+    const vector<T> a = filled<T>(len);
+    vector<T> out(len, T(0));
+    for (auto _: state) {
+        out = a * T(2);
+        benchmark::DoNotOptimize(out.data());
+        benchmark::ClobberMemory();
+    }
+    processed<T>(state, 2);
+}
+
+template<typename T>
+void vector_compound_add(benchmark::State &state) {
+    const auto len = static_cast<std::size_t>(state.range(0));
+    const vector<T> a = filled<T>(len);
+    vector<T> out(len, T(0));
+    for (auto _: state) {
+        out += a;
+        benchmark::DoNotOptimize(out.data());
+        benchmark::ClobberMemory();
+    }
+    processed<T>(state, 3);
+}
+
+template<typename T>
+void vector_nested_expression(benchmark::State &state) {
+    const auto len = static_cast<std::size_t>(state.range(0));
+    const vector<T> a = filled<T>(len), b = filled<T>(len), c = filled<T>(len);
+    vector<T> out(len, T(0));
+    for (auto _: state) {
+        out = a * b + c;
+        benchmark::DoNotOptimize(out.data());
+        benchmark::ClobberMemory();
+    }
+    processed<T>(state, 4);
+}
+
+BENCHMARK(vector_binary<float, ops::add>)->Apply(sizes);
+BENCHMARK(vector_binary<float, ops::sub>)->Apply(sizes);
+BENCHMARK(vector_binary<float, ops::mul>)->Apply(sizes);
+BENCHMARK(vector_binary<float, ops::div>)->Apply(sizes);
+BENCHMARK(vector_binary<double, ops::add>)->Apply(sizes);
+BENCHMARK(vector_binary<double, ops::mul>)->Apply(sizes);
+BENCHMARK(vector_binary<std::int32_t, ops::add>)->Apply(sizes);
+BENCHMARK(vector_binary<std::complex<float>, ops::mul>)->Apply(sizes);
+BENCHMARK(vector_scale<float>)->Apply(sizes);
+BENCHMARK(vector_scale<double>)->Apply(sizes);
+BENCHMARK(vector_compound_add<float>)->Apply(sizes);
+BENCHMARK(vector_compound_add<double>)->Apply(sizes);
+BENCHMARK(vector_nested_expression<float>)->Apply(sizes);
+BENCHMARK(vector_nested_expression<double>)->Apply(sizes);
+
+//************************************************ TYPE CONVERSION *************************************************
+
+template<typename From, typename To>
+void vector_convert_construct(benchmark::State &state) {
+    const vector<From> source = filled<From>(static_cast<std::size_t>(state.range(0)));
+    for (auto _: state) {
+        vector<To, 0, conversion::allow> v(source);
+        benchmark::DoNotOptimize(v.data());
+        benchmark::ClobberMemory();
+    }
+    processed<To>(state, 2);
+}
+
+template<typename From, typename To>
+void vector_mixed_add(benchmark::State &state) {
+    const auto len = static_cast<std::size_t>(state.range(0));
+    const vector<From> a = filled<From>(len);
+    const vector<To> b = filled<To>(len);
+    vector<To, 0, conversion::allow> out(len, To(0));
+    for (auto _: state) {
+        out = a + b;
+        benchmark::DoNotOptimize(out.data());
+        benchmark::ClobberMemory();
+    }
+    processed<To>(state, 3);
+}
+
+BENCHMARK(vector_convert_construct<float, double>)->Apply(sizes);
+BENCHMARK(vector_convert_construct<double, float>)->Apply(sizes);
+BENCHMARK(vector_convert_construct<std::int32_t, float>)->Apply(sizes);
+BENCHMARK(vector_mixed_add<float, double>)->Apply(sizes);
+BENCHMARK(vector_mixed_add<std::int32_t, double>)->Apply(sizes);
+
+//*************************************************** PRODUCTS *****************************************************
+
+template<typename T>
+void vector_cross_fixed(benchmark::State &state) {
+    const vector<T, 3> a{T(1), T(2), T(3)}, b{T(4), T(5), T(6)};
+    for (auto _: state) {
+        auto c = a & b;
+        benchmark::DoNotOptimize(c.data());
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+template<typename T>
+void vector_cross_dynamic(benchmark::State &state) {
+    const vector<T> a{T(1), T(2), T(3)}, b{T(4), T(5), T(6)};
+    for (auto _: state) {
+        auto c = a & b;
+        benchmark::DoNotOptimize(c.data());
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+template<typename T>
+void vector_inner(benchmark::State &state) {
+    const auto len = static_cast<std::size_t>(state.range(0));
+    const vector<T> a = filled<T>(len), b = filled<T>(len);
+    for (auto _: state) {
+        auto result = a | b;
+        benchmark::DoNotOptimize(result);
+    }
+    processed<T>(state, 2);
+}
+
+template<typename T>
+void vector_inner_parallel(benchmark::State &state) {
+    const auto len = static_cast<std::size_t>(state.range(0));
+    const vector<T> a = filled<T>(len), b = filled<T>(len);
+    for (auto _: state) {
+        auto result = inner(execution::par_unseq, a, b);
+        benchmark::DoNotOptimize(result);
+    }
+    processed<T>(state, 2);
+}
+
+BENCHMARK(vector_cross_fixed<float>);
+BENCHMARK(vector_cross_fixed<double>);
+BENCHMARK(vector_cross_dynamic<float>);
+BENCHMARK(vector_cross_dynamic<double>);
+BENCHMARK(vector_inner<float>)->Apply(sizes);
+BENCHMARK(vector_inner<double>)->Apply(sizes);
+BENCHMARK(vector_inner<std::complex<float> >)->Apply(sizes);
+BENCHMARK(vector_inner_parallel<float>)->Apply(sizes);
+BENCHMARK(vector_inner_parallel<double>)->Apply(sizes);
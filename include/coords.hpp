@@ -5,5 +5,12 @@
 #define CCOMMS_COORDS_HPP
 
 #include "../modules/coords/types.hpp"
+#include "../modules/coords/batch.hpp"
+#include "../modules/coords/transforms.hpp"
+#include "../modules/coords/geodesic.hpp"
+#include "../modules/coords/spatial.hpp"
+#include "../modules/coords/tle.hpp"
+#include "../modules/coords/orbit.hpp"
+#include "../modules/coords/visibility.hpp"
 
 #endif //CCOMMS_COORDS_HPP
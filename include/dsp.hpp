@@ -0,0 +1,10 @@
+// Copyright(c) 2023, Matthew Petrin, All rights reserved.
+
+#ifndef CCOMMS_DSP_HPP
+#define CCOMMS_DSP_HPP
+
+#include "../modules/dsp/fft.hpp"
+#include "../modules/dsp/fir.hpp"
+#include "../modules/dsp/beamforming.hpp"
+
+#endif //CCOMMS_DSP_HPP
@@ -0,0 +1,8 @@
+// Copyright(c) 2023, Matthew Petrin, All rights reserved.
+
+#ifndef CCOMMS_IO_HPP
+#define CCOMMS_IO_HPP
+
+#include "../modules/io/binary.hpp"
+
+#endif //CCOMMS_IO_HPP
@@ -0,0 +1,9 @@
+// Copyright(c) 2023, Matthew Petrin, All rights reserved.
+
+#ifndef CCOMMS_STREAM_HPP
+#define CCOMMS_STREAM_HPP
+
+#include "../modules/stream/ring.hpp"
+#include "../modules/stream/graph.hpp"
+
+#endif //CCOMMS_STREAM_HPP
@@ -3,6 +3,13 @@
 #ifndef CCOMMS_TENSOR_HPP
 #define CCOMMS_TENSOR_HPP
 
+#include "../modules/tensor/memory.hpp"
+#include "../modules/tensor/inline_vector.hpp"
 #include "../modules/tensor/vector.hpp"
+#include "../modules/tensor/view.hpp"
+#include "../modules/tensor/complex.hpp"
+#include "../modules/tensor/matrix.hpp"
+#include "../modules/tensor/execution.hpp"
+#include "../modules/tensor/math.hpp"
 
 #endif //CCOMMS_TENSOR_HPP
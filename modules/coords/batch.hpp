@@ -0,0 +1,383 @@
+// Copyright(c) 2023, Matthew Petrin, All rights reserved.
+
+#ifndef CCOMMS_COORDS_BATCH_HPP
+#define CCOMMS_COORDS_BATCH_HPP
+
+#include "types.hpp"
+#include "../tensor/simd.hpp"
+#include "../tensor/vector.hpp"
+
+#include <array>
+#include <cmath>
+#include <string>
+#include <ranges>
+#include <stdexcept>
+
+namespace ccomms {
+
+    /**
+     * @class coordinate_batch
+     *
+     * @brief Structure of arrays storage for a batch of points with K components each.
+     *
+     * @tparam T: Component type
+     * @tparam K: Number of components per point
+     * @tparam Alloc: Allocator of the component columns
+     *
+     * @ingroup coords
+     *
+     * @details Each component is stored in its own contiguous ccomms::vector, so operations applied to every point
+     * in the batch become elementwise operations over whole columns and run on the tensor SIMD kernels. Points can be
+     * bulk loaded from and written back to interleaved buffers holding K components per point.
+     */
+    template<typename T, std::size_t K, typename Alloc = std::allocator<T>>
+    class coordinate_batch {
+    public:
+        using value_type = T;
+        using column_type = vector<T, 0, conversion::warn_once, Alloc>;
+
+        static constexpr std::size_t components = K;
+
+        //************************************************* CONSTRUCTORS ***********************************************
+
+        coordinate_batch() = default;
+
+        explicit coordinate_batch(const std::size_t &len) {
+            for (auto &c: columns)
+                c.assign(len, T(0));
+        }
+
+        /**
+         * @brief Loads len points from a buffer holding K interleaved components per point.
+         */
+        coordinate_batch(const T *interleaved, const std::size_t &len) : coordinate_batch(len) {
+            for (std::size_t k = 0; k < K; k++) {
+                T *dst = columns[k].data();
+                for (std::size_t i = 0; i < len; i++)
+                    dst[i] = interleaved[i * K + k];
+            }
+        }
+
+        //*************************************************** ACCESS ***************************************************
+
+        [[nodiscard]] std::size_t size() const { return columns[0].size(); }
+
+        [[nodiscard]] bool empty() const { return columns[0].empty(); }
+
+        column_type &column(const std::size_t &k) { return columns[k]; }
+
+        const column_type &column(const std::size_t &k) const { return columns[k]; }
+
+        std::array<T, K> point(const std::size_t &i) const {
+            std::array<T, K> result;
+            for (std::size_t k = 0; k < K; k++)
+                result[k] = columns[k][i];
+            return result;
+        }
+
+        void resize(const std::size_t &len) {
+            for (auto &c: columns)
+                c.resize(len, T(0));
+        }
+
+        void reserve(const std::size_t &len) {
+            for (auto &c: columns)
+                c.reserve(len);
+        }
+
+        void clear() {
+            for (auto &c: columns)
+                c.clear();
+        }
+
+        /**
+         * @brief Writes the batch to a buffer of size() * K components, K interleaved components per point.
+         */
+        void interleave(T *out) const {
+            for (std::size_t k = 0; k < K; k++) {
+                const T *src = columns[k].data();
+                for (std::size_t i = 0; i < size(); i++)
+                    out[i * K + k] = src[i];
+            }
+        }
+
+        vector<T> interleave() const {
+            vector<T> result(size() * K, T(0));
+            interleave(result.data());
+            return result;
+        }
+
+    protected:
+        std::array<column_type, K> columns;
+
+        void check_size(const std::size_t &len, const std::string &name) const {
+            if (len != size())
+                throw std::invalid_argument("\nERR: batch " + name + " requires batches of equal length\n");
+        }
+
+        static void sqrt_in_place(column_type &c) {
+            if constexpr (std::is_same_v<T, float> || std::is_same_v<T, double>)
+                simd::sqrt(c.data(), c.data(), c.size());
+            else
+                for (auto &value: c)
+                    value = static_cast<T>(std::sqrt(value));
+        }
+    };
+
+    /**
+     * @class cartesian_batch
+     *
+     * @brief A batch of cartesian points stored as contiguous x, y and z columns.
+     *
+     * @ingroup coords
+     */
+    template<typename T, typename Alloc = std::allocator<T>>
+    class cartesian_batch : public coordinate_batch<T, 3, Alloc> {
+
+        using base = coordinate_batch<T, 3, Alloc>;
+
+    public:
+        using typename base::column_type;
+
+        //************************************************* CONSTRUCTORS ***********************************************
+
+        using base::base;
+
+        template<std::ranges::sized_range P>
+        requires indexable<std::ranges::range_value_t<P>>
+        explicit cartesian_batch(const P &points) : base(std::ranges::size(points)) {
+            std::size_t i = 0;
+            for (const auto &p: points)
+                set(i++, p[0], p[1], p[2]);
+        }
+
+        //*************************************************** ACCESS ***************************************************
+
+        column_type &x() { return this->columns[0]; }
+
+        const column_type &x() const { return this->columns[0]; }
+
+        column_type &y() { return this->columns[1]; }
+
+        const column_type &y() const { return this->columns[1]; }
+
+        column_type &z() { return this->columns[2]; }
+
+        const column_type &z() const { return this->columns[2]; }
+
+        cartesian<T> operator[](const std::size_t &i) const { return {x()[i], y()[i], z()[i]}; }
+
+        void set(const std::size_t &i, const T &px, const T &py, const T &pz) {
+            x()[i] = px;
+            y()[i] = py;
+            z()[i] = pz;
+        }
+
+        void push_back(const T &px, const T &py, const T &pz) {
+            x().push_back(px);
+            y().push_back(py);
+            z().push_back(pz);
+        }
+
+        void push_back(const cartesian<T> &p) { push_back(p[0], p[1], p[2]); }
+
+        //*************************************************** POINTWISE ************************************************
+
+        cartesian_batch operator+(const cartesian_batch &other) const {
+            this->check_size(other.size(), "addition");
+            cartesian_batch result;
+            result.x() = x() + other.x();
+            result.y() = y() + other.y();
+            result.z() = z() + other.z();
+            return result;
+        }
+
+        cartesian_batch operator-(const cartesian_batch &other) const {
+            this->check_size(other.size(), "subtraction");
+            cartesian_batch result;
+            result.x() = x() - other.x();
+            result.y() = y() - other.y();
+            result.z() = z() - other.z();
+            return result;
+        }
+
+        /**
+         * @brief Every point relative to origin.
+         */
+        cartesian_batch operator-(const cartesian<T> &origin) const {
+            cartesian_batch result;
+            result.x() = x() - origin[0];
+            result.y() = y() - origin[1];
+            result.z() = z() - origin[2];
+            return result;
+        }
+
+        cartesian_batch operator*(const T &scale) const {
+            cartesian_batch result;
+            result.x() = x() * scale;
+            result.y() = y() * scale;
+            result.z() = z() * scale;
+            return result;
+        }
+
+        /**
+         * @brief Per point inner product.
+         */
+        column_type dot(const cartesian_batch &other) const {
+            this->check_size(other.size(), "inner product");
+            column_type result = x() * other.x();
+            result.fma(y(), other.y());
+            result.fma(z(), other.z());
+            return result;
+        }
+
+        /**
+         * @brief Per point cross product.
+         */
+        cartesian_batch cross(const cartesian_batch &other) const {
+            this->check_size(other.size(), "cross product");
+            cartesian_batch result;
+            result.x() = y() * other.z() - z() * other.y();
+            result.y() = z() * other.x() - x() * other.z();
+            result.z() = x() * other.y() - y() * other.x();
+            return result;
+        }
+
+        /**
+         * @brief Per point Euclidean length.
+         */
+        column_type norm() const {
+            column_type result = dot(*this);
+            this->sqrt_in_place(result);
+            return result;
+        }
+
+        column_type distance(const cartesian_batch &other) const { return (*this - other).norm(); }
+
+        column_type distance(const cartesian<T> &point) const { return (*this - point).norm(); }
+    };
+
+    /**
+     * @class spherical_batch
+     *
+     * @brief A batch of spherical points stored as contiguous azimuth, elevation and range columns.
+     *
+     * @details Angles are in degrees, matching ccomms::spherical. Since spherical carries only a direction, points
+     * pushed from one take their range separately.
+     *
+     * @ingroup coords
+     */
+    template<typename T, typename Alloc = std::allocator<T>>
+    class spherical_batch : public coordinate_batch<T, 3, Alloc> {
+
+        using base = coordinate_batch<T, 3, Alloc>;
+
+    public:
+        using typename base::column_type;
+
+        using base::base;
+
+        column_type &az() { return this->columns[0]; }
+
+        const column_type &az() const { return this->columns[0]; }
+
+        column_type &el() { return this->columns[1]; }
+
+        const column_type &el() const { return this->columns[1]; }
+
+        column_type &range() { return this->columns[2]; }
+
+        const column_type &range() const { return this->columns[2]; }
+
+        spherical<T> operator[](const std::size_t &i) const { return {az()[i], el()[i]}; }
+
+        void set(const std::size_t &i, const T &paz, const T &pel, const T &prange) {
+            az()[i] = paz;
+            el()[i] = pel;
+            range()[i] = prange;
+        }
+
+        void push_back(const T &paz, const T &pel, const T &prange) {
+            az().push_back(paz);
+            el().push_back(pel);
+            range().push_back(prange);
+        }
+
+        void push_back(const spherical<T> &p, const T &prange = T(1)) { push_back(p[0], p[1], prange); }
+    };
+
+    /**
+     * @class geodetic_batch
+     *
+     * @brief A batch of geodetic points stored as contiguous latitude, longitude and altitude columns.
+     *
+     * @details Latitude and longitude are in degrees and altitude in meters above the ellipsoid. Bulk loads are
+     * validated against the same latitude and longitude bounds as ccomms::geodetic.
+     *
+     * @ingroup coords
+     */
+    template<typename T, typename Alloc = std::allocator<T>>
+    class geodetic_batch : public coordinate_batch<T, 3, Alloc> {
+
+        using base = coordinate_batch<T, 3, Alloc>;
+
+    public:
+        using typename base::column_type;
+
+        geodetic_batch() = default;
+
+        explicit geodetic_batch(const std::size_t &len) : base(len) {}
+
+        geodetic_batch(const T *interleaved, const std::size_t &len) : base(interleaved, len) {
+            validate();
+        }
+
+        column_type &lat() { return this->columns[0]; }
+
+        const column_type &lat() const { return this->columns[0]; }
+
+        column_type &lon() { return this->columns[1]; }
+
+        const column_type &lon() const { return this->columns[1]; }
+
+        column_type &alt() { return this->columns[2]; }
+
+        const column_type &alt() const { return this->columns[2]; }
+
+        geodetic<T> operator[](const std::size_t &i) const { return {lat()[i], lon()[i]}; }
+
+        void set(const std::size_t &i, const T &plat, const T &plon, const T &palt) {
+            check_bounds(plat, plon);
+            lat()[i] = plat;
+            lon()[i] = plon;
+            alt()[i] = palt;
+        }
+
+        void push_back(const T &plat, const T &plon, const T &palt) {
+            check_bounds(plat, plon);
+            lat().push_back(plat);
+            lon().push_back(plon);
+            alt().push_back(palt);
+        }
+
+        void push_back(const geodetic<T> &p, const T &palt = T(0)) { push_back(p[0], p[1], palt); }
+
+        /**
+         * @brief Checks every point against the latitude and longitude bounds.
+         */
+        void validate() const {
+            for (std::size_t i = 0; i < this->size(); i++)
+                check_bounds(lat()[i], lon()[i]);
+        }
+
+    private:
+        static void check_bounds(const T &plat, const T &plon) {
+            if (plat > 90 || plat < -90)
+                throw std::invalid_argument("ERR: geodetic lat must be between -90 and 90");
+            if (plon > 180 || plon < -180)
+                throw std::invalid_argument("ERR: geodetic lon must be between -180 and 180");
+        }
+    };
+}
+
+#endif //CCOMMS_COORDS_BATCH_HPP
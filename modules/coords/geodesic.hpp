@@ -0,0 +1,541 @@
+// Copyright(c) 2023, Matthew Petrin, All rights reserved.
+
+#ifndef CCOMMS_COORDS_GEODESIC_HPP
+#define CCOMMS_COORDS_GEODESIC_HPP
+
+#include "types.hpp"
+#include "batch.hpp"
+#include "transforms.hpp"
+#include "../tensor/simd.hpp"
+#include "../tensor/matrix.hpp"
+#include "../tensor/execution.hpp"
+
+#include <cmath>
+#include <limits>
+#include <string>
+#include <numbers>
+#include <algorithm>
+#include <stdexcept>
+#include <type_traits>
+
+namespace ccomms {
+
+    /**
+     * @brief Earth model of the geodesic functions: great circles on a sphere of mean_earth_radius, or Vincenty's
+     * geodesics on the WGS-84 ellipsoid.
+     */
+    enum class geodesic_method {
+        haversine,
+        vincenty
+    };
+
+    /**
+     * @brief Mean radius (2a + b) / 3 of the WGS-84 ellipsoid in meters, the sphere of the haversine method.
+     */
+    inline constexpr double mean_earth_radius = (2.0 * wgs84::a + wgs84::b) / 3.0;
+
+    /**
+     * @brief Pairs per task when the batch functions are spread across threads.
+     */
+    inline constexpr std::size_t geodesic_chunk = 4 * simd::block;
+
+    //*************************************************** BLOCK KERNELS ************************************************
+
+    // Each block kernel handles up to simd::block pairs from stack buffers, so that every transcendental runs as one
+    // pass of a SIMD kernel over the block. A stride of 0 for the first point repeats lat1[0], lon1[0] for every pair.
+
+    inline double wrap_longitude(const double &lon) {
+        return lon > 180.0 ? lon - 360.0 : lon < -180.0 ? lon + 360.0 : lon;
+    }
+
+    /**
+     * @brief Sine and cosine of the reduced latitude tan(u) = (1 - f) tan(lat), from the latitude in radians held in
+     * sin_u on entry. Written without the tangent so the poles stay finite.
+     */
+    inline void reduced_latitude(double *sin_u, double *cos_u, double *scratch, const std::size_t &count) {
+        simd::sincos(sin_u, cos_u, sin_u, count);
+        for (std::size_t k = 0; k < count; k++) {
+            sin_u[k] *= 1.0 - wgs84::f;
+            scratch[k] = sin_u[k] * sin_u[k] + cos_u[k] * cos_u[k];
+        }
+        simd::sqrt(scratch, scratch, count);
+        for (std::size_t k = 0; k < count; k++) {
+            sin_u[k] /= scratch[k];
+            cos_u[k] /= scratch[k];
+        }
+    }
+
+    template<typename T>
+    void haversine_inverse_block(const T *lat1, const T *lon1, const std::size_t &stride1, const T *lat2,
+                                 const T *lon2, T *distance, T *bearing, const std::size_t &count) {
+        constexpr T rad = static_cast<T>(deg_to_rad);
+        T sin1[simd::block], cos1[simd::block], sin2[simd::block], cos2[simd::block];
+        T sin_dlon[simd::block], cos_dlon[simd::block], sin_dlat[simd::block], x[simd::block], y[simd::block];
+
+        // Half angle differences, which keep the haversine well conditioned for nearby points
+        for (std::size_t k = 0; k < count; k++) {
+            sin1[k] = lat1[k * stride1] * rad;
+            sin2[k] = lat2[k] * rad;
+            sin_dlat[k] = (lat2[k] - lat1[k * stride1]) * (rad / 2);
+            sin_dlon[k] = (lon2[k] - lon1[k * stride1]) * (rad / 2);
+        }
+        simd::sincos(sin1, cos1, sin1, count);
+        simd::sincos(sin2, cos2, sin2, count);
+        simd::sincos(sin_dlat, x, sin_dlat, count);
+        simd::sincos(sin_dlon, cos_dlon, sin_dlon, count);
+
+        if (distance) {
+            for (std::size_t k = 0; k < count; k++) {
+                const T h = sin_dlat[k] * sin_dlat[k] + cos1[k] * cos2[k] * sin_dlon[k] * sin_dlon[k];
+                x[k] = std::clamp(h, T(0), T(1));
+                y[k] = T(1) - x[k];
+            }
+            simd::sqrt(x, x, count);
+            simd::sqrt(y, y, count);
+            simd::atan2(x, x, y, count);
+            for (std::size_t k = 0; k < count; k++)
+                distance[k] = x[k] * static_cast<T>(2 * mean_earth_radius);
+        }
+
+        if (bearing) {
+            for (std::size_t k = 0; k < count; k++) {
+                y[k] = 2 * sin_dlon[k] * cos_dlon[k] * cos2[k];
+                x[k] = cos1[k] * sin2[k] - sin1[k] * cos2[k] * (1 - 2 * sin_dlon[k] * sin_dlon[k]);
+            }
+            simd::atan2(y, y, x, count);
+            for (std::size_t k = 0; k < count; k++)
+                bearing[k] = wrap_azimuth(static_cast<T>(y[k] * rad_to_deg));
+        }
+    }
+
+    template<typename T>
+    void haversine_direct_block(const T *lat1, const T *lon1, const std::size_t &stride1, const T *bearing,
+                                const T *distance, T *lat2, T *lon2, const std::size_t &count) {
+        constexpr T rad = static_cast<T>(deg_to_rad);
+        T sin1[simd::block], cos1[simd::block], sin_b[simd::block], cos_b[simd::block];
+        T sin_d[simd::block], cos_d[simd::block], z[simd::block], w[simd::block];
+
+        for (std::size_t k = 0; k < count; k++) {
+            sin1[k] = lat1[k * stride1] * rad;
+            sin_b[k] = bearing[k] * rad;
+            sin_d[k] = distance[k] / static_cast<T>(mean_earth_radius);
+        }
+        simd::sincos(sin1, cos1, sin1, count);
+        simd::sincos(sin_b, cos_b, sin_b, count);
+        simd::sincos(sin_d, cos_d, sin_d, count);
+
+        // Sine of the destination latitude, its arcsine taken as atan2(z, sqrt(1 - z^2))
+        for (std::size_t k = 0; k < count; k++) {
+            z[k] = std::clamp(sin1[k] * cos_d[k] + cos1[k] * sin_d[k] * cos_b[k], T(-1), T(1));
+            w[k] = T(1) - z[k] * z[k];
+        }
+        simd::sqrt(w, w, count);
+        simd::atan2(w, z, w, count);
+
+        for (std::size_t k = 0; k < count; k++) {
+            z[k] = cos_d[k] - sin1[k] * z[k];
+            sin_b[k] *= sin_d[k] * cos1[k];
+        }
+        simd::atan2(z, sin_b, z, count);
+
+        for (std::size_t k = 0; k < count; k++) {
+            lat2[k] = static_cast<T>(std::clamp(w[k] * rad_to_deg, -90.0, 90.0));
+            lon2[k] = static_cast<T>(wrap_longitude(lon1[k * stride1] + z[k] * rad_to_deg));
+        }
+    }
+
+    /**
+     * @details Vincenty's inverse iterates the longitude difference on the auxiliary sphere. The whole block iterates
+     * until every pair has converged to 1e-12 radians, about 6 micrometers; pairs that fail to converge within 200
+     * iterations, which only happens for nearly antipodal points, give NaN.
+     */
+    template<typename T>
+    void vincenty_inverse_block(const T *lat1, const T *lon1, const std::size_t &stride1, const T *lat2,
+                                const T *lon2, T *distance, T *bearing, const std::size_t &count) {
+        constexpr double f = wgs84::f, pi = std::numbers::pi, tolerance = 1e-12;
+        double sin_u1[simd::block], cos_u1[simd::block], sin_u2[simd::block], cos_u2[simd::block];
+        double l[simd::block], lambda[simd::block], sin_lambda[simd::block], cos_lambda[simd::block];
+        double sin_sigma[simd::block], cos_sigma[simd::block], sigma[simd::block], cos2_alpha[simd::block];
+        double cos_2sm[simd::block], change[simd::block];
+
+        for (std::size_t k = 0; k < count; k++) {
+            sin_u1[k] = lat1[k * stride1] * deg_to_rad;
+            sin_u2[k] = lat2[k] * deg_to_rad;
+            const double dlon = (static_cast<double>(lon2[k]) - static_cast<double>(lon1[k * stride1])) * deg_to_rad;
+            l[k] = dlon > pi ? dlon - 2 * pi : dlon < -pi ? dlon + 2 * pi : dlon;
+            lambda[k] = l[k];
+        }
+        reduced_latitude(sin_u1, cos_u1, change, count);
+        reduced_latitude(sin_u2, cos_u2, change, count);
+
+        bool converged = false;
+        for (int iteration = 0; iteration < 200 && !converged; iteration++) {
+            simd::sincos(sin_lambda, cos_lambda, lambda, count);
+            for (std::size_t k = 0; k < count; k++) {
+                const double t1 = cos_u2[k] * sin_lambda[k];
+                const double t2 = cos_u1[k] * sin_u2[k] - sin_u1[k] * cos_u2[k] * cos_lambda[k];
+                sin_sigma[k] = t1 * t1 + t2 * t2;
+                cos_sigma[k] = sin_u1[k] * sin_u2[k] + cos_u1[k] * cos_u2[k] * cos_lambda[k];
+            }
+            simd::sqrt(sin_sigma, sin_sigma, count);
+            simd::atan2(sigma, sin_sigma, cos_sigma, count);
+
+            double largest = 0;
+            for (std::size_t k = 0; k < count; k++) {
+                const double sin_alpha = sin_sigma[k] > 0 ? cos_u1[k] * cos_u2[k] * sin_lambda[k] / sin_sigma[k] : 0;
+                cos2_alpha[k] = 1 - sin_alpha * sin_alpha;
+                cos_2sm[k] = cos2_alpha[k] > 0 ? cos_sigma[k] - 2 * sin_u1[k] * sin_u2[k] / cos2_alpha[k] : 0;
+                const double c = f / 16 * cos2_alpha[k] * (4 + f * (4 - 3 * cos2_alpha[k]));
+                const double next = l[k] + (1 - c) * f * sin_alpha *
+                        (sigma[k] + c * sin_sigma[k] * (cos_2sm[k] + c * cos_sigma[k] *
+                                                                     (2 * cos_2sm[k] * cos_2sm[k] - 1)));
+                change[k] = std::abs(next - lambda[k]);
+                largest = std::max(largest, change[k]);
+                lambda[k] = next;
+            }
+            converged = largest <= tolerance;
+        }
+
+        const double nan = std::numeric_limits<double>::quiet_NaN();
+        for (std::size_t k = 0; k < count; k++) {
+            const bool failed = !(change[k] <= tolerance) || std::abs(lambda[k]) > pi;
+            if (distance) {
+                const double u2 = cos2_alpha[k] * wgs84::ep2;
+                const double a = 1 + u2 / 16384 * (4096 + u2 * (-768 + u2 * (320 - 175 * u2)));
+                const double b = u2 / 1024 * (256 + u2 * (-128 + u2 * (74 - 47 * u2)));
+                const double c2 = cos_2sm[k], s = sin_sigma[k], c = cos_sigma[k];
+                const double delta = b * s * (c2 + b / 4 * (c * (2 * c2 * c2 - 1) -
+                                                            b / 6 * c2 * (4 * s * s - 3) * (4 * c2 * c2 - 3)));
+                distance[k] = static_cast<T>(failed ? nan : wgs84::b * a * (sigma[k] - delta));
+            }
+            if (failed)
+                change[k] = nan;
+        }
+
+        if (bearing) {
+            for (std::size_t k = 0; k < count; k++) {
+                sin_sigma[k] = cos_u2[k] * sin_lambda[k];
+                cos_sigma[k] = cos_u1[k] * sin_u2[k] - sin_u1[k] * cos_u2[k] * cos_lambda[k];
+            }
+            simd::atan2(sigma, sin_sigma, cos_sigma, count);
+            for (std::size_t k = 0; k < count; k++)
+                bearing[k] = std::isnan(change[k]) ? static_cast<T>(nan) :
+                             wrap_azimuth(static_cast<T>(sigma[k] * rad_to_deg));
+        }
+    }
+
+    template<typename T>
+    void vincenty_direct_block(const T *lat1, const T *lon1, const std::size_t &stride1, const T *bearing,
+                               const T *distance, T *lat2, T *lon2, const std::size_t &count) {
+        constexpr double f = wgs84::f, tolerance = 1e-12;
+        double sin_u1[simd::block], cos_u1[simd::block], sin_a1[simd::block], cos_a1[simd::block];
+        double sigma1[simd::block], sigma[simd::block], first[simd::block], sin_sigma[simd::block];
+        double cos_sigma[simd::block], cos_2sm[simd::block], sin_alpha[simd::block], big_b[simd::block];
+        double x[simd::block], y[simd::block];
+
+        for (std::size_t k = 0; k < count; k++) {
+            sin_u1[k] = lat1[k * stride1] * deg_to_rad;
+            sin_a1[k] = bearing[k] * deg_to_rad;
+        }
+        reduced_latitude(sin_u1, cos_u1, x, count);
+        simd::sincos(sin_a1, cos_a1, sin_a1, count);
+
+        // Angular distance from the equator crossing, and the first approximation of the arc on the auxiliary sphere
+        for (std::size_t k = 0; k < count; k++) {
+            x[k] = cos_u1[k] * cos_a1[k];
+            sin_alpha[k] = cos_u1[k] * sin_a1[k];
+            const double u2 = (1 - sin_alpha[k] * sin_alpha[k]) * wgs84::ep2;
+            const double a = 1 + u2 / 16384 * (4096 + u2 * (-768 + u2 * (320 - 175 * u2)));
+            big_b[k] = u2 / 1024 * (256 + u2 * (-128 + u2 * (74 - 47 * u2)));
+            first[k] = distance[k] / (wgs84::b * a);
+            sigma[k] = first[k];
+        }
+        simd::atan2(sigma1, sin_u1, x, count);
+
+        bool converged = false;
+        for (int iteration = 0; iteration < 100 && !converged; iteration++) {
+            for (std::size_t k = 0; k < count; k++)
+                x[k] = 2 * sigma1[k] + sigma[k];
+            simd::sincos(y, cos_2sm, x, count);
+            simd::sincos(sin_sigma, cos_sigma, sigma, count);
+
+            double largest = 0;
+            for (std::size_t k = 0; k < count; k++) {
+                const double b = big_b[k], c2 = cos_2sm[k], s = sin_sigma[k], c = cos_sigma[k];
+                const double delta = b * s * (c2 + b / 4 * (c * (2 * c2 * c2 - 1) -
+                                                            b / 6 * c2 * (4 * s * s - 3) * (4 * c2 * c2 - 3)));
+                const double next = first[k] + delta;
+                largest = std::max(largest, std::abs(next - sigma[k]));
+                sigma[k] = next;
+            }
+            converged = largest <= tolerance;
+        }
+
+        // Latitude, then the longitude on the auxiliary sphere corrected back to the ellipsoid
+        for (std::size_t k = 0; k < count; k++) {
+            const double t = sin_u1[k] * sin_sigma[k] - cos_u1[k] * cos_sigma[k] * cos_a1[k];
+            y[k] = sin_u1[k] * cos_sigma[k] + cos_u1[k] * sin_sigma[k] * cos_a1[k];
+            x[k] = sin_alpha[k] * sin_alpha[k] + t * t;
+        }
+        simd::sqrt(x, x, count);
+        for (std::size_t k = 0; k < count; k++)
+            x[k] *= 1 - f;
+        simd::atan2(y, y, x, count);
+
+        for (std::size_t k = 0; k < count; k++) {
+            first[k] = sin_sigma[k] * sin_a1[k];
+            x[k] = cos_u1[k] * cos_sigma[k] - sin_u1[k] * sin_sigma[k] * cos_a1[k];
+        }
+        simd::atan2(x, first, x, count);
+
+        for (std::size_t k = 0; k < count; k++) {
+            const double cos2_alpha = 1 - sin_alpha[k] * sin_alpha[k];
+            const double c = f / 16 * cos2_alpha * (4 + f * (4 - 3 * cos2_alpha));
+            const double c2 = cos_2sm[k];
+            const double l = x[k] - (1 - c) * f * sin_alpha[k] *
+                    (sigma[k] + c * sin_sigma[k] * (c2 + c * cos_sigma[k] * (2 * c2 * c2 - 1)));
+            lat2[k] = static_cast<T>(std::clamp(y[k] * rad_to_deg, -90.0, 90.0));
+            lon2[k] = static_cast<T>(wrap_longitude(lon1[k * stride1] + l * rad_to_deg));
+        }
+    }
+
+    //*************************************************** ARRAY KERNELS ************************************************
+
+    /**
+     * @brief Distance in meters and initial bearing in degrees clockwise from north in [0, 360) from each point 1 to
+     * the matching point 2. Either output may be null to skip it, and stride1 = 0 measures from the single point
+     * lat1[0], lon1[0] to every point 2.
+     *
+     * @details haversine works in the coordinate type; vincenty works in double whatever the coordinate type, as the
+     * ellipsoidal corrections are below float resolution, and gives NaN for nearly antipodal pairs where its
+     * iteration fails to converge.
+     */
+    template<typename T>
+    requires std::is_same_v<T, float> || std::is_same_v<T, double>
+    void inverse_geodesic(const geodesic_method &method, const T *lat1, const T *lon1, const std::size_t &stride1,
+                          const T *lat2, const T *lon2, T *distance, T *bearing, const std::size_t &len) {
+        for (std::size_t i = 0; i < len; i += simd::block) {
+            const std::size_t count = std::min(simd::block, len - i);
+            const T *first_lat = lat1 + i * stride1, *first_lon = lon1 + i * stride1;
+            T *d = distance ? distance + i : nullptr, *b = bearing ? bearing + i : nullptr;
+            if (method == geodesic_method::haversine)
+                haversine_inverse_block(first_lat, first_lon, stride1, lat2 + i, lon2 + i, d, b, count);
+            else
+                vincenty_inverse_block(first_lat, first_lon, stride1, lat2 + i, lon2 + i, d, b, count);
+        }
+    }
+
+    /**
+     * @brief Destination reached from each point 1 along the given initial bearing in degrees for the given distance
+     * in meters. stride1 = 0 starts every path at the single point lat1[0], lon1[0]. The outputs may alias the
+     * bearing and distance inputs.
+     */
+    template<typename T>
+    requires std::is_same_v<T, float> || std::is_same_v<T, double>
+    void direct_geodesic(const geodesic_method &method, const T *lat1, const T *lon1, const std::size_t &stride1,
+                         const T *bearing, const T *distance, T *lat2, T *lon2, const std::size_t &len) {
+        for (std::size_t i = 0; i < len; i += simd::block) {
+            const std::size_t count = std::min(simd::block, len - i);
+            const T *first_lat = lat1 + i * stride1, *first_lon = lon1 + i * stride1;
+            if (method == geodesic_method::haversine)
+                haversine_direct_block(first_lat, first_lon, stride1, bearing + i, distance + i, lat2 + i, lon2 + i,
+                                       count);
+            else
+                vincenty_direct_block(first_lat, first_lon, stride1, bearing + i, distance + i, lat2 + i, lon2 + i,
+                                      count);
+        }
+    }
+
+    //************************************************** SCALAR POINTS *************************************************
+
+    template<typename T>
+    T geodesic_distance(const geodetic<T> &a, const geodetic<T> &b,
+                        const geodesic_method &method = geodesic_method::vincenty) {
+        T result;
+        inverse_geodesic(method, &a[0], &a[1], 0, &b[0], &b[1], &result, static_cast<T *>(nullptr), 1);
+        return result;
+    }
+
+    template<typename T>
+    T initial_bearing(const geodetic<T> &a, const geodetic<T> &b,
+                      const geodesic_method &method = geodesic_method::vincenty) {
+        T result;
+        inverse_geodesic(method, &a[0], &a[1], 0, &b[0], &b[1], static_cast<T *>(nullptr), &result, 1);
+        return result;
+    }
+
+    template<typename T>
+    geodetic<T> destination(const geodetic<T> &origin, const T &bearing, const T &distance,
+                            const geodesic_method &method = geodesic_method::vincenty) {
+        T lat, lon;
+        direct_geodesic(method, &origin[0], &origin[1], 0, &bearing, &distance, &lat, &lon, 1);
+        return {lat, lon};
+    }
+
+    //***************************************************** BATCHES ****************************************************
+
+    // One to one between equal batches, or one to many from a single point, spread across the threads of the
+    // policy a chunk of pairs at a time. The overloads without a policy run in parallel.
+
+    template<typename T, typename Alloc>
+    void check_geodesic_sizes(const geodetic_batch<T, Alloc> &a, const std::size_t &len, const std::string &name) {
+        if (a.size() != len)
+            throw std::invalid_argument("\nERR: " + name + " requires batches of equal length\n");
+    }
+
+    template<execution::policy P, typename T, typename Alloc>
+    typename geodetic_batch<T, Alloc>::column_type
+    geodesic_distance(const P &policy, const geodetic_batch<T, Alloc> &a, const geodetic_batch<T, Alloc> &b,
+                      const geodesic_method &method = geodesic_method::vincenty) {
+        check_geodesic_sizes(a, b.size(), "geodesic distance");
+        typename geodetic_batch<T, Alloc>::column_type result(a.size(), T(0));
+        execution::for_each_chunk(policy, a.size(), geodesic_chunk, [&](std::size_t first, std::size_t count) {
+            inverse_geodesic(method, a.lat().data() + first, a.lon().data() + first, 1, b.lat().data() + first,
+                             b.lon().data() + first, result.data() + first, static_cast<T *>(nullptr), count);
+        });
+        return result;
+    }
+
+    template<execution::policy P, typename T, typename Alloc>
+    typename geodetic_batch<T, Alloc>::column_type
+    geodesic_distance(const P &policy, const geodetic<T> &origin, const geodetic_batch<T, Alloc> &b,
+                      const geodesic_method &method = geodesic_method::vincenty) {
+        typename geodetic_batch<T, Alloc>::column_type result(b.size(), T(0));
+        execution::for_each_chunk(policy, b.size(), geodesic_chunk, [&](std::size_t first, std::size_t count) {
+            inverse_geodesic(method, &origin[0], &origin[1], 0, b.lat().data() + first, b.lon().data() + first,
+                             result.data() + first, static_cast<T *>(nullptr), count);
+        });
+        return result;
+    }
+
+    template<execution::policy P, typename T, typename Alloc>
+    typename geodetic_batch<T, Alloc>::column_type
+    initial_bearing(const P &policy, const geodetic_batch<T, Alloc> &a, const geodetic_batch<T, Alloc> &b,
+                    const geodesic_method &method = geodesic_method::vincenty) {
+        check_geodesic_sizes(a, b.size(), "initial bearing");
+        typename geodetic_batch<T, Alloc>::column_type result(a.size(), T(0));
+        execution::for_each_chunk(policy, a.size(), geodesic_chunk, [&](std::size_t first, std::size_t count) {
+            inverse_geodesic(method, a.lat().data() + first, a.lon().data() + first, 1, b.lat().data() + first,
+                             b.lon().data() + first, static_cast<T *>(nullptr), result.data() + first, count);
+        });
+        return result;
+    }
+
+    template<execution::policy P, typename T, typename Alloc>
+    typename geodetic_batch<T, Alloc>::column_type
+    initial_bearing(const P &policy, const geodetic<T> &origin, const geodetic_batch<T, Alloc> &b,
+                    const geodesic_method &method = geodesic_method::vincenty) {
+        typename geodetic_batch<T, Alloc>::column_type result(b.size(), T(0));
+        execution::for_each_chunk(policy, b.size(), geodesic_chunk, [&](std::size_t first, std::size_t count) {
+            inverse_geodesic(method, &origin[0], &origin[1], 0, b.lat().data() + first, b.lon().data() + first,
+                             static_cast<T *>(nullptr), result.data() + first, count);
+        });
+        return result;
+    }
+
+    /**
+     * @brief Destinations from every point of a batch along its own bearing and distance. Altitudes are carried
+     * over from the origins.
+     */
+    template<execution::policy P, typename T, typename Alloc>
+    geodetic_batch<T, Alloc> destination(const P &policy, const geodetic_batch<T, Alloc> &origins,
+                                         const vector<T> &bearing, const vector<T> &distance,
+                                         const geodesic_method &method = geodesic_method::vincenty) {
+        check_geodesic_sizes(origins, bearing.size(), "destination");
+        check_geodesic_sizes(origins, distance.size(), "destination");
+        geodetic_batch<T, Alloc> result(origins.size());
+        result.alt() = origins.alt();
+        execution::for_each_chunk(policy, origins.size(), geodesic_chunk, [&](std::size_t first, std::size_t count) {
+            direct_geodesic(method, origins.lat().data() + first, origins.lon().data() + first, 1,
+                            bearing.data() + first, distance.data() + first, result.lat().data() + first,
+                            result.lon().data() + first, count);
+        });
+        return result;
+    }
+
+    /**
+     * @brief Destinations from a single point along each bearing and distance, for example a ring of equal range.
+     */
+    template<execution::policy P, typename T>
+    geodetic_batch<T> destination(const P &policy, const geodetic<T> &origin, const vector<T> &bearing,
+                                  const vector<T> &distance,
+                                  const geodesic_method &method = geodesic_method::vincenty) {
+        if (bearing.size() != distance.size())
+            throw std::invalid_argument("\nERR: destination requires as many distances as bearings\n");
+        geodetic_batch<T> result(bearing.size());
+        execution::for_each_chunk(policy, bearing.size(), geodesic_chunk, [&](std::size_t first, std::size_t count) {
+            direct_geodesic(method, &origin[0], &origin[1], 0, bearing.data() + first, distance.data() + first,
+                            result.lat().data() + first, result.lon().data() + first, count);
+        });
+        return result;
+    }
+
+    template<typename T, typename Alloc>
+    typename geodetic_batch<T, Alloc>::column_type
+    geodesic_distance(const geodetic_batch<T, Alloc> &a, const geodetic_batch<T, Alloc> &b,
+                      const geodesic_method &method = geodesic_method::vincenty) {
+        return geodesic_distance(execution::par, a, b, method);
+    }
+
+    template<typename T, typename Alloc>
+    typename geodetic_batch<T, Alloc>::column_type
+    geodesic_distance(const geodetic<T> &origin, const geodetic_batch<T, Alloc> &b,
+                      const geodesic_method &method = geodesic_method::vincenty) {
+        return geodesic_distance(execution::par, origin, b, method);
+    }
+
+    template<typename T, typename Alloc>
+    typename geodetic_batch<T, Alloc>::column_type
+    initial_bearing(const geodetic_batch<T, Alloc> &a, const geodetic_batch<T, Alloc> &b,
+                    const geodesic_method &method = geodesic_method::vincenty) {
+        return initial_bearing(execution::par, a, b, method);
+    }
+
+    template<typename T, typename Alloc>
+    typename geodetic_batch<T, Alloc>::column_type
+    initial_bearing(const geodetic<T> &origin, const geodetic_batch<T, Alloc> &b,
+                    const geodesic_method &method = geodesic_method::vincenty) {
+        return initial_bearing(execution::par, origin, b, method);
+    }
+
+    template<typename T, typename Alloc>
+    geodetic_batch<T, Alloc> destination(const geodetic_batch<T, Alloc> &origins, const vector<T> &bearing,
+                                         const vector<T> &distance,
+                                         const geodesic_method &method = geodesic_method::vincenty) {
+        return destination(execution::par, origins, bearing, distance, method);
+    }
+
+    template<typename T>
+    geodetic_batch<T> destination(const geodetic<T> &origin, const vector<T> &bearing, const vector<T> &distance,
+                                  const geodesic_method &method = geodesic_method::vincenty) {
+        return destination(execution::par, origin, bearing, distance, method);
+    }
+
+    //**************************************************** MATRICES ****************************************************
+
+    /**
+     * @brief All pairs distances: row i holds the distances from a[i] to every point of b. Rows are spread across
+     * the threads of the policy, several per task when b is short.
+     */
+    template<execution::policy P, typename T, typename Alloc>
+    matrix<T> distance_matrix(const P &policy, const geodetic_batch<T, Alloc> &a, const geodetic_batch<T, Alloc> &b,
+                              const geodesic_method &method = geodesic_method::vincenty) {
+        const std::size_t cols = b.size();
+        matrix<T> result(a.size(), cols);
+        const std::size_t rows = std::max<std::size_t>(1, geodesic_chunk / std::max<std::size_t>(cols, 1));
+        execution::for_each_chunk(policy, a.size(), rows, [&](std::size_t first, std::size_t count) {
+            for (std::size_t r = first; r < first + count; r++)
+                inverse_geodesic(method, a.lat().data() + r, a.lon().data() + r, 0, b.lat().data(), b.lon().data(),
+                                 result.data() + r * cols, static_cast<T *>(nullptr), cols);
+        });
+        return result;
+    }
+
+    template<typename T, typename Alloc>
+    matrix<T> distance_matrix(const geodetic_batch<T, Alloc> &a, const geodetic_batch<T, Alloc> &b,
+                              const geodesic_method &method = geodesic_method::vincenty) {
+        return distance_matrix(execution::par, a, b, method);
+    }
+}
+
+#endif //CCOMMS_COORDS_GEODESIC_HPP
@@ -0,0 +1,677 @@
+// Copyright(c) 2023, Matthew Petrin, All rights reserved.
+
+#ifndef CCOMMS_COORDS_ORBIT_HPP
+#define CCOMMS_COORDS_ORBIT_HPP
+
+#include "tle.hpp"
+#include "types.hpp"
+#include "batch.hpp"
+#include "transforms.hpp"
+#include "../tensor/simd.hpp"
+#include "../tensor/matrix.hpp"
+#include "../tensor/execution.hpp"
+
+#include <cmath>
+#include <limits>
+#include <string>
+#include <vector>
+#include <numbers>
+#include <utility>
+#include <algorithm>
+#include <stdexcept>
+#include <type_traits>
+
+namespace ccomms {
+
+    namespace wgs84 {
+        inline constexpr double gm = 3.986004418e14;
+        inline constexpr double rotation_rate = 7.292115146706979e-5;
+    }
+
+    /**
+     * @brief The WGS-72 constants SGP4 was fitted with, which two line element sets must be propagated with. Lengths
+     * in kilometers.
+     */
+    namespace wgs72 {
+        inline constexpr double mu = 398600.8;
+        inline constexpr double radius = 6378.135;
+        inline constexpr double j2 = 0.001082616;
+        inline constexpr double j3 = -0.00000253881;
+        inline constexpr double j4 = -0.00000165597;
+        inline const double xke = 60.0 / std::sqrt(radius * radius * radius / mu);
+    }
+
+    /**
+     * @brief Propagation model of a constellation: SGP4 from two line element sets, or unperturbed two body motion.
+     */
+    enum class orbit_model {
+        sgp4,
+        kepler
+    };
+
+    /**
+     * @brief Frame of propagated states: the true equator, mean equinox inertial frame of SGP4, or earth fixed
+     * (ECEF) through Greenwich mean sidereal time, neglecting polar motion.
+     */
+    enum class orbit_frame {
+        teme,
+        ecef
+    };
+
+    /**
+     * @brief Osculating classical elements for two body propagation. Semi-major axis in meters, angles in degrees.
+     */
+    struct keplerian_elements {
+        double semi_major_axis = wgs84::a;
+        double eccentricity = 0.0;
+        double inclination = 0.0;
+        double raan = 0.0;
+        double arg_perigee = 0.0;
+        double mean_anomaly = 0.0;
+        julian_date epoch;
+    };
+
+    /**
+     * @brief Two body elements matching the mean motion of a two line element set.
+     */
+    inline keplerian_elements to_keplerian(const two_line_element &tle) {
+        const double n = tle.mean_motion * 2.0 * std::numbers::pi / 86400.0;
+        return {std::cbrt(wgs84::gm / (n * n)), tle.eccentricity, tle.inclination, tle.raan, tle.arg_perigee,
+                tle.mean_anomaly, tle.epoch};
+    }
+
+    /**
+     * @brief Satellites per task when propagation is spread across threads.
+     */
+    inline constexpr std::size_t orbit_chunk = 2 * simd::block;
+
+    /**
+     * @class constellation
+     *
+     * @brief A set of satellites prepared for propagation, their per satellite model terms stored as one contiguous
+     * row of the terms matrix per term, so that propagation runs across satellites on SIMD.
+     *
+     * @ingroup coords
+     *
+     * @details SGP4 covers the near earth model, orbital periods under 225 minutes, including its drag and secular
+     * gravity terms; element sets of deep space orbits are rejected, and can be propagated with orbit_model::kepler
+     * instead. Times are kept as minutes from the epoch of the first satellite.
+     */
+    class constellation {
+    public:
+        enum sgp4_term : std::size_t {
+            epoch_minutes, mo, mdot, argpo, argpdot, nodeo, nodedot, nodecf, cc1, cc4, cc5, t2cof, bstar, omgcof,
+            xmcof, eta, delmo, sinmao, d2, d3, d4, t3cof, t4cof, t5cof, no, ao, ecco, inclo, sinio, cosio, aycof,
+            xlcof, con41, x1mth2, x7thm1, sgp4_terms
+        };
+
+        enum kepler_term : std::size_t {
+            kepler_epoch_minutes, semi_major_axis, mean_motion, eccentricity, root, mean_anomaly, px, py, pz, qx, qy,
+            qz, kepler_terms
+        };
+
+        //************************************************* CONSTRUCTORS ***********************************************
+
+        constellation() = default;
+
+        explicit constellation(const std::vector<two_line_element> &tles, const orbit_model &model = orbit_model::sgp4)
+                : kind(model), count(tles.size()) {
+            if (model == orbit_model::kepler) {
+                std::vector<keplerian_elements> elements;
+                elements.reserve(tles.size());
+                for (const auto &tle: tles)
+                    elements.push_back(to_keplerian(tle));
+                *this = constellation(elements);
+                return;
+            }
+            if (!tles.empty())
+                reference = tles[0].epoch;
+            terms = matrix<double>(sgp4_terms, count);
+            for (std::size_t i = 0; i < count; i++)
+                init_sgp4(tles[i], i);
+        }
+
+        explicit constellation(const std::vector<keplerian_elements> &elements)
+                : kind(orbit_model::kepler), count(elements.size()) {
+            if (!elements.empty())
+                reference = elements[0].epoch;
+            terms = matrix<double>(kepler_terms, count);
+            for (std::size_t i = 0; i < count; i++)
+                init_kepler(elements[i], i);
+        }
+
+        //*************************************************** ACCESS ***************************************************
+
+        [[nodiscard]] std::size_t size() const { return count; }
+
+        [[nodiscard]] bool empty() const { return count == 0; }
+
+        [[nodiscard]] orbit_model model() const { return kind; }
+
+        /**
+         * @brief Instant that propagation times are measured from, the epoch of the first satellite.
+         */
+        [[nodiscard]] const julian_date &epoch() const { return reference; }
+
+        /**
+         * @brief The given term of every satellite, contiguous.
+         */
+        [[nodiscard]] const double *term(const std::size_t &t) const { return terms.data() + t * count; }
+
+    private:
+        orbit_model kind = orbit_model::sgp4;
+        std::size_t count = 0;
+        julian_date reference;
+        matrix<double> terms;
+
+        void set(const std::size_t &t, const std::size_t &i, const double &value) {
+            terms.data()[t * count + i] = value;
+        }
+
+        /**
+         * @brief Near earth SGP4 initialization after Vallado et al., "Revisiting Spacetrack Report #3", 2006.
+         */
+        void init_sgp4(const two_line_element &tle, const std::size_t &i) {
+            using namespace wgs72;
+            constexpr double x2o3 = 2.0 / 3.0;
+            const double no_kozai = tle.mean_motion * 2.0 * std::numbers::pi / 1440.0;
+            const double e = tle.eccentricity, incl = tle.inclination * deg_to_rad;
+            const double argp = tle.arg_perigee * deg_to_rad, m0 = tle.mean_anomaly * deg_to_rad;
+            if (!(no_kozai > 0.0) || e < 0.0 || e >= 1.0)
+                throw std::invalid_argument("\nERR: element set of catalog number " +
+                                            std::to_string(tle.catalog_number) + " is not a closed orbit\n");
+
+            // Recover the original mean motion and semi-major axis from the Kozai mean motion of the element set
+            const double eccsq = e * e, omeosq = 1.0 - eccsq, rteosq = std::sqrt(omeosq);
+            const double cosi = std::cos(incl), cosio2 = cosi * cosi, sini = std::sin(incl);
+            const double ak = std::pow(xke / no_kozai, x2o3);
+            const double d1 = 0.75 * j2 * (3.0 * cosio2 - 1.0) / (rteosq * omeosq);
+            double del = d1 / (ak * ak);
+            const double adel = ak * (1.0 - del * del - del * (1.0 / 3.0 + 134.0 * del * del / 81.0));
+            del = d1 / (adel * adel);
+            const double n0 = no_kozai / (1.0 + del);
+            const double a0 = std::pow(xke / n0, x2o3);
+            if (2.0 * std::numbers::pi / n0 >= 225.0)
+                throw std::invalid_argument("\nERR: element set of catalog number " +
+                                            std::to_string(tle.catalog_number) +
+                                            " is a deep space orbit, which near earth SGP4 does not cover\n");
+
+            const double po = a0 * omeosq, con42 = 1.0 - 5.0 * cosio2, con41_ = -con42 - cosio2 - cosio2;
+            const double posq = po * po, rp = a0 * (1.0 - e);
+
+            // Atmospheric density parameters from the perigee height
+            const double ss = 78.0 / radius + 1.0;
+            double sfour = ss, qzms24 = std::pow((120.0 - 78.0) / radius, 4);
+            const double perigee = (rp - 1.0) * radius;
+            if (perigee < 156.0) {
+                sfour = perigee < 98.0 ? 20.0 : perigee - 78.0;
+                qzms24 = std::pow((120.0 - sfour) / radius, 4);
+                sfour = sfour / radius + 1.0;
+            }
+            const bool simple = rp < 220.0 / radius + 1.0;
+
+            const double pinvsq = 1.0 / posq, tsi = 1.0 / (a0 - sfour);
+            const double eta_ = a0 * e * tsi, etasq = eta_ * eta_, eeta = e * eta_;
+            const double psisq = std::abs(1.0 - etasq), coef = qzms24 * std::pow(tsi, 4);
+            const double coef1 = coef / std::pow(psisq, 3.5);
+            const double cc2 = coef1 * n0 * (a0 * (1.0 + 1.5 * etasq + eeta * (4.0 + etasq)) + 0.375 * j2 * tsi /
+                                                                                               psisq * con41_ *
+                                                                                               (8.0 + 3.0 * etasq *
+                                                                                                      (8.0 + etasq)));
+            const double cc1_ = tle.bstar * cc2;
+            const double cc3 = e > 1.0e-4 ? -2.0 * coef * tsi * (j3 / j2) * n0 * sini / e : 0.0;
+            const double x1mth2_ = 1.0 - cosio2;
+            const double cc4_ = 2.0 * n0 * coef1 * a0 * omeosq *
+                                (eta_ * (2.0 + 0.5 * etasq) + e * (0.5 + 2.0 * etasq) -
+                                 j2 * tsi / (a0 * psisq) *
+                                 (-3.0 * con41_ * (1.0 - 2.0 * eeta + etasq * (1.5 - 0.5 * eeta)) +
+                                  0.75 * x1mth2_ * (2.0 * etasq - eeta * (1.0 + etasq)) * std::cos(2.0 * argp)));
+            const double cc5_ = 2.0 * coef1 * a0 * omeosq * (1.0 + 2.75 * (etasq + eeta) + eeta * etasq);
+
+            // Secular rates of the mean anomaly, argument of perigee and node
+            const double cosio4 = cosio2 * cosio2;
+            const double temp1 = 1.5 * j2 * pinvsq * n0, temp2 = 0.5 * temp1 * j2 * pinvsq;
+            const double temp3 = -0.46875 * j4 * pinvsq * pinvsq * n0;
+            const double mdot_ = n0 + 0.5 * temp1 * rteosq * con41_ +
+                                 0.0625 * temp2 * rteosq * (13.0 - 78.0 * cosio2 + 137.0 * cosio4);
+            const double argpdot_ = -0.5 * temp1 * con42 + 0.0625 * temp2 * (7.0 - 114.0 * cosio2 + 395.0 * cosio4) +
+                                    temp3 * (3.0 - 36.0 * cosio2 + 49.0 * cosio4);
+            const double xhdot1 = -temp1 * cosi;
+            const double nodedot_ =
+                    xhdot1 + (0.5 * temp2 * (4.0 - 19.0 * cosio2) + 2.0 * temp3 * (3.0 - 7.0 * cosio2)) * cosi;
+
+            const double delmotemp = 1.0 + eta_ * std::cos(m0);
+            const double xlcof_ = -0.25 * (j3 / j2) * sini * (3.0 + 5.0 * cosi) /
+                                  (std::abs(cosi + 1.0) > 1.5e-12 ? 1.0 + cosi : 1.5e-12);
+
+            set(epoch_minutes, i, tle.epoch.minutes_since(reference));
+            set(mo, i, m0);
+            set(mdot, i, mdot_);
+            set(argpo, i, argp);
+            set(argpdot, i, argpdot_);
+            set(nodeo, i, tle.raan * deg_to_rad);
+            set(nodedot, i, nodedot_);
+            set(nodecf, i, 3.5 * omeosq * xhdot1 * cc1_);
+            set(cc1, i, cc1_);
+            set(cc4, i, cc4_);
+            set(cc5, i, simple ? 0.0 : cc5_);
+            set(t2cof, i, 1.5 * cc1_);
+            set(bstar, i, tle.bstar);
+            set(omgcof, i, simple ? 0.0 : tle.bstar * cc3 * std::cos(argp));
+            set(xmcof, i, simple || e <= 1.0e-4 ? 0.0 : -x2o3 * coef * tle.bstar / eeta);
+            set(eta, i, eta_);
+            set(delmo, i, delmotemp * delmotemp * delmotemp);
+            set(sinmao, i, std::sin(m0));
+            set(no, i, n0);
+            set(ao, i, a0);
+            set(ecco, i, e);
+            set(inclo, i, incl);
+            set(sinio, i, sini);
+            set(cosio, i, cosi);
+            set(aycof, i, -0.5 * (j3 / j2) * sini);
+            set(xlcof, i, xlcof_);
+            set(con41, i, con41_);
+            set(x1mth2, i, x1mth2_);
+            set(x7thm1, i, 7.0 * cosio2 - 1.0);
+
+            // Higher order drag terms, left at zero for perigees below 220 km so the kernel needs no branch
+            if (!simple) {
+                const double cc1sq = cc1_ * cc1_;
+                const double d2_ = 4.0 * a0 * tsi * cc1sq;
+                const double temp = d2_ * tsi * cc1_ / 3.0;
+                const double d3_ = (17.0 * a0 + sfour) * temp;
+                const double d4_ = 0.5 * temp * a0 * tsi * (221.0 * a0 + 31.0 * sfour) * cc1_;
+                set(d2, i, d2_);
+                set(d3, i, d3_);
+                set(d4, i, d4_);
+                set(t3cof, i, d2_ + 2.0 * cc1sq);
+                set(t4cof, i, 0.25 * (3.0 * d3_ + cc1_ * (12.0 * d2_ + 10.0 * cc1sq)));
+                set(t5cof, i, 0.2 * (3.0 * d4_ + 12.0 * cc1_ * d3_ + 6.0 * d2_ * d2_ +
+                                     15.0 * cc1sq * (2.0 * d2_ + cc1sq)));
+            }
+        }
+
+        void init_kepler(const keplerian_elements &elements, const std::size_t &i) {
+            const double a = elements.semi_major_axis / 1000.0, e = elements.eccentricity;
+            if (!(a > 0.0) || e < 0.0 || e >= 1.0)
+                throw std::invalid_argument("\nERR: keplerian elements must describe a closed orbit\n");
+            const double incl = elements.inclination * deg_to_rad, node = elements.raan * deg_to_rad;
+            const double argp = elements.arg_perigee * deg_to_rad;
+            const double ci = std::cos(incl), si = std::sin(incl), cn = std::cos(node), sn = std::sin(node);
+            const double cw = std::cos(argp), sw = std::sin(argp);
+
+            set(kepler_epoch_minutes, i, elements.epoch.minutes_since(reference));
+            set(semi_major_axis, i, a);
+            set(mean_motion, i, std::sqrt(wgs84::gm * 1e-9 / (a * a * a)) * 60.0);
+            set(eccentricity, i, e);
+            set(root, i, std::sqrt(1.0 - e * e));
+            set(mean_anomaly, i, elements.mean_anomaly * deg_to_rad);
+
+            // Perifocal axes toward perigee and 90 degrees ahead of it in the orbit plane
+            set(px, i, cn * cw - sn * sw * ci);
+            set(py, i, sn * cw + cn * sw * ci);
+            set(pz, i, sw * si);
+            set(qx, i, -cn * sw - sn * cw * ci);
+            set(qy, i, -sn * sw + cn * cw * ci);
+            set(qz, i, cw * si);
+        }
+    };
+
+    //*************************************************** BLOCK KERNELS ************************************************
+
+    // Each block kernel propagates up to simd::block satellites to one instant, given in minutes from the epoch of the
+    // constellation, into position in kilometers and velocity in kilometers per second. Every transcendental runs as
+    // one pass of a SIMD kernel over the block. Satellites whose orbit has decayed or become invalid come back as NaN.
+
+    inline double wrap_two_pi(const double &angle) {
+        constexpr double two_pi = 2.0 * std::numbers::pi;
+        return angle - two_pi * static_cast<double>(static_cast<long long>(angle / two_pi));
+    }
+
+    inline void sgp4_block(const constellation &sats, const std::size_t &first, const std::size_t &count,
+                           const double &minutes, double *const (&out)[6]) {
+        using enum constellation::sgp4_term;
+        using namespace wgs72;
+        constexpr std::size_t B = simd::block;
+        const auto c = [&](const constellation::sgp4_term &t) { return sats.term(t) + first; };
+        double t[B], mm[B], argpm[B], nodem[B], tempa[B], tempe[B], templ[B], s[B], co[B];
+        double am[B], nm[B], axnl[B], aynl[B], u[B], eo1[B], sin_e[B], cos_e[B], step[B];
+        bool bad[B];
+
+        // Secular gravity and drag
+        const double *epoch = c(epoch_minutes), *m0 = c(mo), *mdt = c(mdot), *w0 = c(argpo), *wdt = c(argpdot);
+        const double *node0 = c(nodeo), *nodedt = c(nodedot), *ncf = c(nodecf), *c1 = c(cc1), *c4 = c(cc4);
+        const double *drag = c(bstar), *t2c = c(t2cof);
+        for (std::size_t k = 0; k < count; k++) {
+            t[k] = minutes - epoch[k];
+            mm[k] = m0[k] + mdt[k] * t[k];
+            argpm[k] = w0[k] + wdt[k] * t[k];
+            nodem[k] = node0[k] + nodedt[k] * t[k] + ncf[k] * t[k] * t[k];
+            tempa[k] = 1.0 - c1[k] * t[k];
+            tempe[k] = drag[k] * c4[k] * t[k];
+            templ[k] = t2c[k] * t[k] * t[k];
+        }
+
+        simd::sincos(s, co, mm, count);
+        const double *omg = c(omgcof), *xmc = c(xmcof), *et = c(eta), *dm = c(delmo);
+        const double *dd2 = c(d2), *dd3 = c(d3), *dd4 = c(d4), *t3c = c(t3cof), *t4c = c(t4cof), *t5c = c(t5cof);
+        for (std::size_t k = 0; k < count; k++) {
+            const double delm_base = 1.0 + et[k] * co[k];
+            const double delta = omg[k] * t[k] + xmc[k] * (delm_base * delm_base * delm_base - dm[k]);
+            const double t2 = t[k] * t[k], t3 = t2 * t[k], t4 = t3 * t[k];
+            mm[k] += delta;
+            argpm[k] -= delta;
+            tempa[k] -= dd2[k] * t2 + dd3[k] * t3 + dd4[k] * t4;
+            templ[k] += t3c[k] * t3 + t4 * (t4c[k] + t[k] * t5c[k]);
+        }
+
+        simd::sincos(s, co, mm, count);
+        const double *c5 = c(cc5), *sm0 = c(sinmao), *n0 = c(no), *a0 = c(ao), *e0 = c(ecco);
+        for (std::size_t k = 0; k < count; k++) {
+            tempe[k] += drag[k] * c5[k] * (s[k] - sm0[k]);
+            am[k] = a0[k] * tempa[k] * tempa[k];
+            nm[k] = n0[k] / (tempa[k] * tempa[k] * tempa[k]);
+            double em = e0[k] - tempe[k];
+            bad[k] = !(tempa[k] > 0.0) || em >= 1.0 || em < -0.001;
+            em = std::max(em, 1.0e-6);
+            mm[k] += n0[k] * templ[k];
+            const double xlm = wrap_two_pi(mm[k] + argpm[k] + nodem[k]);
+            nodem[k] = wrap_two_pi(nodem[k]);
+            argpm[k] = wrap_two_pi(argpm[k]);
+            mm[k] = wrap_two_pi(xlm - argpm[k] - nodem[k]);
+            axnl[k] = em;
+        }
+
+        // Long period periodics
+        simd::sincos(s, co, argpm, count);
+        const double *ay = c(aycof), *xl = c(xlcof);
+        for (std::size_t k = 0; k < count; k++) {
+            const double em = axnl[k];
+            const double temp = 1.0 / (am[k] * (1.0 - em * em));
+            axnl[k] = em * co[k];
+            aynl[k] = em * s[k] + temp * ay[k];
+            u[k] = wrap_two_pi(mm[k] + argpm[k] + temp * xl[k] * axnl[k]);
+            eo1[k] = u[k];
+        }
+
+        // Kepler's equation in the equinoctial form, the whole block iterating until every satellite converges
+        for (int iteration = 0; iteration < 10; iteration++) {
+            simd::sincos(sin_e, cos_e, eo1, count);
+            bool converged = true;
+            for (std::size_t k = 0; k < count; k++) {
+                double d = (u[k] - aynl[k] * cos_e[k] + axnl[k] * sin_e[k] - eo1[k]) /
+                           (1.0 - cos_e[k] * axnl[k] - sin_e[k] * aynl[k]);
+                d = std::clamp(d, -0.95, 0.95);
+                step[k] = d;
+                converged = converged && !(std::abs(d) >= 1.0e-12);
+            }
+            for (std::size_t k = 0; k < count; k++)
+                if (std::abs(step[k]) >= 1.0e-12)
+                    eo1[k] += step[k];
+            if (converged)
+                break;
+        }
+
+        // Short period periodics
+        double el2[B], pl[B], rl[B], betal[B], root_am[B], root_pl[B], sinu[B], cosu[B], su[B];
+        for (std::size_t k = 0; k < count; k++) {
+            const double ecose = axnl[k] * cos_e[k] + aynl[k] * sin_e[k];
+            el2[k] = axnl[k] * axnl[k] + aynl[k] * aynl[k];
+            pl[k] = am[k] * (1.0 - el2[k]);
+            bad[k] = bad[k] || !(pl[k] >= 0.0);
+            rl[k] = am[k] * (1.0 - ecose);
+            betal[k] = 1.0 - el2[k];
+        }
+        simd::sqrt(root_am, am, count);
+        simd::sqrt(root_pl, pl, count);
+        simd::sqrt(betal, betal, count);
+        for (std::size_t k = 0; k < count; k++) {
+            const double esine = axnl[k] * sin_e[k] - aynl[k] * cos_e[k];
+            const double temp = esine / (1.0 + betal[k]);
+            sinu[k] = am[k] / rl[k] * (sin_e[k] - aynl[k] - axnl[k] * temp);
+            cosu[k] = am[k] / rl[k] * (cos_e[k] - axnl[k] + aynl[k] * temp);
+            // Radial rates, kept in the Kepler buffers which are no longer needed
+            u[k] = root_am[k] * esine / rl[k];
+            step[k] = root_pl[k] / rl[k];
+        }
+        simd::atan2(su, sinu, cosu, count);
+
+        double xnode[B], xinc[B], mrt[B], mvt[B], rvdot[B];
+        const double *ci = c(cosio), *si = c(sinio), *i0 = c(inclo), *c41 = c(con41), *x1m = c(x1mth2);
+        const double *x7 = c(x7thm1);
+        for (std::size_t k = 0; k < count; k++) {
+            const double sin2u = (cosu[k] + cosu[k]) * sinu[k], cos2u = 1.0 - 2.0 * sinu[k] * sinu[k];
+            const double temp = 1.0 / pl[k], temp1 = 0.5 * j2 * temp, temp2 = temp1 * temp;
+            mrt[k] = rl[k] * (1.0 - 1.5 * temp2 * betal[k] * c41[k]) + 0.5 * temp1 * x1m[k] * cos2u;
+            su[k] -= 0.25 * temp2 * x7[k] * sin2u;
+            xnode[k] = nodem[k] + 1.5 * temp2 * ci[k] * sin2u;
+            xinc[k] = i0[k] + 1.5 * temp2 * ci[k] * si[k] * cos2u;
+            mvt[k] = u[k] - nm[k] * temp1 * x1m[k] * sin2u / xke;
+            rvdot[k] = step[k] + nm[k] * temp1 * (x1m[k] * cos2u + 1.5 * c41[k]) / xke;
+            bad[k] = bad[k] || mrt[k] < 1.0;
+        }
+
+        // Orientation vectors
+        double sin_su[B], cos_su[B], sin_node[B], cos_node[B], sin_inc[B], cos_inc[B];
+        simd::sincos(sin_su, cos_su, su, count);
+        simd::sincos(sin_node, cos_node, xnode, count);
+        simd::sincos(sin_inc, cos_inc, xinc, count);
+        const double speed = radius * xke / 60.0;
+        constexpr double nan = std::numeric_limits<double>::quiet_NaN();
+        for (std::size_t k = 0; k < count; k++) {
+            const double xmx = -sin_node[k] * cos_inc[k], xmy = cos_node[k] * cos_inc[k];
+            const double ux = xmx * sin_su[k] + cos_node[k] * cos_su[k];
+            const double uy = xmy * sin_su[k] + sin_node[k] * cos_su[k];
+            const double uz = sin_inc[k] * sin_su[k];
+            const double vx = xmx * cos_su[k] - cos_node[k] * sin_su[k];
+            const double vy = xmy * cos_su[k] - sin_node[k] * sin_su[k];
+            const double vz = sin_inc[k] * cos_su[k];
+            const double r = bad[k] ? nan : mrt[k] * radius;
+            const double v = bad[k] ? nan : speed;
+            out[0][k] = r * ux;
+            out[1][k] = r * uy;
+            out[2][k] = r * uz;
+            out[3][k] = v * (mvt[k] * ux + rvdot[k] * vx);
+            out[4][k] = v * (mvt[k] * uy + rvdot[k] * vy);
+            out[5][k] = v * (mvt[k] * uz + rvdot[k] * vz);
+        }
+    }
+
+    inline void kepler_block(const constellation &sats, const std::size_t &first, const std::size_t &count,
+                             const double &minutes, double *const (&out)[6]) {
+        using enum constellation::kepler_term;
+        constexpr std::size_t B = simd::block;
+        const auto c = [&](const constellation::kepler_term &t) { return sats.term(t) + first; };
+        double m[B], e_anomaly[B], s[B], co[B], step[B];
+
+        const double *epoch = c(kepler_epoch_minutes), *m0 = c(mean_anomaly), *n = c(mean_motion);
+        const double *e = c(eccentricity);
+        for (std::size_t k = 0; k < count; k++) {
+            m[k] = wrap_two_pi(m0[k] + n[k] * (minutes - epoch[k]));
+            e_anomaly[k] = m[k] + (e[k] > 0.8 ? std::copysign(1.0, m[k]) * e[k] : 0.0);
+        }
+
+        // Newton's method on Kepler's equation, the whole block iterating until every satellite converges
+        for (int iteration = 0; iteration < 30; iteration++) {
+            simd::sincos(s, co, e_anomaly, count);
+            bool converged = true;
+            for (std::size_t k = 0; k < count; k++) {
+                step[k] = (e_anomaly[k] - e[k] * s[k] - m[k]) / (1.0 - e[k] * co[k]);
+                converged = converged && std::abs(step[k]) < 1.0e-13;
+            }
+            for (std::size_t k = 0; k < count; k++)
+                e_anomaly[k] -= step[k];
+            if (converged)
+                break;
+        }
+        simd::sincos(s, co, e_anomaly, count);
+
+        const double *a = c(semi_major_axis), *r = c(root), *p[3] = {c(px), c(py), c(pz)};
+        const double *q[3] = {c(qx), c(qy), c(qz)};
+        for (std::size_t k = 0; k < count; k++) {
+            const double xp = a[k] * (co[k] - e[k]), yp = a[k] * r[k] * s[k];
+            const double rate = a[k] * n[k] / (60.0 * (1.0 - e[k] * co[k]));
+            const double vxp = -rate * s[k], vyp = rate * r[k] * co[k];
+            for (std::size_t j = 0; j < 3; j++) {
+                out[j][k] = xp * p[j][k] + yp * q[j][k];
+                out[3 + j][k] = vxp * p[j][k] + vyp * q[j][k];
+            }
+        }
+    }
+
+    //*************************************************** ARRAY KERNELS ************************************************
+
+    /**
+     * @brief Position in meters and velocity in meters per second of satellites [first, first + count) at the given
+     * minutes from the constellation epoch, into the six output columns. gmst rotates into the earth fixed frame when
+     * frame is ecef.
+     */
+    template<typename T>
+    void propagate_satellites(const constellation &sats, const std::size_t &first, const std::size_t &count,
+                              const double &minutes, const orbit_frame &frame, const double &gmst, T *const (&out)[6]) {
+        double x[simd::block], y[simd::block], z[simd::block], vx[simd::block], vy[simd::block], vz[simd::block];
+        double *const state[6] = {x, y, z, vx, vy, vz};
+        const double cg = std::cos(gmst), sg = std::sin(gmst);
+        for (std::size_t i = first; i < first + count; i += simd::block) {
+            const std::size_t n = std::min(simd::block, first + count - i);
+            if (sats.model() == orbit_model::sgp4)
+                sgp4_block(sats, i, n, minutes, state);
+            else
+                kepler_block(sats, i, n, minutes, state);
+
+            const std::size_t offset = i - first;
+            for (std::size_t k = 0; k < n; k++) {
+                double px = x[k], py = y[k], pvx = vx[k], pvy = vy[k];
+                if (frame == orbit_frame::ecef) {
+                    px = cg * x[k] + sg * y[k];
+                    py = -sg * x[k] + cg * y[k];
+                    pvx = cg * vx[k] + sg * vy[k] + wgs84::rotation_rate * py;
+                    pvy = -sg * vx[k] + cg * vy[k] - wgs84::rotation_rate * px;
+                }
+                out[0][offset + k] = static_cast<T>(px * 1000.0);
+                out[1][offset + k] = static_cast<T>(py * 1000.0);
+                out[2][offset + k] = static_cast<T>(z[k] * 1000.0);
+                out[3][offset + k] = static_cast<T>(pvx * 1000.0);
+                out[4][offset + k] = static_cast<T>(pvy * 1000.0);
+                out[5][offset + k] = static_cast<T>(vz[k] * 1000.0);
+            }
+        }
+    }
+
+    //**************************************************** EPHEMERIS ***************************************************
+
+    /**
+     * @brief States of every satellite of a constellation over a uniform time grid, step major: the state of a
+     * satellite at a step is point index(step, satellite) of the position and velocity batches.
+     */
+    template<typename T>
+    struct ephemeris {
+        julian_date start;
+        double step = 0.0;
+        std::size_t steps = 0, satellites = 0;
+        cartesian_batch<T> position, velocity;
+
+        [[nodiscard]] std::size_t index(const std::size_t &s, const std::size_t &satellite) const {
+            return s * satellites + satellite;
+        }
+
+        [[nodiscard]] julian_date time(const std::size_t &s) const { return start + static_cast<double>(s) * step; }
+    };
+
+    /**
+     * @brief Propagates steps instants from start, step seconds apart, into the position and velocity columns,
+     * the state of a satellite at a step landing at s * sats.size() + satellite. Work is split into tasks of one step
+     * and up to orbit_chunk satellites, so that small constellations still spread across threads.
+     */
+    template<execution::policy P, typename T>
+    void propagate_grid(const P &policy, const constellation &sats, const julian_date &start, const double &step,
+                        const std::size_t &steps, const orbit_frame &frame, T *const (&position)[3],
+                        T *const (&velocity)[3]) {
+        const std::size_t n = sats.size(), chunks = (n + orbit_chunk - 1) / orbit_chunk;
+        execution::for_each_chunk(policy, steps * chunks, 1, [&](std::size_t task, std::size_t) {
+            const std::size_t s = task / chunks, first = (task % chunks) * orbit_chunk;
+            const julian_date time = start + static_cast<double>(s) * step;
+            const std::size_t offset = s * n + first;
+            T *const out[6] = {position[0] + offset, position[1] + offset, position[2] + offset, velocity[0] + offset,
+                               velocity[1] + offset, velocity[2] + offset};
+            propagate_satellites(sats, first, std::min(orbit_chunk, n - first), time.minutes_since(sats.epoch()), frame,
+                                 frame == orbit_frame::ecef ? time.gmst() : 0.0, out);
+        });
+    }
+
+    /**
+     * @brief Position in meters and velocity in meters per second of every satellite at one instant, resizing the
+     * batches to the constellation.
+     */
+    template<execution::policy P, typename T, typename Alloc>
+    void propagate(const P &policy, const constellation &sats, const julian_date &time,
+                   cartesian_batch<T, Alloc> &position, cartesian_batch<T, Alloc> &velocity,
+                   const orbit_frame &frame = orbit_frame::teme) {
+        position.resize(sats.size());
+        velocity.resize(sats.size());
+        propagate_grid(policy, sats, time, 0.0, 1, frame, {position.x().data(), position.y().data(),
+                                                           position.z().data()},
+                       {velocity.x().data(), velocity.y().data(), velocity.z().data()});
+    }
+
+    /**
+     * @brief The ephemeris of every satellite over steps instants from start, step seconds apart.
+     *
+     * @details The whole grid is held in memory; long grids over large constellations should use the streaming
+     * overload instead.
+     */
+    template<typename T = double, execution::policy P>
+    ephemeris<T> propagate(const P &policy, const constellation &sats, const julian_date &start, const double &step,
+                           const std::size_t &steps, const orbit_frame &frame = orbit_frame::teme) {
+        ephemeris<T> result{start, step, steps, sats.size(), cartesian_batch<T>(steps * sats.size()),
+                            cartesian_batch<T>(steps * sats.size())};
+        propagate_grid(policy, sats, start, step, steps, frame,
+                       {result.position.x().data(), result.position.y().data(), result.position.z().data()},
+                       {result.velocity.x().data(), result.velocity.y().data(), result.velocity.z().data()});
+        return result;
+    }
+
+    /**
+     * @brief Streams the states of every satellite over steps instants from start, step seconds apart, calling
+     * consumer(s, time, position, velocity) for each step in order with batches of one point per satellite.
+     *
+     * @details Steps are propagated a window at a time, enough to keep every thread busy, so memory stays bounded
+     * by the window however long the grid.
+     */
+    template<typename T = double, execution::policy P, typename F>
+    void propagate(const P &policy, const constellation &sats, const julian_date &start, const double &step,
+                   const std::size_t &steps, const orbit_frame &frame, F &&consumer) {
+        const std::size_t n = sats.size();
+        const std::size_t window = std::clamp<std::size_t>(n ? 16 * orbit_chunk / n : steps, 1, 64);
+        cartesian_batch<T> position(window * n), velocity(window * n), current_position(n), current_velocity(n);
+        for (std::size_t s = 0; s < steps; s += window) {
+            const std::size_t count = std::min(window, steps - s);
+            const julian_date first = start + static_cast<double>(s) * step;
+            propagate_grid(policy, sats, first, step, count, frame,
+                           {position.x().data(), position.y().data(), position.z().data()},
+                           {velocity.x().data(), velocity.y().data(), velocity.z().data()});
+            for (std::size_t w = 0; w < count; w++) {
+                for (std::size_t k = 0; k < 3; k++) {
+                    std::copy_n(position.column(k).data() + w * n, n, current_position.column(k).data());
+                    std::copy_n(velocity.column(k).data() + w * n, n, current_velocity.column(k).data());
+                }
+                consumer(s + w, start + static_cast<double>(s + w) * step, std::as_const(current_position),
+                         std::as_const(current_velocity));
+            }
+        }
+    }
+
+    template<typename T, typename Alloc>
+    void propagate(const constellation &sats, const julian_date &time, cartesian_batch<T, Alloc> &position,
+                   cartesian_batch<T, Alloc> &velocity, const orbit_frame &frame = orbit_frame::teme) {
+        propagate(execution::par, sats, time, position, velocity, frame);
+    }
+
+    template<typename T = double>
+    ephemeris<T> propagate(const constellation &sats, const julian_date &start, const double &step,
+                           const std::size_t &steps, const orbit_frame &frame = orbit_frame::teme) {
+        return propagate<T>(execution::par, sats, start, step, steps, frame);
+    }
+}
+
+#endif //CCOMMS_COORDS_ORBIT_HPP
@@ -0,0 +1,778 @@
+// Copyright(c) 2023, Matthew Petrin, All rights reserved.
+
+#ifndef CCOMMS_COORDS_SPATIAL_HPP
+#define CCOMMS_COORDS_SPATIAL_HPP
+
+#include "types.hpp"
+#include "batch.hpp"
+#include "geodesic.hpp"
+#include "transforms.hpp"
+#include "../tensor/simd.hpp"
+
+#include <array>
+#include <cmath>
+#include <limits>
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <numbers>
+#include <numeric>
+#include <algorithm>
+#include <stdexcept>
+#include <type_traits>
+
+namespace ccomms {
+
+    /**
+     * @brief Identifier of a point in a spatial index: its position in the batch the index was built from, then
+     * consecutive values for later inserts. Ids are never reused.
+     */
+    using point_id = std::size_t;
+
+    /**
+     * @brief A point found by a spatial query and its distance in meters from the query point.
+     */
+    template<typename T>
+    struct neighbor {
+        point_id id;
+        T distance;
+    };
+
+    /**
+     * @class spatial_store
+     *
+     * @brief Point storage shared by the spatial indexes.
+     *
+     * @tparam Batch: Coordinate batch holding the points
+     *
+     * @ingroup coords
+     *
+     * @details The leading indexed() points are laid out in the order of the index, so every query scans contiguous
+     * runs of the batch columns. Inserts are appended after them and scanned directly until the next rebuild, and
+     * removals leave a tombstone in place. Once the appended and removed points together pass a quarter of the live
+     * points, the owning index rebuilds itself and the store is compacted back into index order.
+     */
+    template<typename Batch>
+    class spatial_store {
+    public:
+        using value_type = typename Batch::value_type;
+
+        //*************************************************** ACCESS ***************************************************
+
+        [[nodiscard]] std::size_t size() const { return ids.size() - removed; }
+
+        [[nodiscard]] bool empty() const { return size() == 0; }
+
+        [[nodiscard]] bool contains(const point_id &id) const { return id < slots.size() && slots[id] != npos; }
+
+        /**
+         * @brief Number of stored points, live or removed, covered by the index rather than scanned directly.
+         */
+        [[nodiscard]] std::size_t indexed() const { return indexed_count; }
+
+        /**
+         * @brief The stored points, in index order then insertion order, including tombstones.
+         */
+        const Batch &points() const { return stored; }
+
+    protected:
+        static constexpr std::size_t npos = std::numeric_limits<std::size_t>::max();
+
+        Batch stored;
+        std::vector<point_id> ids;          // Id of each stored point, npos once removed
+        std::vector<std::size_t> slots;     // Stored position of each id, npos once removed
+        std::size_t indexed_count = 0;
+        std::size_t removed = 0;
+
+        spatial_store() = default;
+
+        explicit spatial_store(Batch points) : stored(std::move(points)), ids(stored.size()) {
+            std::iota(ids.begin(), ids.end(), point_id(0));
+            slots = ids;
+        }
+
+        std::size_t slot_of(const point_id &id, const std::string &name) const {
+            if (!contains(id))
+                throw std::invalid_argument("\nERR: spatial index " + name + " of an unknown point id\n");
+            return slots[id];
+        }
+
+        /**
+         * @brief Records the point just appended to the batch under id, a new one unless it is an existing point
+         * that moved.
+         */
+        void attach(const point_id &id) {
+            if (id == slots.size())
+                slots.push_back(ids.size());
+            else
+                slots[id] = ids.size();
+            ids.push_back(id);
+        }
+
+        void detach(const point_id &id) {
+            ids[slots[id]] = npos;
+            slots[id] = npos;
+            removed++;
+        }
+
+        [[nodiscard]] bool stale() const {
+            return (ids.size() - indexed_count) + removed > std::max<std::size_t>(64, size() / 4);
+        }
+
+        /**
+         * @brief Stored positions of the live points.
+         */
+        [[nodiscard]] std::vector<std::size_t> live() const {
+            std::vector<std::size_t> result;
+            result.reserve(size());
+            for (std::size_t i = 0; i < ids.size(); i++)
+                if (ids[i] != npos)
+                    result.push_back(i);
+            return result;
+        }
+
+        /**
+         * @brief Rewrites the store as the given stored positions in order, all of them indexed.
+         */
+        void reorder(const std::vector<std::size_t> &order) {
+            Batch next(order.size());
+            std::vector<point_id> next_ids(order.size());
+            for (std::size_t k = 0; k < Batch::components; k++) {
+                const value_type *src = stored.column(k).data();
+                value_type *dst = next.column(k).data();
+                for (std::size_t i = 0; i < order.size(); i++)
+                    dst[i] = src[order[i]];
+            }
+            for (std::size_t i = 0; i < order.size(); i++) {
+                next_ids[i] = ids[order[i]];
+                slots[next_ids[i]] = i;
+            }
+            stored = std::move(next);
+            ids = std::move(next_ids);
+            indexed_count = ids.size();
+            removed = 0;
+        }
+    };
+
+    //****************************************************** K-D TREE **************************************************
+
+    /**
+     * @class kd_tree
+     *
+     * @brief k-d tree over ECEF points for nearest neighbour, radius and bounding box queries by straight line
+     * distance.
+     *
+     * @tparam T: Coordinate type, float or double
+     *
+     * @ingroup coords
+     *
+     * @details Bulk construction splits the points at the median of the widest axis of each node's bounding box
+     * down to leaves of at most leaf_size points, then lays the points out in leaf order, so a leaf is a contiguous
+     * run of the x, y and z columns. Each node keeps its tight bounding box for pruning. Geodetic points are
+     * converted to ECEF with their altitude, which suits ground terminals and satellites alike; distances are chords
+     * in meters, not distances along the surface. Queries are const and may run concurrently with each other, but
+     * not with insert, remove, update or rebuild.
+     */
+    template<typename T>
+    requires std::is_same_v<T, float> || std::is_same_v<T, double>
+    class kd_tree : public spatial_store<cartesian_batch<T> > {
+
+        using base = spatial_store<cartesian_batch<T> >;
+        using base::npos;
+        using base::stored;
+        using base::ids;
+
+        struct node {
+            std::array<T, 3> lo, hi;
+            std::size_t first, count;
+            std::size_t right;          // The left child follows its parent; 0 for a leaf
+        };
+
+        struct entry {
+            std::array<T, 3> p;
+            std::size_t position;
+        };
+
+        std::vector<node> nodes;
+
+    public:
+        static constexpr std::size_t leaf_size = 16;
+
+        //************************************************* CONSTRUCTORS ***********************************************
+
+        kd_tree() = default;
+
+        template<typename Alloc>
+        explicit kd_tree(const cartesian_batch<T, Alloc> &points) : base(copy(points)) { rebuild(); }
+
+        template<typename Alloc>
+        explicit kd_tree(const geodetic_batch<T, Alloc> &points) : kd_tree(geodetic_to_ecef(points)) {}
+
+        //************************************************** UPDATES ***************************************************
+
+        point_id insert(const cartesian<T> &p) {
+            const point_id id = this->slots.size();
+            append(id, p);
+            return id;
+        }
+
+        point_id insert(const geodetic<T> &p, const T &alt = T(0)) { return insert(geodetic_to_ecef(p, alt)); }
+
+        /**
+         * @brief Removes a point, returning false if the id is not in the index.
+         */
+        bool remove(const point_id &id) {
+            if (!this->contains(id))
+                return false;
+            this->detach(id);
+            if (this->stale())
+                rebuild();
+            return true;
+        }
+
+        /**
+         * @brief Moves a point, keeping its id. A point still awaiting the next rebuild is overwritten in place,
+         * an indexed one leaves a tombstone and is appended again.
+         */
+        void update(const point_id &id, const cartesian<T> &p) {
+            const std::size_t slot = this->slot_of(id, "update");
+            if (slot >= this->indexed_count) {
+                stored.set(slot, p[0], p[1], p[2]);
+                return;
+            }
+            this->detach(id);
+            append(id, p);
+        }
+
+        void update(const point_id &id, const geodetic<T> &p, const T &alt = T(0)) {
+            update(id, geodetic_to_ecef(p, alt));
+        }
+
+        cartesian<T> point(const point_id &id) const { return stored[this->slot_of(id, "lookup")]; }
+
+        /**
+         * @brief Rebuilds the tree over the live points, which happens automatically as points are inserted and
+         * removed.
+         */
+        void rebuild() {
+            const std::vector<std::size_t> live = this->live();
+            std::vector<entry> entries(live.size());
+            for (std::size_t i = 0; i < live.size(); i++)
+                entries[i] = {{stored.x()[live[i]], stored.y()[live[i]], stored.z()[live[i]]}, live[i]};
+            nodes.clear();
+            nodes.reserve(2 * (entries.size() / leaf_size + 1));
+            if (!entries.empty())
+                build(entries.data(), 0, entries.size());
+
+            std::vector<std::size_t> order(entries.size());
+            for (std::size_t i = 0; i < entries.size(); i++)
+                order[i] = entries[i].position;
+            this->reorder(order);
+        }
+
+        //************************************************** QUERIES ***************************************************
+
+        /**
+         * @brief The k points closest to p, nearest first. Fewer are returned if the index holds fewer points.
+         */
+        std::vector<neighbor<T> > nearest(const cartesian<T> &p, const std::size_t &k) const {
+            const std::array<T, 3> q{p[0], p[1], p[2]};
+            std::vector<neighbor<T> > heap;
+            if (k == 0)
+                return heap;
+            heap.reserve(k + leaf_size);
+
+            const auto offer = [&](const std::size_t &first, const std::size_t &count) {
+                scan(q, first, count, [&](const std::size_t &i, const T &d2) {
+                    if (heap.size() < k || d2 < heap.front().distance) {
+                        heap.push_back({ids[i], d2});
+                        std::push_heap(heap.begin(), heap.end(), farther);
+                        if (heap.size() > k) {
+                            std::pop_heap(heap.begin(), heap.end(), farther);
+                            heap.pop_back();
+                        }
+                    }
+                });
+            };
+
+            offer(this->indexed_count, ids.size() - this->indexed_count);
+
+            // Best first descent, nearer child first, pruning boxes beyond the current k-th distance
+            std::vector<std::pair<std::size_t, T> > stack;
+            if (!nodes.empty())
+                stack.emplace_back(0, box_distance(nodes[0], q));
+            while (!stack.empty()) {
+                const auto [index, d2] = stack.back();
+                stack.pop_back();
+                if (heap.size() == k && d2 >= heap.front().distance)
+                    continue;
+                const node &n = nodes[index];
+                if (n.right == 0) {
+                    offer(n.first, n.count);
+                    continue;
+                }
+                const T left = box_distance(nodes[index + 1], q), right = box_distance(nodes[n.right], q);
+                if (left <= right) {
+                    stack.emplace_back(n.right, right);
+                    stack.emplace_back(index + 1, left);
+                } else {
+                    stack.emplace_back(index + 1, left);
+                    stack.emplace_back(n.right, right);
+                }
+            }
+
+            std::sort_heap(heap.begin(), heap.end(), farther);
+            for (auto &match: heap)
+                match.distance = std::sqrt(match.distance);
+            return heap;
+        }
+
+        std::vector<neighbor<T> > nearest(const geodetic<T> &p, const std::size_t &k, const T &alt = T(0)) const {
+            return nearest(geodetic_to_ecef(p, alt), k);
+        }
+
+        /**
+         * @brief Every point within radius meters of p, nearest first.
+         */
+        std::vector<neighbor<T> > within(const cartesian<T> &p, const T &radius) const {
+            const std::array<T, 3> q{p[0], p[1], p[2]};
+            const T r2 = radius * radius;
+            std::vector<neighbor<T> > result;
+            const auto collect = [&](const std::size_t &first, const std::size_t &count) {
+                scan(q, first, count, [&](const std::size_t &i, const T &d2) {
+                    if (d2 <= r2)
+                        result.push_back({ids[i], std::sqrt(d2)});
+                });
+            };
+
+            collect(this->indexed_count, ids.size() - this->indexed_count);
+            std::vector<std::size_t> stack;
+            if (!nodes.empty())
+                stack.push_back(0);
+            while (!stack.empty()) {
+                const std::size_t index = stack.back();
+                stack.pop_back();
+                const node &n = nodes[index];
+                if (box_distance(n, q) > r2)
+                    continue;
+                if (n.right == 0) {
+                    collect(n.first, n.count);
+                } else {
+                    stack.push_back(n.right);
+                    stack.push_back(index + 1);
+                }
+            }
+
+            std::sort(result.begin(), result.end(), [](const neighbor<T> &a, const neighbor<T> &b) {
+                return a.distance < b.distance;
+            });
+            return result;
+        }
+
+        std::vector<neighbor<T> > within(const geodetic<T> &p, const T &radius, const T &alt = T(0)) const {
+            return within(geodetic_to_ecef(p, alt), radius);
+        }
+
+        /**
+         * @brief Ids of every point inside the axis aligned box from lo to hi, inclusive, in no particular order.
+         */
+        std::vector<point_id> in_box(const cartesian<T> &lo, const cartesian<T> &hi) const {
+            const std::array<T, 3> a{lo[0], lo[1], lo[2]}, b{hi[0], hi[1], hi[2]};
+            std::vector<point_id> result;
+            const auto collect = [&](const std::size_t &first, const std::size_t &count, const bool &inside) {
+                const T *x = stored.x().data(), *y = stored.y().data(), *z = stored.z().data();
+                for (std::size_t i = first; i < first + count; i++)
+                    if (ids[i] != npos && (inside || (x[i] >= a[0] && x[i] <= b[0] && y[i] >= a[1] && y[i] <= b[1] &&
+                                                      z[i] >= a[2] && z[i] <= b[2])))
+                        result.push_back(ids[i]);
+            };
+
+            collect(this->indexed_count, ids.size() - this->indexed_count, false);
+            std::vector<std::size_t> stack;
+            if (!nodes.empty())
+                stack.push_back(0);
+            while (!stack.empty()) {
+                const std::size_t index = stack.back();
+                stack.pop_back();
+                const node &n = nodes[index];
+                bool overlaps = true, inside = true;
+                for (std::size_t k = 0; k < 3; k++) {
+                    overlaps = overlaps && n.lo[k] <= b[k] && n.hi[k] >= a[k];
+                    inside = inside && n.lo[k] >= a[k] && n.hi[k] <= b[k];
+                }
+                if (!overlaps)
+                    continue;
+                if (inside || n.right == 0) {
+                    collect(n.first, n.count, inside);
+                } else {
+                    stack.push_back(n.right);
+                    stack.push_back(index + 1);
+                }
+            }
+            return result;
+        }
+
+    private:
+        template<typename Alloc>
+        static cartesian_batch<T> copy(const cartesian_batch<T, Alloc> &points) {
+            cartesian_batch<T> result(points.size());
+            for (std::size_t k = 0; k < 3; k++)
+                std::copy(points.column(k).begin(), points.column(k).end(), result.column(k).begin());
+            return result;
+        }
+
+        static bool farther(const neighbor<T> &a, const neighbor<T> &b) { return a.distance < b.distance; }
+
+        void append(const point_id &id, const cartesian<T> &p) {
+            stored.push_back(p);
+            this->attach(id);
+            if (this->stale())
+                rebuild();
+        }
+
+        /**
+         * @brief Builds the subtree over entries[first, first + count) and returns its node index. The entries carry
+         * their coordinates so that partitioning works on contiguous memory rather than gathering from the columns.
+         */
+        std::size_t build(entry *entries, const std::size_t &first, const std::size_t &count) {
+            const std::size_t index = nodes.size();
+            node n{};
+            n.first = first;
+            n.count = count;
+            n.lo.fill(std::numeric_limits<T>::infinity());
+            n.hi.fill(-std::numeric_limits<T>::infinity());
+            for (std::size_t i = first; i < first + count; i++)
+                for (std::size_t k = 0; k < 3; k++) {
+                    n.lo[k] = std::min(n.lo[k], entries[i].p[k]);
+                    n.hi[k] = std::max(n.hi[k], entries[i].p[k]);
+                }
+            nodes.push_back(n);
+            if (count <= leaf_size)
+                return index;
+
+            std::size_t axis = 0;
+            for (std::size_t k = 1; k < 3; k++)
+                if (n.hi[k] - n.lo[k] > n.hi[axis] - n.lo[axis])
+                    axis = k;
+            const std::size_t half = count / 2;
+            std::nth_element(entries + first, entries + first + half, entries + first + count,
+                             [axis](const entry &a, const entry &b) { return a.p[axis] < b.p[axis]; });
+
+            build(entries, first, half);
+            const std::size_t right = build(entries, first + half, count - half);
+            nodes[index].right = right;
+            return index;
+        }
+
+        static T box_distance(const node &n, const std::array<T, 3> &q) {
+            T d2 = 0;
+            for (std::size_t k = 0; k < 3; k++) {
+                const T d = std::max({n.lo[k] - q[k], T(0), q[k] - n.hi[k]});
+                d2 += d * d;
+            }
+            return d2;
+        }
+
+        /**
+         * @brief Calls f(position, squared distance) for each live stored point in [first, first + count), the
+         * distances computed a leaf at a time over the contiguous columns.
+         */
+        template<typename F>
+        void scan(const std::array<T, 3> &q, const std::size_t &first, const std::size_t &count, F &&f) const {
+            const T *x = stored.x().data(), *y = stored.y().data(), *z = stored.z().data();
+            T d2[leaf_size];
+            for (std::size_t i = first; i < first + count; i += leaf_size) {
+                const std::size_t n = std::min(leaf_size, first + count - i);
+                for (std::size_t j = 0; j < n; j++) {
+                    const T dx = x[i + j] - q[0], dy = y[i + j] - q[1], dz = z[i + j] - q[2];
+                    d2[j] = dx * dx + dy * dy + dz * dz;
+                }
+                for (std::size_t j = 0; j < n; j++)
+                    if (ids[i + j] != npos)
+                        f(i + j, d2[j]);
+            }
+        }
+    };
+
+    //*************************************************** GEODETIC GRID ************************************************
+
+    /**
+     * @class geodetic_grid
+     *
+     * @brief Grid of equal angle latitude and longitude cells for nearest neighbour, radius and bounding box queries
+     * by great circle distance.
+     *
+     * @tparam T: Coordinate type, float or double
+     *
+     * @ingroup coords
+     *
+     * @details Points are sorted by cell in row major order, south to north and west to east, so that each row of a
+     * query window is a single contiguous run of the latitude and longitude columns, found by binary search on the
+     * cell keys and measured by the haversine SIMD kernel. Radius queries cover the bounding window of the spherical
+     * cap, widening to whole rows when the cap reaches a pole and splitting at the antimeridian. Distances are the
+     * haversine on the mean earth sphere, matching geodesic_method::haversine. Queries are const and may run
+     * concurrently with each other, but not with insert, remove, update or rebuild.
+     */
+    template<typename T>
+    requires std::is_same_v<T, float> || std::is_same_v<T, double>
+    class geodetic_grid : public spatial_store<geodetic_batch<T> > {
+
+        using base = spatial_store<geodetic_batch<T> >;
+        using base::npos;
+        using base::stored;
+        using base::ids;
+
+        double cell = 1.0;
+        std::size_t rows = 180, cols = 360;
+        std::vector<std::uint64_t> keys;    // Cell key of each indexed point, ascending
+
+    public:
+        //************************************************* CONSTRUCTORS ***********************************************
+
+        /**
+         * @brief An empty grid of cells spanning cell_degrees of latitude and longitude.
+         */
+        explicit geodetic_grid(const double &cell_degrees = 1.0) { set_cell(cell_degrees); }
+
+        template<typename Alloc>
+        explicit geodetic_grid(const geodetic_batch<T, Alloc> &points, const double &cell_degrees = 1.0)
+                : base(copy(points)) {
+            set_cell(cell_degrees);
+            rebuild();
+        }
+
+        [[nodiscard]] double cell_size() const { return cell; }
+
+        //************************************************** UPDATES ***************************************************
+
+        point_id insert(const geodetic<T> &p, const T &alt = T(0)) {
+            const point_id id = this->slots.size();
+            append(id, p, alt);
+            return id;
+        }
+
+        /**
+         * @brief Removes a point, returning false if the id is not in the index.
+         */
+        bool remove(const point_id &id) {
+            if (!this->contains(id))
+                return false;
+            this->detach(id);
+            if (this->stale())
+                rebuild();
+            return true;
+        }
+
+        /**
+         * @brief Moves a point, keeping its id.
+         */
+        void update(const point_id &id, const geodetic<T> &p, const T &alt = T(0)) {
+            const std::size_t slot = this->slot_of(id, "update");
+            if (slot >= this->indexed_count) {
+                stored.set(slot, p[0], p[1], alt);
+                return;
+            }
+            this->detach(id);
+            append(id, p, alt);
+        }
+
+        geodetic<T> point(const point_id &id) const { return stored[this->slot_of(id, "lookup")]; }
+
+        /**
+         * @brief Re-sorts the live points into cell order, which happens automatically as points are inserted and
+         * removed.
+         */
+        void rebuild() {
+            std::vector<std::size_t> order = this->live();
+            std::vector<std::uint64_t> cell_keys(ids.size());
+            for (const auto &i: order)
+                cell_keys[i] = key(stored.lat()[i], stored.lon()[i]);
+            std::stable_sort(order.begin(), order.end(), [&](const std::size_t &a, const std::size_t &b) {
+                return cell_keys[a] < cell_keys[b];
+            });
+            keys.resize(order.size());
+            for (std::size_t i = 0; i < order.size(); i++)
+                keys[i] = cell_keys[order[i]];
+            this->reorder(order);
+        }
+
+        //************************************************** QUERIES ***************************************************
+
+        /**
+         * @brief Every point within radius meters of center along the great circle, nearest first.
+         */
+        std::vector<neighbor<T> > within(const geodetic<T> &center, const T &radius) const {
+            std::vector<neighbor<T> > result;
+            const T r = radius;
+            const auto collect = [&](const std::size_t &first, const std::size_t &count) {
+                measure(center, first, count, [&](const std::size_t &i, const T &d) {
+                    if (d <= r)
+                        result.push_back({ids[i], d});
+                });
+            };
+
+            collect(this->indexed_count, ids.size() - this->indexed_count);
+
+            // Window of the cap, padded by the rounding of the distances so that it holds every point they admit
+            const double delta = static_cast<double>(radius) / mean_earth_radius *
+                                 (1 + 16 * std::numeric_limits<T>::epsilon()) + 1e-12;
+            const double lat = center[0], lon = center[1];
+            if (delta >= std::numbers::pi) {
+                collect(0, this->indexed_count);
+            } else {
+                const double lat_lo = lat - delta * rad_to_deg, lat_hi = lat + delta * rad_to_deg;
+                double half_width = 180.0;
+                if (lat_lo > -90.0 && lat_hi < 90.0) {
+                    const double s = std::sin(delta) / std::cos(lat * deg_to_rad);
+                    if (s < 1.0)
+                        half_width = std::asin(s) * rad_to_deg;
+                }
+                scan_window(lat_lo, lat_hi, lon - half_width, lon + half_width, collect);
+            }
+
+            std::sort(result.begin(), result.end(), [](const neighbor<T> &a, const neighbor<T> &b) {
+                return a.distance < b.distance;
+            });
+            return result;
+        }
+
+        /**
+         * @brief The k points closest to center along the great circle, nearest first. Fewer are returned if the
+         * index holds fewer points.
+         *
+         * @details Radius queries from one cell width, doubling until they hold k points: every point outside the
+         * last radius is farther than all those inside it.
+         */
+        std::vector<neighbor<T> > nearest(const geodetic<T> &center, const std::size_t &k) const {
+            if (k == 0 || this->empty())
+                return {};
+            double radius = cell * deg_to_rad * mean_earth_radius;
+            while (true) {
+                const bool everything = radius >= std::numbers::pi * mean_earth_radius;
+                std::vector<neighbor<T> > found = within(
+                        center, everything ? std::numeric_limits<T>::infinity() : static_cast<T>(radius));
+                if (found.size() >= k || everything) {
+                    found.resize(std::min(k, found.size()));
+                    return found;
+                }
+                radius *= 2;
+            }
+        }
+
+        /**
+         * @brief Ids of every point in the latitude and longitude box between the south west and north east corners,
+         * inclusive, in no particular order. A west longitude greater than the east one spans the antimeridian.
+         */
+        std::vector<point_id> in_box(const geodetic<T> &south_west, const geodetic<T> &north_east) const {
+            const double south = south_west[0], west = south_west[1], north = north_east[0], east = north_east[1];
+            std::vector<point_id> result;
+            if (south > north)
+                return result;
+            const auto inside = [&](const T &plat, const T &plon) {
+                const bool lon_inside = west <= east ? plon >= west && plon <= east : plon >= west || plon <= east;
+                return plat >= south && plat <= north && lon_inside;
+            };
+            const auto collect = [&](const std::size_t &first, const std::size_t &count) {
+                const T *plat = stored.lat().data(), *plon = stored.lon().data();
+                for (std::size_t i = first; i < first + count; i++)
+                    if (ids[i] != npos && inside(plat[i], plon[i]))
+                        result.push_back(ids[i]);
+            };
+
+            collect(this->indexed_count, ids.size() - this->indexed_count);
+            scan_window(south, north, west, west <= east ? east : east + 360.0, collect);
+            return result;
+        }
+
+    private:
+        template<typename Alloc>
+        static geodetic_batch<T> copy(const geodetic_batch<T, Alloc> &points) {
+            geodetic_batch<T> result(points.size());
+            for (std::size_t k = 0; k < 3; k++)
+                std::copy(points.column(k).begin(), points.column(k).end(), result.column(k).begin());
+            return result;
+        }
+
+        void set_cell(const double &cell_degrees) {
+            if (!(cell_degrees > 0.0 && cell_degrees <= 180.0))
+                throw std::invalid_argument("\nERR: geodetic grid cell size must be in (0, 180] degrees\n");
+            cell = cell_degrees;
+            rows = static_cast<std::size_t>(std::ceil(180.0 / cell));
+            cols = static_cast<std::size_t>(std::ceil(360.0 / cell));
+        }
+
+        [[nodiscard]] std::size_t row(const double &lat) const {
+            return std::min(rows - 1, static_cast<std::size_t>(std::max(0.0, (lat + 90.0) / cell)));
+        }
+
+        [[nodiscard]] std::size_t col(const double &lon) const {
+            return std::min(cols - 1, static_cast<std::size_t>(std::max(0.0, (lon + 180.0) / cell)));
+        }
+
+        [[nodiscard]] std::uint64_t key(const double &lat, const double &lon) const {
+            return static_cast<std::uint64_t>(row(lat) * cols + col(lon));
+        }
+
+        void append(const point_id &id, const geodetic<T> &p, const T &alt) {
+            stored.push_back(p, alt);
+            this->attach(id);
+            if (this->stale())
+                rebuild();
+        }
+
+        /**
+         * @brief Calls collect(first, count) for each run of indexed points in the cells overlapping latitudes
+         * [south, north] and longitudes [west, east], where the longitudes may run past 180 or below -180 and are
+         * wrapped around the antimeridian.
+         */
+        template<typename F>
+        void scan_window(const double &south, const double &north, const double &west, const double &east,
+                         F &&collect) const {
+            if (this->indexed_count == 0)
+                return;
+            std::array<std::pair<std::size_t, std::size_t>, 2> spans;
+            std::size_t span_count = 1;
+            if (east - west >= 360.0)
+                spans[0] = {0, cols - 1};
+            else if (west < -180.0) {
+                spans[0] = {col(west + 360.0), cols - 1};
+                spans[1] = {0, col(east)};
+                span_count = 2;
+            } else if (east > 180.0) {
+                spans[0] = {col(west), cols - 1};
+                spans[1] = {0, col(east - 360.0)};
+                span_count = 2;
+            } else
+                spans[0] = {col(west), col(east)};
+
+            for (std::size_t r = row(south); r <= row(north); r++)
+                for (std::size_t s = 0; s < span_count; s++) {
+                    const std::uint64_t lo = r * cols + spans[s].first, hi = r * cols + spans[s].second;
+                    const auto begin = std::lower_bound(keys.begin(), keys.end(), lo);
+                    const auto end = std::upper_bound(begin, keys.end(), hi);
+                    if (begin != end)
+                        collect(static_cast<std::size_t>(begin - keys.begin()), static_cast<std::size_t>(end - begin));
+                }
+        }
+
+        /**
+         * @brief Calls f(position, distance) for each live stored point in [first, first + count), the distances
+         * from center computed a SIMD block at a time.
+         */
+        template<typename F>
+        void measure(const geodetic<T> &center, const std::size_t &first, const std::size_t &count, F &&f) const {
+            const T lat = center[0], lon = center[1];
+            T d[simd::block];
+            for (std::size_t i = first; i < first + count; i += simd::block) {
+                const std::size_t n = std::min(simd::block, first + count - i);
+                inverse_geodesic(geodesic_method::haversine, &lat, &lon, 0, stored.lat().data() + i,
+                                 stored.lon().data() + i, d, static_cast<T *>(nullptr), n);
+                for (std::size_t j = 0; j < n; j++)
+                    if (ids[i + j] != npos)
+                        f(i + j, d[j]);
+            }
+        }
+    };
+}
+
+#endif //CCOMMS_COORDS_SPATIAL_HPP
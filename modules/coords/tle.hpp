@@ -0,0 +1,210 @@
+// Copyright(c) 2023, Matthew Petrin, All rights reserved.
+
+#ifndef CCOMMS_COORDS_TLE_HPP
+#define CCOMMS_COORDS_TLE_HPP
+
+#include <cmath>
+#include <numbers>
+#include <string>
+#include <vector>
+#include <istream>
+#include <stdexcept>
+
+namespace ccomms {
+
+    /**
+     * @brief A UT1 instant as a Julian date split in two parts, so that differences of nearby instants keep
+     * microsecond resolution.
+     */
+    struct julian_date {
+        double day = 2451545.0;
+        double fraction = 0.0;
+
+        /**
+         * @brief Julian date of a Gregorian calendar date and time of day, valid from 1901 to 2099.
+         */
+        static julian_date from_calendar(const int &year, const int &month, const int &day, const int &hour = 0,
+                                         const int &minute = 0, const double &second = 0.0) {
+            const double whole = 367.0 * year - std::floor(7.0 * (year + std::floor((month + 9) / 12.0)) * 0.25) +
+                                 std::floor(275.0 * month / 9.0) + day + 1721013.5;
+            return julian_date{whole, 0.0} + (hour * 3600.0 + minute * 60.0 + second);
+        }
+
+        /**
+         * @brief The instant a number of seconds later, with whole days carried into the day part.
+         */
+        julian_date operator+(const double &seconds) const {
+            const double f = fraction + seconds / 86400.0;
+            const double whole = std::floor(f);
+            return {day + whole, f - whole};
+        }
+
+        [[nodiscard]] double days_since(const julian_date &other) const {
+            return (day - other.day) + (fraction - other.fraction);
+        }
+
+        [[nodiscard]] double minutes_since(const julian_date &other) const { return days_since(other) * 1440.0; }
+
+        /**
+         * @brief Greenwich mean sidereal time in radians in [0, 2 pi), the IAU 1982 model used with SGP4.
+         */
+        [[nodiscard]] double gmst() const {
+            const double t = ((day - 2451545.0) + fraction) / 36525.0;
+            double seconds = -6.2e-6 * t * t * t + 0.093104 * t * t + (876600.0 * 3600.0 + 8640184.812866) * t +
+                             67310.54841;
+            constexpr double two_pi = 2.0 * std::numbers::pi;
+            seconds = std::fmod(seconds * (two_pi / 86400.0), two_pi);
+            return seconds < 0.0 ? seconds + two_pi : seconds;
+        }
+    };
+
+    /**
+     * @brief Mean orbital elements of one satellite from a NORAD two line element set, in the units of the format:
+     * angles in degrees and mean motion in revolutions per day.
+     */
+    struct two_line_element {
+        std::string name;
+        int catalog_number = 0;
+        std::string designator;
+        julian_date epoch;
+        double mean_motion_dot = 0.0;       // First derivative of mean motion / 2, revolutions per day^2
+        double mean_motion_ddot = 0.0;      // Second derivative of mean motion / 6, revolutions per day^3
+        double bstar = 0.0;                 // Drag term, inverse earth radii
+        double inclination = 0.0;
+        double raan = 0.0;
+        double eccentricity = 0.0;
+        double arg_perigee = 0.0;
+        double mean_anomaly = 0.0;
+        double mean_motion = 0.0;
+        int revolution = 0;
+    };
+
+    //***************************************************** PARSING ****************************************************
+
+    /**
+     * @brief Field of a TLE line between columns first and last, 1 based and inclusive as in the format definition.
+     */
+    inline std::string tle_field(const std::string &line, const std::size_t &first, const std::size_t &last) {
+        const std::string field = line.substr(first - 1, last - first + 1);
+        const auto begin = field.find_first_not_of(' ');
+        if (begin == std::string::npos)
+            return {};
+        return field.substr(begin, field.find_last_not_of(' ') - begin + 1);
+    }
+
+    inline double tle_number(const std::string &line, const std::size_t &first, const std::size_t &last) {
+        const std::string field = tle_field(line, first, last);
+        if (field.empty())
+            return 0.0;
+        std::size_t used = 0;
+        double value = 0.0;
+        try {
+            value = std::stod(field, &used);
+        } catch (const std::exception &) {
+            used = 0;
+        }
+        if (used != field.size())
+            throw std::invalid_argument("\nERR: TLE field '" + field + "' is not a number\n");
+        return value;
+    }
+
+    /**
+     * @brief Field in the format's exponential notation with an assumed leading decimal point, such as -11606-4 for
+     * -0.11606e-4.
+     */
+    inline double tle_exponential(const std::string &line, const std::size_t &first, const std::size_t &last) {
+        std::string field = tle_field(line, first, last);
+        if (field.empty())
+            return 0.0;
+        const double sign = field[0] == '-' ? -1.0 : 1.0;
+        if (field[0] == '-' || field[0] == '+')
+            field.erase(0, 1);
+        const auto exponent = field.find_last_of("+-");
+        if (exponent == std::string::npos || exponent == 0)
+            throw std::invalid_argument("\nERR: TLE field '" + field + "' is not in exponential notation\n");
+        return sign * tle_number("0." + field.substr(0, exponent), 1, exponent + 2) *
+               std::pow(10.0, tle_number(field.substr(exponent), 1, field.size() - exponent));
+    }
+
+    /**
+     * @brief Parses a two line element set. Both lines must have 69 columns with correct modulo 10 checksums and
+     * agree on the catalog number.
+     */
+    inline two_line_element parse_tle(const std::string &line1, const std::string &line2,
+                                      const std::string &name = "") {
+        const auto check = [](const std::string &line, const char &number) {
+            std::string error;
+            if (line.size() < 69 || line[0] != number || line[1] != ' ')
+                error = "is not a TLE line ";
+            else {
+                int sum = 0;
+                for (std::size_t i = 0; i < 68; i++)
+                    sum += line[i] == '-' ? 1 : line[i] >= '0' && line[i] <= '9' ? line[i] - '0' : 0;
+                if (line[68] - '0' != sum % 10)
+                    error = "fails its checksum as TLE line ";
+            }
+            if (!error.empty())
+                throw std::invalid_argument("\nERR: '" + line + "' " + error + number + "\n");
+        };
+        check(line1, '1');
+        check(line2, '2');
+
+        two_line_element result;
+        result.name = name;
+        result.catalog_number = static_cast<int>(tle_number(line1, 3, 7));
+        if (static_cast<int>(tle_number(line2, 3, 7)) != result.catalog_number)
+            throw std::invalid_argument("\nERR: TLE lines belong to different catalog numbers\n");
+        result.designator = tle_field(line1, 10, 17);
+
+        // Two digit years from 57 are 1957 to 1999; the day of the year counts from 1.0 at midnight on January 1
+        const int year = static_cast<int>(tle_number(line1, 19, 20));
+        result.epoch = julian_date::from_calendar(year < 57 ? 2000 + year : 1900 + year, 1, 1);
+        const double day = tle_number(line1, 21, 32) - 1.0;
+        result.epoch.day += std::floor(day);
+        result.epoch.fraction = day - std::floor(day);
+
+        result.mean_motion_dot = tle_number(line1, 34, 43);
+        result.mean_motion_ddot = tle_exponential(line1, 45, 52);
+        result.bstar = tle_exponential(line1, 54, 61);
+
+        result.inclination = tle_number(line2, 9, 16);
+        result.raan = tle_number(line2, 18, 25);
+        result.eccentricity = tle_number("0." + tle_field(line2, 27, 33), 1, 9);
+        result.arg_perigee = tle_number(line2, 35, 42);
+        result.mean_anomaly = tle_number(line2, 44, 51);
+        result.mean_motion = tle_number(line2, 53, 63);
+        result.revolution = static_cast<int>(tle_number(line2, 64, 68));
+        return result;
+    }
+
+    /**
+     * @brief Parses every element set in a stream of two or three line entries, taking the line before a pair as
+     * its name. Blank lines are skipped and a leading "0 " on a name line is dropped.
+     */
+    inline std::vector<two_line_element> parse_tles(std::istream &in) {
+        std::vector<two_line_element> result;
+        std::string line, name, first;
+        while (std::getline(in, line)) {
+            while (!line.empty() && (line.back() == '\r' || line.back() == ' '))
+                line.pop_back();
+            if (line.empty())
+                continue;
+            if (line.size() >= 69 && line[0] == '1' && line[1] == ' ' && first.empty())
+                first = line;
+            else if (line.size() >= 69 && line[0] == '2' && line[1] == ' ' && !first.empty()) {
+                result.push_back(parse_tle(first, line, name));
+                first.clear();
+                name.clear();
+            } else {
+                if (!first.empty())
+                    throw std::invalid_argument("\nERR: TLE line 1 '" + first + "' is not followed by line 2\n");
+                name = line.rfind("0 ", 0) == 0 ? line.substr(2) : line;
+            }
+        }
+        if (!first.empty())
+            throw std::invalid_argument("\nERR: TLE line 1 '" + first + "' is not followed by line 2\n");
+        return result;
+    }
+}
+
+#endif //CCOMMS_COORDS_TLE_HPP
@@ -0,0 +1,411 @@
+// Copyright(c) 2023, Matthew Petrin, All rights reserved.
+
+#ifndef CCOMMS_COORDS_TRANSFORMS_HPP
+#define CCOMMS_COORDS_TRANSFORMS_HPP
+
+#include "types.hpp"
+#include "batch.hpp"
+#include "../tensor/simd.hpp"
+
+#include <array>
+#include <cmath>
+#include <numbers>
+#include <algorithm>
+
+namespace ccomms {
+
+    /**
+     * @brief WGS-84 reference ellipsoid.
+     */
+    namespace wgs84 {
+        inline constexpr double a = 6378137.0;
+        inline constexpr double f = 1.0 / 298.257223563;
+        inline constexpr double b = a * (1.0 - f);
+        inline constexpr double e2 = f * (2.0 - f);
+        inline constexpr double ep2 = e2 / (1.0 - e2);
+    }
+
+    inline constexpr double deg_to_rad = std::numbers::pi / 180.0;
+    inline constexpr double rad_to_deg = 180.0 / std::numbers::pi;
+
+    //*************************************************** POINT KERNELS ************************************************
+
+    // Ellipsoid conversions are carried out in double precision whatever the coordinate type: the intermediate
+    // terms of the closed-form inverse exceed the range of float.
+
+    inline void geodetic_to_ecef(const double &lat, const double &lon, const double &alt,
+                                 double &x, double &y, double &z) {
+        const double phi = lat * deg_to_rad;
+        const double lambda = lon * deg_to_rad;
+        const double sin_phi = std::sin(phi), cos_phi = std::cos(phi);
+        const double radius = wgs84::a / std::sqrt(1.0 - wgs84::e2 * sin_phi * sin_phi);
+
+        x = (radius + alt) * cos_phi * std::cos(lambda);
+        y = (radius + alt) * cos_phi * std::sin(lambda);
+        z = (radius * (1.0 - wgs84::e2) + alt) * sin_phi;
+    }
+
+    /**
+     * @brief Closed-form (Heikkinen) inverse of geodetic_to_ecef, accurate to well under a millimeter from the
+     * surface out to geostationary altitude.
+     */
+    inline void ecef_to_geodetic(const double &x, const double &y, const double &z,
+                                 double &lat, double &lon, double &alt) {
+        constexpr double a2 = wgs84::a * wgs84::a;
+        constexpr double b2 = wgs84::b * wgs84::b;
+        constexpr double e4 = wgs84::e2 * wgs84::e2;
+
+        const double p2 = x * x + y * y;
+        const double p = std::sqrt(p2);
+        const double z2 = z * z;
+
+        const double F = 54.0 * b2 * z2;
+        const double G = p2 + (1.0 - wgs84::e2) * z2 - wgs84::e2 * (a2 - b2);
+        const double c = e4 * F * p2 / (G * G * G);
+        const double s = std::cbrt(1.0 + c + std::sqrt(c * c + 2.0 * c));
+        const double k = s + 1.0 + 1.0 / s;
+        const double P = F / (3.0 * k * k * G * G);
+        const double Q = std::sqrt(1.0 + 2.0 * e4 * P);
+        const double r0 = -P * wgs84::e2 * p / (1.0 + Q) +
+                          std::sqrt(std::max(0.0, 0.5 * a2 * (1.0 + 1.0 / Q) -
+                                                  P * (1.0 - wgs84::e2) * z2 / (Q * (1.0 + Q)) - 0.5 * P * p2));
+        const double t = p - wgs84::e2 * r0;
+        const double U = std::sqrt(t * t + z2);
+        const double V = std::sqrt(t * t + (1.0 - wgs84::e2) * z2);
+        const double z0 = b2 * z / (wgs84::a * V);
+
+        lat = std::clamp(std::atan2(z + wgs84::ep2 * z0, p) * rad_to_deg, -90.0, 90.0);
+        lon = std::atan2(y, x) * rad_to_deg;
+        alt = U * (1.0 - b2 / (wgs84::a * V));
+    }
+
+    /**
+     * @brief Maps an angle in degrees from (-360, 360) into [0, 360). A tiny negative angle rounds to exactly 360 once
+     * shifted, so that case becomes 0.
+     */
+    template<typename T>
+    T wrap_azimuth(const T &degrees) {
+        const T shifted = degrees < T(0) ? degrees + T(360) : degrees;
+        return shifted < T(360) ? shifted : T(0);
+    }
+
+    /**
+     * @brief Row-major rotation from ECEF axes to east, north, up axes at the given geodetic latitude and longitude.
+     */
+    template<typename T>
+    std::array<T, 9> enu_rotation(const double &lat, const double &lon) {
+        const double phi = lat * deg_to_rad;
+        const double lambda = lon * deg_to_rad;
+        const double sp = std::sin(phi), cp = std::cos(phi);
+        const double sl = std::sin(lambda), cl = std::cos(lambda);
+
+        return {static_cast<T>(-sl), static_cast<T>(cl), T(0),
+                static_cast<T>(-sp * cl), static_cast<T>(-sp * sl), static_cast<T>(cp),
+                static_cast<T>(cp * cl), static_cast<T>(cp * sl), static_cast<T>(sp)};
+    }
+
+    //*************************************************** ARRAY KERNELS ************************************************
+
+    /**
+     * @brief out = m * (in - pre) + post over separate x, y and z arrays, on SIMD for float and double.
+     */
+    template<typename T>
+    void affine3(const std::array<T, 9> &m, const std::array<T, 3> &pre, const std::array<T, 3> &post,
+                 const T *x, const T *y, const T *z, T *ox, T *oy, T *oz, const std::size_t &len) {
+        if constexpr (std::is_same_v<T, float> || std::is_same_v<T, double>)
+            simd::affine3(m.data(), pre.data(), post.data(), x, y, z, ox, oy, oz, len);
+        else
+            simd::scalar::affine3(m.data(), pre.data(), post.data(), x, y, z, ox, oy, oz, len);
+    }
+
+    /**
+     * @brief Geodetic to ECEF over arrays. The outputs may alias the inputs.
+     *
+     * @details Runs a block at a time in double precision through the SIMD sincos and sqrt kernels.
+     */
+    template<typename T>
+    void geodetic_to_ecef(const T *lat, const T *lon, const T *alt, T *x, T *y, T *z, const std::size_t &len) {
+        double sin_phi[simd::block], cos_phi[simd::block], sin_lambda[simd::block], cos_lambda[simd::block];
+        double root[simd::block];
+        for (std::size_t i = 0; i < len; i += simd::block) {
+            const std::size_t count = std::min(simd::block, len - i);
+            for (std::size_t k = 0; k < count; k++) {
+                sin_phi[k] = static_cast<double>(lat[i + k]) * deg_to_rad;
+                sin_lambda[k] = static_cast<double>(lon[i + k]) * deg_to_rad;
+            }
+            simd::sincos(sin_phi, cos_phi, sin_phi, count);
+            simd::sincos(sin_lambda, cos_lambda, sin_lambda, count);
+
+            for (std::size_t k = 0; k < count; k++)
+                root[k] = 1.0 - wgs84::e2 * sin_phi[k] * sin_phi[k];
+            simd::sqrt(root, root, count);
+
+            for (std::size_t k = 0; k < count; k++) {
+                const double radius = wgs84::a / root[k];
+                const double h = static_cast<double>(alt[i + k]);
+                const double horizontal = (radius + h) * cos_phi[k];
+                x[i + k] = static_cast<T>(horizontal * cos_lambda[k]);
+                y[i + k] = static_cast<T>(horizontal * sin_lambda[k]);
+                z[i + k] = static_cast<T>((radius * (1.0 - wgs84::e2) + h) * sin_phi[k]);
+            }
+        }
+    }
+
+    template<typename T>
+    void ecef_to_geodetic(const T *x, const T *y, const T *z, T *lat, T *lon, T *alt, const std::size_t &len) {
+        for (std::size_t i = 0; i < len; i++) {
+            double plat, plon, palt;
+            ecef_to_geodetic(x[i], y[i], z[i], plat, plon, palt);
+            lat[i] = static_cast<T>(plat);
+            lon[i] = static_cast<T>(plon);
+            alt[i] = static_cast<T>(palt);
+        }
+    }
+
+    /**
+     * @brief ECEF to east, north, up relative to a reference point. The outputs may alias the inputs.
+     */
+    template<typename T>
+    void ecef_to_enu(const T *x, const T *y, const T *z, T *e, T *n, T *u, const std::size_t &len,
+                     const geodetic<T> &ref, const T &ref_alt = T(0)) {
+        double rx, ry, rz;
+        geodetic_to_ecef(ref[0], ref[1], ref_alt, rx, ry, rz);
+        const std::array<T, 3> origin{static_cast<T>(rx), static_cast<T>(ry), static_cast<T>(rz)};
+
+        affine3(enu_rotation<T>(ref[0], ref[1]), origin, {T(0), T(0), T(0)}, x, y, z, e, n, u, len);
+    }
+
+    /**
+     * @brief ECEF to north, east, down relative to a reference point. The outputs may alias the inputs.
+     */
+    template<typename T>
+    void ecef_to_ned(const T *x, const T *y, const T *z, T *n, T *e, T *d, const std::size_t &len,
+                     const geodetic<T> &ref, const T &ref_alt = T(0)) {
+        double rx, ry, rz;
+        geodetic_to_ecef(ref[0], ref[1], ref_alt, rx, ry, rz);
+        const std::array<T, 3> origin{static_cast<T>(rx), static_cast<T>(ry), static_cast<T>(rz)};
+
+        const auto r = enu_rotation<T>(ref[0], ref[1]);
+        const std::array<T, 9> m{r[3], r[4], r[5], r[0], r[1], r[2], -r[6], -r[7], -r[8]};
+        affine3(m, origin, {T(0), T(0), T(0)}, x, y, z, n, e, d, len);
+    }
+
+    /**
+     * @brief East, north, up relative to a reference point back to ECEF. The outputs may alias the inputs.
+     */
+    template<typename T>
+    void enu_to_ecef(const T *e, const T *n, const T *u, T *x, T *y, T *z, const std::size_t &len,
+                     const geodetic<T> &ref, const T &ref_alt = T(0)) {
+        double rx, ry, rz;
+        geodetic_to_ecef(ref[0], ref[1], ref_alt, rx, ry, rz);
+        const std::array<T, 3> origin{static_cast<T>(rx), static_cast<T>(ry), static_cast<T>(rz)};
+
+        const auto r = enu_rotation<T>(ref[0], ref[1]);
+        const std::array<T, 9> m{r[0], r[3], r[6], r[1], r[4], r[7], r[2], r[5], r[8]};
+        affine3(m, {T(0), T(0), T(0)}, origin, e, n, u, x, y, z, len);
+    }
+
+    /**
+     * @brief Local east, north, up to azimuth (degrees clockwise from north in [0, 360)), elevation (degrees above
+     * the horizontal plane) and range. The outputs may alias the inputs.
+     *
+     * @details Float and double run a block at a time through the SIMD sqrt and atan2 kernels at accuracy tier A.
+     */
+    template<simd::accuracy A = simd::accuracy::precise, typename T>
+    void cartesian_to_spherical(const T *e, const T *n, const T *u, T *az, T *el, T *range, const std::size_t &len) {
+        if constexpr (std::is_same_v<T, float> || std::is_same_v<T, double>) {
+            T horizontal[simd::block], distance[simd::block], paz[simd::block], pel[simd::block];
+            for (std::size_t i = 0; i < len; i += simd::block) {
+                const std::size_t count = std::min(simd::block, len - i);
+                for (std::size_t k = 0; k < count; k++) {
+                    horizontal[k] = e[i + k] * e[i + k] + n[i + k] * n[i + k];
+                    distance[k] = horizontal[k] + u[i + k] * u[i + k];
+                }
+                simd::sqrt<A>(horizontal, horizontal, count);
+                simd::sqrt<A>(distance, distance, count);
+                simd::atan2<A>(paz, e + i, n + i, count);
+                simd::atan2<A>(pel, u + i, horizontal, count);
+
+                for (std::size_t k = 0; k < count; k++) {
+                    az[i + k] = wrap_azimuth(paz[k] * static_cast<T>(rad_to_deg));
+                    el[i + k] = pel[k] * static_cast<T>(rad_to_deg);
+                    range[i + k] = distance[k];
+                }
+            }
+        } else {
+            for (std::size_t i = 0; i < len; i++) {
+                const T horizontal = std::hypot(e[i], n[i]);
+                const T pe = e[i], pn = n[i], pu = u[i];
+                az[i] = wrap_azimuth(static_cast<T>(std::atan2(pe, pn) * static_cast<T>(rad_to_deg)));
+                el[i] = std::atan2(pu, horizontal) * static_cast<T>(rad_to_deg);
+                range[i] = std::sqrt(horizontal * horizontal + pu * pu);
+            }
+        }
+    }
+
+    /**
+     * @brief Azimuth, elevation and range back to local east, north, up. The outputs may alias the inputs.
+     *
+     * @details Float and double run a block at a time through the SIMD sincos kernel at accuracy tier A.
+     */
+    template<simd::accuracy A = simd::accuracy::precise, typename T>
+    void spherical_to_cartesian(const T *az, const T *el, const T *range, T *e, T *n, T *u, const std::size_t &len) {
+        if constexpr (std::is_same_v<T, float> || std::is_same_v<T, double>) {
+            T sin_az[simd::block], cos_az[simd::block], sin_el[simd::block], cos_el[simd::block];
+            for (std::size_t i = 0; i < len; i += simd::block) {
+                const std::size_t count = std::min(simd::block, len - i);
+                for (std::size_t k = 0; k < count; k++) {
+                    sin_az[k] = az[i + k] * static_cast<T>(deg_to_rad);
+                    sin_el[k] = el[i + k] * static_cast<T>(deg_to_rad);
+                }
+                simd::sincos<A>(sin_az, cos_az, sin_az, count);
+                simd::sincos<A>(sin_el, cos_el, sin_el, count);
+
+                for (std::size_t k = 0; k < count; k++) {
+                    const T r = range[i + k];
+                    const T horizontal = r * cos_el[k];
+                    e[i + k] = horizontal * sin_az[k];
+                    n[i + k] = horizontal * cos_az[k];
+                    u[i + k] = r * sin_el[k];
+                }
+            }
+        } else {
+            for (std::size_t i = 0; i < len; i++) {
+                const T paz = az[i] * static_cast<T>(deg_to_rad);
+                const T pel = el[i] * static_cast<T>(deg_to_rad);
+                const T r = range[i];
+                const T horizontal = r * std::cos(pel);
+                e[i] = horizontal * std::sin(paz);
+                n[i] = horizontal * std::cos(paz);
+                u[i] = r * std::sin(pel);
+            }
+        }
+    }
+
+    //************************************************** SCALAR POINTS *************************************************
+
+    template<typename T>
+    cartesian<T> geodetic_to_ecef(const geodetic<T> &p, const T &alt = T(0)) {
+        double x, y, z;
+        geodetic_to_ecef(p[0], p[1], alt, x, y, z);
+        return {static_cast<T>(x), static_cast<T>(y), static_cast<T>(z)};
+    }
+
+    template<typename T>
+    geodetic<T> ecef_to_geodetic(const cartesian<T> &p, T &alt) {
+        double lat, lon, h;
+        ecef_to_geodetic(p[0], p[1], p[2], lat, lon, h);
+        alt = static_cast<T>(h);
+        return {static_cast<T>(lat), static_cast<T>(lon)};
+    }
+
+    template<typename T>
+    geodetic<T> ecef_to_geodetic(const cartesian<T> &p) {
+        T alt;
+        return ecef_to_geodetic(p, alt);
+    }
+
+    template<typename T>
+    cartesian<T> ecef_to_enu(const cartesian<T> &p, const geodetic<T> &ref, const T &ref_alt = T(0)) {
+        cartesian<T> result;
+        ecef_to_enu(&p[0], &p[1], &p[2], &result[0], &result[1], &result[2], 1, ref, ref_alt);
+        return result;
+    }
+
+    template<typename T>
+    cartesian<T> ecef_to_ned(const cartesian<T> &p, const geodetic<T> &ref, const T &ref_alt = T(0)) {
+        cartesian<T> result;
+        ecef_to_ned(&p[0], &p[1], &p[2], &result[0], &result[1], &result[2], 1, ref, ref_alt);
+        return result;
+    }
+
+    template<typename T>
+    cartesian<T> enu_to_ecef(const cartesian<T> &p, const geodetic<T> &ref, const T &ref_alt = T(0)) {
+        cartesian<T> result;
+        enu_to_ecef(&p[0], &p[1], &p[2], &result[0], &result[1], &result[2], 1, ref, ref_alt);
+        return result;
+    }
+
+    template<typename T>
+    spherical<T> cartesian_to_spherical(const cartesian<T> &p, T &range) {
+        T az, el;
+        cartesian_to_spherical(&p[0], &p[1], &p[2], &az, &el, &range, 1);
+        return {az, el};
+    }
+
+    template<typename T>
+    spherical<T> cartesian_to_spherical(const cartesian<T> &p) {
+        T range;
+        return cartesian_to_spherical(p, range);
+    }
+
+    template<typename T>
+    cartesian<T> spherical_to_cartesian(const spherical<T> &p, const T &range = T(1)) {
+        cartesian<T> result;
+        spherical_to_cartesian(&p[0], &p[1], &range, &result[0], &result[1], &result[2], 1);
+        return result;
+    }
+
+    //***************************************************** BATCHES ****************************************************
+
+    template<typename T, typename Alloc>
+    cartesian_batch<T, Alloc> geodetic_to_ecef(const geodetic_batch<T, Alloc> &p) {
+        cartesian_batch<T, Alloc> result(p.size());
+        geodetic_to_ecef(p.lat().data(), p.lon().data(), p.alt().data(),
+                         result.x().data(), result.y().data(), result.z().data(), p.size());
+        return result;
+    }
+
+    template<typename T, typename Alloc>
+    geodetic_batch<T, Alloc> ecef_to_geodetic(const cartesian_batch<T, Alloc> &p) {
+        geodetic_batch<T, Alloc> result(p.size());
+        ecef_to_geodetic(p.x().data(), p.y().data(), p.z().data(),
+                         result.lat().data(), result.lon().data(), result.alt().data(), p.size());
+        return result;
+    }
+
+    template<typename T, typename Alloc>
+    cartesian_batch<T, Alloc> ecef_to_enu(const cartesian_batch<T, Alloc> &p, const geodetic<T> &ref,
+                                          const T &ref_alt = T(0)) {
+        cartesian_batch<T, Alloc> result(p.size());
+        ecef_to_enu(p.x().data(), p.y().data(), p.z().data(),
+                    result.x().data(), result.y().data(), result.z().data(), p.size(), ref, ref_alt);
+        return result;
+    }
+
+    template<typename T, typename Alloc>
+    cartesian_batch<T, Alloc> ecef_to_ned(const cartesian_batch<T, Alloc> &p, const geodetic<T> &ref,
+                                          const T &ref_alt = T(0)) {
+        cartesian_batch<T, Alloc> result(p.size());
+        ecef_to_ned(p.x().data(), p.y().data(), p.z().data(),
+                    result.x().data(), result.y().data(), result.z().data(), p.size(), ref, ref_alt);
+        return result;
+    }
+
+    template<typename T, typename Alloc>
+    cartesian_batch<T, Alloc> enu_to_ecef(const cartesian_batch<T, Alloc> &p, const geodetic<T> &ref,
+                                          const T &ref_alt = T(0)) {
+        cartesian_batch<T, Alloc> result(p.size());
+        enu_to_ecef(p.x().data(), p.y().data(), p.z().data(),
+                    result.x().data(), result.y().data(), result.z().data(), p.size(), ref, ref_alt);
+        return result;
+    }
+
+    template<simd::accuracy A = simd::accuracy::precise, typename T, typename Alloc>
+    spherical_batch<T, Alloc> cartesian_to_spherical(const cartesian_batch<T, Alloc> &p) {
+        spherical_batch<T, Alloc> result(p.size());
+        cartesian_to_spherical<A>(p.x().data(), p.y().data(), p.z().data(),
+                                  result.az().data(), result.el().data(), result.range().data(), p.size());
+        return result;
+    }
+
+    template<simd::accuracy A = simd::accuracy::precise, typename T, typename Alloc>
+    cartesian_batch<T, Alloc> spherical_to_cartesian(const spherical_batch<T, Alloc> &p) {
+        cartesian_batch<T, Alloc> result(p.size());
+        spherical_to_cartesian<A>(p.az().data(), p.el().data(), p.range().data(),
+                                  result.x().data(), result.y().data(), result.z().data(), p.size());
+        return result;
+    }
+}
+
+#endif //CCOMMS_COORDS_TRANSFORMS_HPP
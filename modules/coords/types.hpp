@@ -3,58 +3,59 @@
 #ifndef CCOMMS_COORDS_TYPES_HPP
 #define CCOMMS_COORDS_TYPES_HPP
 
-#include "../tensor/types.hpp"
+#include "../tensor/vector.hpp"
 
 #include <numbers>
 
 namespace ccomms {
 
-    template<typename T, typename = std::enable_if_t<std::is_arithmetic_v<T>>>
-    class cartesian : public vector<T> {
+    template<typename T, typename Policy = conversion::warn_once,
+            typename = std::enable_if_t<std::is_arithmetic_v<T>>>
+    class cartesian : public vector<T, 0, Policy, std::allocator<T>, 3> {
+
+        using base = vector<T, 0, Policy, std::allocator<T>, 3>;
+
     public:
         T x = (*this)[0];
         T y = (*this)[1];
         T z = (*this)[2];
 
-        cartesian() : vector<T>(3) {}
+        cartesian() : base(3, T(0)) {}
 
         template<typename U, typename = std::enable_if_t<std::is_convertible_v<U, T>>>
-        cartesian(const U &x, const U &y, const U &z) : vector<T>({x, y, z}) {
-            if constexpr (!std::is_same_v<U, T>)
-                std::cerr << "\nWARNING: cartesian list constructor performing type conversion\n";
+        cartesian(const U &x, const U &y, const U &z) : base({x, y, z}) {
+            conversion::check<Policy, U, T>("\nWARNING: cartesian list constructor performing type conversion\n");
         }
 
         template<typename U, typename = std::enable_if_t<std::is_convertible_v<U, T>>>
-        explicit cartesian(const std::vector<U> &vec) : vector<T>(vec) {
+        explicit cartesian(const std::vector<U> &vec) : base(vec) {
             if (vec.size() != 3)
                 throw std::invalid_argument("cartesian copy constructor source must have exactly 3 elements");
 
-            if constexpr (!std::is_same_v<U, T>)
-                std::cerr << "\nWARNING: cartesian copy constructor performing type conversion\n";
+            conversion::check<Policy, U, T>("\nWARNING: cartesian copy constructor performing type conversion\n");
         }
 
         template<typename U, typename = std::enable_if_t<std::is_convertible_v<U, T>>>
-        explicit cartesian(std::vector<U> &&vec) : vector<T>(std::move(vec)) {
+        explicit cartesian(std::vector<U> &&vec) : base(std::move(vec)) {
             if (this->size() != 3)
                 throw std::invalid_argument("cartesian move constructor source must have exactly 3 elements");
 
-            if constexpr (!std::is_same_v<U, T>)
-                std::cerr << "\nWARNING: cartesian move constructor performing type conversion\n";
+            conversion::check<Policy, U, T>("\nWARNING: cartesian move constructor performing type conversion\n");
         }
 
         //*********************************************** ASSIGN AND MOVE **********************************************
 
         template<template<typename> class V, typename U>
-        cartesian<T> &operator=(const V<U> &other) {
+        cartesian<T, Policy> &operator=(const V<U> &other) {
             static_assert(std::is_arithmetic_v<U>, "cartesian assignment operator source must have arithmetic type");
 
             if (other.size() != 3)
                 throw std::invalid_argument("cartesian assignment operator source must have exactly 3 elements");
 
             if constexpr (std::is_same_v<T, U>)
-                vector<T>::operator=(cartesian<U>{other[0], other[1], other[2]});
+                base::operator=(cartesian<U>{other[0], other[1], other[2]});
             else {
-                std::cerr << "\nWARNING: cartesian copy operator performing type conversion\n";
+                conversion::check<Policy, U, T>("\nWARNING: cartesian copy operator performing type conversion\n");
                 (*this)[0] = static_cast<T>(other[0]);
                 (*this)[1] = static_cast<T>(other[1]);
                 (*this)[2] = static_cast<T>(other[2]);
@@ -64,7 +65,7 @@ namespace ccomms {
         }
 
         template<template<typename> class V, typename U>
-        cartesian<T> &operator=(V<U> &&other) {
+        cartesian<T, Policy> &operator=(V<U> &&other) {
             static_assert(std::is_arithmetic_v<U>,
                           "cartesian move operator source type must be convertible to destination type");
 
@@ -72,9 +73,9 @@ namespace ccomms {
                 throw std::invalid_argument("cartesian move operator source must have exactly 3 elements");
 
             if constexpr (std::is_same_v<T, U>)
-                vector<T>::operator=(std::move(cartesian<U>{other[0], other[1], other[2]}));
+                base::operator=(std::move(cartesian<U>{other[0], other[1], other[2]}));
             else {
-                std::cerr << "\nWARNING: cartesian move operator performing type conversion\n";
+                conversion::check<Policy, U, T>("\nWARNING: cartesian move operator performing type conversion\n");
                 (*this)[0] = static_cast<T>(std::move(other[0]));
                 (*this)[1] = static_cast<T>(std::move(other[1]));
                 (*this)[2] = static_cast<T>(std::move(other[2]));
@@ -90,44 +91,45 @@ namespace ccomms {
         cartesian(const std::size_t &size, const T &vals) = delete;
     };
 
-    template<typename T, typename = std::enable_if_t<std::is_arithmetic_v<T>>>
-    class spherical : public vector<T> {
+    template<typename T, typename Policy = conversion::warn_once,
+            typename = std::enable_if_t<std::is_arithmetic_v<T>>>
+    class spherical : public vector<T, 0, Policy, std::allocator<T>, 2> {
+
+        using base = vector<T, 0, Policy, std::allocator<T>, 2>;
+
     public:
         T az = (*this)[0];
         T el = (*this)[1];
 
         //************************************************* CONSTRUCTORS ***********************************************
 
-        spherical() : vector<T>(2) {}
+        spherical() : base(2, T(0)) {}
 
         template<typename U, typename = std::enable_if_t<std::is_convertible_v<U, T>>>
-        spherical(const U &az, const U &el) : vector<T>({az, el}) {
-            if constexpr (!std::is_same_v<U, T>)
-                std::cerr << "\nWARNING: spherical list constructor performing type conversion\n";
+        spherical(const U &az, const U &el) : base({az, el}) {
+            conversion::check<Policy, U, T>("\nWARNING: spherical list constructor performing type conversion\n");
         }
 
         template<typename U, typename = std::enable_if_t<std::is_convertible_v<U, T>>>
-        explicit spherical(const std::vector<U> &vec) : vector<T>(vec) {
+        explicit spherical(const std::vector<U> &vec) : base(vec) {
             if (vec.size() != 2)
                 throw std::invalid_argument("\nERR: spherical copy constructor source must have exactly 2 elements\n");
 
-            if constexpr (!std::is_same_v<U, T>)
-                std::cerr << "\nWARNING: spherical copy constructor performing type conversion\n";
+            conversion::check<Policy, U, T>("\nWARNING: spherical copy constructor performing type conversion\n");
         }
 
         template<typename U, typename = std::enable_if_t<std::is_convertible_v<U, T>>>
-        explicit spherical(std::vector<U> &&vec) : vector<T>(std::move(vec)) {
+        explicit spherical(std::vector<U> &&vec) : base(std::move(vec)) {
             if (this->size() != 2)
                 throw std::invalid_argument("\nERR: spherical move constructor source must have exactly 2 elements\n");
 
-            if constexpr (!std::is_same_v<U, T>)
-                std::cerr << "\nWARNING: spherical move constructor performing type conversion\n";
+            conversion::check<Policy, U, T>("\nWARNING: spherical move constructor performing type conversion\n");
         }
 
         //*********************************************** ASSIGN AND MOVE **********************************************
 
         template<template<typename> class V, typename U>
-        spherical<T> &operator=(const V<U> &other) {
+        spherical<T, Policy> &operator=(const V<U> &other) {
             static_assert(std::is_arithmetic_v<U>,
                           "\nERR: spherical assignment operator source must have arithmetic type\n");
 
@@ -136,9 +138,9 @@ namespace ccomms {
                         "\nERR: spherical assignment operator source must have exactly 2 elements\n");
 
             if constexpr (std::is_same_v<T, U>)
-                vector<T>::operator=(spherical<U>{other[0], other[1]});
+                base::operator=(spherical<U>{other[0], other[1]});
             else {
-                std::cerr << "\nWARNING: spherical copy operator performing type conversion\n";
+                conversion::check<Policy, U, T>("\nWARNING: spherical copy operator performing type conversion\n");
                 (*this)[0] = static_cast<T>(other[0]);
                 (*this)[1] = static_cast<T>(other[1]);
             }
@@ -147,7 +149,7 @@ namespace ccomms {
         }
 
         template<template<typename> class V, typename U>
-        spherical<T> &operator=(V<U> &&other) {
+        spherical<T, Policy> &operator=(V<U> &&other) {
             static_assert(std::is_arithmetic_v<U>,
                           "\nERR: spherical move operator source type must be convertible to destination type\n");
 
@@ -155,9 +157,9 @@ namespace ccomms {
                 throw std::invalid_argument("\nERR: spherical move operator source must have exactly 2 elements\n");
 
             if constexpr (std::is_same_v<T, U>)
-                vector<T>::operator=(std::move(spherical<U>{other[0], other[1]}));
+                base::operator=(std::move(spherical<U>{other[0], other[1]}));
             else {
-                std::cerr << "\nWARNING: spherical move operator performing type conversion\n";
+                conversion::check<Policy, U, T>("\nWARNING: spherical move operator performing type conversion\n");
                 (*this)[0] = static_cast<T>(std::move(other[0]));
                 (*this)[1] = static_cast<T>(std::move(other[1]));
             }
@@ -172,29 +174,32 @@ namespace ccomms {
         spherical(const std::size_t &size, const T &vals) = delete;
     };
 
-    template<typename T, typename = std::enable_if_t<std::is_arithmetic_v<T>>>
-    class geodetic : public vector<T> {
+    template<typename T, typename Policy = conversion::warn_once,
+            typename = std::enable_if_t<std::is_arithmetic_v<T>>>
+    class geodetic : public vector<T, 0, Policy, std::allocator<T>, 2> {
+
+        using base = vector<T, 0, Policy, std::allocator<T>, 2>;
+
     public:
         T lat = (*this)[0];
         T lon = (*this)[1];
 
         //************************************************* CONSTRUCTORS ***********************************************
 
-        geodetic() : vector<T>(2) {}
+        geodetic() : base(2, T(0)) {}
 
         template<typename U, typename = std::enable_if_t<std::is_convertible_v<U, T>>>
-        geodetic(const U &lat, const U &lon) : vector<T>({lat, lon}) {
+        geodetic(const U &lat, const U &lon) : base({lat, lon}) {
             if (lat > 90 || lat < -90)
                 throw std::invalid_argument("ERR: geodetic lat must be between -90 and 90");
             if (lon > 180 || lon < -180)
                 throw std::invalid_argument("ERR: geodetic lon must be between -180 and 180");
 
-            if constexpr (!std::is_same_v<U, T>)
-                    std::cerr << "\nWARNING: geodetic list constructor performing type conversion\n";
+            conversion::check<Policy, U, T>("\nWARNING: geodetic list constructor performing type conversion\n");
         }
 
         template<typename U, typename = std::enable_if_t<std::is_convertible_v<U, T>>>
-        explicit geodetic(const std::vector<U> &vec) : vector<T>(vec) {
+        explicit geodetic(const std::vector<U> &vec) : base(vec) {
             if (vec.size() != 2)
                 throw std::invalid_argument("\nERR: geodetic copy constructor source must have exactly 2 elements\n");
             if (lat > 90 || lat < -90)
@@ -202,12 +207,11 @@ namespace ccomms {
             if (lon > 180 || lon < -180)
                 throw std::invalid_argument("ERR: geodetic lon must be between -180 and 180");
 
-            if constexpr (!std::is_same_v<U, T>)
-                std::cerr << "\nWARNING: geodetic copy constructor performing type conversion\n";
+            conversion::check<Policy, U, T>("\nWARNING: geodetic copy constructor performing type conversion\n");
         }
 
         template<typename U, typename = std::enable_if_t<std::is_convertible_v<U, T>>>
-        explicit geodetic(std::vector<U> &&vec) : vector<T>(std::move(vec)) {
+        explicit geodetic(std::vector<U> &&vec) : base(std::move(vec)) {
             if (this->size() != 2)
                 throw std::invalid_argument("\nERR: geodetic move constructor source must have exactly 2 elements\n");
             if (lat > 90 || lat < -90)
@@ -215,14 +219,13 @@ namespace ccomms {
             if (lon > 180 || lon < -180)
                 throw std::invalid_argument("ERR: geodetic lon must be between -180 and 180");
 
-            if constexpr (!std::is_same_v<U, T>)
-                std::cerr << "\nWARNING: geodetic move constructor performing type conversion\n";
+            conversion::check<Policy, U, T>("\nWARNING: geodetic move constructor performing type conversion\n");
         }
 
         //*********************************************** ASSIGN AND MOVE **********************************************
 
         template<template<typename> class V, typename U>
-        geodetic<T> &operator=(const V<U> &other) {
+        geodetic<T, Policy> &operator=(const V<U> &other) {
             static_assert(std::is_arithmetic_v<U>,
                           "\nERR: geodetic assignment operator source must have arithmetic type\n");
             static_assert(other.size() == 2,
@@ -234,9 +237,9 @@ namespace ccomms {
                 throw std::invalid_argument("ERR: geodetic lon must be between -180 and 180");
 
             if constexpr (std::is_same_v<T, U>)
-                vector<T>::operator=(geodetic<U>{other[0], other[1]});
+                base::operator=(geodetic<U>{other[0], other[1]});
             else {
-                std::cerr << "\nWARNING: geodetic copy operator performing type conversion\n";
+                conversion::check<Policy, U, T>("\nWARNING: geodetic copy operator performing type conversion\n");
                 (*this)[0] = static_cast<T>(other[0]);
                 (*this)[1] = static_cast<T>(other[1]);
             }
@@ -245,7 +248,7 @@ namespace ccomms {
         }
 
         template<template<typename> class V, typename U>
-        geodetic<T> &operator=(V<U> &&other) {
+        geodetic<T, Policy> &operator=(V<U> &&other) {
             static_assert(std::is_arithmetic_v<U>,
                           "\nERR: geodetic move operator source type must be convertible to destination type\n");
             static_assert(other.size() == 2,
@@ -257,9 +260,9 @@ namespace ccomms {
                 throw std::invalid_argument("ERR: geodetic lon must be between -180 and 180");
 
             if constexpr (std::is_same_v<T, U>)
-                vector<T>::operator=(std::move(geodetic<U>{other[0], other[1]}));
+                base::operator=(std::move(geodetic<U>{other[0], other[1]}));
             else {
-                std::cerr << "\nWARNING: geodetic move operator performing type conversion\n";
+                conversion::check<Policy, U, T>("\nWARNING: geodetic move operator performing type conversion\n");
                 (*this)[0] = static_cast<T>(std::move(other[0]));
                 (*this)[1] = static_cast<T>(std::move(other[1]));
             }
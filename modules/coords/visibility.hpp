@@ -0,0 +1,363 @@
+// Copyright(c) 2023, Matthew Petrin, All rights reserved.
+
+#ifndef CCOMMS_COORDS_VISIBILITY_HPP
+#define CCOMMS_COORDS_VISIBILITY_HPP
+
+#include "tle.hpp"
+#include "types.hpp"
+#include "batch.hpp"
+#include "orbit.hpp"
+#include "transforms.hpp"
+#include "../tensor/execution.hpp"
+
+#include <cmath>
+#include <array>
+#include <limits>
+#include <vector>
+#include <numbers>
+#include <algorithm>
+#include <stdexcept>
+
+namespace ccomms {
+
+    /**
+     * @brief An interval over which a satellite stays at or above the elevation mask of a station. Windows already
+     * open at the start of the trajectories, or still open at their end, are cut there.
+     */
+    struct access_window {
+        std::size_t station = 0;
+        std::size_t satellite = 0;
+        julian_date rise;
+        julian_date set;
+    };
+
+    /**
+     * @brief Station and satellite pairs per task when access windows are spread across threads.
+     */
+    inline constexpr std::size_t visibility_chunk = 64;
+
+    /**
+     * @brief Widening of the pruning cones in radians. The cones are drawn about the geocentric direction of a
+     * station, which departs from its geodetic normal by up to 0.193 degrees.
+     */
+    inline constexpr double visibility_margin = 0.25 * deg_to_rad;
+
+    //************************************************** ROOT FINDING **************************************************
+
+    /**
+     * @brief Root of f in [a, b] to within tolerance by Brent's method, from fa = f(a) and fb = f(b) of opposite
+     * signs.
+     */
+    template<typename F>
+    double brent_root(F &&f, double a, double b, double fa, double fb, const double &tolerance) {
+        double c = b, fc = fb, d = b - a, e = d;
+        for (int iteration = 0; iteration < 100; iteration++) {
+            if ((fb > 0.0 && fc > 0.0) || (fb < 0.0 && fc < 0.0)) {
+                c = a;
+                fc = fa;
+                d = e = b - a;
+            }
+            if (std::abs(fc) < std::abs(fb)) {
+                a = b;
+                b = c;
+                c = a;
+                fa = fb;
+                fb = fc;
+                fc = fa;
+            }
+            const double tol = 2.0 * std::numeric_limits<double>::epsilon() * std::abs(b) + 0.5 * tolerance;
+            const double m = 0.5 * (c - b);
+            if (std::abs(m) <= tol || fb == 0.0)
+                return b;
+
+            // Inverse quadratic or secant step when it stays well inside the bracket, bisection otherwise
+            if (std::abs(e) >= tol && std::abs(fa) > std::abs(fb)) {
+                const double s = fb / fa;
+                double p, q;
+                if (a == c) {
+                    p = 2.0 * m * s;
+                    q = 1.0 - s;
+                } else {
+                    const double r = fb / fc;
+                    q = fa / fc;
+                    p = s * (2.0 * m * q * (q - r) - (b - a) * (r - 1.0));
+                    q = (q - 1.0) * (r - 1.0) * (s - 1.0);
+                }
+                if (p > 0.0)
+                    q = -q;
+                else
+                    p = -p;
+                if (2.0 * p < std::min(3.0 * m * q - std::abs(tol * q), std::abs(e * q))) {
+                    e = d;
+                    d = p / q;
+                } else {
+                    d = e = m;
+                }
+            } else {
+                d = e = m;
+            }
+            a = b;
+            fa = fb;
+            b += std::abs(d) > tol ? d : m > 0.0 ? tol : -tol;
+            fb = f(b);
+        }
+        return b;
+    }
+
+    //*************************************************** TRAJECTORIES *************************************************
+
+    /**
+     * @class satellite_track
+     *
+     * @brief The states of one satellite of an ephemeris gathered step by step, six to a step, so that the searches
+     * of its pairs read them contiguously, with bounds on its motion for pruning.
+     *
+     * @details The bounds cover the geocentric radius, the geocentric latitude in radians and the angular rate about
+     * the earth centre in radians per second, widened to cover the states between steps: the radius by a quarter
+     * step of its rate of change, the rate by a twentieth and the latitude by half a step of the rate. finite is
+     * false when any state is not, as for a decayed orbit.
+     */
+    struct satellite_track {
+        std::vector<double> states;
+        std::size_t steps = 0;
+        double step = 0.0;
+        double radius = 0.0;
+        double latitude = 0.0;
+        double rate = 0.0;
+        bool finite = true;
+
+        template<typename T>
+        void assign(const ephemeris<T> &trajectories, const std::size_t &satellite) {
+            steps = trajectories.steps;
+            step = steps > 1 ? trajectories.step : 0.0;
+            states.resize(6 * steps);
+            radius = latitude = rate = 0.0;
+            finite = true;
+            const auto &p = trajectories.position;
+            const auto &v = trajectories.velocity;
+            double z_ratio = 0.0;
+            for (std::size_t s = 0; s < steps; s++) {
+                const std::size_t i = trajectories.index(s, satellite);
+                double *state = states.data() + 6 * s;
+                for (std::size_t k = 0; k < 3; k++) {
+                    state[k] = p.column(k)[i];
+                    state[k + 3] = v.column(k)[i];
+                }
+                const double r = std::sqrt(state[0] * state[0] + state[1] * state[1] + state[2] * state[2]);
+                const double speed = std::sqrt(state[3] * state[3] + state[4] * state[4] + state[5] * state[5]);
+                if (!std::isfinite(r) || !std::isfinite(speed) || r == 0.0)
+                    finite = false;
+                const double radial = (state[0] * state[3] + state[1] * state[4] + state[2] * state[5]) / r;
+                radius = std::max(radius, r + 0.25 * step * std::abs(radial));
+                rate = std::max(rate, speed / r);
+                z_ratio = std::max(z_ratio, std::abs(state[2]) / r);
+            }
+            rate *= 1.05;
+            latitude = std::asin(std::min(z_ratio, 1.0)) + 0.5 * step * rate;
+        }
+
+        /**
+         * @brief Position and velocity at any time within the track, in seconds from its start, by cubic Hermite
+         * interpolation between the states of the neighbouring steps.
+         */
+        void interpolate(const double &seconds, double (&position)[3], double (&velocity)[3]) const {
+            if (steps < 2) {
+                for (std::size_t k = 0; k < 3; k++) {
+                    velocity[k] = states[k + 3];
+                    position[k] = states[k] + velocity[k] * seconds;
+                }
+                return;
+            }
+
+            const double s = std::clamp(std::floor(seconds / step), 0.0, static_cast<double>(steps - 2));
+            const double u = seconds / step - s, u2 = u * u, u3 = u2 * u;
+            const double h00 = 2.0 * u3 - 3.0 * u2 + 1.0, h10 = (u3 - 2.0 * u2 + u) * step, h11 = (u3 - u2) * step;
+            const double d00 = 6.0 * (u2 - u) / step, d10 = 3.0 * u2 - 4.0 * u + 1.0, d11 = 3.0 * u2 - 2.0 * u;
+            const double *a = states.data() + 6 * static_cast<std::size_t>(s), *b = a + 6;
+            for (std::size_t k = 0; k < 3; k++) {
+                position[k] = h00 * a[k] + h10 * a[k + 3] + (1.0 - h00) * b[k] + h11 * b[k + 3];
+                velocity[k] = d00 * (a[k] - b[k]) + d10 * a[k + 3] + d11 * b[k + 3];
+            }
+        }
+    };
+
+    //***************************************************** STATIONS ***************************************************
+
+    /**
+     * @brief ECEF position in meters, geodetic up vector, geocentric radius and geocentric latitude in radians of a
+     * ground station.
+     */
+    struct station_frame {
+        double position[3] = {0.0, 0.0, 0.0};
+        double up[3] = {0.0, 0.0, 0.0};
+        double radius = 0.0;
+        double latitude = 0.0;
+    };
+
+    inline station_frame frame_of(const double &lat, const double &lon, const double &alt) {
+        station_frame result;
+        geodetic_to_ecef(lat, lon, alt, result.position[0], result.position[1], result.position[2]);
+        const std::array<double, 9> rotation = enu_rotation<double>(lat, lon);
+        std::copy_n(rotation.begin() + 6, 3, result.up);
+        result.radius = std::hypot(result.position[0], result.position[1], result.position[2]);
+        result.latitude = std::asin(result.position[2] / result.radius);
+        return result;
+    }
+
+    //****************************************************** PAIRS *****************************************************
+
+    /**
+     * @brief Appends the access windows of one station and satellite pair to out, with mask in radians and times in
+     * seconds from start, the instant the track begins.
+     *
+     * @details The sine of the elevation less the sine of the mask is sampled every sample_step seconds, and each
+     * change of sign is refined by Brent's method. Where the samples on either side agree but the elevation rate
+     * turns between them, the turning point is found first, so that passes shorter than a step are not missed.
+     *
+     * Samples are skipped where the satellite provably cannot be above the mask: visibility needs the angle at the
+     * earth centre between station and satellite within the cone acos(R cos(mask) / r) - mask of a satellite at the
+     * largest radius r it reaches, and that angle closes no faster than the angular rate bound. A pair whose
+     * latitudes stay further apart than the cone is skipped whole.
+     */
+    inline void pair_windows(const julian_date &start, const std::size_t &station, const station_frame &frame,
+                             const std::size_t &satellite, const satellite_track &track, const double &mask,
+                             const double &sample_step, const double &tolerance, std::vector<access_window> &out) {
+        const double cone_mask = mask - visibility_margin;
+        const double cone = std::acos(std::min(1.0, frame.radius * std::cos(cone_mask) / track.radius)) - cone_mask;
+        if (cone < 0.0 || std::abs(frame.latitude) - track.latitude > cone)
+            return;
+        const double cos_cone = cone < std::numbers::pi ? std::cos(cone) : -2.0;
+
+        struct sample {
+            double t, f, df, cos_angle;
+        };
+        const double sin_mask = std::sin(mask);
+        const auto evaluate = [&](const double &t) {
+            double p[3], v[3], d[3];
+            track.interpolate(t, p, v);
+            for (std::size_t k = 0; k < 3; k++)
+                d[k] = p[k] - frame.position[k];
+            const double range = std::sqrt(d[0] * d[0] + d[1] * d[1] + d[2] * d[2]);
+            const double ud = frame.up[0] * d[0] + frame.up[1] * d[1] + frame.up[2] * d[2];
+            const double uv = frame.up[0] * v[0] + frame.up[1] * v[1] + frame.up[2] * v[2];
+            const double dv = d[0] * v[0] + d[1] * v[1] + d[2] * v[2];
+            const double r = std::sqrt(p[0] * p[0] + p[1] * p[1] + p[2] * p[2]);
+            const double sp = frame.position[0] * p[0] + frame.position[1] * p[1] + frame.position[2] * p[2];
+            return sample{t, ud / range - sin_mask, uv / range - ud * dv / (range * range * range),
+                          sp / (frame.radius * r)};
+        };
+        const auto f = [&](const double &t) { return evaluate(t).f; };
+        const auto df = [&](const double &t) { return evaluate(t).df; };
+
+        const double end = static_cast<double>(track.steps - 1) * track.step;
+        const auto last = static_cast<std::size_t>(std::ceil(end / sample_step));
+        sample a = evaluate(0.0);
+        bool open = a.f >= 0.0;
+        double rise = 0.0;
+        const auto cross = [&](const sample &x, const sample &y) {
+            const double t = brent_root(f, x.t, y.t, x.f, y.f, tolerance);
+            if (open)
+                out.push_back({station, satellite, start + rise, start + t});
+            rise = t;
+            open = !open;
+        };
+
+        for (std::size_t k = 0; k < last;) {
+            std::size_t next = k + 1;
+            bool clear = false;
+            if (a.cos_angle < cos_cone) {
+                const double angle = std::acos(std::max(a.cos_angle, -1.0));
+                const double skip = std::floor((angle - cone) / track.rate / sample_step);
+                if (skip >= 1.0) {
+                    next = skip >= static_cast<double>(last - k) ? last : k + static_cast<std::size_t>(skip);
+                    clear = true;
+                }
+            }
+            const sample b = evaluate(std::min(static_cast<double>(next) * sample_step, end));
+            if (!clear) {
+                if ((a.f >= 0.0) != (b.f >= 0.0)) {
+                    cross(a, b);
+                } else if (a.f >= 0.0 ? a.df < 0.0 && b.df > 0.0 : a.df > 0.0 && b.df < 0.0) {
+                    const sample turn = evaluate(brent_root(df, a.t, b.t, a.df, b.df, tolerance));
+                    if ((turn.f >= 0.0) != (a.f >= 0.0)) {
+                        cross(a, turn);
+                        cross(turn, b);
+                    }
+                }
+            }
+            a = b;
+            k = next;
+        }
+        if (open)
+            out.push_back({station, satellite, start + rise, start + end});
+    }
+
+    //*************************************************** ACCESS WINDOWS ***********************************************
+
+    /**
+     * @brief Every window in which a satellite of the trajectories is at or above mask degrees of elevation from a
+     * station, sorted by rise time, then station, then satellite.
+     *
+     * @details The trajectories must be in the earth fixed frame, as propagated with orbit_frame::ecef. Between its
+     * steps a satellite follows the cubic through the positions and velocities of the neighbouring steps, so that
+     * an ephemeris of a low orbit can be propagated a minute apart without losing rise and set times. Pairs are
+     * spread across the threads of the policy; see pair_windows for the search. sample_step should stay below half
+     * the shortest pass of interest, and tolerance is the precision of rise and set times in seconds. Satellites
+     * with states that are not finite, as after decay, have no windows.
+     */
+    template<execution::policy P, typename T, typename Alloc>
+    std::vector<access_window> access_windows(const P &policy, const geodetic_batch<T, Alloc> &stations,
+                                              const ephemeris<T> &trajectories, const double &mask,
+                                              const double &sample_step = 60.0, const double &tolerance = 1e-3) {
+        if (!(sample_step > 0.0) || !(tolerance > 0.0))
+            throw std::invalid_argument("\nERR: access windows require a positive sample step and tolerance\n");
+        if (trajectories.steps > 1 && !(trajectories.step > 0.0))
+            throw std::invalid_argument("\nERR: access windows require trajectories with a positive step\n");
+        if (trajectories.position.size() != trajectories.steps * trajectories.satellites ||
+            trajectories.velocity.size() != trajectories.position.size())
+            throw std::invalid_argument("\nERR: trajectories do not hold steps * satellites states\n");
+
+        const std::size_t n = stations.size(), satellites = trajectories.satellites;
+        if (n == 0 || satellites == 0 || trajectories.steps == 0)
+            return {};
+        std::vector<station_frame> frames(n);
+        for (std::size_t j = 0; j < n; j++)
+            frames[j] = frame_of(stations.lat()[j], stations.lon()[j], stations.alt()[j]);
+
+        // Pairs run satellite major, so that a task gathers the trajectory of a satellite once for its stations
+        const std::size_t pairs = n * satellites;
+        std::vector<std::vector<access_window> > found((pairs + visibility_chunk - 1) / visibility_chunk);
+        execution::for_each_chunk(policy, pairs, visibility_chunk, [&](std::size_t first, std::size_t count) {
+            auto &out = found[first / visibility_chunk];
+            satellite_track track;
+            for (std::size_t pair = first; pair < first + count; pair++) {
+                const std::size_t satellite = pair / n, station = pair % n;
+                if (pair == first || station == 0)
+                    track.assign(trajectories, satellite);
+                if (track.finite)
+                    pair_windows(trajectories.start, station, frames[station], satellite, track, mask * deg_to_rad,
+                                 sample_step, tolerance, out);
+            }
+        });
+
+        std::vector<access_window> result;
+        for (auto &windows: found)
+            result.insert(result.end(), windows.begin(), windows.end());
+        std::sort(result.begin(), result.end(), [](const access_window &a, const access_window &b) {
+            const double order = a.rise.days_since(b.rise);
+            if (order != 0.0)
+                return order < 0.0;
+            return a.station != b.station ? a.station < b.station : a.satellite < b.satellite;
+        });
+        return result;
+    }
+
+    template<typename T, typename Alloc>
+    std::vector<access_window> access_windows(const geodetic_batch<T, Alloc> &stations,
+                                              const ephemeris<T> &trajectories, const double &mask,
+                                              const double &sample_step = 60.0, const double &tolerance = 1e-3) {
+        return access_windows(execution::par, stations, trajectories, mask, sample_step, tolerance);
+    }
+}
+
+#endif //CCOMMS_COORDS_VISIBILITY_HPP
@@ -0,0 +1,328 @@
+// Copyright(c) 2023, Matthew Petrin, All rights reserved.
+
+#ifndef CCOMMS_MODULES_DSP_BEAMFORMING_HPP_
+#define CCOMMS_MODULES_DSP_BEAMFORMING_HPP_
+
+#include <cmath>
+#include <string>
+#include <numbers>
+#include <complex>
+#include <cstddef>
+#include <algorithm>
+#include <stdexcept>
+#include <type_traits>
+
+#include "../coords/batch.hpp"
+#include "../coords/types.hpp"
+#include "../coords/transforms.hpp"
+#include "../tensor/simd.hpp"
+#include "../tensor/matrix.hpp"
+#include "../tensor/vector.hpp"
+#include "../tensor/execution.hpp"
+
+namespace ccomms::dsp {
+
+/**
+ * @brief Precisions of the antenna array computations.
+ */
+template<typename T>
+concept array_precision = std::is_same_v<T, float> || std::is_same_v<T, double>;
+
+//************************************************** ANTENNA ARRAY *************************************************
+
+/**
+ * @class antenna_array
+ *
+ * @brief Steering vectors, beamforming weights and beam patterns of an array of antenna elements.
+ *
+ * @tparam T: Precision, float or double
+ *
+ * @ingroup dsp
+ *
+ * @details Element positions are local east, north, up coordinates in meters and directions are azimuth and
+ * elevation in degrees, following the coords module. The steering vector of a direction with unit vector d has the
+ * elements a_k = exp(j * 2 pi / wavelength * p_k . d), the phase of a plane wave arriving from d at element k relative
+ * to the origin. A beam with weights w has the response w^H a, so conventional weights a / K have unit gain towards
+ * their own direction.
+ * Positions are held as a cartesian batch already scaled by the wavenumber, so the phases of a direction across all
+ * elements are three elementwise SIMD operations followed by the SIMD sincos kernel. Pattern sweeps separate the
+ * phase over a grid, k_x cos(el) sin(az) + k_y cos(el) cos(az) + k_z sin(el), into sin/cos tables of the two grid
+ * axes computed once and a per element term folded into its weight, which leaves one multiply-add and one sincos per
+ * element and azimuth. Elevation rows are independent and run in parallel under an execution policy.
+ */
+template<array_precision T>
+class antenna_array {
+
+    using complex_type = std::complex<T>;
+
+    cartesian_batch<T> scaled;
+    T lambda;
+
+public:
+
+    //************************************************** CONSTRUCTORS **************************************************
+
+    /**
+     * @brief An array with elements at the given east, north, up positions in meters, operating at the given
+     * wavelength in meters.
+     */
+    antenna_array(const cartesian_batch<T> &positions, const T &wavelength) : lambda(wavelength) {
+        if (positions.empty())
+            throw std::invalid_argument("\nERR: antenna array requires at least one element\n");
+        if (!(wavelength > 0))
+            throw std::invalid_argument("\nERR: antenna array wavelength must be positive\n");
+
+        scaled = positions * static_cast<T>(2 * std::numbers::pi / static_cast<double>(wavelength));
+    }
+
+    //***************************************************** ACCESS *****************************************************
+
+    [[nodiscard]] std::size_t size() const { return scaled.size(); }
+
+    [[nodiscard]] T wavelength() const { return lambda; }
+
+    /**
+     * @brief Element positions in meters.
+     */
+    cartesian_batch<T> positions() const {
+        return scaled * static_cast<T>(static_cast<double>(lambda) / (2 * std::numbers::pi));
+    }
+
+    //************************************************ STEERING VECTORS ************************************************
+
+    vector<complex_type> steering(const spherical<T> &direction) const {
+        spherical_batch<T> single;
+        single.push_back(direction);
+        const matrix<complex_type> a = steering(single);
+        vector<complex_type> result(size(), complex_type(0));
+        std::copy(a.begin(), a.end(), result.begin());
+        return result;
+    }
+
+    /**
+     * @brief Steering vectors of a batch of directions, one direction per row and one element per column.
+     */
+    matrix<complex_type> steering(const spherical_batch<T> &directions) const {
+        const std::size_t n = directions.size();
+        const std::size_t k = size();
+        matrix<complex_type> result(n, k);
+
+        vector<T> sin_az(n, T(0)), cos_az(n, T(0)), sin_el(n, T(0)), cos_el(n, T(0));
+        sincos_degrees(sin_az, cos_az, directions.az());
+        sincos_degrees(sin_el, cos_el, directions.el());
+
+        vector<T> phase(k, T(0)), re(k, T(0)), im(k, T(0));
+        for (std::size_t d = 0; d < n; d++) {
+            phase = scaled.x() * (cos_el[d] * sin_az[d]) + scaled.y() * (cos_el[d] * cos_az[d]) +
+                    scaled.z() * sin_el[d];
+            simd::sincos(im.data(), re.data(), phase.data(), k);
+
+            complex_type *row = result.data() + d * k;
+            for (std::size_t i = 0; i < k; i++)
+                row[i] = complex_type(re[i], im[i]);
+        }
+        return result;
+    }
+
+    //***************************************************** WEIGHTS ****************************************************
+
+    /**
+     * @brief Delay-and-sum weights a / K, with unit gain towards direction.
+     */
+    vector<complex_type> conventional_weights(const spherical<T> &direction) const {
+        vector<complex_type> w = steering(direction);
+        const T scale = T(1) / static_cast<T>(size());
+        for (auto &value: w)
+            value *= scale;
+        return w;
+    }
+
+    matrix<complex_type> conventional_weights(const spherical_batch<T> &directions) const {
+        matrix<complex_type> w = steering(directions);
+        const T scale = T(1) / static_cast<T>(size());
+        for (auto &value: w)
+            value *= scale;
+        return w;
+    }
+
+    /**
+     * @brief Minimum variance distortionless response weights R^-1 a / (a^H R^-1 a), with unit gain towards direction
+     * and the least output power for the given element covariance.
+     *
+     * @details loading is added to the diagonal of the covariance before it is inverted, which keeps the weights
+     * stable when the covariance is estimated from few snapshots. The covariance has to be Hermitian positive
+     * definite once loaded.
+     */
+    vector<complex_type> mvdr_weights(const matrix<complex_type> &covariance, const spherical<T> &direction,
+                                      const T &loading = T(0)) const {
+        vector<complex_type> w = steering(direction);
+        const matrix<complex_type> l = cholesky(covariance, loading);
+        mvdr_solve(l, w.data());
+        return w;
+    }
+
+    /**
+     * @brief MVDR weights of a batch of directions, one direction per row. The covariance is factored once.
+     */
+    matrix<complex_type> mvdr_weights(const matrix<complex_type> &covariance, const spherical_batch<T> &directions,
+                                      const T &loading = T(0)) const {
+        matrix<complex_type> w = steering(directions);
+        const matrix<complex_type> l = cholesky(covariance, loading);
+        for (std::size_t d = 0; d < directions.size(); d++)
+            mvdr_solve(l, w.data() + d * size());
+        return w;
+    }
+
+    //*************************************************** BEAMFORMING **************************************************
+
+    /**
+     * @brief Beam output y = w^H X of snapshots holding one element per row and one sample per column.
+     */
+    vector<complex_type> beamform(const vector<complex_type> &weights, const matrix<complex_type> &snapshots) const {
+        check_weights(weights.size(), "beamforming");
+        if (snapshots.rows() != size())
+            throw std::invalid_argument("\nERR: beamforming requires one snapshot row per array element\n");
+
+        const std::size_t n = snapshots.cols();
+        vector<complex_type> y(n, complex_type(0));
+        for (std::size_t k = 0; k < size(); k++) {
+            const T wr = weights[k].real(), wi = weights[k].imag();
+            for (std::size_t t = 0; t < n; t++) {
+                const complex_type &x = snapshots(k, t);
+                y[t] += complex_type(wr * x.real() + wi * x.imag(), wr * x.imag() - wi * x.real());
+            }
+        }
+        return y;
+    }
+
+    //*************************************************** BEAM PATTERN *************************************************
+
+    /**
+     * @brief Power response |w^H a|^2 of the weights over a grid of directions, one elevation per row and one azimuth
+     * per column, with the rows split across the pool of the policy.
+     */
+    template<execution::policy P>
+    matrix<T> pattern(const P &policy, const vector<complex_type> &weights, const vector<T> &az,
+                      const vector<T> &el) const {
+        check_weights(weights.size(), "pattern");
+
+        const std::size_t k = size();
+        const std::size_t n_az = az.size();
+        matrix<T> result(el.size(), n_az);
+
+        vector<T> sin_az(n_az, T(0)), cos_az(n_az, T(0)), sin_el(el.size(), T(0)), cos_el(el.size(), T(0));
+        sincos_degrees(sin_az, cos_az, az);
+        sincos_degrees(sin_el, cos_el, el);
+
+        vector<T> w_re(k, T(0)), w_im(k, T(0));
+        for (std::size_t i = 0; i < k; i++) {
+            w_re[i] = weights[i].real();
+            w_im[i] = weights[i].imag();
+        }
+
+        execution::for_each_chunk(policy, el.size(), 1, [&](std::size_t first, std::size_t count) {
+            vector<T> g_re(k, T(0)), g_im(k, T(0)), s(k, T(0)), c(k, T(0));
+            vector<T> phase(n_az, T(0)), sn(n_az, T(0)), cs(n_az, T(0)), re(n_az, T(0)), im(n_az, T(0));
+
+            for (std::size_t row = first; row < first + count; row++) {
+                // The elevation term of every element folded into its conjugated weight: g = conj(w) exp(j k_z sin(el))
+                phase = scaled.z() * sin_el[row];
+                simd::sincos(s.data(), c.data(), phase.data(), k);
+                g_re = w_re * c + w_im * s;
+                g_im = w_re * s - w_im * c;
+
+                std::fill(re.begin(), re.end(), T(0));
+                std::fill(im.begin(), im.end(), T(0));
+                for (std::size_t i = 0; i < k; i++) {
+                    phase = sin_az * (scaled.x()[i] * cos_el[row]);
+                    simd::axpy(phase.data(), scaled.y()[i] * cos_el[row], cos_az.data(), n_az);
+                    simd::sincos(sn.data(), cs.data(), phase.data(), n_az);
+
+                    simd::axpy(re.data(), g_re[i], cs.data(), n_az);
+                    simd::axpy(re.data(), -g_im[i], sn.data(), n_az);
+                    simd::axpy(im.data(), g_re[i], sn.data(), n_az);
+                    simd::axpy(im.data(), g_im[i], cs.data(), n_az);
+                }
+                simd::split_norm(result.data() + row * n_az, re.data(), im.data(), n_az);
+            }
+        });
+        return result;
+    }
+
+    matrix<T> pattern(const vector<complex_type> &weights, const vector<T> &az, const vector<T> &el) const {
+        return pattern(execution::par, weights, az, el);
+    }
+
+private:
+
+    void check_weights(const std::size_t &len, const std::string &name) const {
+        if (len != size())
+            throw std::invalid_argument("\nERR: " + name + " requires one weight per array element\n");
+    }
+
+    static void sincos_degrees(vector<T> &s, vector<T> &c, const vector<T> &angles) {
+        vector<T> radians = angles * static_cast<T>(deg_to_rad);
+        simd::sincos(s.data(), c.data(), radians.data(), radians.size());
+    }
+
+    /**
+     * @brief Lower triangular L with L L^H equal to the covariance plus loading on the diagonal.
+     */
+    matrix<complex_type> cholesky(const matrix<complex_type> &covariance, const T &loading) const {
+        const std::size_t k = size();
+        if (covariance.rows() != k || covariance.cols() != k)
+            throw std::invalid_argument("\nERR: MVDR covariance must be square with one row per array element\n");
+
+        matrix<complex_type> l(k, k);
+        for (std::size_t j = 0; j < k; j++) {
+            T diagonal = covariance(j, j).real() + loading;
+            for (std::size_t p = 0; p < j; p++)
+                diagonal -= std::norm(l(j, p));
+            if (!(diagonal > 0))
+                throw std::invalid_argument("\nERR: MVDR covariance must be positive definite\n");
+
+            const T root = std::sqrt(diagonal);
+            l(j, j) = root;
+            for (std::size_t i = j + 1; i < k; i++) {
+                complex_type sum = covariance(i, j);
+                for (std::size_t p = 0; p < j; p++)
+                    sum -= l(i, p) * std::conj(l(j, p));
+                l(i, j) = sum / root;
+            }
+        }
+        return l;
+    }
+
+    /**
+     * @brief Replaces the steering vector a with R^-1 a / (a^H R^-1 a), given the Cholesky factor of R.
+     */
+    void mvdr_solve(const matrix<complex_type> &l, complex_type *a) const {
+        const std::size_t k = size();
+        vector<complex_type> v(k, complex_type(0));
+        std::copy(a, a + k, v.begin());
+
+        // L y = a, then L^H v = y
+        for (std::size_t i = 0; i < k; i++) {
+            complex_type sum = v[i];
+            for (std::size_t p = 0; p < i; p++)
+                sum -= l(i, p) * v[p];
+            v[i] = sum / l(i, i).real();
+        }
+        for (std::size_t i = k; i-- > 0;) {
+            complex_type sum = v[i];
+            for (std::size_t p = i + 1; p < k; p++)
+                sum -= std::conj(l(p, i)) * v[p];
+            v[i] = sum / l(i, i).real();
+        }
+
+        complex_type gain(0);
+        for (std::size_t i = 0; i < k; i++)
+            gain += std::conj(a[i]) * v[i];
+        for (std::size_t i = 0; i < k; i++)
+            a[i] = v[i] / gain.real();
+    }
+};
+
+}
+
+#endif // CCOMMS_MODULES_DSP_BEAMFORMING_HPP_
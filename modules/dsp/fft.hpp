@@ -0,0 +1,554 @@
+// Copyright(c) 2023, Matthew Petrin, All rights reserved.
+
+#ifndef CCOMMS_MODULES_DSP_FFT_HPP_
+#define CCOMMS_MODULES_DSP_FFT_HPP_
+
+#include <cmath>
+#include <mutex>
+#include <numbers>
+#include <memory>
+#include <vector>
+#include <complex>
+#include <cstddef>
+#include <algorithm>
+#include <stdexcept>
+#include <type_traits>
+#include <unordered_map>
+
+#include "../tensor/simd.hpp"
+#include "../tensor/view.hpp"
+#include "../tensor/vector.hpp"
+
+namespace ccomms::dsp {
+
+/**
+ * @brief Sample precisions with FFT plans.
+ */
+template<typename T>
+concept fft_precision = std::is_same_v<T, float> || std::is_same_v<T, double>;
+
+/**
+ * @brief Contiguous buffers of std::complex<float> or std::complex<double> samples, such as a vector, a non-strided
+ * vector_view or a std::vector.
+ */
+template<typename V>
+concept complex_signal = simd::contiguous<std::remove_cvref_t<V> > &&
+                         is_complex_v<typename std::remove_cvref_t<V>::value_type> &&
+                         fft_precision<typename std::remove_cvref_t<V>::value_type::value_type>;
+
+/**
+ * @brief Contiguous buffers of float or double samples.
+ */
+template<typename V>
+concept real_signal = simd::contiguous<std::remove_cvref_t<V> > &&
+                      fft_precision<std::remove_cv_t<typename std::remove_cvref_t<V>::value_type> >;
+
+/**
+ * @brief Buffers whose elements can be written through data().
+ */
+template<typename V>
+concept writable = requires(V &v) {
+    { v.data() } -> std::convertible_to<std::remove_cv_t<typename std::remove_cvref_t<V>::value_type> *>;
+};
+
+//****************************************************** PLANS *****************************************************
+
+/**
+ * @class fft_plan
+ *
+ * @brief Precomputed factorization and twiddle factors of a complex FFT of one length.
+ *
+ * @tparam T: float or double, the precision of the std::complex samples
+ *
+ * @ingroup dsp
+ *
+ * @details The transform runs as a sequence of Stockham autosort stages, one per factor of the length: radix 4 while
+ * the length divides by 4, one radix 2 stage for a remaining factor of 2, then the odd prime factors. Stockham stages
+ * read one buffer and write another, so the output comes out in natural order with no bit reversal pass; the stages
+ * alternate between the output and a per-thread scratch buffer. Radix 2 and 4 stages run on the SIMD butterflies of
+ * the tensor module and radix 3 and 5 stages on dedicated scalar butterflies. Larger prime factors use a generic
+ * butterfly whose cost grows with the radix, so such lengths are supported but slow.
+ * Plans are immutable once built and can be shared between threads. cached() keeps one plan per length for the life
+ * of the program.
+ */
+template<fft_precision T>
+class fft_plan {
+
+    using complex_type = std::complex<T>;
+
+    struct stage {
+        std::size_t radix;
+        std::size_t length;
+        std::size_t stride;
+        std::size_t twiddles;
+        std::size_t roots;
+    };
+
+    std::size_t len;
+    std::vector<stage> stages;
+    std::vector<complex_type> table;
+
+public:
+
+    /**
+     * @param n: Transform length, any positive value
+     */
+    explicit fft_plan(const std::size_t &n) : len(n) {
+        if (n == 0)
+            throw std::invalid_argument("\nERR: fft plan length must be positive\n");
+
+        std::size_t length = n, stride = 1;
+        for (const std::size_t &radix: factorize(n)) {
+            stage s{radix, length, stride, table.size(), 0};
+
+            // Twiddles exp(-2 pi i p k / length) for every butterfly p and output k > 0
+            for (std::size_t p = 0; p < length / radix; p++)
+                for (std::size_t k = 1; k < radix; k++)
+                    table.push_back(root(p * k, length));
+
+            // Generic butterflies also need the radix-th roots of unity
+            if (radix > 5) {
+                s.roots = table.size();
+                for (std::size_t j = 0; j < radix; j++)
+                    table.push_back(root(j, radix));
+            }
+
+            stages.push_back(s);
+            length /= radix;
+            stride *= radix;
+        }
+    }
+
+    /**
+     * @brief Shared plan for a length, built on first use.
+     */
+    static std::shared_ptr<const fft_plan> cached(const std::size_t &n) {
+        static std::mutex lock;
+        static std::unordered_map<std::size_t, std::shared_ptr<const fft_plan> > plans;
+
+        std::lock_guard<std::mutex> guard(lock);
+        auto &plan = plans[n];
+        if (!plan)
+            plan = std::make_shared<const fft_plan>(n);
+        return plan;
+    }
+
+    [[nodiscard]] std::size_t size() const { return len; }
+
+    /**
+     * @brief Radices of the stages, in the order they run.
+     */
+    [[nodiscard]] std::vector<std::size_t> radices() const {
+        std::vector<std::size_t> result;
+        for (const auto &s: stages)
+            result.push_back(s.radix);
+        return result;
+    }
+
+    /**
+     * @brief Unnormalized forward transform, out[k] = sum of in[j] exp(-2 pi i j k / n). in and out hold n samples
+     * and are either the same buffer or do not overlap.
+     */
+    void forward(const complex_type *in, complex_type *out) const { execute<false>(in, out); }
+
+    /**
+     * @brief Inverse transform scaled by 1 / n, so that inverse(forward(x)) reproduces x.
+     */
+    void inverse(const complex_type *in, complex_type *out) const { execute<true>(in, out); }
+
+private:
+
+    static std::vector<std::size_t> factorize(std::size_t n) {
+        std::vector<std::size_t> factors;
+        while (n % 4 == 0) {
+            factors.push_back(4);
+            n /= 4;
+        }
+        if (n % 2 == 0) {
+            factors.push_back(2);
+            n /= 2;
+        }
+        for (std::size_t f = 3; f * f <= n; f += 2)
+            while (n % f == 0) {
+                factors.push_back(f);
+                n /= f;
+            }
+        if (n > 1)
+            factors.push_back(n);
+        return factors;
+    }
+
+    // exp(-2 pi i k / n), evaluated in double precision on the reduced angle
+    static complex_type root(const std::size_t &k, const std::size_t &n) {
+        const double angle = -2.0 * std::numbers::pi * static_cast<double>(k % n) / static_cast<double>(n);
+        return {static_cast<T>(std::cos(angle)), static_cast<T>(std::sin(angle))};
+    }
+
+    static complex_type *scratch(const std::size_t &n) {
+        thread_local std::vector<complex_type> buffer;
+        if (buffer.size() < n)
+            buffer.resize(n);
+        return buffer.data();
+    }
+
+    // z multiplied by -i for the forward transform and by i for the inverse
+    template<bool Inverse>
+    static complex_type rotate(const complex_type &z) {
+        return Inverse ? complex_type(-z.imag(), z.real()) : complex_type(z.imag(), -z.real());
+    }
+
+    template<bool Inverse>
+    void radix3_stage(const stage &s, const complex_type *x, complex_type *y) const {
+        const T sin60 = static_cast<T>(std::sqrt(3.0) / 2);
+        const std::size_t m = s.length / 3;
+        const complex_type *tw = table.data() + s.twiddles;
+
+        for (std::size_t p = 0; p < m; p++) {
+            const complex_type w1 = simd::scalar::twiddle<Inverse>(tw[2 * p]);
+            const complex_type w2 = simd::scalar::twiddle<Inverse>(tw[2 * p + 1]);
+            const complex_type *a0 = x + s.stride * p, *a1 = a0 + s.stride * m, *a2 = a1 + s.stride * m;
+            complex_type *y0 = y + s.stride * 3 * p, *y1 = y0 + s.stride, *y2 = y1 + s.stride;
+
+            for (std::size_t q = 0; q < s.stride; q++) {
+                const complex_type t1 = a1[q] + a2[q];
+                const complex_type t2 = a0[q] - t1 * T(0.5);
+                const complex_type t3 = rotate<Inverse>((a1[q] - a2[q]) * sin60);
+                y0[q] = a0[q] + t1;
+                y1[q] = simd::scalar::cmul(t2 + t3, w1);
+                y2[q] = simd::scalar::cmul(t2 - t3, w2);
+            }
+        }
+    }
+
+    template<bool Inverse>
+    void radix5_stage(const stage &s, const complex_type *x, complex_type *y) const {
+        constexpr double angle = 2 * std::numbers::pi / 5;
+        const T c1 = static_cast<T>(std::cos(angle)), c2 = static_cast<T>(std::cos(2 * angle));
+        const T s1 = static_cast<T>(std::sin(angle)), s2 = static_cast<T>(std::sin(2 * angle));
+        const std::size_t m = s.length / 5;
+        const complex_type *tw = table.data() + s.twiddles;
+
+        for (std::size_t p = 0; p < m; p++) {
+            complex_type w[4];
+            for (std::size_t k = 0; k < 4; k++)
+                w[k] = simd::scalar::twiddle<Inverse>(tw[4 * p + k]);
+            const complex_type *a0 = x + s.stride * p, *a1 = a0 + s.stride * m, *a2 = a1 + s.stride * m,
+                    *a3 = a2 + s.stride * m, *a4 = a3 + s.stride * m;
+            complex_type *y0 = y + s.stride * 5 * p, *y1 = y0 + s.stride, *y2 = y1 + s.stride, *y3 = y2 + s.stride,
+                    *y4 = y3 + s.stride;
+
+            for (std::size_t q = 0; q < s.stride; q++) {
+                const complex_type t1 = a1[q] + a4[q], t2 = a2[q] + a3[q], t3 = a1[q] - a4[q], t4 = a2[q] - a3[q];
+                const complex_type r1 = a0[q] + t1 * c1 + t2 * c2, r2 = a0[q] + t1 * c2 + t2 * c1;
+                const complex_type i1 = rotate<Inverse>(t3 * s1 + t4 * s2), i2 = rotate<Inverse>(t3 * s2 - t4 * s1);
+                y0[q] = a0[q] + t1 + t2;
+                y1[q] = simd::scalar::cmul(r1 + i1, w[0]);
+                y2[q] = simd::scalar::cmul(r2 + i2, w[1]);
+                y3[q] = simd::scalar::cmul(r2 - i2, w[2]);
+                y4[q] = simd::scalar::cmul(r1 - i1, w[3]);
+            }
+        }
+    }
+
+    template<bool Inverse>
+    void generic_stage(const stage &s, const complex_type *x, complex_type *y) const {
+        const std::size_t r = s.radix, m = s.length / r;
+        const complex_type *tw = table.data() + s.twiddles;
+        const complex_type *roots = table.data() + s.roots;
+        std::vector<complex_type> a(r);
+
+        for (std::size_t p = 0; p < m; p++)
+            for (std::size_t q = 0; q < s.stride; q++) {
+                for (std::size_t j = 0; j < r; j++)
+                    a[j] = x[q + s.stride * (p + j * m)];
+
+                for (std::size_t k = 0; k < r; k++) {
+                    complex_type sum = a[0];
+                    for (std::size_t j = 1, jk = k; j < r; j++, jk = jk + k >= r ? jk + k - r : jk + k)
+                        sum += simd::scalar::cmul(a[j], simd::scalar::twiddle<Inverse>(roots[jk]));
+                    if (k > 0)
+                        sum = simd::scalar::cmul(sum, simd::scalar::twiddle<Inverse>(tw[p * (r - 1) + k - 1]));
+                    y[q + s.stride * (r * p + k)] = sum;
+                }
+            }
+    }
+
+    template<bool Inverse>
+    void execute(const complex_type *in, complex_type *out) const {
+        if (stages.empty()) {
+            out[0] = in[0];
+            return;
+        }
+
+        complex_type *work = scratch(len);
+        const complex_type *src = in;
+
+        // The last stage has to land in out. An in-place transform with an odd number of stages would have the first
+        // stage overwrite its own input, so that input is moved aside first.
+        if (in == out && stages.size() % 2 == 1) {
+            std::copy(in, in + len, work);
+            src = work;
+        }
+
+        for (std::size_t i = 0; i < stages.size(); i++) {
+            const stage &s = stages[i];
+            complex_type *dst = (stages.size() - 1 - i) % 2 == 0 ? out : work;
+
+            if (s.radix == 4)
+                simd::fft_radix4<Inverse>(src, dst, s.length, s.stride, table.data() + s.twiddles);
+            else if (s.radix == 2)
+                simd::fft_radix2<Inverse>(src, dst, s.length, s.stride, table.data() + s.twiddles);
+            else if (s.radix == 3)
+                radix3_stage<Inverse>(s, src, dst);
+            else if (s.radix == 5)
+                radix5_stage<Inverse>(s, src, dst);
+            else
+                generic_stage<Inverse>(s, src, dst);
+            src = dst;
+        }
+
+        if constexpr (Inverse) {
+            const T scale = T(1) / static_cast<T>(len);
+            auto *values = reinterpret_cast<T *>(out);
+            simd::transform<ops::mul, false, true>(values, values, &scale, 2 * len);
+        }
+    }
+};
+
+/**
+ * @class real_fft_plan
+ *
+ * @brief FFT of real samples, returning the n / 2 + 1 non-redundant bins of the Hermitian spectrum.
+ *
+ * @tparam T: float or double
+ *
+ * @ingroup dsp
+ *
+ * @details An even length n is transformed by packing the even and odd samples into the real and imaginary parts of a
+ * complex sequence of length n / 2, transforming that, and separating the two spectra with one pass of twiddles, at
+ * about half the cost of the complex transform. Odd lengths fall back to the complex transform of length n.
+ */
+template<fft_precision T>
+class real_fft_plan {
+
+    using complex_type = std::complex<T>;
+
+    std::size_t len;
+    std::shared_ptr<const fft_plan<T> > complex_plan;
+    std::vector<complex_type> twiddles;
+
+public:
+
+    explicit real_fft_plan(const std::size_t &n) : len(n) {
+        if (n == 0)
+            throw std::invalid_argument("\nERR: fft plan length must be positive\n");
+
+        complex_plan = fft_plan<T>::cached(packed() ? n / 2 : n);
+        if (packed())
+            for (std::size_t k = 0; k < n / 2; k++) {
+                const double angle = -2.0 * std::numbers::pi * static_cast<double>(k) / static_cast<double>(n);
+                twiddles.emplace_back(static_cast<T>(std::cos(angle)), static_cast<T>(std::sin(angle)));
+            }
+    }
+
+    static std::shared_ptr<const real_fft_plan> cached(const std::size_t &n) {
+        static std::mutex lock;
+        static std::unordered_map<std::size_t, std::shared_ptr<const real_fft_plan> > plans;
+
+        std::lock_guard<std::mutex> guard(lock);
+        auto &plan = plans[n];
+        if (!plan)
+            plan = std::make_shared<const real_fft_plan>(n);
+        return plan;
+    }
+
+    [[nodiscard]] std::size_t size() const { return len; }
+
+    /**
+     * @brief Number of spectrum bins, n / 2 + 1.
+     */
+    [[nodiscard]] std::size_t bins() const { return len / 2 + 1; }
+
+    /**
+     * @brief Unnormalized forward transform of n real samples into bins() complex bins. in and out must not overlap.
+     */
+    void forward(const T *in, complex_type *out) const {
+        if (!packed()) {
+            complex_type *buffer = scratch(len);
+            std::copy(in, in + len, buffer);
+            complex_plan->forward(buffer, buffer);
+            std::copy(buffer, buffer + bins(), out);
+            return;
+        }
+
+        // The real samples already have the memory layout of the packed complex sequence
+        const std::size_t m = len / 2;
+        complex_plan->forward(reinterpret_cast<const complex_type *>(in), out);
+
+        const complex_type z0 = out[0];
+        out[0] = {z0.real() + z0.imag(), T(0)};
+        out[m] = {z0.real() - z0.imag(), T(0)};
+
+        for (std::size_t k = 1; k <= m - k; k++) {
+            const complex_type zk = out[k], zm = out[m - k];
+            const complex_type even = (zk + std::conj(zm)) * T(0.5);
+            const complex_type diff = (zk - std::conj(zm)) * T(0.5);
+            const complex_type odd = simd::scalar::cmul(complex_type(diff.imag(), -diff.real()), twiddles[k]);
+            out[k] = even + odd;
+            if (k != m - k)
+                out[m - k] = std::conj(even - odd);
+        }
+    }
+
+    /**
+     * @brief Inverse transform of bins() complex bins into n real samples, scaled by 1 / n so that it reproduces the
+     * input of forward(). The imaginary parts of the bins that must be real for a real signal are ignored. in and
+     * out must not overlap.
+     */
+    void inverse(const complex_type *in, T *out) const {
+        if (!packed()) {
+            complex_type *buffer = scratch(len);
+            for (std::size_t k = 0; k < bins(); k++)
+                buffer[k] = in[k];
+            for (std::size_t k = bins(); k < len; k++)
+                buffer[k] = std::conj(in[len - k]);
+            complex_plan->inverse(buffer, buffer);
+            for (std::size_t j = 0; j < len; j++)
+                out[j] = buffer[j].real();
+            return;
+        }
+
+        const std::size_t m = len / 2;
+        auto *packed_out = reinterpret_cast<complex_type *>(out);
+        for (std::size_t k = 0; k < m; k++) {
+            const complex_type even = (in[k] + std::conj(in[m - k])) * T(0.5);
+            const complex_type odd = simd::scalar::cmul((in[k] - std::conj(in[m - k])) * T(0.5),
+                                                        std::conj(twiddles[k]));
+            packed_out[k] = even + complex_type(-odd.imag(), odd.real());
+        }
+        complex_plan->inverse(packed_out, packed_out);
+    }
+
+private:
+
+    [[nodiscard]] bool packed() const { return len % 2 == 0; }
+
+    static complex_type *scratch(const std::size_t &n) {
+        thread_local std::vector<complex_type> buffer;
+        if (buffer.size() < n)
+            buffer.resize(n);
+        return buffer.data();
+    }
+};
+
+//**************************************************** TRANSFORMS **************************************************
+
+/**
+ * @brief Forward FFT of x into out, both contiguous complex buffers of the same length. out may be x itself.
+ */
+template<complex_signal V, complex_signal W>
+requires writable<W> && std::is_same_v<std::remove_cv_t<typename std::remove_cvref_t<V>::value_type>,
+                                       typename std::remove_cvref_t<W>::value_type>
+W &&fft(const V &x, W &&out) {
+    using T = typename std::remove_cvref_t<W>::value_type::value_type;
+
+    if (out.size() != x.size())
+        throw std::invalid_argument("\nERR: fft output must have the same length as the input\n");
+    if (x.size() > 0)
+        fft_plan<T>::cached(x.size())->forward(x.data(), out.data());
+    return std::forward<W>(out);
+}
+
+/**
+ * @brief Inverse FFT of x into out, scaled by 1 / n. out may be x itself.
+ */
+template<complex_signal V, complex_signal W>
+requires writable<W> && std::is_same_v<std::remove_cv_t<typename std::remove_cvref_t<V>::value_type>,
+                                       typename std::remove_cvref_t<W>::value_type>
+W &&ifft(const V &x, W &&out) {
+    using T = typename std::remove_cvref_t<W>::value_type::value_type;
+
+    if (out.size() != x.size())
+        throw std::invalid_argument("\nERR: ifft output must have the same length as the input\n");
+    if (x.size() > 0)
+        fft_plan<T>::cached(x.size())->inverse(x.data(), out.data());
+    return std::forward<W>(out);
+}
+
+/**
+ * @brief Forward FFT of x, returned as a new vector with the same static length.
+ */
+template<complex_signal V>
+auto fft(const V &x) {
+    using C = std::remove_cv_t<typename V::value_type>;
+    vector<C, static_extent_v<V> > result(x.size(), C(0));
+    fft(x, result);
+    return result;
+}
+
+/**
+ * @brief Inverse FFT of x scaled by 1 / n, returned as a new vector with the same static length.
+ */
+template<complex_signal V>
+auto ifft(const V &x) {
+    using C = std::remove_cv_t<typename V::value_type>;
+    vector<C, static_extent_v<V> > result(x.size(), C(0));
+    ifft(x, result);
+    return result;
+}
+
+/**
+ * @brief Forward FFT overwriting x.
+ */
+template<complex_signal V>
+requires writable<V>
+V &&fft_in_place(V &&x) {
+    return fft(x, std::forward<V>(x));
+}
+
+/**
+ * @brief Inverse FFT scaled by 1 / n, overwriting x.
+ */
+template<complex_signal V>
+requires writable<V>
+V &&ifft_in_place(V &&x) {
+    return ifft(x, std::forward<V>(x));
+}
+
+/**
+ * @brief Spectrum of real samples: the n / 2 + 1 bins from 0 up to the Nyquist frequency. A fixed length input gives
+ * a fixed length spectrum.
+ */
+template<real_signal V>
+auto rfft(const V &x) {
+    using T = std::remove_cv_t<typename V::value_type>;
+    constexpr std::size_t N = static_extent_v<V>;
+
+    if (x.size() == 0)
+        throw std::invalid_argument("\nERR: rfft requires a non-empty input\n");
+
+    const auto plan = real_fft_plan<T>::cached(x.size());
+    vector<std::complex<T>, N == 0 ? 0 : N / 2 + 1> result(plan->bins(), std::complex<T>(0));
+    plan->forward(x.data(), result.data());
+    return result;
+}
+
+/**
+ * @brief Real samples of length n from the n / 2 + 1 bins of their spectrum, scaled by 1 / n so that
+ * irfft(rfft(x), x.size()) reproduces x.
+ */
+template<complex_signal V>
+auto irfft(const V &spectrum, const std::size_t &n) {
+    using T = typename std::remove_cv_t<typename V::value_type>::value_type;
+
+    if (n == 0 || spectrum.size() != n / 2 + 1)
+        throw std::invalid_argument("\nERR: irfft requires n / 2 + 1 bins for an output of length n\n");
+
+    vector<T> result(n, T(0));
+    real_fft_plan<T>::cached(n)->inverse(spectrum.data(), result.data());
+    return result;
+}
+
+}
+
+#endif // CCOMMS_MODULES_DSP_FFT_HPP_
@@ -0,0 +1,313 @@
+// Copyright(c) 2023, Matthew Petrin, All rights reserved.
+
+#ifndef CCOMMS_MODULES_DSP_FIR_HPP_
+#define CCOMMS_MODULES_DSP_FIR_HPP_
+
+#include <array>
+#include <vector>
+#include <numeric>
+#include <complex>
+#include <cstddef>
+#include <algorithm>
+#include <stdexcept>
+#include <type_traits>
+
+#include "../tensor/simd.hpp"
+#include "../tensor/vector.hpp"
+#include "../tensor/expression.hpp"
+
+namespace ccomms::dsp {
+
+/**
+ * @brief Sample and tap types of the filters: float, double and their complex counterparts.
+ */
+template<typename T>
+concept filter_value = std::is_same_v<T, float> || std::is_same_v<T, double> ||
+                       std::is_same_v<T, std::complex<float> > || std::is_same_v<T, std::complex<double> >;
+
+template<typename T>
+struct real_part_type {
+    using type = T;
+};
+
+template<typename T>
+struct real_part_type<std::complex<T> > {
+    using type = T;
+};
+
+template<typename T>
+using real_part_t = typename real_part_type<T>::type;
+
+//**************************************************** RESAMPLER ***************************************************
+
+/**
+ * @class resampler
+ *
+ * @brief Streaming polyphase FIR filter that changes the sample rate by the rational factor up / down.
+ *
+ * @tparam S: Sample type, float, double or complex
+ * @tparam C: Tap type of the same precision as S, real or complex
+ *
+ * @ingroup dsp
+ *
+ * @details The taps are those of a single filter running at up times the input rate. They are split into up
+ * polyphase branches of ceil(taps / up) taps each, so every output costs one branch's worth of multiplies and the
+ * samples zero-stuffed in by interpolation or discarded by decimation are never computed. The taps are applied as
+ * given: an interpolating filter needs a passband gain of up to keep the signal level.
+ * Filter history and the position between calls are kept in the object, so a stream can be fed in blocks of any size,
+ * including one sample at a time, with the same result as one long call. Samples pass through a delay line allocated
+ * at construction and held as separate real and imaginary planes. The outputs of a block that share a branch are
+ * computed together by the SIMD fir kernel, which vectorizes across outputs when their windows are adjacent.
+ * Inputs only have to be indexable, which includes strided views and ring buffers; processing never allocates except
+ * in the overloads returning a new vector.
+ * fir_filter, decimator and interpolator are the cases with one of the factors equal to 1.
+ */
+template<filter_value S, filter_value C = real_part_t<S> >
+requires std::is_same_v<real_part_t<S>, real_part_t<C> >
+class resampler {
+
+    using R = real_part_t<S>;
+
+    static constexpr std::size_t sample_planes = is_complex_v<S> ? 2 : 1;
+    static constexpr std::size_t tap_planes = is_complex_v<C> ? 3 : 1;
+
+public:
+
+    using sample_type = S;
+    using tap_type = C;
+    using value_type = std::conditional_t<is_complex_v<S> || is_complex_v<C>, std::complex<R>, R>;
+
+private:
+
+    static constexpr std::size_t output_planes = is_complex_v<value_type> ? 2 : 1;
+
+    std::size_t up_factor;
+    std::size_t down_factor;
+    std::size_t period;
+    std::size_t step;
+    std::size_t branch;
+    std::size_t block;
+    vector<C> coefficients;
+
+    // Branch p holds taps p, p + up, p + 2 up, ... in reverse order, zero padded to the branch length. Complex taps
+    // are split into real, imaginary and negated imaginary planes.
+    std::array<std::vector<R>, tap_planes> branches;
+
+    // History of branch - 1 samples followed by room for one block of input
+    std::array<std::vector<R>, sample_planes> line;
+
+    // Outputs of one block
+    std::array<std::vector<R>, output_planes> results;
+
+    // Position of the next output in upsampled samples, relative to the first sample of the next input
+    std::size_t offset = 0;
+
+public:
+
+    /**
+     * @param taps: Filter taps at up times the input rate
+     * @param up: Interpolation factor
+     * @param down: Decimation factor
+     * @param block: Input samples moved through the delay line at a time
+     */
+    resampler(const vector<C> &taps, const std::size_t &up, const std::size_t &down, const std::size_t &block = 1024)
+            : up_factor(up), down_factor(down), coefficients(taps) {
+        if (taps.size() == 0)
+            throw std::invalid_argument("\nERR: filter requires at least one tap\n");
+        if (up == 0 || down == 0)
+            throw std::invalid_argument("\nERR: resampling factors must be positive\n");
+
+        // Outputs whose index differs by a multiple of period use the same branch, on windows step samples apart
+        period = up / std::gcd(up, down);
+        step = down / std::gcd(up, down);
+        branch = (taps.size() + up - 1) / up;
+        this->block = std::max(block, 4 * branch);
+
+        for (auto &plane: branches)
+            plane.assign(up * branch, R(0));
+        for (std::size_t p = 0; p < up; p++)
+            for (std::size_t k = 0; k * up + p < taps.size(); k++) {
+                const std::size_t i = p * branch + branch - 1 - k;
+                if constexpr (is_complex_v<C>) {
+                    branches[0][i] = taps[k * up + p].real();
+                    branches[1][i] = taps[k * up + p].imag();
+                    branches[2][i] = -taps[k * up + p].imag();
+                } else {
+                    branches[0][i] = taps[k * up + p];
+                }
+            }
+
+        for (auto &plane: line)
+            plane.assign(branch - 1 + this->block, R(0));
+        for (auto &plane: results)
+            plane.assign(this->block * up / down + 1, R(0));
+    }
+
+    [[nodiscard]] const vector<C> &taps() const { return coefficients; }
+
+    [[nodiscard]] std::size_t up() const { return up_factor; }
+
+    [[nodiscard]] std::size_t down() const { return down_factor; }
+
+    /**
+     * @brief Number of outputs the next call with n input samples produces.
+     */
+    [[nodiscard]] std::size_t output_size(const std::size_t &n) const {
+        const std::size_t span = n * up_factor;
+        return offset < span ? (span - offset + down_factor - 1) / down_factor : 0;
+    }
+
+    /**
+     * @brief Clears the filter history and restarts the output phase.
+     */
+    void reset() {
+        for (auto &plane: line)
+            std::fill(plane.begin(), plane.end(), R(0));
+        offset = 0;
+    }
+
+    /**
+     * @brief Filters a block of input into out, which must hold at least output_size(in.size()) elements.
+     *
+     * @return The number of outputs written
+     */
+    template<typename V, typename W>
+    requires indexable<V> && indexable<std::remove_cvref_t<W> >
+    std::size_t process(const V &in, W &&out) {
+        using O = typename std::remove_cvref_t<W>::value_type;
+
+        if (out.size() < output_size(in.size()))
+            throw std::invalid_argument("\nERR: filter output holds fewer elements than the input produces\n");
+
+        std::size_t written = 0;
+        for (std::size_t first = 0; first < in.size(); first += block) {
+            const std::size_t len = std::min(block, in.size() - first);
+            const std::size_t count = output_size(len);
+
+            load(in, first, len);
+            filter(count);
+
+            for (std::size_t j = 0; j < count; j++) {
+                if constexpr (output_planes == 2)
+                    out[written + j] = static_cast<O>(value_type(results[0][j], results[1][j]));
+                else
+                    out[written + j] = static_cast<O>(results[0][j]);
+            }
+
+            written += count;
+            offset = offset + count * down_factor - len * up_factor;
+            retain(len);
+        }
+        return written;
+    }
+
+    /**
+     * @brief Filters a block of input into a new vector.
+     */
+    template<typename V>
+    requires indexable<V>
+    vector<value_type> process(const V &in) {
+        vector<value_type> result(output_size(in.size()), value_type(0));
+        process(in, result);
+        return result;
+    }
+
+private:
+
+    template<typename V>
+    void load(const V &in, const std::size_t &first, const std::size_t &len) {
+        R *re = line[0].data() + branch - 1;
+        if constexpr (is_complex_v<S>) {
+            R *im = line[1].data() + branch - 1;
+            for (std::size_t i = 0; i < len; i++) {
+                const S sample = static_cast<S>(in[first + i]);
+                re[i] = sample.real();
+                im[i] = sample.imag();
+            }
+        } else {
+            for (std::size_t i = 0; i < len; i++)
+                re[i] = static_cast<S>(in[first + i]);
+        }
+    }
+
+    // Keeps the last branch - 1 samples as history for the next block
+    void retain(const std::size_t &len) {
+        for (auto &plane: line)
+            std::copy(plane.begin() + static_cast<std::ptrdiff_t>(len),
+                      plane.begin() + static_cast<std::ptrdiff_t>(len + branch - 1), plane.begin());
+    }
+
+    // Computes the count outputs of the loaded block, one branch at a time
+    void filter(const std::size_t &count) {
+        for (std::size_t c = 0; c < std::min(period, count); c++) {
+            const std::size_t u = offset + c * down_factor;
+            const std::size_t n = (count - c + period - 1) / period;
+            const std::size_t at = (u % up_factor) * branch;
+            const R *x = line[0].data() + u / up_factor;
+
+            if constexpr (is_complex_v<S> && is_complex_v<C>) {
+                const R *y = line[1].data() + u / up_factor;
+                simd::fir(branches[0].data() + at, branch, x, step, results[0].data() + c, period, n);
+                simd::fir<true>(branches[2].data() + at, branch, y, step, results[0].data() + c, period, n);
+                simd::fir(branches[0].data() + at, branch, y, step, results[1].data() + c, period, n);
+                simd::fir<true>(branches[1].data() + at, branch, x, step, results[1].data() + c, period, n);
+            } else if constexpr (is_complex_v<S>) {
+                const R *y = line[1].data() + u / up_factor;
+                simd::fir(branches[0].data() + at, branch, x, step, results[0].data() + c, period, n);
+                simd::fir(branches[0].data() + at, branch, y, step, results[1].data() + c, period, n);
+            } else if constexpr (is_complex_v<C>) {
+                simd::fir(branches[0].data() + at, branch, x, step, results[0].data() + c, period, n);
+                simd::fir(branches[1].data() + at, branch, x, step, results[1].data() + c, period, n);
+            } else {
+                simd::fir(branches[0].data() + at, branch, x, step, results[0].data() + c, period, n);
+            }
+        }
+    }
+};
+
+//****************************************************** FILTERS ***************************************************
+
+/**
+ * @class fir_filter
+ *
+ * @brief Streaming FIR filter producing one output per input sample.
+ *
+ * @ingroup dsp
+ */
+template<filter_value S, filter_value C = real_part_t<S> >
+class fir_filter : public resampler<S, C> {
+public:
+    explicit fir_filter(const vector<C> &taps, const std::size_t &block = 1024) : resampler<S, C>(taps, 1, 1, block) {}
+};
+
+/**
+ * @class decimator
+ *
+ * @brief Streaming FIR filter keeping one output in every factor, computing only the outputs it keeps.
+ *
+ * @ingroup dsp
+ */
+template<filter_value S, filter_value C = real_part_t<S> >
+class decimator : public resampler<S, C> {
+public:
+    decimator(const vector<C> &taps, const std::size_t &factor, const std::size_t &block = 1024)
+            : resampler<S, C>(taps, 1, factor, block) {}
+};
+
+/**
+ * @class interpolator
+ *
+ * @brief Streaming polyphase interpolator producing factor outputs per input sample.
+ *
+ * @ingroup dsp
+ */
+template<filter_value S, filter_value C = real_part_t<S> >
+class interpolator : public resampler<S, C> {
+public:
+    interpolator(const vector<C> &taps, const std::size_t &factor, const std::size_t &block = 1024)
+            : resampler<S, C>(taps, factor, 1, block) {}
+};
+
+}
+
+#endif // CCOMMS_MODULES_DSP_FIR_HPP_
@@ -0,0 +1,585 @@
+// Copyright(c) 2023, Matthew Petrin, All rights reserved.
+
+#ifndef CCOMMS_MODULES_IO_BINARY_HPP_
+#define CCOMMS_MODULES_IO_BINARY_HPP_
+
+#include <array>
+#include <tuple>
+#include <string>
+#include <vector>
+#include <complex>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <utility>
+#include <algorithm>
+#include <stdexcept>
+#include <filesystem>
+#include <type_traits>
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "../tensor/simd.hpp"
+#include "../tensor/view.hpp"
+#include "../tensor/vector.hpp"
+#include "../coords/batch.hpp"
+
+namespace ccomms::io {
+
+//***************************************************** FORMAT *****************************************************
+
+/**
+ * @brief Element type of a stored record.
+ */
+enum class dtype : std::uint8_t {
+    int8 = 1,
+    int16,
+    int32,
+    int64,
+    uint8,
+    uint16,
+    uint32,
+    uint64,
+    float32,
+    float64,
+    complex64,
+    complex128
+};
+
+/**
+ * @brief What a stored record holds, so that a batch is only loaded back as the same coordinate system.
+ */
+enum class record_kind : std::uint8_t {
+    vector = 1,
+    batch,
+    cartesian,
+    spherical,
+    geodetic
+};
+
+template<typename T>
+inline constexpr bool has_dtype = std::is_same_v<T, std::int8_t> || std::is_same_v<T, std::int16_t> ||
+                                  std::is_same_v<T, std::int32_t> || std::is_same_v<T, std::int64_t> ||
+                                  std::is_same_v<T, std::uint8_t> || std::is_same_v<T, std::uint16_t> ||
+                                  std::is_same_v<T, std::uint32_t> || std::is_same_v<T, std::uint64_t> ||
+                                  std::is_same_v<T, float> || std::is_same_v<T, double> ||
+                                  std::is_same_v<T, std::complex<float> > || std::is_same_v<T, std::complex<double> >;
+
+/**
+ * @brief Element types that can be stored: fixed width integers, float, double and their complex counterparts.
+ */
+template<typename T>
+concept storable = has_dtype<T>;
+
+template<storable T>
+constexpr dtype dtype_of() {
+    if constexpr (std::is_same_v<T, std::int8_t>) return dtype::int8;
+    else if constexpr (std::is_same_v<T, std::int16_t>) return dtype::int16;
+    else if constexpr (std::is_same_v<T, std::int32_t>) return dtype::int32;
+    else if constexpr (std::is_same_v<T, std::int64_t>) return dtype::int64;
+    else if constexpr (std::is_same_v<T, std::uint8_t>) return dtype::uint8;
+    else if constexpr (std::is_same_v<T, std::uint16_t>) return dtype::uint16;
+    else if constexpr (std::is_same_v<T, std::uint32_t>) return dtype::uint32;
+    else if constexpr (std::is_same_v<T, std::uint64_t>) return dtype::uint64;
+    else if constexpr (std::is_same_v<T, float>) return dtype::float32;
+    else if constexpr (std::is_same_v<T, double>) return dtype::float64;
+    else if constexpr (std::is_same_v<T, std::complex<float> >) return dtype::complex64;
+    else return dtype::complex128;
+}
+
+/**
+ * @brief Size in bytes of one element of the given type, or 0 if the type is not one of the enumerators.
+ */
+constexpr std::size_t element_size(const dtype &type) {
+    switch (type) {
+        case dtype::int8: case dtype::uint8: return 1;
+        case dtype::int16: case dtype::uint16: return 2;
+        case dtype::int32: case dtype::uint32: case dtype::float32: return 4;
+        case dtype::int64: case dtype::uint64: case dtype::float64: case dtype::complex64: return 8;
+        case dtype::complex128: return 16;
+    }
+    return 0;
+}
+
+/**
+ * @brief Every header and every component of every record starts on a multiple of this many bytes, so mapped data
+ * is aligned for the widest SIMD loads.
+ */
+inline constexpr std::size_t alignment = 64;
+
+inline constexpr std::uint16_t format_version = 1;
+
+/**
+ * @brief Written in native byte order; reads back differently on a machine of the other endianness.
+ */
+inline constexpr std::uint32_t byte_order_mark = 0x01020304;
+
+inline constexpr char file_magic[8] = {'C', 'C', 'O', 'M', 'M', 'S', 'B', 'F'};
+
+inline constexpr char record_tag[4] = {'R', 'E', 'C', 'D'};
+
+/**
+ * @brief Leading block of every file.
+ */
+struct file_header {
+    char magic[8];
+    std::uint32_t byte_order;
+    std::uint16_t version;
+    std::uint16_t header_size;
+    std::uint8_t reserved[48];
+};
+
+/**
+ * @brief Block preceding the payload of every record. The payload holds components columns of length elements
+ * each, stride bytes apart.
+ */
+struct record_header {
+    char tag[4];
+    std::uint8_t type;
+    std::uint8_t kind;
+    std::uint8_t orientation;
+    std::uint8_t components;
+    std::uint64_t length;
+    std::uint64_t stride;
+    char name[40];
+};
+
+static_assert(sizeof(file_header) == alignment && sizeof(record_header) == alignment);
+
+inline constexpr std::size_t max_name_length = sizeof(record_header::name) - 1;
+
+inline constexpr std::size_t padded(const std::size_t &bytes) {
+    return (bytes + alignment - 1) / alignment * alignment;
+}
+
+[[noreturn]] inline void throw_corrupt() {
+    throw std::runtime_error("\nERR: binary file is corrupt\n");
+}
+
+inline void check_header(const file_header &header) {
+    if (std::memcmp(header.magic, file_magic, sizeof(file_magic)) != 0)
+        throw std::runtime_error("\nERR: not a ccomms binary file\n");
+    if (header.byte_order != byte_order_mark)
+        throw std::runtime_error("\nERR: binary file was written with a different byte order\n");
+    if (header.version > format_version)
+        throw std::runtime_error("\nERR: binary file version is newer than this reader\n");
+}
+
+//***************************************************** RECORD *****************************************************
+
+/**
+ * @brief Description of a record found in a file.
+ */
+struct record {
+    std::string name;
+    dtype type;
+    record_kind kind;
+    char orientation;
+    std::size_t components;
+    std::size_t length;
+    std::size_t stride;
+    std::size_t offset;
+};
+
+/**
+ * @brief Parses the records of a file image of the given size. Parsing stops at the first record that does not fit,
+ * which is one a writer has not finished yet. Headers are checked without overflow against the image, so a damaged
+ * file raises an error rather than yielding records that reach outside it.
+ *
+ * @return the records and the size of the well formed prefix of the image
+ */
+inline std::pair<std::vector<record>, std::size_t> parse(const std::byte *image, const std::size_t &size) {
+    if (size < sizeof(file_header))
+        throw std::runtime_error("\nERR: binary file is missing its header\n");
+
+    file_header header;
+    std::memcpy(&header, image, sizeof(header));
+    check_header(header);
+
+    if (header.header_size < sizeof(file_header) || header.header_size > size || header.header_size % alignment)
+        throw_corrupt();
+
+    std::vector<record> records;
+    std::size_t offset = header.header_size;
+    while (size - offset >= sizeof(record_header)) {
+        record_header rh;
+        std::memcpy(&rh, image + offset, sizeof(rh));
+        if (std::memcmp(rh.tag, record_tag, sizeof(record_tag)) != 0)
+            throw_corrupt();
+        if (rh.stride % alignment || (rh.components && rh.stride > SIZE_MAX / rh.components))
+            throw_corrupt();
+
+        const std::size_t payload = rh.components * rh.stride;
+        if (payload > size - offset - sizeof(rh))
+            break;
+
+        const std::size_t width = element_size(static_cast<dtype>(rh.type));
+        if (!width || rh.length > rh.stride / width)
+            throw_corrupt();
+        if (rh.kind < static_cast<std::uint8_t>(record_kind::vector) ||
+            rh.kind > static_cast<std::uint8_t>(record_kind::geodetic))
+            throw_corrupt();
+        if (rh.orientation != 'r' && rh.orientation != 'c')
+            throw_corrupt();
+
+        rh.name[max_name_length] = '\0';
+        records.push_back({rh.name, static_cast<dtype>(rh.type), static_cast<record_kind>(rh.kind),
+                           static_cast<char>(rh.orientation), rh.components, rh.length, rh.stride,
+                           offset + sizeof(rh)});
+        offset += sizeof(rh) + payload;
+    }
+
+    return {std::move(records), std::min(offset, size)};
+}
+
+//*************************************************** MAPPED FILE **************************************************
+
+/**
+ * @class mapped_file
+ *
+ * @brief Read-only memory mapping of a binary file giving zero-copy views of its records.
+ *
+ * @ingroup io
+ *
+ * @details Opening a file maps it and reads only the record headers, so the cost of opening is independent of the
+ * amount of data. view and columns return vector_views straight into the mapping, aligned for SIMD, which stay valid
+ * for as long as the mapped_file exists and is not refreshed. load copies a record into an owning vector or coordinate
+ * batch. refresh remaps the file to pick up records appended since it was opened.
+ */
+class mapped_file {
+
+    std::string path;
+    void *base = nullptr;
+    std::size_t bytes = 0;
+    std::size_t complete = 0;
+    std::vector<record> table;
+
+public:
+
+    explicit mapped_file(std::string file) : path(std::move(file)) { map(); }
+
+    mapped_file(const mapped_file &) = delete;
+
+    mapped_file &operator=(const mapped_file &) = delete;
+
+    mapped_file(mapped_file &&other) noexcept :
+            path(std::move(other.path)),
+            base(std::exchange(other.base, nullptr)),
+            bytes(std::exchange(other.bytes, 0)),
+            complete(std::exchange(other.complete, 0)),
+            table(std::move(other.table)) {}
+
+    mapped_file &operator=(mapped_file &&other) noexcept {
+        if (this != &other) {
+            unmap();
+            path = std::move(other.path);
+            base = std::exchange(other.base, nullptr);
+            bytes = std::exchange(other.bytes, 0);
+            complete = std::exchange(other.complete, 0);
+            table = std::move(other.table);
+        }
+        return *this;
+    }
+
+    ~mapped_file() { unmap(); }
+
+    //**************************************************** ACCESS ******************************************************
+
+    [[nodiscard]] std::size_t size() const { return table.size(); }
+
+    [[nodiscard]] const std::vector<record> &records() const { return table; }
+
+    /**
+     * @brief Bytes taken by the header and the complete records, excluding any record still being written.
+     */
+    [[nodiscard]] std::size_t complete_size() const { return complete; }
+
+    const record &operator[](const std::size_t &i) const { return table.at(i); }
+
+    /**
+     * @brief The last record with the given name, so that a name appended again supersedes the earlier record.
+     */
+    [[nodiscard]] const record *find(const std::string &name) const {
+        auto it = std::find_if(table.rbegin(), table.rend(), [&](const record &r) { return r.name == name; });
+        return it == table.rend() ? nullptr : &*it;
+    }
+
+    const record &at(const std::string &name) const {
+        const record *r = find(name);
+        if (!r)
+            throw std::out_of_range("\nERR: binary file has no record named " + name + "\n");
+        return *r;
+    }
+
+    /**
+     * @brief Zero-copy view of one component of a record.
+     */
+    template<storable T>
+    vector_view<const T> view(const record &r, const std::size_t &component = 0) const {
+        if (r.type != dtype_of<T>())
+            throw std::invalid_argument("\nERR: binary record " + r.name + " has a different element type\n");
+        if (component >= r.components)
+            throw std::out_of_range("\nERR: binary record " + r.name + " has no such component\n");
+        if (r.offset > bytes || r.stride > (bytes - r.offset) / r.components || r.length > r.stride / sizeof(T))
+            throw_corrupt();
+
+        const auto *data = static_cast<const std::byte *>(base) + r.offset + component * r.stride;
+        return {reinterpret_cast<const T *>(data), r.length};
+    }
+
+    template<storable T>
+    vector_view<const T> view(const std::string &name, const std::size_t &component = 0) const {
+        return view<T>(at(name), component);
+    }
+
+    /**
+     * @brief Zero-copy views of every component of a K component record, such as the columns of a batch.
+     */
+    template<storable T, std::size_t K>
+    std::array<vector_view<const T>, K> columns(const std::string &name) const {
+        const record &r = at(name);
+        if (r.components != K)
+            throw std::invalid_argument("\nERR: binary record " + r.name + " has a different number of components\n");
+
+        std::array<vector_view<const T>, K> result;
+        for (std::size_t k = 0; k < K; k++)
+            result[k] = view<T>(r, k);
+        return result;
+    }
+
+    /**
+     * @brief Copies a vector record into a dynamic vector with its stored orientation.
+     */
+    template<storable T>
+    vector<T> load(const std::string &name) const {
+        const record &r = at(name);
+        if (r.kind != record_kind::vector)
+            throw std::invalid_argument("\nERR: binary record " + r.name + " is not a vector\n");
+        return vector<T>(view<T>(r), r.orientation);
+    }
+
+    /**
+     * @brief Copies a batch record into an owning coordinate batch of the same coordinate system.
+     */
+    template<typename Batch>
+    Batch load_batch(const std::string &name) const {
+        using T = typename Batch::value_type;
+        constexpr std::size_t K = Batch::components;
+
+        const record &r = at(name);
+        if (r.kind != kind_of<Batch>())
+            throw std::invalid_argument("\nERR: binary record " + r.name + " is a different kind of batch\n");
+
+        const auto source = columns<T, K>(name);
+        Batch result(r.length);
+        for (std::size_t k = 0; k < K; k++)
+            std::copy(source[k].begin(), source[k].end(), result.column(k).begin());
+
+        if constexpr (requires { result.validate(); })
+            result.validate();
+        return result;
+    }
+
+    /**
+     * @brief Remaps the file to pick up appended records. Invalidates every view taken before.
+     */
+    void refresh() {
+        unmap();
+        map();
+    }
+
+private:
+
+    template<typename Batch>
+    static constexpr record_kind kind_of() {
+        using T = typename Batch::value_type;
+        if constexpr (std::is_base_of_v<cartesian_batch<T, typename Batch::column_type::allocator_type>, Batch>)
+            return record_kind::cartesian;
+        else if constexpr (std::is_base_of_v<spherical_batch<T, typename Batch::column_type::allocator_type>, Batch>)
+            return record_kind::spherical;
+        else if constexpr (std::is_base_of_v<geodetic_batch<T, typename Batch::column_type::allocator_type>, Batch>)
+            return record_kind::geodetic;
+        else
+            return record_kind::batch;
+    }
+
+    void map() {
+        const int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0)
+            throw std::runtime_error("\nERR: unable to open binary file " + path + "\n");
+
+        struct stat info{};
+        if (::fstat(fd, &info) != 0 || info.st_size == 0) {
+            ::close(fd);
+            throw std::runtime_error("\nERR: unable to map binary file " + path + "\n");
+        }
+
+        bytes = static_cast<std::size_t>(info.st_size);
+        base = ::mmap(nullptr, bytes, PROT_READ, MAP_SHARED, fd, 0);
+        ::close(fd);
+        if (base == MAP_FAILED) {
+            base = nullptr;
+            throw std::runtime_error("\nERR: unable to map binary file " + path + "\n");
+        }
+
+        try {
+            std::tie(table, complete) = parse(static_cast<const std::byte *>(base), bytes);
+        } catch (...) {
+            unmap();
+            throw;
+        }
+    }
+
+    void unmap() {
+        if (base)
+            ::munmap(base, bytes);
+        base = nullptr;
+        bytes = 0;
+        complete = 0;
+        table.clear();
+    }
+};
+
+//***************************************************** WRITER *****************************************************
+
+/**
+ * @class writer
+ *
+ * @brief Streams vectors, views and coordinate batches to a binary file as a sequence of named records.
+ *
+ * @ingroup io
+ *
+ * @details Each record is appended as soon as it is written, so a reader mapping the file while it grows sees every
+ * complete record and ignores one still being written. Opening an existing file in append mode continues after its
+ * last complete record, dropping a record left unfinished by an interrupted writer. Elements are stored in native
+ * byte order; the file header records it so that a mismatched reader refuses the file.
+ */
+class writer {
+
+    std::ofstream out;
+
+public:
+
+    enum class mode {
+        truncate,
+        append
+    };
+
+    explicit writer(const std::string &path, const mode &open_mode = mode::truncate) {
+        namespace fs = std::filesystem;
+
+        if (open_mode == mode::append && fs::exists(path) && fs::file_size(path) > 0) {
+            fs::resize_file(path, mapped_file(path).complete_size());
+            out.open(path, std::ios::binary | std::ios::app);
+        } else {
+            out.open(path, std::ios::binary | std::ios::trunc);
+            file_header header{};
+            std::memcpy(header.magic, file_magic, sizeof(file_magic));
+            header.byte_order = byte_order_mark;
+            header.version = format_version;
+            header.header_size = sizeof(file_header);
+            put(&header, sizeof(header));
+        }
+
+        if (!out)
+            throw std::runtime_error("\nERR: unable to open binary file " + path + " for writing\n");
+    }
+
+    template<storable T, std::size_t N, typename Policy, typename Alloc, std::size_t Inline>
+    writer &write(const std::string &name, const vector<T, N, Policy, Alloc, Inline> &v) {
+        return write_record<T>(name, record_kind::vector, v.orientation(), std::array{&v});
+    }
+
+    template<typename T, std::size_t Extent, bool Strided>
+    requires storable<std::remove_cv_t<T> >
+    writer &write(const std::string &name, const vector_view<T, Extent, Strided> &v) {
+        return write_record<std::remove_cv_t<T> >(name, record_kind::vector, 'c', std::array{&v});
+    }
+
+    template<storable T, std::size_t K, typename Alloc>
+    writer &write(const std::string &name, const coordinate_batch<T, K, Alloc> &batch) {
+        return write_batch(name, record_kind::batch, batch);
+    }
+
+    template<storable T, typename Alloc>
+    writer &write(const std::string &name, const cartesian_batch<T, Alloc> &batch) {
+        return write_batch(name, record_kind::cartesian, batch);
+    }
+
+    template<storable T, typename Alloc>
+    writer &write(const std::string &name, const spherical_batch<T, Alloc> &batch) {
+        return write_batch(name, record_kind::spherical, batch);
+    }
+
+    template<storable T, typename Alloc>
+    writer &write(const std::string &name, const geodetic_batch<T, Alloc> &batch) {
+        return write_batch(name, record_kind::geodetic, batch);
+    }
+
+    /**
+     * @brief Pushes written records to the file so that readers mapping it see them.
+     */
+    writer &flush() {
+        out.flush();
+        return *this;
+    }
+
+private:
+
+    void put(const void *data, const std::size_t &bytes) {
+        out.write(static_cast<const char *>(data), static_cast<std::streamsize>(bytes));
+    }
+
+    template<typename T, std::size_t K, typename Alloc>
+    writer &write_batch(const std::string &name, const record_kind &kind, const coordinate_batch<T, K, Alloc> &b) {
+        std::array<const typename coordinate_batch<T, K, Alloc>::column_type *, K> columns;
+        for (std::size_t k = 0; k < K; k++)
+            columns[k] = &b.column(k);
+        return write_record<T>(name, kind, 'c', columns);
+    }
+
+    template<typename T, typename Columns>
+    writer &write_record(const std::string &name, const record_kind &kind, const char &orientation,
+                         const Columns &columns) {
+        if (name.size() > max_name_length)
+            throw std::invalid_argument("\nERR: binary record name is too long\n");
+
+        const std::size_t length = columns[0]->size();
+        const std::size_t stride = padded(length * sizeof(T));
+
+        record_header header{};
+        std::memcpy(header.tag, record_tag, sizeof(record_tag));
+        std::memcpy(header.name, name.data(), name.size());
+        header.type = static_cast<std::uint8_t>(dtype_of<T>());
+        header.kind = static_cast<std::uint8_t>(kind);
+        header.orientation = static_cast<std::uint8_t>(orientation);
+        header.components = static_cast<std::uint8_t>(columns.size());
+        header.length = length;
+        header.stride = stride;
+        put(&header, sizeof(header));
+
+        static constexpr std::array<std::byte, alignment> padding{};
+        for (const auto *column: columns) {
+            if constexpr (simd::contiguous<std::remove_cvref_t<decltype(*column)> >) {
+                put(column->data(), length * sizeof(T));
+            } else {
+                for (std::size_t i = 0; i < length; i++) {
+                    const T value = (*column)[i];
+                    put(&value, sizeof(T));
+                }
+            }
+            put(padding.data(), stride - length * sizeof(T));
+        }
+
+        if (!out)
+            throw std::runtime_error("\nERR: failed writing binary record " + name + "\n");
+        return *this;
+    }
+};
+
+}
+
+#endif // CCOMMS_MODULES_IO_BINARY_HPP_
@@ -0,0 +1,740 @@
+// Copyright(c) 2023, Matthew Petrin, All rights reserved.
+
+#ifndef CCOMMS_MODULES_STREAM_GRAPH_HPP_
+#define CCOMMS_MODULES_STREAM_GRAPH_HPP_
+
+#include <mutex>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <optional>
+#include <exception>
+#include <stdexcept>
+#include <type_traits>
+
+#include <sched.h>
+#include <pthread.h>
+
+#include "ring.hpp"
+#include "../tensor/view.hpp"
+#include "../tensor/execution.hpp"
+
+namespace ccomms::stream {
+
+class stage;
+
+class graph;
+
+/**
+ * @brief Outcome of one call to stage::work.
+ *
+ * @details progressed: a block was consumed or produced. starved: an input had no block. blocked: an output had no free
+ * slot, which is how a slow consumer pushes back on its producers. finished: the stage is done and its outputs are
+ * closed.
+ */
+enum class step { progressed, starved, blocked, finished };
+
+/**
+ * @brief Counters of one stage. Latencies are the durations of the work calls that made progress, so busy_ns over
+ * samples gives the cost per sample and max_latency_ns the worst single block.
+ */
+struct stage_statistics {
+    std::uint64_t runs = 0;
+    std::uint64_t starved = 0;
+    std::uint64_t blocked = 0;
+    std::uint64_t blocks_in = 0;
+    std::uint64_t blocks_out = 0;
+    std::uint64_t samples_in = 0;
+    std::uint64_t samples_out = 0;
+    std::uint64_t busy_ns = 0;
+    std::uint64_t max_latency_ns = 0;
+
+    [[nodiscard]] double mean_latency_ns() const {
+        return runs > 0 ? static_cast<double>(busy_ns) / static_cast<double>(runs) : 0;
+    }
+
+    /**
+     * @brief Samples consumed per second of work, or produced for stages without inputs.
+     */
+    [[nodiscard]] double throughput() const {
+        const std::uint64_t samples = blocks_in > 0 ? samples_in : samples_out;
+        return busy_ns > 0 ? static_cast<double>(samples) * 1e9 / static_cast<double>(busy_ns) : 0;
+    }
+};
+
+//****************************************************** PORTS *****************************************************
+
+class port {
+    friend class stage;
+    friend class graph;
+
+protected:
+
+    stage &owner;
+
+    explicit port(stage &owner) : owner(owner) {}
+
+    virtual ~port() = default;
+
+    [[nodiscard]] virtual bool connected() const = 0;
+
+    // True for an output whose consumer has finished
+    [[nodiscard]] virtual bool abandoned() const { return false; }
+
+    // Releases any claim held by the port and, for outputs, tells the consumer no more blocks follow
+    virtual void close() = 0;
+};
+
+template<ring_value T>
+struct link {
+    mpmc_ring<T> ring;
+    std::atomic<bool> closed{false};
+    std::atomic<bool> detached{false};
+
+    link(const std::size_t &depth, const std::size_t &block) : ring(depth, block) {}
+};
+
+template<ring_value T>
+class input;
+
+/**
+ * @class output
+ *
+ * @brief Typed output port of a stage, writing blocks of up to block_size() samples.
+ *
+ * @ingroup stream
+ *
+ * @details reserve hands out a slot of the connection ring to be filled in place and publish passes the first n samples
+ * on as a block, so blocks are written once and the slots are reused for the life of the graph. A reserved slot stays
+ * reserved across work calls until it is published. Once the consumer has finished, the oldest unread block is
+ * discarded to make room rather than blocking the stage forever.
+ */
+template<ring_value T>
+class output : public port {
+    friend class graph;
+
+    std::size_t block;
+    std::shared_ptr<link<T> > target;
+    std::optional<typename mpmc_ring<T>::write_claim> reserved;
+
+public:
+
+    output(stage &owner, const std::size_t &block_size) : port(owner), block(block_size) {
+        if (block_size == 0)
+            throw std::invalid_argument("\nERR: port block size must be positive\n");
+        register_output();
+    }
+
+    [[nodiscard]] std::size_t block_size() const { return block; }
+
+    /**
+     * @brief A slot of block_size() samples to fill, or nothing while the connection is full.
+     */
+    std::optional<vector_view<T> > reserve() {
+        if (!reserved)
+            reserved = target->ring.try_claim_write();
+        if (!reserved && abandoned()) {
+            if (const auto discarded = target->ring.try_claim_read())
+                target->ring.commit_read(*discarded);
+            reserved = target->ring.try_claim_write();
+        }
+        if (!reserved)
+            return std::nullopt;
+        return reserved->samples;
+    }
+
+    /**
+     * @brief Sends the first n samples of the reserved slot downstream.
+     */
+    void publish(const std::size_t &n) {
+        if (!reserved)
+            throw std::invalid_argument("\nERR: output published without a reserved slot\n");
+        target->ring.commit_write(*reserved, n);
+        reserved.reset();
+        count(n);
+    }
+
+private:
+
+    void register_output();
+
+    void count(const std::size_t &n);
+
+    [[nodiscard]] bool connected() const override { return target != nullptr; }
+
+    [[nodiscard]] bool abandoned() const override { return target->detached.load(std::memory_order_acquire); }
+
+    void close() override {
+        if (reserved) {
+            target->ring.commit_write(*reserved, 0);
+            reserved.reset();
+        }
+        if (target)
+            target->closed.store(true, std::memory_order_release);
+    }
+};
+
+/**
+ * @class input
+ *
+ * @brief Typed input port of a stage, reading the blocks written to the output it is connected to.
+ *
+ * @ingroup stream
+ *
+ * @details peek returns the oldest block in place and keeps returning it until consume hands its slot back to the
+ * producer, so a stage that finds its output full can retry later without losing the block. Empty blocks are skipped.
+ */
+template<ring_value T>
+class input : public port {
+    friend class graph;
+
+    std::shared_ptr<link<T> > source;
+    std::optional<typename mpmc_ring<T>::read_claim> held;
+
+public:
+
+    explicit input(stage &owner) : port(owner) {
+        register_input();
+    }
+
+    /**
+     * @brief The oldest block, or nothing while the connection is empty.
+     */
+    std::optional<vector_view<const T> > peek() {
+        while (!held) {
+            held = source->ring.try_claim_read();
+            if (!held)
+                return std::nullopt;
+            if (held->samples.empty()) {
+                source->ring.commit_read(*held);
+                held.reset();
+            }
+        }
+        return held->samples;
+    }
+
+    /**
+     * @brief Returns the block last returned by peek to the producer.
+     */
+    void consume() {
+        if (!held)
+            throw std::invalid_argument("\nERR: input consumed without a block\n");
+        const std::size_t n = held->samples.size();
+        source->ring.commit_read(*held);
+        held.reset();
+        count(n);
+    }
+
+    /**
+     * @brief True once the producer has finished and every block it wrote has been consumed.
+     */
+    [[nodiscard]] bool drained() {
+        const bool closed = source->closed.load(std::memory_order_acquire);
+        return closed && !peek();
+    }
+
+private:
+
+    void register_input();
+
+    void count(const std::size_t &n);
+
+    [[nodiscard]] bool connected() const override { return source != nullptr; }
+
+    void close() override {
+        if (held) {
+            source->ring.commit_read(*held);
+            held.reset();
+        }
+        if (source)
+            source->detached.store(true, std::memory_order_release);
+    }
+};
+
+//****************************************************** STAGE *****************************************************
+
+/**
+ * @class stage
+ *
+ * @brief A node of a flowgraph that moves blocks from its input ports to its output ports.
+ *
+ * @ingroup stream
+ *
+ * @details Derived stages declare their ports as members constructed with *this and implement work, which handles at
+ * most a block or so and returns without waiting: a stage with nothing to read returns starved, one whose output is
+ * full returns blocked, and the scheduler runs something else. A stage is never run by two threads at once, so work
+ * needs no locking of its own state.
+ */
+class stage {
+    friend class graph;
+
+    template<ring_value>
+    friend class input;
+
+    template<ring_value>
+    friend class output;
+
+    std::string label;
+    std::vector<port *> inputs;
+    std::vector<port *> outputs;
+
+    std::atomic<bool> running{false};
+    std::atomic<bool> done{false};
+
+    std::atomic<std::uint64_t> runs{0}, starved{0}, blocked{0};
+    std::atomic<std::uint64_t> blocks_in{0}, blocks_out{0}, samples_in{0}, samples_out{0};
+    std::atomic<std::uint64_t> busy_ns{0}, max_latency_ns{0};
+
+public:
+
+    explicit stage(std::string name) : label(std::move(name)) {}
+
+    stage(const stage &) = delete;
+
+    stage &operator=(const stage &) = delete;
+
+    virtual ~stage() = default;
+
+    [[nodiscard]] const std::string &name() const { return label; }
+
+    [[nodiscard]] bool finished() const { return done.load(std::memory_order_acquire); }
+
+    [[nodiscard]] stage_statistics stats() const {
+        stage_statistics result;
+        result.runs = runs.load(std::memory_order_relaxed);
+        result.starved = starved.load(std::memory_order_relaxed);
+        result.blocked = blocked.load(std::memory_order_relaxed);
+        result.blocks_in = blocks_in.load(std::memory_order_relaxed);
+        result.blocks_out = blocks_out.load(std::memory_order_relaxed);
+        result.samples_in = samples_in.load(std::memory_order_relaxed);
+        result.samples_out = samples_out.load(std::memory_order_relaxed);
+        result.busy_ns = busy_ns.load(std::memory_order_relaxed);
+        result.max_latency_ns = max_latency_ns.load(std::memory_order_relaxed);
+        return result;
+    }
+
+protected:
+
+    /**
+     * @brief Handles the next block without waiting.
+     */
+    virtual step work() = 0;
+
+private:
+
+    // Counters are only written by the thread running the stage, so plain load and store suffice
+    static void bump(std::atomic<std::uint64_t> &counter, const std::uint64_t &n) {
+        counter.store(counter.load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+    }
+
+    bool try_acquire() {
+        return !done.load(std::memory_order_acquire) && !running.exchange(true, std::memory_order_acquire);
+    }
+
+    void release() {
+        running.store(false, std::memory_order_release);
+    }
+
+    [[nodiscard]] bool abandoned() const {
+        for (const port *p: outputs)
+            if (!p->abandoned())
+                return false;
+        return !outputs.empty();
+    }
+
+    // Runs work once on the thread holding the stage and records what happened. A stage whose consumers have all
+    // finished is finished as well.
+    step run_once() {
+        if (abandoned()) {
+            finish();
+            return step::finished;
+        }
+
+        const auto start = std::chrono::steady_clock::now();
+        const step result = work();
+        const auto elapsed = static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now() - start).count());
+
+        switch (result) {
+            case step::progressed:
+                bump(runs, 1);
+                bump(busy_ns, elapsed);
+                if (elapsed > max_latency_ns.load(std::memory_order_relaxed))
+                    max_latency_ns.store(elapsed, std::memory_order_relaxed);
+                break;
+            case step::starved:
+                bump(starved, 1);
+                break;
+            case step::blocked:
+                bump(blocked, 1);
+                break;
+            case step::finished:
+                finish();
+                break;
+        }
+        return result;
+    }
+
+    void finish() {
+        for (port *p: inputs)
+            p->close();
+        for (port *p: outputs)
+            p->close();
+        done.store(true, std::memory_order_release);
+    }
+};
+
+template<ring_value T>
+void output<T>::register_output() {
+    owner.outputs.push_back(this);
+}
+
+template<ring_value T>
+void output<T>::count(const std::size_t &n) {
+    stage::bump(owner.blocks_out, 1);
+    stage::bump(owner.samples_out, n);
+}
+
+template<ring_value T>
+void input<T>::register_input() {
+    owner.inputs.push_back(this);
+}
+
+template<ring_value T>
+void input<T>::count(const std::size_t &n) {
+    stage::bump(owner.blocks_in, 1);
+    stage::bump(owner.samples_in, n);
+}
+
+//************************************************* FUNCTION STAGES ************************************************
+
+/**
+ * @class source_stage
+ *
+ * @brief Stage filling each output block with fill(vector_view<T>), which returns the number of samples written.
+ * Returning 0 ends the stream.
+ *
+ * @ingroup stream
+ */
+template<ring_value T, typename F>
+class source_stage : public stage {
+    F fill;
+
+public:
+
+    output<T> out;
+
+    source_stage(std::string name, const std::size_t &block_size, F fill)
+            : stage(std::move(name)), fill(std::move(fill)), out(*this, block_size) {}
+
+protected:
+
+    step work() override {
+        const std::optional<vector_view<T> > block = out.reserve();
+        if (!block)
+            return step::blocked;
+        const std::size_t n = fill(*block);
+        if (n == 0)
+            return step::finished;
+        out.publish(n);
+        return step::progressed;
+    }
+};
+
+/**
+ * @class transform_stage
+ *
+ * @brief Stage computing each output block from an input block with apply(vector_view<const In>, vector_view<Out>),
+ * which returns the number of samples written to the output.
+ *
+ * @ingroup stream
+ */
+template<ring_value In, ring_value Out, typename F>
+class transform_stage : public stage {
+    F apply;
+
+public:
+
+    input<In> in;
+    output<Out> out;
+
+    transform_stage(std::string name, const std::size_t &block_size, F apply)
+            : stage(std::move(name)), apply(std::move(apply)), in(*this), out(*this, block_size) {}
+
+protected:
+
+    step work() override {
+        const std::optional<vector_view<const In> > block = in.peek();
+        if (!block)
+            return in.drained() ? step::finished : step::starved;
+        const std::optional<vector_view<Out> > result = out.reserve();
+        if (!result)
+            return step::blocked;
+        out.publish(apply(*block, *result));
+        in.consume();
+        return step::progressed;
+    }
+};
+
+/**
+ * @class sink_stage
+ *
+ * @brief Stage passing every input block to consume(vector_view<const T>).
+ *
+ * @ingroup stream
+ */
+template<ring_value T, typename F>
+class sink_stage : public stage {
+    F take;
+
+public:
+
+    input<T> in;
+
+    sink_stage(std::string name, F take) : stage(std::move(name)), take(std::move(take)), in(*this) {}
+
+protected:
+
+    step work() override {
+        const std::optional<vector_view<const T> > block = in.peek();
+        if (!block)
+            return in.drained() ? step::finished : step::starved;
+        take(*block);
+        in.consume();
+        return step::progressed;
+    }
+};
+
+//****************************************************** GRAPH *****************************************************
+
+/**
+ * @class graph
+ *
+ * @brief A flowgraph of stages connected output to input by bounded rings of sample blocks.
+ *
+ * @ingroup stream
+ *
+ * @details Every connection is an mpmc_ring of depth blocks whose slots are filled and read in place, so a running
+ * graph moves samples without allocating and a full ring stops its producer until the consumer catches up. The graph
+ * runs either with one thread per stage, optionally pinned to given CPUs, or on the workers of a thread pool: each
+ * worker starts its scan of the stages at its own offset, so the workers settle on different stages, and takes over any
+ * other stage that is runnable and not held by another worker when its own have nothing to do. A stage runs on one
+ * thread at a time either way. run returns once every stage has finished, which happens when the sources end and the
+ * blocks they wrote have drained through the graph, or when the sinks finish and the stages feeding them follow, or
+ * once stop is called. The first exception thrown by a stage stops the graph and is rethrown by run.
+ */
+class graph {
+    std::vector<std::unique_ptr<stage> > nodes;
+
+    std::atomic<bool> stopping{false};
+    std::exception_ptr error;
+    std::mutex error_lock;
+
+    // Work calls a worker makes on a stage that keeps progressing before moving on
+    static constexpr std::size_t burst = 16;
+
+public:
+
+    graph() = default;
+
+    graph(const graph &) = delete;
+
+    graph &operator=(const graph &) = delete;
+
+    /**
+     * @brief Constructs a stage of type S owned by the graph.
+     */
+    template<typename S, typename... A>
+    requires std::is_base_of_v<stage, S>
+    S &add(A &&... args) {
+        auto node = std::make_unique<S>(std::forward<A>(args)...);
+        S &result = *node;
+        nodes.push_back(std::move(node));
+        return result;
+    }
+
+    template<ring_value T, typename F>
+    source_stage<T, std::decay_t<F> > &source(std::string name, const std::size_t &block_size, F &&fill) {
+        return add<source_stage<T, std::decay_t<F> > >(std::move(name), block_size, std::forward<F>(fill));
+    }
+
+    template<ring_value In, ring_value Out, typename F>
+    transform_stage<In, Out, std::decay_t<F> > &transform(std::string name, const std::size_t &block_size,
+                                                          F &&apply) {
+        return add<transform_stage<In, Out, std::decay_t<F> > >(std::move(name), block_size, std::forward<F>(apply));
+    }
+
+    template<ring_value T, typename F>
+    sink_stage<T, std::decay_t<F> > &sink(std::string name, F &&take) {
+        return add<sink_stage<T, std::decay_t<F> > >(std::move(name), std::forward<F>(take));
+    }
+
+    /**
+     * @brief Connects an output to an input through a ring of depth blocks.
+     */
+    template<ring_value T>
+    void connect(output<T> &from, input<T> &to, const std::size_t &depth = 8) {
+        if (from.target || to.source)
+            throw std::invalid_argument("\nERR: port is already connected\n");
+        auto edge = std::make_shared<link<T> >(depth, from.block);
+        from.target = edge;
+        to.source = edge;
+    }
+
+    [[nodiscard]] const std::vector<std::unique_ptr<stage> > &stages() const { return nodes; }
+
+    /**
+     * @brief Makes run return after the work calls in progress, leaving unfinished stages as they are. A later run
+     * starts afresh.
+     */
+    void stop() { stopping.store(true, std::memory_order_release); }
+
+    /**
+     * @brief Runs the graph on the workers of a pool and the calling thread.
+     */
+    void run(execution::thread_pool &pool) {
+        validate();
+        reset();
+        const std::size_t workers = pool.concurrency();
+        pool.parallel_for(workers, [&](std::size_t worker) { drive(worker * nodes.size() / workers); });
+        rethrow();
+    }
+
+    void run() { run(execution::default_pool()); }
+
+    /**
+     * @brief Runs every stage on a thread of its own, stage i pinned to cpus[i % cpus.size()] when cpus is given. Each
+     * thread pins itself before running its stage, and a cpu it cannot be pinned to fails the run like a throwing stage
+     * does.
+     */
+    void run_pinned(const std::vector<int> &cpus = {}) {
+        validate();
+        reset();
+        std::vector<std::thread> threads;
+        try {
+            for (std::size_t i = 0; i < nodes.size(); i++) {
+                const bool pinned = !cpus.empty();
+                const int cpu = pinned ? cpus[i % cpus.size()] : 0;
+                threads.emplace_back([this, i, pinned, cpu] {
+                    try {
+                        if (pinned)
+                            pin(cpu);
+                    } catch (...) {
+                        fail();
+                        return;
+                    }
+                    dedicated(*nodes[i]);
+                });
+            }
+        } catch (...) {
+            stop();
+            for (auto &thread: threads)
+                thread.join();
+            throw;
+        }
+        for (auto &thread: threads)
+            thread.join();
+        rethrow();
+    }
+
+private:
+
+    void validate() const {
+        for (const auto &node: nodes) {
+            for (const port *p: node->inputs)
+                if (!p->connected())
+                    throw std::invalid_argument("\nERR: stage " + node->name() + " has an unconnected input\n");
+            for (const port *p: node->outputs)
+                if (!p->connected())
+                    throw std::invalid_argument("\nERR: stage " + node->name() + " has an unconnected output\n");
+        }
+    }
+
+    void reset() {
+        error = nullptr;
+        stopping.store(false, std::memory_order_release);
+    }
+
+    // Pins the calling thread
+    static void pin(const int &cpu) {
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        if (cpu < 0 || cpu >= CPU_SETSIZE)
+            throw std::invalid_argument("\nERR: cannot pin stage thread to cpu " + std::to_string(cpu) + "\n");
+        CPU_SET(cpu, &set);
+        if (pthread_setaffinity_np(pthread_self(), sizeof(set), &set) != 0)
+            throw std::invalid_argument("\nERR: cannot pin stage thread to cpu " + std::to_string(cpu) + "\n");
+    }
+
+    // Records the exception being handled if it is the first, and stops the graph
+    void fail() {
+        {
+            std::lock_guard<std::mutex> guard(error_lock);
+            if (!error)
+                error = std::current_exception();
+        }
+        stop();
+    }
+
+    [[nodiscard]] bool active() const {
+        if (stopping.load(std::memory_order_acquire))
+            return false;
+        for (const auto &node: nodes)
+            if (!node->finished())
+                return true;
+        return false;
+    }
+
+    // Runs the stage, recording the first exception and stopping the graph if it throws
+    step attempt(stage &node) {
+        try {
+            return node.run_once();
+        } catch (...) {
+            fail();
+            return step::starved;
+        }
+    }
+
+    void drive(const std::size_t &home) {
+        while (active()) {
+            bool progressed = false;
+            for (std::size_t k = 0; k < nodes.size(); k++) {
+                stage &node = *nodes[(home + k) % nodes.size()];
+                if (!node.try_acquire())
+                    continue;
+                for (std::size_t i = 0; i < burst && !stopping.load(std::memory_order_relaxed); i++) {
+                    if (attempt(node) != step::progressed)
+                        break;
+                    progressed = true;
+                }
+                node.release();
+            }
+            if (!progressed)
+                std::this_thread::yield();
+        }
+    }
+
+    void dedicated(stage &node) {
+        if (!node.try_acquire())
+            return;
+        while (!node.finished() && !stopping.load(std::memory_order_acquire))
+            if (attempt(node) != step::progressed)
+                std::this_thread::yield();
+        node.release();
+    }
+
+    void rethrow() {
+        if (error)
+            std::rethrow_exception(error);
+    }
+};
+
+}
+
+#endif // CCOMMS_MODULES_STREAM_GRAPH_HPP_
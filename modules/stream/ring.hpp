@@ -0,0 +1,482 @@
+// Copyright(c) 2023, Matthew Petrin, All rights reserved.
+
+#ifndef CCOMMS_MODULES_STREAM_RING_HPP_
+#define CCOMMS_MODULES_STREAM_RING_HPP_
+
+#include <atomic>
+#include <memory>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <algorithm>
+#include <stdexcept>
+#include <type_traits>
+
+#include "../tensor/view.hpp"
+#include "../tensor/vector.hpp"
+#include "../tensor/expression.hpp"
+
+namespace ccomms::stream {
+
+/**
+ * @brief Alignment that keeps the positions written by different threads on separate cache lines.
+ */
+inline constexpr std::size_t cache_line = 64;
+
+/**
+ * @brief Element types a ring can hold: anything moved between threads with a plain copy, such as samples.
+ */
+template<typename T>
+concept ring_value = std::is_trivially_copyable_v<T> && std::is_default_constructible_v<T>;
+
+/**
+ * @brief Snapshot of the fill level and traffic of a ring, in samples for spsc_ring and blocks for mpmc_ring.
+ * Written and consumed count every element ever claimed, full and empty count the claims that found no room or
+ * nothing to read. The high watermark is the largest fill level seen at a write, so a value close to capacity means
+ * the consumer is falling behind.
+ */
+struct ring_statistics {
+    std::size_t capacity = 0;
+    std::size_t size = 0;
+    std::size_t high_watermark = 0;
+    std::uint64_t written = 0;
+    std::uint64_t consumed = 0;
+    std::uint64_t full = 0;
+    std::uint64_t empty = 0;
+};
+
+/**
+ * @brief Copies n elements from[first, first + n) to to[at, at + n), as one memory copy when both are contiguous
+ * buffers of the same element type.
+ */
+template<typename V, typename W>
+void copy_samples(const V &from, const std::size_t &first, W &&to, const std::size_t &at, const std::size_t &n) {
+    using O = typename std::remove_cvref_t<W>::value_type;
+
+    if constexpr (std::is_same_v<typename V::value_type, O> && requires { from.data(); to.data(); }) {
+        std::copy_n(from.data() + first, n, to.data() + at);
+    } else {
+        for (std::size_t i = 0; i < n; i++)
+            to[at + i] = static_cast<O>(from[first + i]);
+    }
+}
+
+inline std::size_t ring_capacity(const std::size_t &requested) {
+    if (requested == 0)
+        throw std::invalid_argument("\nERR: ring capacity must be positive\n");
+    std::size_t capacity = 1;
+    while (capacity < requested)
+        capacity <<= 1;
+    return capacity;
+}
+
+//***************************************************** SPSC RING **************************************************
+
+/**
+ * @class spsc_ring
+ *
+ * @brief Lock-free sample ring between one producer thread and one consumer thread.
+ *
+ * @tparam T: Sample type
+ *
+ * @ingroup stream
+ *
+ * @details The producer claims a contiguous region of free samples, fills it in place and commits the samples it
+ * wrote; the consumer claims and commits the samples it has read the same way, so blocks pass between pipeline stages
+ * without being copied. Claimed regions are vector_views and take part in vector math and the DSP blocks directly.
+ * A region ends at the end of the buffer, so a claim near the wrap returns fewer samples than asked for and the rest
+ * follows with the next claim; with a capacity that is a multiple of the block length, whole blocks are never split.
+ * The capacity is rounded up to a power of two. Each side keeps its position on its own cache line together with a
+ * cached copy of the other side's position, so the two threads only share a line when the cached copy says the ring
+ * is full or empty. Positions increase monotonically and never wrap in practice.
+ */
+template<ring_value T>
+class spsc_ring {
+
+    std::vector<T> buffer;
+    std::size_t mask;
+
+    // Producer side
+    alignas(cache_line) std::atomic<std::size_t> head{0};
+    std::size_t tail_cache = 0;
+    std::size_t write_claimed = 0;
+    std::atomic<std::size_t> watermark{0};
+    std::atomic<std::uint64_t> overflows{0};
+
+    // Consumer side
+    alignas(cache_line) std::atomic<std::size_t> tail{0};
+    std::size_t head_cache = 0;
+    std::size_t read_claimed = 0;
+    std::atomic<std::uint64_t> underflows{0};
+
+public:
+
+    using value_type = T;
+
+    /**
+     * @param capacity: Minimum number of samples the ring holds, rounded up to a power of two
+     */
+    explicit spsc_ring(const std::size_t &capacity) : buffer(ring_capacity(capacity)), mask(buffer.size() - 1) {}
+
+    spsc_ring(const spsc_ring &) = delete;
+
+    spsc_ring &operator=(const spsc_ring &) = delete;
+
+    [[nodiscard]] std::size_t capacity() const { return buffer.size(); }
+
+    /**
+     * @brief Samples written but not yet consumed. Exact on the producer and consumer threads, a snapshot elsewhere.
+     */
+    [[nodiscard]] std::size_t size() const {
+        const std::size_t t = tail.load(std::memory_order_acquire);
+        return head.load(std::memory_order_acquire) - t;
+    }
+
+    [[nodiscard]] bool empty() const { return size() == 0; }
+
+    //************************************************** PRODUCER ******************************************************
+
+    /**
+     * @brief Claims up to n free samples for writing. The region is empty when the ring is full.
+     */
+    vector_view<T> claim_write(const std::size_t &n) {
+        const std::size_t h = head.load(std::memory_order_relaxed);
+        if (buffer.size() - (h - tail_cache) < n)
+            tail_cache = tail.load(std::memory_order_acquire);
+
+        const std::size_t index = h & mask;
+        write_claimed = std::min({n, buffer.size() - (h - tail_cache), buffer.size() - index});
+        if (write_claimed == 0 && n > 0)
+            overflows.store(overflows.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        return {buffer.data() + index, write_claimed};
+    }
+
+    /**
+     * @brief Publishes the first n samples of the last claimed region to the consumer.
+     */
+    void commit_write(const std::size_t &n) {
+        if (n > write_claimed)
+            throw std::invalid_argument("\nERR: ring commit exceeds the claimed region\n");
+
+        const std::size_t h = head.load(std::memory_order_relaxed) + n;
+        head.store(h, std::memory_order_release);
+        write_claimed = 0;
+
+        const std::size_t fill = h - tail.load(std::memory_order_relaxed);
+        if (fill > watermark.load(std::memory_order_relaxed))
+            watermark.store(fill, std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Copies as many samples of in as there is room for and returns how many were written.
+     */
+    template<typename V>
+    requires indexable<V>
+    std::size_t write(const V &in) {
+        std::size_t done = 0;
+        while (done < in.size()) {
+            vector_view<T> region = claim_write(in.size() - done);
+            if (region.empty())
+                break;
+            copy_samples(in, done, region, 0, region.size());
+            commit_write(region.size());
+            done += region.size();
+        }
+        return done;
+    }
+
+    //************************************************** CONSUMER ******************************************************
+
+    /**
+     * @brief Claims up to n written samples for reading. The region is empty when the ring is empty.
+     */
+    vector_view<const T> claim_read(const std::size_t &n) {
+        const std::size_t t = tail.load(std::memory_order_relaxed);
+        if (head_cache - t < n)
+            head_cache = head.load(std::memory_order_acquire);
+
+        const std::size_t index = t & mask;
+        read_claimed = std::min({n, head_cache - t, buffer.size() - index});
+        if (read_claimed == 0 && n > 0)
+            underflows.store(underflows.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        return {buffer.data() + index, read_claimed};
+    }
+
+    /**
+     * @brief Returns the first n samples of the last claimed region to the producer.
+     */
+    void commit_read(const std::size_t &n) {
+        if (n > read_claimed)
+            throw std::invalid_argument("\nERR: ring commit exceeds the claimed region\n");
+
+        tail.store(tail.load(std::memory_order_relaxed) + n, std::memory_order_release);
+        read_claimed = 0;
+    }
+
+    /**
+     * @brief Copies up to out.size() samples into out and returns how many were read.
+     */
+    template<typename W>
+    requires indexable<std::remove_cvref_t<W> >
+    std::size_t read(W &&out) {
+        std::size_t done = 0;
+        while (done < out.size()) {
+            vector_view<const T> region = claim_read(out.size() - done);
+            if (region.empty())
+                break;
+            copy_samples(region, 0, out, done, region.size());
+            commit_read(region.size());
+            done += region.size();
+        }
+        return done;
+    }
+
+    //************************************************* STATISTICS *****************************************************
+
+    [[nodiscard]] ring_statistics stats() const {
+        ring_statistics result;
+        result.capacity = buffer.size();
+        result.consumed = tail.load(std::memory_order_acquire);
+        result.written = head.load(std::memory_order_acquire);
+        result.size = static_cast<std::size_t>(result.written - result.consumed);
+        result.high_watermark = watermark.load(std::memory_order_relaxed);
+        result.full = overflows.load(std::memory_order_relaxed);
+        result.empty = underflows.load(std::memory_order_relaxed);
+        return result;
+    }
+
+    /**
+     * @brief Restarts the high watermark from the current fill level. Call from the producer thread.
+     */
+    void reset_watermark() {
+        watermark.store(size(), std::memory_order_relaxed);
+    }
+};
+
+//***************************************************** MPMC RING **************************************************
+
+/**
+ * @class mpmc_ring
+ *
+ * @brief Lock-free ring of fixed-size sample blocks shared by any number of producer and consumer threads.
+ *
+ * @tparam T: Sample type
+ *
+ * @ingroup stream
+ *
+ * @details Storage is a ring of slots, each holding one block of up to block_size() samples. A producer claims a
+ * whole free slot, fills it in place and commits the number of samples it wrote; a consumer claims the oldest
+ * committed slot, reads it in place and commits it back as free. Claiming is one compare-and-swap on the shared
+ * enqueue or dequeue position, and every slot carries a sequence number telling the claimant whether it is free or
+ * holds a block, so no thread ever waits on a lock. Blocks are consumed in the order their slots were claimed: a
+ * producer that claims a slot and stalls before committing holds back the consumers behind it, so commit promptly.
+ * The number of slots is rounded up to a power of two of at least two, since with a single slot a freed slot and
+ * a committed block would carry the same sequence number. The slot headers and positions sit on their own cache
+ * lines.
+ */
+template<ring_value T>
+class mpmc_ring {
+
+    struct alignas(cache_line) slot {
+        std::atomic<std::size_t> sequence{0};
+        std::size_t length = 0;
+    };
+
+    std::size_t block;
+    std::size_t mask;
+    std::unique_ptr<slot[]> slots;
+    std::vector<T> samples;
+
+    alignas(cache_line) std::atomic<std::size_t> enqueue{0};
+    alignas(cache_line) std::atomic<std::size_t> dequeue{0};
+    alignas(cache_line) std::atomic<std::size_t> watermark{0};
+    std::atomic<std::uint64_t> overflows{0};
+    std::atomic<std::uint64_t> underflows{0};
+
+public:
+
+    using value_type = T;
+
+    /**
+     * @brief A slot claimed for writing and the position it was claimed at.
+     */
+    struct write_claim {
+        vector_view<T> samples;
+        std::size_t position = 0;
+    };
+
+    /**
+     * @brief A committed block claimed for reading and the position it was claimed at.
+     */
+    struct read_claim {
+        vector_view<const T> samples;
+        std::size_t position = 0;
+    };
+
+    /**
+     * @param blocks: Minimum number of blocks the ring holds, rounded up to a power of two of at least two
+     * @param block_size: Maximum samples per block
+     */
+    mpmc_ring(const std::size_t &blocks, const std::size_t &block_size)
+            : block(block_size), mask(std::max<std::size_t>(ring_capacity(blocks), 2) - 1),
+              slots(new slot[mask + 1]), samples((mask + 1) * block_size) {
+        if (block_size == 0)
+            throw std::invalid_argument("\nERR: ring block size must be positive\n");
+        for (std::size_t i = 0; i <= mask; i++)
+            slots[i].sequence.store(i, std::memory_order_relaxed);
+    }
+
+    mpmc_ring(const mpmc_ring &) = delete;
+
+    mpmc_ring &operator=(const mpmc_ring &) = delete;
+
+    /**
+     * @brief Number of blocks the ring holds.
+     */
+    [[nodiscard]] std::size_t capacity() const { return mask + 1; }
+
+    [[nodiscard]] std::size_t block_size() const { return block; }
+
+    /**
+     * @brief Blocks claimed for writing but not yet claimed for reading, a snapshot while other threads run.
+     */
+    [[nodiscard]] std::size_t size() const {
+        const std::size_t d = dequeue.load(std::memory_order_acquire);
+        const std::size_t e = enqueue.load(std::memory_order_acquire);
+        return e > d ? e - d : 0;
+    }
+
+    [[nodiscard]] bool empty() const { return size() == 0; }
+
+    //************************************************** PRODUCER ******************************************************
+
+    /**
+     * @brief Claims a free slot of block_size() samples, or nothing when every slot holds a block.
+     */
+    std::optional<write_claim> try_claim_write() {
+        std::size_t pos = enqueue.load(std::memory_order_relaxed);
+        while (true) {
+            const std::size_t sequence = slots[pos & mask].sequence.load(std::memory_order_acquire);
+            const auto lag = static_cast<std::ptrdiff_t>(sequence - pos);
+            if (lag == 0) {
+                if (enqueue.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                    break;
+            } else if (lag < 0) {
+                overflows.fetch_add(1, std::memory_order_relaxed);
+                return std::nullopt;
+            } else {
+                pos = enqueue.load(std::memory_order_relaxed);
+            }
+        }
+
+        const std::size_t fill = pos + 1 - std::min(pos + 1, dequeue.load(std::memory_order_relaxed));
+        std::size_t seen = watermark.load(std::memory_order_relaxed);
+        while (fill > seen && !watermark.compare_exchange_weak(seen, fill, std::memory_order_relaxed)) {}
+
+        return write_claim{vector_view<T>(samples.data() + (pos & mask) * block, block), pos};
+    }
+
+    /**
+     * @brief Publishes the first n samples of a claimed slot as a block.
+     */
+    void commit_write(const write_claim &claim, const std::size_t &n) {
+        if (n > block)
+            throw std::invalid_argument("\nERR: ring commit exceeds the claimed region\n");
+        slot &s = slots[claim.position & mask];
+        s.length = n;
+        s.sequence.store(claim.position + 1, std::memory_order_release);
+    }
+
+    /**
+     * @brief Copies in as one block if a slot is free. Returns false when the ring is full.
+     */
+    template<typename V>
+    requires indexable<V>
+    bool try_push(const V &in) {
+        if (in.size() > block)
+            throw std::invalid_argument("\nERR: block is longer than the ring block size\n");
+
+        const std::optional<write_claim> claim = try_claim_write();
+        if (!claim)
+            return false;
+        copy_samples(in, 0, claim->samples, 0, in.size());
+        commit_write(*claim, in.size());
+        return true;
+    }
+
+    //************************************************** CONSUMER ******************************************************
+
+    /**
+     * @brief Claims the oldest committed block, or nothing when no block is ready.
+     */
+    std::optional<read_claim> try_claim_read() {
+        std::size_t pos = dequeue.load(std::memory_order_relaxed);
+        while (true) {
+            const std::size_t sequence = slots[pos & mask].sequence.load(std::memory_order_acquire);
+            const auto lag = static_cast<std::ptrdiff_t>(sequence - (pos + 1));
+            if (lag == 0) {
+                if (dequeue.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                    break;
+            } else if (lag < 0) {
+                underflows.fetch_add(1, std::memory_order_relaxed);
+                return std::nullopt;
+            } else {
+                pos = dequeue.load(std::memory_order_relaxed);
+            }
+        }
+
+        const slot &s = slots[pos & mask];
+        return read_claim{vector_view<const T>(samples.data() + (pos & mask) * block, s.length), pos};
+    }
+
+    /**
+     * @brief Returns a claimed block's slot to the producers.
+     */
+    void commit_read(const read_claim &claim) {
+        slots[claim.position & mask].sequence.store(claim.position + mask + 1, std::memory_order_release);
+    }
+
+    /**
+     * @brief Copies the oldest block into out, which must hold block_size() samples, and returns its length. Returns
+     * nothing when no block is ready.
+     */
+    template<typename W>
+    requires indexable<std::remove_cvref_t<W> >
+    std::optional<std::size_t> try_pop(W &&out) {
+        if (out.size() < block)
+            throw std::invalid_argument("\nERR: output holds fewer samples than the ring block size\n");
+
+        const std::optional<read_claim> claim = try_claim_read();
+        if (!claim)
+            return std::nullopt;
+        copy_samples(claim->samples, 0, out, 0, claim->samples.size());
+        commit_read(*claim);
+        return claim->samples.size();
+    }
+
+    //************************************************* STATISTICS *****************************************************
+
+    [[nodiscard]] ring_statistics stats() const {
+        ring_statistics result;
+        result.capacity = mask + 1;
+        result.consumed = dequeue.load(std::memory_order_acquire);
+        result.written = enqueue.load(std::memory_order_acquire);
+        result.size = result.written > result.consumed ? static_cast<std::size_t>(result.written - result.consumed) : 0;
+        result.high_watermark = watermark.load(std::memory_order_relaxed);
+        result.full = overflows.load(std::memory_order_relaxed);
+        result.empty = underflows.load(std::memory_order_relaxed);
+        return result;
+    }
+
+    /**
+     * @brief Restarts the high watermark from the current fill level.
+     */
+    void reset_watermark() {
+        watermark.store(size(), std::memory_order_relaxed);
+    }
+};
+
+}
+
+#endif // CCOMMS_MODULES_STREAM_RING_HPP_
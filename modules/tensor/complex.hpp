@@ -0,0 +1,202 @@
+// Copyright(c) 2023, Matthew Petrin, All rights reserved.
+
+#ifndef CCOMMS_MODULES_TENSOR_COMPLEX_HPP_
+#define CCOMMS_MODULES_TENSOR_COMPLEX_HPP_
+
+#include <complex>
+#include <ostream>
+#include <stdexcept>
+#include <type_traits>
+
+#include "simd.hpp"
+#include "vector.hpp"
+#include "expression.hpp"
+
+namespace ccomms {
+
+//*************************************************** ELEMENTWISE **************************************************
+
+/**
+ * @brief Lazy elementwise complex conjugate. Real operands are passed through unchanged.
+ */
+template<typename V>
+requires tensor_operand<V>
+auto conj(V &&v) {
+    return make_expression<ops::conj>(std::forward<V>(v));
+}
+
+/**
+ * @brief Lazy elementwise magnitude squared.
+ */
+template<typename V>
+requires tensor_operand<V>
+auto norm(V &&v) {
+    return make_expression<ops::norm>(std::forward<V>(v));
+}
+
+/**
+ * @brief Lazy elementwise real part.
+ */
+template<typename V>
+requires tensor_operand<V>
+auto real(V &&v) {
+    return make_expression<ops::real>(std::forward<V>(v));
+}
+
+/**
+ * @brief Lazy elementwise imaginary part.
+ */
+template<typename V>
+requires tensor_operand<V>
+auto imag(V &&v) {
+    return make_expression<ops::imag>(std::forward<V>(v));
+}
+
+//************************************************* SPLIT COMPLEX **************************************************
+
+/**
+ * @class split_complex
+ *
+ * @brief A complex vector stored as separate real and imaginary vectors (structure of arrays).
+ *
+ * @tparam T: Real component type, float or double
+ * @tparam Policy: Element type conversion policy from ccomms::conversion, applied when converting interleaved data
+ *
+ * @ingroup tensor
+ *
+ * @details Interleaved std::complex storage forces every kernel to shuffle real and imaginary lanes apart. Keeping the
+ * components in two contiguous vectors lets the Hermitian inner product, magnitude squared and complex products run
+ * as plain SIMD arithmetic. Conversion to and from interleaved vectors is provided for interoperating with
+ * ccomms::vector<std::complex<T>>.
+ */
+template<typename T, typename Policy = conversion::warn_once>
+class split_complex {
+
+    static_assert(std::is_same_v<T, float> || std::is_same_v<T, double>,
+                  "\nERR: split_complex component type must be float or double\n");
+
+    vector<T> re;
+    vector<T> im;
+
+public:
+
+    using value_type = std::complex<T>;
+
+    //************************************************** CONSTRUCTORS **************************************************
+
+    explicit split_complex(const std::size_t &len = 0) : re(len, T(0)), im(len, T(0)) {}
+
+    split_complex(const vector<T> &re, const vector<T> &im) : re(re), im(im) {
+        if (re.size() != im.size())
+            throw std::invalid_argument("\nERR: split_complex requires real and imaginary parts of equal length\n");
+    }
+
+    template<typename V, typename U = typename V::value_type>
+    requires is_complex_v<U>
+    explicit split_complex(const V &interleaved) : re(interleaved.size(), T(0)), im(interleaved.size(), T(0)) {
+        for (std::size_t i = 0; i < interleaved.size(); i++) {
+            re[i] = static_cast<T>(interleaved[i].real());
+            im[i] = static_cast<T>(interleaved[i].imag());
+        }
+
+        conversion::check<Policy, typename U::value_type, T>(
+                "\nWARNING: split_complex interleaved constructor performing type conversion\n");
+    }
+
+    //**************************************************** ACCESS ******************************************************
+
+    [[nodiscard]] std::size_t size() const { return re.size(); }
+
+    [[nodiscard]] bool empty() const { return re.empty(); }
+
+    std::complex<T> operator[](const std::size_t &i) const { return {re[i], im[i]}; }
+
+    void set(const std::size_t &i, const std::complex<T> &value) {
+        re[i] = value.real();
+        im[i] = value.imag();
+    }
+
+    vector<T> &real() { return re; }
+
+    const vector<T> &real() const { return re; }
+
+    vector<T> &imag() { return im; }
+
+    const vector<T> &imag() const { return im; }
+
+    vector<std::complex<T> > interleave() const {
+        vector<std::complex<T> > result(size(), std::complex<T>(0));
+        for (std::size_t i = 0; i < size(); i++)
+            result[i] = {re[i], im[i]};
+        return result;
+    }
+
+    //************************************************** VECTOR MATH ***************************************************
+
+    /**
+     * @brief Hermitian inner product, the sum of conj(this[i]) * other[i].
+     */
+    std::complex<T> operator|(const split_complex &other) const {
+        if (other.size() != size())
+            throw std::invalid_argument("\nERR: inner product requires vectors of the same length\n");
+
+        return simd::split_dotc(re.data(), im.data(), other.re.data(), other.im.data(), size());
+    }
+
+    /**
+     * @brief Elementwise complex product.
+     */
+    split_complex operator*(const split_complex &other) const {
+        if (other.size() != size())
+            throw std::invalid_argument("\nERR: elementwise multiplication requires vectors of equal length\n");
+
+        split_complex result(size());
+        simd::split_mul<false>(result.re.data(), result.im.data(), re.data(), im.data(), other.re.data(),
+                               other.im.data(), size());
+        return result;
+    }
+
+    /**
+     * @brief Elementwise conj(this[i]) * other[i], the per-sample terms of a correlation.
+     */
+    split_complex conj_mul(const split_complex &other) const {
+        if (other.size() != size())
+            throw std::invalid_argument("\nERR: elementwise multiplication requires vectors of equal length\n");
+
+        split_complex result(size());
+        simd::split_mul<true>(result.re.data(), result.im.data(), re.data(), im.data(), other.re.data(),
+                              other.im.data(), size());
+        return result;
+    }
+
+    split_complex conj() const {
+        split_complex result(re, im);
+        for (std::size_t i = 0; i < size(); i++)
+            result.im[i] = -im[i];
+        return result;
+    }
+
+    /**
+     * @brief Elementwise magnitude squared.
+     */
+    vector<T> norm() const {
+        vector<T> result(size(), T(0));
+        simd::split_norm(result.data(), re.data(), im.data(), size());
+        return result;
+    }
+};
+
+template<typename T, typename Policy>
+std::ostream &operator<<(std::ostream &os, const split_complex<T, Policy> &vec) {
+    os << "[";
+    for (std::size_t i = 0; i < vec.size(); i++) {
+        os << vec[i];
+        if (i != vec.size() - 1) os << ", ";
+    }
+    os << "]";
+    return os;
+}
+
+}
+
+#endif // CCOMMS_MODULES_TENSOR_COMPLEX_HPP_
@@ -0,0 +1,102 @@
+// Copyright(c) 2023, Matthew Petrin, All rights reserved.
+
+#ifndef CCOMMS_MODULES_TENSOR_CONVERSION_HPP_
+#define CCOMMS_MODULES_TENSOR_CONVERSION_HPP_
+
+#include <atomic>
+#include <cstdio>
+#include <cstddef>
+#include <type_traits>
+
+namespace ccomms::conversion {
+
+//**************************************************** POLICIES ****************************************************
+
+/**
+ * @brief Element type conversions are performed silently.
+ */
+struct allow {
+    static constexpr bool permitted = true;
+    static constexpr bool diagnose = false;
+};
+
+/**
+ * @brief Element type conversions are performed and reported on stderr the first time each source and destination
+ * type pair is seen. Later conversions of the same pair cost a single relaxed atomic load.
+ */
+struct warn_once {
+    static constexpr bool permitted = true;
+    static constexpr bool diagnose = true;
+};
+
+/**
+ * @brief Element type conversions are rejected at compile time.
+ */
+struct forbid {
+    static constexpr bool permitted = false;
+    static constexpr bool diagnose = false;
+};
+
+template<typename P>
+concept policy = requires {
+    { P::permitted } -> std::convertible_to<bool>;
+    { P::diagnose } -> std::convertible_to<bool>;
+};
+
+//*************************************************** DIAGNOSTICS **************************************************
+
+inline std::atomic<std::size_t> &warning_count() {
+    static std::atomic<std::size_t> count{0};
+    return count;
+}
+
+/**
+ * @brief Number of distinct conversion diagnostics emitted so far.
+ */
+inline std::size_t warnings() {
+    return warning_count().load(std::memory_order_relaxed);
+}
+
+template<typename From, typename To>
+[[gnu::cold, gnu::noinline]] void report(const char *message) {
+    static std::atomic<bool> fired{false};
+    if (fired.exchange(true, std::memory_order_relaxed))
+        return;
+
+    warning_count().fetch_add(1, std::memory_order_relaxed);
+    std::fputs(message, stderr);
+}
+
+template<typename From, typename To>
+inline std::atomic<bool> &seen() {
+    static std::atomic<bool> flag{false};
+    return flag;
+}
+
+/**
+ * @brief Applies the conversion policy to a conversion from From to To. Does nothing when the types match.
+ *
+ * @details The check is resolved at compile time: allow compiles to nothing, forbid fails with the given message and
+ * warn_once tests a per type pair flag, only taking the cold reporting path the first time. Conversions performed
+ * during constant evaluation are never reported.
+ */
+template<policy Policy, typename From, typename To>
+constexpr void check(const char *message) {
+    if constexpr (!std::is_same_v<From, To>) {
+        static_assert(Policy::permitted, "\nERR: element type conversion forbidden by conversion policy\n");
+
+        if constexpr (Policy::diagnose) {
+            if (std::is_constant_evaluated())
+                return;
+
+            if (!seen<From, To>().load(std::memory_order_relaxed)) {
+                seen<From, To>().store(true, std::memory_order_relaxed);
+                report<From, To>(message);
+            }
+        }
+    }
+}
+
+}
+
+#endif // CCOMMS_MODULES_TENSOR_CONVERSION_HPP_
@@ -0,0 +1,403 @@
+// Copyright(c) 2023, Matthew Petrin, All rights reserved.
+
+#ifndef CCOMMS_MODULES_TENSOR_EXECUTION_HPP_
+#define CCOMMS_MODULES_TENSOR_EXECUTION_HPP_
+
+#include <deque>
+#include <mutex>
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <vector>
+#include <cstddef>
+#include <utility>
+#include <exception>
+#include <algorithm>
+#include <stdexcept>
+#include <functional>
+#include <type_traits>
+#include <condition_variable>
+
+#include <unistd.h>
+
+#include "simd.hpp"
+#include "vector.hpp"
+#include "expression.hpp"
+
+namespace ccomms::execution {
+
+//*************************************************** THREAD POOL **************************************************
+
+/**
+ * @class thread_pool
+ *
+ * @brief A work-stealing thread pool running the chunks of parallel vector operations.
+ *
+ * @ingroup tensor
+ *
+ * @details Every worker owns a task deque: it pushes and pops its own work at the back and, once that runs dry,
+ * steals from the front of the other deques, so the oldest and usually largest pieces of work migrate between
+ * threads. Threads outside the pool submit through a shared injection deque. A thread waiting in parallel_for runs
+ * queued tasks rather than blocking, which lets parallel_for nest and lets a pool without workers run everything on
+ * the calling thread.
+ */
+class thread_pool {
+
+    struct task_queue {
+        std::mutex lock;
+        std::deque<std::function<void()> > tasks;
+    };
+
+    static constexpr std::size_t external = static_cast<std::size_t>(-1);
+
+    std::vector<std::unique_ptr<task_queue> > queues;
+    std::vector<std::thread> workers;
+
+    std::mutex sleep_lock;
+    std::condition_variable wake;
+    std::size_t pending = 0;
+    bool stopping = false;
+
+    static thread_pool *&current_pool() {
+        thread_local thread_pool *pool = nullptr;
+        return pool;
+    }
+
+    static std::size_t &current_index() {
+        thread_local std::size_t index = external;
+        return index;
+    }
+
+public:
+
+    /**
+     * @param threads: Number of worker threads, not counting the threads that submit work
+     */
+    explicit thread_pool(const std::size_t &threads) {
+        for (std::size_t i = 0; i <= threads; i++)
+            queues.push_back(std::make_unique<task_queue>());
+        for (std::size_t i = 0; i < threads; i++)
+            workers.emplace_back([this, i] { work(i); });
+    }
+
+    thread_pool(const thread_pool &) = delete;
+
+    thread_pool &operator=(const thread_pool &) = delete;
+
+    ~thread_pool() {
+        {
+            std::lock_guard<std::mutex> guard(sleep_lock);
+            stopping = true;
+        }
+        wake.notify_all();
+        for (auto &worker: workers)
+            worker.join();
+    }
+
+    /**
+     * @brief Number of threads that take part in parallel_for: the workers plus the calling thread.
+     */
+    [[nodiscard]] std::size_t concurrency() const { return workers.size() + 1; }
+
+    void submit(std::function<void()> task) {
+        const std::size_t index = queue_of_caller();
+        const std::size_t target = index < workers.size() ? index : workers.size();
+        {
+            std::lock_guard<std::mutex> guard(queues[target]->lock);
+            queues[target]->tasks.push_back(std::move(task));
+        }
+        {
+            std::lock_guard<std::mutex> guard(sleep_lock);
+            pending++;
+        }
+        wake.notify_one();
+    }
+
+    /**
+     * @brief Calls body(i) for every i in [0, count) across the pool and returns once all calls have finished. The
+     * first exception thrown by body is rethrown here.
+     */
+    template<typename F>
+    void parallel_for(const std::size_t &count, F &&body) {
+        if (count == 1 || workers.empty()) {
+            for (std::size_t i = 0; i < count; i++)
+                body(i);
+            return;
+        }
+
+        std::atomic<std::size_t> remaining{count};
+        std::exception_ptr error;
+        std::mutex error_lock;
+
+        for (std::size_t i = 0; i < count; i++)
+            submit([&, i] {
+                try {
+                    body(i);
+                } catch (...) {
+                    std::lock_guard<std::mutex> guard(error_lock);
+                    if (!error)
+                        error = std::current_exception();
+                }
+                remaining.fetch_sub(1, std::memory_order_release);
+            });
+
+        const std::size_t self = queue_of_caller();
+        while (remaining.load(std::memory_order_acquire) > 0)
+            if (!run_one(self))
+                std::this_thread::yield();
+
+        if (error)
+            std::rethrow_exception(error);
+    }
+
+private:
+
+    [[nodiscard]] std::size_t queue_of_caller() const {
+        return current_pool() == this ? current_index() : workers.size();
+    }
+
+    bool run_one(const std::size_t &self) {
+        std::function<void()> task;
+
+        {
+            std::lock_guard<std::mutex> guard(queues[self]->lock);
+            if (!queues[self]->tasks.empty()) {
+                task = std::move(queues[self]->tasks.back());
+                queues[self]->tasks.pop_back();
+            }
+        }
+
+        for (std::size_t k = 1; !task && k < queues.size(); k++) {
+            task_queue &victim = *queues[(self + k) % queues.size()];
+            std::lock_guard<std::mutex> guard(victim.lock);
+            if (!victim.tasks.empty()) {
+                task = std::move(victim.tasks.front());
+                victim.tasks.pop_front();
+            }
+        }
+
+        if (!task)
+            return false;
+
+        {
+            std::lock_guard<std::mutex> guard(sleep_lock);
+            pending--;
+        }
+        task();
+        return true;
+    }
+
+    void work(const std::size_t &index) {
+        current_pool() = this;
+        current_index() = index;
+
+        while (true) {
+            if (run_one(index))
+                continue;
+
+            std::unique_lock<std::mutex> guard(sleep_lock);
+            wake.wait(guard, [this] { return stopping || pending > 0; });
+            if (stopping && pending == 0)
+                return;
+        }
+    }
+};
+
+/**
+ * @brief Pool used by the parallel policies unless another one is given, with one worker less than the hardware
+ * threads since the calling thread takes part as well.
+ */
+inline thread_pool &default_pool() {
+    static thread_pool pool(std::max(std::thread::hardware_concurrency(), 1u) - 1);
+    return pool;
+}
+
+//**************************************************** POLICIES ****************************************************
+
+/**
+ * @brief Runs on the calling thread.
+ */
+struct sequenced_policy {};
+
+/**
+ * @brief Splits the work into chunks run across a thread pool.
+ */
+struct parallel_policy {
+    thread_pool *pool = nullptr;
+
+    /**
+     * @brief The same policy running on the given pool rather than the default one.
+     */
+    [[nodiscard]] parallel_policy on(thread_pool &target) const { return {&target}; }
+
+    [[nodiscard]] thread_pool &executor() const { return pool ? *pool : default_pool(); }
+};
+
+/**
+ * @brief Splits the work into chunks run across a thread pool, each chunk on the SIMD kernels.
+ */
+struct parallel_unsequenced_policy {
+    thread_pool *pool = nullptr;
+
+    [[nodiscard]] parallel_unsequenced_policy on(thread_pool &target) const { return {&target}; }
+
+    [[nodiscard]] thread_pool &executor() const { return pool ? *pool : default_pool(); }
+};
+
+inline constexpr sequenced_policy seq{};
+inline constexpr parallel_policy par{};
+inline constexpr parallel_unsequenced_policy par_unseq{};
+
+template<typename P>
+inline constexpr bool is_execution_policy_v = std::is_same_v<std::remove_cvref_t<P>, sequenced_policy> ||
+                                              std::is_same_v<std::remove_cvref_t<P>, parallel_policy> ||
+                                              std::is_same_v<std::remove_cvref_t<P>, parallel_unsequenced_policy>;
+
+template<typename P>
+concept policy = is_execution_policy_v<P>;
+
+//**************************************************** CHUNKING ****************************************************
+
+/**
+ * @brief Size of the per-core L2 cache, or 1 MiB where the system does not report it.
+ */
+inline std::size_t cache_bytes() {
+    static const std::size_t bytes = [] {
+#ifdef _SC_LEVEL2_CACHE_SIZE
+        const long reported = ::sysconf(_SC_LEVEL2_CACHE_SIZE);
+        if (reported > 0)
+            return static_cast<std::size_t>(reported);
+#endif
+        return std::size_t(1) << 20;
+    }();
+    return bytes;
+}
+
+/**
+ * @brief Elements per chunk of an elementwise operation touching the given number of buffers, sized so that one
+ * chunk of every buffer fits in half of the L2 cache and rounded to whole cache lines.
+ */
+template<typename T>
+std::size_t chunk_size(const std::size_t &streams) {
+    const std::size_t line = std::max<std::size_t>(64 / sizeof(T), 1);
+    const std::size_t elements = cache_bytes() / 2 / (streams * sizeof(T));
+    return std::max(line, elements / line * line);
+}
+
+/**
+ * @brief Elements per block of a parallel reduction. Fixed rather than derived from the cache or thread count so
+ * that the summation order, and with it the rounding of the result, is the same on every run.
+ */
+inline constexpr std::size_t reduction_block = std::size_t(1) << 14;
+
+/**
+ * @brief Calls body(first, count) for consecutive chunks of [0, len), across the pool of a parallel policy.
+ */
+template<policy P, typename F>
+void for_each_chunk(const P &policy, const std::size_t &len, const std::size_t &chunk, F &&body) {
+    const std::size_t chunks = (len + chunk - 1) / chunk;
+    auto run = [&](const std::size_t &c) { body(c * chunk, std::min(chunk, len - c * chunk)); };
+
+    if constexpr (std::is_same_v<P, sequenced_policy>) {
+        for (std::size_t c = 0; c < chunks; c++)
+            run(c);
+    } else {
+        policy.executor().parallel_for(chunks, run);
+    }
+}
+
+}
+
+namespace ccomms {
+
+//************************************************ PARALLEL ALGORITHMS **********************************************
+
+/**
+ * @brief Evaluates src into dst under an execution policy, a chunk at a time. dst is a vector or mutable view of the
+ * same length as src, which may be an expression or any indexable container.
+ */
+template<execution::policy P, typename D, typename S>
+requires indexable<D> && indexable<S>
+D &assign(const P &policy, D &dst, const S &src) {
+    using T = typename D::value_type;
+
+    if (dst.size() != src.size())
+        throw std::invalid_argument("\nERR: parallel assignment requires a destination of equal length\n");
+
+    execution::for_each_chunk(policy, dst.size(), execution::chunk_size<T>(3), [&](std::size_t first,
+                                                                                    std::size_t count) {
+        if constexpr (simd::kernel_type<T> && simd::contiguous<D> && is_expression_v<S>)
+            if (simd::evaluate(dst.data(), src, first, count))
+                return;
+
+        for (std::size_t i = first; i < first + count; i++)
+            dst[i] = static_cast<T>(src[i]);
+    });
+    return dst;
+}
+
+/**
+ * @brief Materializes an expression into a new vector under an execution policy.
+ */
+template<execution::policy P, typename E>
+requires is_expression_v<E>
+auto eval(const P &policy, const E &expr) {
+    using T = typename E::value_type;
+    vector<T, static_extent_v<E> > result(expr.size(), T());
+    assign(policy, result, expr);
+    return result;
+}
+
+/**
+ * @brief Inner product under an execution policy, Hermitian for complex operands like operator|.
+ *
+ * @details The operands are cut into blocks of execution::reduction_block elements whose partial products are summed
+ * in block order with compensation, so the result is bitwise identical for every policy, pool and thread count. It
+ * may differ in the last bits from operator|, which sums the whole vector in one pass.
+ */
+template<execution::policy P, typename A, typename B>
+requires indexable<A> && indexable<B>
+auto inner(const P &policy, const A &a, const B &b) {
+    using T = typename A::value_type;
+    using U = typename B::value_type;
+    using C = std::common_type_t<T, U>;
+
+    if (a.size() != b.size())
+        throw std::invalid_argument("\nERR: inner product requires vectors of the same length\n");
+
+    const std::size_t blocks = (a.size() + execution::reduction_block - 1) / execution::reduction_block;
+    std::vector<C> partial(blocks, C(0));
+
+    execution::for_each_chunk(policy, a.size(), execution::reduction_block, [&](std::size_t first,
+                                                                               std::size_t count) {
+        C &sum = partial[first / execution::reduction_block];
+
+        if constexpr (std::is_same_v<T, U> && simd::kernel_type<T> && simd::contiguous<A> && simd::contiguous<B>) {
+            if constexpr (is_complex_v<T>)
+                sum = simd::dotc(a.data() + first, b.data() + first, count);
+            else
+                sum = simd::dot(a.data() + first, b.data() + first, count);
+        } else {
+            for (std::size_t i = first; i < first + count; i++)
+                sum += ops::conj{}(static_cast<C>(a[i])) * static_cast<C>(b[i]);
+        }
+    });
+
+    if constexpr (is_complex_v<C>) {
+        typename C::value_type re = 0, re_comp = 0, im = 0, im_comp = 0;
+        for (const auto &value: partial) {
+            simd::compensated_add(re, re_comp, value.real());
+            simd::compensated_add(im, im_comp, value.imag());
+        }
+        return C(re + re_comp, im + im_comp);
+    } else {
+        C sum = 0, comp = 0;
+        for (const auto &value: partial)
+            simd::compensated_add(sum, comp, value);
+        return static_cast<C>(sum + comp);
+    }
+}
+
+}
+
+#endif // CCOMMS_MODULES_TENSOR_EXECUTION_HPP_
@@ -0,0 +1,545 @@
+// Copyright(c) 2023, Matthew Petrin, All rights reserved.
+
+#ifndef CCOMMS_MODULES_TENSOR_EXPRESSION_HPP_
+#define CCOMMS_MODULES_TENSOR_EXPRESSION_HPP_
+
+#include <array>
+#include <string>
+#include <complex>
+#include <cstddef>
+#include <memory>
+#include <utility>
+#include <iterator>
+#include <concepts>
+#include <stdexcept>
+#include <algorithm>
+#include <type_traits>
+
+namespace ccomms {
+
+namespace conversion {
+struct warn_once;
+}
+
+template<typename T, std::size_t N, typename Policy, typename Alloc, std::size_t Inline>
+class vector;
+
+template<typename T, std::size_t Extent, bool Strided>
+class vector_view;
+
+template<typename Op, typename L, typename R>
+class expression;
+
+template<typename Op, typename E>
+class unary_expression;
+
+template<typename U>
+class scalar;
+
+//***************************************************** TRAITS *****************************************************
+
+template<typename T, std::size_t N, typename Policy, typename Alloc, std::size_t Inline>
+std::true_type is_vector_test(const vector<T, N, Policy, Alloc, Inline> *);
+
+std::false_type is_vector_test(...);
+
+template<typename V>
+inline constexpr bool is_vector_v = decltype(is_vector_test(std::declval<std::remove_cvref_t<V> *>()))::value;
+
+template<typename T, std::size_t Extent, bool Strided>
+std::true_type is_view_test(const vector_view<T, Extent, Strided> *);
+
+std::false_type is_view_test(...);
+
+template<typename V>
+inline constexpr bool is_view_v = decltype(is_view_test(std::declval<std::remove_cvref_t<V> *>()))::value;
+
+template<typename V>
+struct is_expression : std::false_type {};
+
+template<typename Op, typename L, typename R>
+struct is_expression<expression<Op, L, R> > : std::true_type {};
+
+template<typename Op, typename E>
+struct is_expression<unary_expression<Op, E> > : std::true_type {};
+
+template<typename V>
+inline constexpr bool is_expression_v = is_expression<std::remove_cvref_t<V> >::value;
+
+template<typename V>
+struct is_scalar : std::false_type {};
+
+template<typename U>
+struct is_scalar<scalar<U> > : std::true_type {};
+
+template<typename V>
+inline constexpr bool is_scalar_v = is_scalar<std::remove_cvref_t<V> >::value;
+
+template<typename V>
+struct is_complex : std::false_type {};
+
+template<typename T>
+struct is_complex<std::complex<T> > : std::true_type {};
+
+template<typename V>
+inline constexpr bool is_complex_v = is_complex<std::remove_cvref_t<V> >::value;
+
+template<typename V>
+struct static_extent : std::integral_constant<std::size_t, 0> {};
+
+template<typename T, std::size_t N>
+struct static_extent<std::array<T, N> > : std::integral_constant<std::size_t, N> {};
+
+template<typename T, std::size_t N, typename Policy, typename Alloc, std::size_t Inline>
+struct static_extent<vector<T, N, Policy, Alloc, Inline> > : std::integral_constant<std::size_t, N> {};
+
+template<typename T, std::size_t Extent, bool Strided>
+struct static_extent<vector_view<T, Extent, Strided> > : std::integral_constant<std::size_t, Extent> {};
+
+/**
+ * @brief Static length of an elementwise operation, 0 when it is only known at runtime. A single element operand
+ * broadcast over an operand of runtime length leaves the result length unknown.
+ */
+template<typename Op, typename L, typename R>
+constexpr std::size_t expression_extent() {
+    constexpr std::size_t lhs_extent = static_extent<L>::value;
+    constexpr std::size_t rhs_extent = static_extent<R>::value;
+
+    if constexpr (is_scalar_v<L>)
+        return rhs_extent;
+    else if constexpr (is_scalar_v<R>)
+        return lhs_extent;
+    else if constexpr (lhs_extent && rhs_extent)
+        return std::max(lhs_extent, rhs_extent);
+    else if constexpr (Op::broadcast && lhs_extent + rhs_extent == 1)
+        return 0;
+    else
+        return lhs_extent + rhs_extent;
+}
+
+template<typename Op, typename L, typename R>
+struct static_extent<expression<Op, L, R> > : std::integral_constant<std::size_t, expression_extent<
+        Op, std::remove_cvref_t<L>, std::remove_cvref_t<R> >()> {};
+
+template<typename Op, typename E>
+struct static_extent<unary_expression<Op, E> > : static_extent<std::remove_cvref_t<E> > {};
+
+template<typename V>
+inline constexpr std::size_t static_extent_v = static_extent<std::remove_cvref_t<V> >::value;
+
+template<typename V>
+concept indexable = requires(const V &v, std::size_t i) {
+    typename V::value_type;
+    { v.size() } -> std::convertible_to<std::size_t>;
+    v[i];
+};
+
+template<typename V>
+concept tensor_operand = is_vector_v<V> || is_view_v<V> || is_expression_v<V>;
+
+template<typename V>
+concept scalar_operand = std::is_arithmetic_v<std::remove_cvref_t<V> > || is_complex_v<std::remove_cvref_t<V> >;
+
+/**
+ * @brief Operands of a lazy elementwise operator: at least one vector, view or expression, and otherwise containers
+ * or scalars.
+ */
+template<typename L, typename R>
+concept elementwise_operands = (tensor_operand<L> || tensor_operand<R>) &&
+                               (indexable<std::remove_cvref_t<L> > || scalar_operand<L>) &&
+                               (indexable<std::remove_cvref_t<R> > || scalar_operand<R>);
+
+/**
+ * @brief Operands whose static lengths, where both are known, agree or allow one to be broadcast.
+ */
+template<typename L, typename R, bool Broadcast>
+concept matching_extents = static_extent_v<L> == 0 || static_extent_v<R> == 0 ||
+                           static_extent_v<L> == static_extent_v<R> ||
+                           (Broadcast && (static_extent_v<L> == 1 || static_extent_v<R> == 1));
+
+/**
+ * @brief An operand that can be stored in a vector of static length N, checked at compile time when its own length
+ * is static.
+ */
+template<typename V, std::size_t N>
+concept fits_extent = N == 0 || static_extent_v<V> == 0 || static_extent_v<V> == N;
+
+/**
+ * @brief Storage type of an expression operand. Lvalue containers are held by reference, rvalue containers are moved
+ * into the expression so that it never dangles, and sub-expressions and scalars are held by value.
+ */
+template<typename V>
+using operand_t = std::conditional_t<
+        scalar_operand<V>,
+        scalar<std::remove_cvref_t<V> >,
+        std::conditional_t<
+                std::is_lvalue_reference_v<V> && !is_expression_v<V>,
+                const std::remove_reference_t<V> &,
+                std::remove_cvref_t<V> > >;
+
+//*************************************************** OPERATIONS ***************************************************
+
+namespace ops {
+
+struct add {
+    static constexpr bool broadcast = false;
+    static constexpr const char *name = "addition";
+
+    template<typename A, typename B>
+    constexpr auto operator()(const A &a, const B &b) const { return a + b; }
+};
+
+struct sub {
+    static constexpr bool broadcast = false;
+    static constexpr const char *name = "subtraction";
+
+    template<typename A, typename B>
+    constexpr auto operator()(const A &a, const B &b) const { return a - b; }
+};
+
+struct mul {
+    static constexpr bool broadcast = true;
+    static constexpr const char *name = "multiplication";
+
+    template<typename A, typename B>
+    constexpr auto operator()(const A &a, const B &b) const { return a * b; }
+};
+
+struct div {
+    static constexpr bool broadcast = true;
+    static constexpr const char *name = "division";
+
+    template<typename A, typename B>
+    constexpr auto operator()(const A &a, const B &b) const { return a / b; }
+};
+
+struct conj {
+    template<typename A>
+    constexpr A operator()(const A &a) const {
+        if constexpr (is_complex_v<A>)
+            return std::conj(a);
+        else
+            return a;
+    }
+};
+
+struct norm {
+    template<typename A>
+    constexpr auto operator()(const A &a) const {
+        if constexpr (is_complex_v<A>)
+            return std::norm(a);
+        else
+            return a * a;
+    }
+};
+
+struct real {
+    template<typename A>
+    constexpr auto operator()(const A &a) const {
+        if constexpr (is_complex_v<A>)
+            return a.real();
+        else
+            return a;
+    }
+};
+
+struct imag {
+    template<typename A>
+    constexpr auto operator()(const A &a) const {
+        if constexpr (is_complex_v<A>)
+            return a.imag();
+        else
+            return A(0);
+    }
+};
+
+}
+
+//***************************************************** SCALAR *****************************************************
+
+/**
+ * @class scalar
+ *
+ * @brief Expression leaf broadcasting a single value to every index.
+ *
+ * @tparam U: Scalar type
+ *
+ * @ingroup tensor
+ */
+template<typename U>
+class scalar {
+
+    U value;
+
+public:
+
+    using value_type = U;
+
+    constexpr explicit scalar(const U &value) : value(value) {}
+
+    [[nodiscard]] constexpr std::size_t size() const { return 1; }
+
+    constexpr const U &operator[](const std::size_t &) const { return value; }
+};
+
+//**************************************************** ITERATOR ****************************************************
+
+/**
+ * @brief Random access iterator over the values of an expression.
+ */
+template<typename E>
+class expression_iterator {
+
+    const E *expr = nullptr;
+    std::size_t pos = 0;
+
+public:
+
+    using iterator_category = std::random_access_iterator_tag;
+    using value_type = typename E::value_type;
+    using difference_type = std::ptrdiff_t;
+    using pointer = void;
+    using reference = value_type;
+
+    expression_iterator() = default;
+
+    constexpr expression_iterator(const E *expr, const std::size_t &pos) : expr(expr), pos(pos) {}
+
+    constexpr value_type operator*() const { return (*expr)[pos]; }
+
+    constexpr value_type operator[](const difference_type &n) const { return (*expr)[pos + n]; }
+
+    constexpr expression_iterator &operator++() { ++pos; return *this; }
+
+    constexpr expression_iterator &operator--() { --pos; return *this; }
+
+    constexpr expression_iterator operator++(int) { auto it = *this; ++pos; return it; }
+
+    constexpr expression_iterator operator--(int) { auto it = *this; --pos; return it; }
+
+    constexpr expression_iterator &operator+=(const difference_type &n) { pos += n; return *this; }
+
+    constexpr expression_iterator &operator-=(const difference_type &n) { pos -= n; return *this; }
+
+    constexpr expression_iterator operator+(const difference_type &n) const { return {expr, pos + n}; }
+
+    constexpr expression_iterator operator-(const difference_type &n) const { return {expr, pos - n}; }
+
+    friend constexpr expression_iterator operator+(const difference_type &n, const expression_iterator &it) {
+        return it + n;
+    }
+
+    constexpr difference_type operator-(const expression_iterator &other) const {
+        return static_cast<difference_type>(pos) - static_cast<difference_type>(other.pos);
+    }
+
+    constexpr bool operator==(const expression_iterator &other) const { return pos == other.pos; }
+
+    constexpr auto operator<=>(const expression_iterator &other) const { return pos <=> other.pos; }
+};
+
+//*************************************************** EXPRESSION ***************************************************
+
+/**
+ * @class expression
+ *
+ * @brief A lazily evaluated elementwise operation between two tensor operands.
+ *
+ * @tparam Op: Elementwise operation from ccomms::ops
+ * @tparam L: Left operand storage type (see operand_t)
+ * @tparam R: Right operand storage type (see operand_t)
+ *
+ * @ingroup tensor
+ *
+ * @details Arithmetic operators on ccomms::vector return expressions rather than vectors. Expressions nest, so a chain
+ * such as a * w + b * g - c is a single tree that is evaluated in one fused loop with no intermediate buffers once it
+ * is assigned to, or used to construct, a vector. Operand lengths are checked when the expression is built, matching
+ * the eager operators they replace: addition and subtraction require equal lengths while multiplication and division
+ * also accept a single element operand that is broadcast. When both lengths are static the check happens at compile
+ * time instead. Elements are converted to the common type of both operands before the operation is applied.
+ */
+template<typename Op, typename L, typename R>
+class expression {
+
+    using lhs_type = std::remove_cvref_t<L>;
+    using rhs_type = std::remove_cvref_t<R>;
+
+    L lhs;
+    R rhs;
+
+    std::size_t len = 0;
+    bool lhs_broadcast = false;
+    bool rhs_broadcast = false;
+
+public:
+
+    using value_type = std::common_type_t<typename lhs_type::value_type, typename rhs_type::value_type>;
+    using size_type = std::size_t;
+    using operation = Op;
+    using lhs_storage = L;
+    using rhs_storage = R;
+
+    using const_iterator = expression_iterator<expression>;
+
+    //************************************************** CONSTRUCTORS **************************************************
+
+    template<typename A, typename B>
+    constexpr expression(A &&a, B &&b) : lhs(std::forward<A>(a)), rhs(std::forward<B>(b)) {
+        static_assert(matching_extents<lhs_type, rhs_type, Op::broadcast>,
+                      "\nERR: elementwise operation requires vectors of equal length\n");
+
+        if constexpr (is_scalar_v<lhs_type>)
+            len = rhs.size();
+        else if constexpr (is_scalar_v<rhs_type>)
+            len = lhs.size();
+        else if constexpr (static_extent_v<lhs_type> && static_extent_v<lhs_type> == static_extent_v<rhs_type>)
+            len = static_extent_v<lhs_type>;
+        else {
+            const std::size_t lhs_len = lhs.size();
+            const std::size_t rhs_len = rhs.size();
+
+            if (lhs_len == rhs_len)
+                len = lhs_len;
+            else if (Op::broadcast && (lhs_len == 1 || rhs_len == 1)) {
+                len = std::max(lhs_len, rhs_len);
+                lhs_broadcast = lhs_len == 1;
+                rhs_broadcast = rhs_len == 1;
+            } else
+                throw std::invalid_argument(
+                        std::string("\nERR: elementwise ") + Op::name + " requires vectors of equal length\n");
+        }
+    }
+
+    //**************************************************** ACCESS ******************************************************
+
+    [[nodiscard]] constexpr std::size_t size() const { return len; }
+
+    [[nodiscard]] constexpr bool empty() const { return len == 0; }
+
+    constexpr value_type operator[](const std::size_t &i) const {
+        if constexpr (Op::broadcast)
+            return static_cast<value_type>(Op{}(
+                    static_cast<value_type>(lhs[lhs_broadcast ? 0 : i]),
+                    static_cast<value_type>(rhs[rhs_broadcast ? 0 : i])));
+        else
+            return static_cast<value_type>(Op{}(static_cast<value_type>(lhs[i]), static_cast<value_type>(rhs[i])));
+    }
+
+    constexpr const lhs_type &left() const { return lhs; }
+
+    constexpr const rhs_type &right() const { return rhs; }
+
+    /**
+     * @brief Moves out an operand the expression owns, letting the destination reuse its storage.
+     */
+    constexpr lhs_type &&take_left() requires (!std::is_reference_v<L>) { return std::move(lhs); }
+
+    constexpr rhs_type &&take_right() requires (!std::is_reference_v<R>) { return std::move(rhs); }
+
+    [[nodiscard]] constexpr bool broadcasts() const { return lhs_broadcast || rhs_broadcast; }
+
+    constexpr const_iterator begin() const { return {this, 0}; }
+
+    constexpr const_iterator end() const { return {this, len}; }
+
+    /**
+     * @brief Materializes the expression into a vector, fixed-length if any operand has a static length.
+     */
+    constexpr auto eval() const {
+        using result = vector<value_type, static_extent_v<expression>, conversion::warn_once,
+                              std::allocator<value_type>, 0>;
+        return result(*this);
+    }
+};
+
+//************************************************ UNARY EXPRESSION ************************************************
+
+/**
+ * @class unary_expression
+ *
+ * @brief A lazily evaluated elementwise function of a single tensor operand.
+ *
+ * @tparam Op: Elementwise function from ccomms::ops
+ * @tparam E: Operand storage type (see operand_t)
+ *
+ * @ingroup tensor
+ *
+ * @details Unary expressions nest with binary expressions, so conj(a) * b is evaluated in the same single pass as any
+ * other expression. The value type is the result type of Op, which lets norm, real and imag map complex operands to
+ * real values.
+ */
+template<typename Op, typename E>
+class unary_expression {
+
+    using operand_type = std::remove_cvref_t<E>;
+
+    E operand;
+
+public:
+
+    using value_type = std::remove_cvref_t<decltype(Op{}(std::declval<const typename operand_type::value_type &>()))>;
+    using size_type = std::size_t;
+    using operation = Op;
+    using const_iterator = expression_iterator<unary_expression>;
+
+    template<typename A>
+    constexpr explicit unary_expression(A &&a) : operand(std::forward<A>(a)) {}
+
+    [[nodiscard]] constexpr std::size_t size() const { return operand.size(); }
+
+    [[nodiscard]] constexpr bool empty() const { return operand.size() == 0; }
+
+    constexpr value_type operator[](const std::size_t &i) const { return Op{}(operand[i]); }
+
+    constexpr const operand_type &argument() const { return operand; }
+
+    constexpr const_iterator begin() const { return {this, 0}; }
+
+    constexpr const_iterator end() const { return {this, size()}; }
+
+    constexpr auto eval() const {
+        using result = vector<value_type, static_extent_v<unary_expression>, conversion::warn_once,
+                              std::allocator<value_type>, 0>;
+        return result(*this);
+    }
+};
+
+//*************************************************** OPERATORS ****************************************************
+
+template<typename Op, typename L, typename R>
+constexpr expression<Op, operand_t<L>, operand_t<R> > make_expression(L &&lhs, R &&rhs) {
+    return expression<Op, operand_t<L>, operand_t<R> >(std::forward<L>(lhs), std::forward<R>(rhs));
+}
+
+template<typename Op, typename E>
+constexpr unary_expression<Op, operand_t<E> > make_expression(E &&operand) {
+    return unary_expression<Op, operand_t<E> >(std::forward<E>(operand));
+}
+
+template<typename L, typename R>
+requires elementwise_operands<L, R> && matching_extents<L, R, ops::add::broadcast>
+constexpr auto operator+(L &&lhs, R &&rhs) {
+    return make_expression<ops::add>(std::forward<L>(lhs), std::forward<R>(rhs));
+}
+
+template<typename L, typename R>
+requires elementwise_operands<L, R> && matching_extents<L, R, ops::sub::broadcast>
+constexpr auto operator-(L &&lhs, R &&rhs) {
+    return make_expression<ops::sub>(std::forward<L>(lhs), std::forward<R>(rhs));
+}
+
+template<typename L, typename R>
+requires elementwise_operands<L, R> && matching_extents<L, R, ops::mul::broadcast>
+constexpr auto operator*(L &&lhs, R &&rhs) {
+    return make_expression<ops::mul>(std::forward<L>(lhs), std::forward<R>(rhs));
+}
+
+template<typename L, typename R>
+requires elementwise_operands<L, R> && matching_extents<L, R, ops::div::broadcast>
+constexpr auto operator/(L &&lhs, R &&rhs) {
+    return make_expression<ops::div>(std::forward<L>(lhs), std::forward<R>(rhs));
+}
+
+}
+
+#endif // CCOMMS_MODULES_TENSOR_EXPRESSION_HPP_
@@ -0,0 +1,376 @@
+// Copyright(c) 2023, Matthew Petrin, All rights reserved.
+
+#ifndef CCOMMS_MODULES_TENSOR_INLINE_VECTOR_HPP_
+#define CCOMMS_MODULES_TENSOR_INLINE_VECTOR_HPP_
+
+#include <memory>
+#include <cstddef>
+#include <utility>
+#include <iterator>
+#include <stdexcept>
+#include <algorithm>
+#include <initializer_list>
+
+namespace ccomms {
+
+/**
+ * @class inline_vector
+ *
+ * @brief A std::vector-like container that stores up to Capacity elements inside the object and only allocates once
+ * it grows past that.
+ *
+ * @tparam T: Container element type
+ * @tparam Capacity: Number of elements stored inline
+ * @tparam Alloc: Allocator used once the contents spill to the heap
+ *
+ * @ingroup tensor
+ *
+ * @details Provides the subset of the std::vector interface used by ccomms::vector, so it can back the dynamic vector
+ * specialization in place of std::vector. Elements are always contiguous: spilling to the heap moves the inline
+ * elements into the new allocation, and moving a heap backed container steals its allocation. Iterators and
+ * pointers are invalidated by any operation that grows the container past its capacity and, for inline contents, by
+ * moving the container.
+ */
+template<typename T, std::size_t Capacity, typename Alloc = std::allocator<T> >
+class inline_vector {
+
+    static_assert(Capacity > 0, "\nERR: inline_vector requires a non-zero inline capacity\n");
+
+    using traits = std::allocator_traits<Alloc>;
+
+    T *first;
+    std::size_t count = 0;
+    std::size_t cap = Capacity;
+    [[no_unique_address]] Alloc alloc;
+    alignas(T) std::byte buffer[Capacity * sizeof(T)];
+
+public:
+
+    using value_type = T;
+    using allocator_type = Alloc;
+    using size_type = std::size_t;
+    using difference_type = std::ptrdiff_t;
+    using reference = T &;
+    using const_reference = const T &;
+    using pointer = T *;
+    using const_pointer = const T *;
+    using iterator = T *;
+    using const_iterator = const T *;
+    using reverse_iterator = std::reverse_iterator<iterator>;
+    using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+    static constexpr std::size_t inline_capacity = Capacity;
+
+    //************************************************** CONSTRUCTORS **************************************************
+
+    inline_vector() : first(local()), alloc() {}
+
+    explicit inline_vector(const Alloc &alloc) : first(local()), alloc(alloc) {}
+
+    explicit inline_vector(const std::size_t &len, const Alloc &alloc = Alloc()) : inline_vector(alloc) {
+        resize(len);
+    }
+
+    inline_vector(const std::size_t &len, const T &fill, const Alloc &alloc = Alloc()) : inline_vector(alloc) {
+        assign(len, fill);
+    }
+
+    template<std::input_iterator It>
+    inline_vector(It begin, It end, const Alloc &alloc = Alloc()) : inline_vector(alloc) {
+        assign(begin, end);
+    }
+
+    inline_vector(std::initializer_list<T> list, const Alloc &alloc = Alloc()) : inline_vector(alloc) {
+        assign(list.begin(), list.end());
+    }
+
+    inline_vector(const inline_vector &other) :
+            inline_vector(traits::select_on_container_copy_construction(other.alloc)) {
+        assign(other.begin(), other.end());
+    }
+
+    inline_vector(inline_vector &&other) noexcept(std::is_nothrow_move_constructible_v<T>) :
+            inline_vector(other.alloc) {
+        take(other);
+    }
+
+    ~inline_vector() {
+        clear();
+        release();
+    }
+
+    //*************************************************** ASSIGNMENT ***************************************************
+
+    inline_vector &operator=(const inline_vector &other) {
+        if (this != &other)
+            assign(other.begin(), other.end());
+        return *this;
+    }
+
+    inline_vector &operator=(inline_vector &&other) noexcept(std::is_nothrow_move_constructible_v<T>) {
+        if (this != &other) {
+            clear();
+            take(other);
+        }
+        return *this;
+    }
+
+    inline_vector &operator=(std::initializer_list<T> list) {
+        assign(list.begin(), list.end());
+        return *this;
+    }
+
+    void assign(const std::size_t &len, const T &fill) {
+        const T value = fill;
+        clear();
+        reserve(len);
+        std::uninitialized_fill_n(first, len, value);
+        count = len;
+    }
+
+    template<std::input_iterator It>
+    void assign(It begin, It end) {
+        clear();
+        if constexpr (std::forward_iterator<It>)
+            reserve(static_cast<std::size_t>(std::distance(begin, end)));
+        for (; begin != end; ++begin)
+            emplace_back(*begin);
+    }
+
+    //**************************************************** ACCESS ******************************************************
+
+    [[nodiscard]] std::size_t size() const { return count; }
+
+    [[nodiscard]] std::size_t capacity() const { return cap; }
+
+    [[nodiscard]] bool empty() const { return count == 0; }
+
+    [[nodiscard]] std::size_t max_size() const { return traits::max_size(alloc); }
+
+    /**
+     * @brief True while the contents are stored inside the object rather than on the heap.
+     */
+    [[nodiscard]] bool is_inline() const { return first == local(); }
+
+    [[nodiscard]] Alloc get_allocator() const { return alloc; }
+
+    T *data() { return first; }
+
+    const T *data() const { return first; }
+
+    T &operator[](const std::size_t &i) { return first[i]; }
+
+    const T &operator[](const std::size_t &i) const { return first[i]; }
+
+    T &at(const std::size_t &i) {
+        if (i >= count)
+            throw std::out_of_range("\nERR: inline_vector index out of range\n");
+        return first[i];
+    }
+
+    const T &at(const std::size_t &i) const {
+        if (i >= count)
+            throw std::out_of_range("\nERR: inline_vector index out of range\n");
+        return first[i];
+    }
+
+    T &front() { return first[0]; }
+
+    const T &front() const { return first[0]; }
+
+    T &back() { return first[count - 1]; }
+
+    const T &back() const { return first[count - 1]; }
+
+    iterator begin() { return first; }
+
+    const_iterator begin() const { return first; }
+
+    const_iterator cbegin() const { return first; }
+
+    iterator end() { return first + count; }
+
+    const_iterator end() const { return first + count; }
+
+    const_iterator cend() const { return first + count; }
+
+    reverse_iterator rbegin() { return reverse_iterator(end()); }
+
+    const_reverse_iterator rbegin() const { return const_reverse_iterator(end()); }
+
+    reverse_iterator rend() { return reverse_iterator(begin()); }
+
+    const_reverse_iterator rend() const { return const_reverse_iterator(begin()); }
+
+    //*************************************************** MODIFIERS ****************************************************
+
+    void reserve(const std::size_t &len) {
+        if (len <= cap)
+            return;
+
+        T *grown = traits::allocate(alloc, len);
+        std::uninitialized_move(first, first + count, grown);
+        std::destroy(first, first + count);
+        release();
+
+        first = grown;
+        cap = len;
+    }
+
+    void resize(const std::size_t &len) {
+        if (len < count) {
+            std::destroy(first + len, first + count);
+        } else {
+            reserve(len);
+            std::uninitialized_value_construct(first + count, first + len);
+        }
+        count = len;
+    }
+
+    void resize(const std::size_t &len, const T &fill) {
+        if (len < count) {
+            std::destroy(first + len, first + count);
+        } else {
+            const T value = fill;
+            reserve(len);
+            std::uninitialized_fill(first + count, first + len, value);
+        }
+        count = len;
+    }
+
+    template<typename... Args>
+    T &emplace_back(Args &&... args) {
+        // The inline capacity is spelled out so the compiler sees the inline buffer is never written past its end
+        if (count == (is_inline() ? Capacity : cap)) {
+            T value(std::forward<Args>(args)...);
+            reserve(2 * cap);
+            return *std::construct_at(first + count++, std::move(value));
+        }
+        return *std::construct_at(first + count++, std::forward<Args>(args)...);
+    }
+
+    void push_back(const T &value) { emplace_back(value); }
+
+    void push_back(T &&value) { emplace_back(std::move(value)); }
+
+    void pop_back() { std::destroy_at(first + --count); }
+
+    iterator insert(const_iterator pos, const T &value) {
+        const std::size_t offset = pos - first;
+        emplace_back(value);
+        std::rotate(first + offset, first + count - 1, first + count);
+        return first + offset;
+    }
+
+    template<std::input_iterator It>
+    iterator insert(const_iterator pos, It begin, It end) {
+        const std::size_t offset = pos - first;
+        const std::size_t old = count;
+        if constexpr (std::forward_iterator<It>)
+            reserve(count + static_cast<std::size_t>(std::distance(begin, end)));
+        for (; begin != end; ++begin)
+            emplace_back(*begin);
+        std::rotate(first + offset, first + old, first + count);
+        return first + offset;
+    }
+
+    iterator erase(const_iterator pos) { return erase(pos, pos + 1); }
+
+    iterator erase(const_iterator begin, const_iterator end) {
+        T *dst = first + (begin - first);
+        T *src = first + (end - first);
+        std::move(src, first + count, dst);
+        const std::size_t removed = end - begin;
+        std::destroy(first + count - removed, first + count);
+        count -= removed;
+        return dst;
+    }
+
+    void clear() {
+        std::destroy(first, first + count);
+        count = 0;
+    }
+
+    void shrink_to_fit() {
+        if (is_inline() || count > Capacity)
+            return;
+
+        T *heap = first;
+        const std::size_t heap_cap = cap;
+        first = local();
+        cap = Capacity;
+        std::uninitialized_move(heap, heap + count, first);
+        std::destroy(heap, heap + count);
+        traits::deallocate(alloc, heap, heap_cap);
+    }
+
+    /**
+     * @brief Exchanges the contents, and the allocators when they propagate on swap. Heap allocations are exchanged
+     * when both containers own one and the allocators allow it; otherwise the elements are moved.
+     */
+    void swap(inline_vector &other) {
+        constexpr bool propagate = traits::propagate_on_container_swap::value;
+        if (!is_inline() && !other.is_inline() && (propagate || alloc == other.alloc)) {
+            std::swap(first, other.first);
+            std::swap(count, other.count);
+            std::swap(cap, other.cap);
+            if constexpr (propagate)
+                std::swap(alloc, other.alloc);
+            return;
+        }
+
+        inline_vector temp(std::move(other));
+        other.clear();
+        if constexpr (propagate) {
+            other.release();
+            other.alloc = alloc;
+        }
+        other.take(*this);
+
+        clear();
+        if constexpr (propagate) {
+            release();
+            alloc = temp.alloc;
+        }
+        take(temp);
+    }
+
+    friend bool operator==(const inline_vector &lhs, const inline_vector &rhs) {
+        return std::equal(lhs.begin(), lhs.end(), rhs.begin(), rhs.end());
+    }
+
+private:
+
+    T *local() { return reinterpret_cast<T *>(buffer); }
+
+    const T *local() const { return reinterpret_cast<const T *>(buffer); }
+
+    void release() {
+        if (!is_inline())
+            traits::deallocate(alloc, first, cap);
+        first = local();
+        cap = Capacity;
+    }
+
+    /**
+     * @brief Takes the contents of other into this empty container, stealing its allocation when possible.
+     */
+    void take(inline_vector &other) {
+        if (!other.is_inline() && alloc == other.alloc) {
+            release();
+            first = std::exchange(other.first, other.local());
+            count = std::exchange(other.count, 0);
+            cap = std::exchange(other.cap, Capacity);
+            return;
+        }
+
+        reserve(other.count);
+        std::uninitialized_move(other.first, other.first + other.count, first);
+        count = other.count;
+        other.clear();
+    }
+};
+
+}
+
+#endif // CCOMMS_MODULES_TENSOR_INLINE_VECTOR_HPP_
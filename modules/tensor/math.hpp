@@ -0,0 +1,119 @@
+// Copyright(c) 2023, Matthew Petrin, All rights reserved.
+
+#ifndef CCOMMS_MODULES_TENSOR_MATH_HPP_
+#define CCOMMS_MODULES_TENSOR_MATH_HPP_
+
+#include <stdexcept>
+#include <type_traits>
+
+#include "simd.hpp"
+#include "vector.hpp"
+#include "complex.hpp"
+
+namespace ccomms {
+
+/**
+ * @brief Contiguous vectors and views of float or double, the operands of the vectorized math functions.
+ */
+template<typename V>
+concept math_operand = simd::contiguous<std::remove_cvref_t<V> > &&
+                       (std::is_same_v<typename std::remove_cvref_t<V>::value_type, float> ||
+                        std::is_same_v<typename std::remove_cvref_t<V>::value_type, double>);
+
+/**
+ * @brief Element type of a math operand.
+ */
+template<typename V>
+using math_value_t = typename std::remove_cvref_t<V>::value_type;
+
+//*************************************************** ELEMENTWISE **************************************************
+
+// Each function evaluates eagerly through the SIMD math kernels and returns a new vector. The accuracy tier is a
+// template argument, precise by default; see simd::accuracy.
+
+template<simd::accuracy A = simd::accuracy::precise, typename V>
+requires math_operand<V>
+vector<math_value_t<V> > sin(const V &x) {
+    vector<math_value_t<V> > s(x.size(), math_value_t<V>(0)), c(x.size(), math_value_t<V>(0));
+    simd::sincos<A>(s.data(), c.data(), x.data(), x.size());
+    return s;
+}
+
+template<simd::accuracy A = simd::accuracy::precise, typename V>
+requires math_operand<V>
+vector<math_value_t<V> > cos(const V &x) {
+    vector<math_value_t<V> > s(x.size(), math_value_t<V>(0)), c(x.size(), math_value_t<V>(0));
+    simd::sincos<A>(s.data(), c.data(), x.data(), x.size());
+    return c;
+}
+
+/**
+ * @brief Sine and cosine together into s and c, resized to the length of x, for the cost of either alone.
+ */
+template<simd::accuracy A = simd::accuracy::precise, typename V>
+requires math_operand<V>
+void sincos(const V &x, vector<math_value_t<V> > &s, vector<math_value_t<V> > &c) {
+    s.resize(x.size());
+    c.resize(x.size());
+    simd::sincos<A>(s.data(), c.data(), x.data(), x.size());
+}
+
+/**
+ * @brief exp(j phase) as a split complex vector, the cosines and sines landing directly in its two parts.
+ */
+template<simd::accuracy A = simd::accuracy::precise, typename V>
+requires math_operand<V>
+split_complex<math_value_t<V> > expj(const V &phase) {
+    split_complex<math_value_t<V> > result(phase.size());
+    simd::sincos<A>(result.imag().data(), result.real().data(), phase.data(), phase.size());
+    return result;
+}
+
+template<simd::accuracy A = simd::accuracy::precise, typename V>
+requires math_operand<V>
+vector<math_value_t<V> > exp(const V &x) {
+    vector<math_value_t<V> > result(x.size(), math_value_t<V>(0));
+    simd::exp<A>(result.data(), x.data(), x.size());
+    return result;
+}
+
+template<simd::accuracy A = simd::accuracy::precise, typename V>
+requires math_operand<V>
+vector<math_value_t<V> > log(const V &x) {
+    vector<math_value_t<V> > result(x.size(), math_value_t<V>(0));
+    simd::log<A>(result.data(), x.data(), x.size());
+    return result;
+}
+
+template<simd::accuracy A = simd::accuracy::precise, typename V>
+requires math_operand<V>
+vector<math_value_t<V> > sqrt(const V &x) {
+    vector<math_value_t<V> > result(x.size(), math_value_t<V>(0));
+    simd::sqrt<A>(result.data(), x.data(), x.size());
+    return result;
+}
+
+template<simd::accuracy A = simd::accuracy::precise, typename V>
+requires math_operand<V>
+vector<math_value_t<V> > rsqrt(const V &x) {
+    vector<math_value_t<V> > result(x.size(), math_value_t<V>(0));
+    simd::rsqrt<A>(result.data(), x.data(), x.size());
+    return result;
+}
+
+/**
+ * @brief Four quadrant arctangent of y / x in [-pi, pi].
+ */
+template<simd::accuracy A = simd::accuracy::precise, typename V, typename W>
+requires math_operand<V> && math_operand<W> && std::is_same_v<math_value_t<V>, math_value_t<W> >
+vector<math_value_t<V> > atan2(const V &y, const W &x) {
+    if (y.size() != x.size())
+        throw std::invalid_argument("\nERR: atan2 requires operands of equal length\n");
+    vector<math_value_t<V> > result(x.size(), math_value_t<V>(0));
+    simd::atan2<A>(result.data(), y.data(), x.data(), x.size());
+    return result;
+}
+
+}
+
+#endif // CCOMMS_MODULES_TENSOR_MATH_HPP_
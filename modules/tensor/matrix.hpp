@@ -0,0 +1,364 @@
+// Copyright(c) 2023, Matthew Petrin, All rights reserved.
+
+#ifndef CCOMMS_MODULES_TENSOR_MATRIX_HPP_
+#define CCOMMS_MODULES_TENSOR_MATRIX_HPP_
+
+#include <array>
+#include <vector>
+#include <ostream>
+#include <stdexcept>
+#include <algorithm>
+#include <type_traits>
+#include <initializer_list>
+
+#include "simd.hpp"
+#include "view.hpp"
+#include "vector.hpp"
+
+namespace ccomms {
+
+/**
+ * @brief Storage order of a ccomms::matrix.
+ */
+enum class layout {
+    row_major,
+    col_major
+};
+
+/**
+ * @class matrix
+ *
+ * @brief A dense matrix stored in a single contiguous buffer.
+ *
+ * @tparam T: Matrix element type
+ * @tparam R: Static number of rows, 0 for a dynamic matrix
+ * @tparam C: Static number of columns, 0 for a dynamic matrix
+ * @tparam L: Storage order
+ *
+ * @ingroup tensor
+ *
+ * @details Mirrors the fixed/dynamic split of ccomms::vector: when both R and C are given the elements live in a
+ * std::array, otherwise in a std::vector sized at runtime. Matrix products of float and double matrices run on a
+ * cache-blocked SIMD GEMM, and matrix-vector products reduce to the SIMD inner product and axpy kernels along the
+ * contiguous dimension. A matrix multiplies column vectors from the left and row vectors from the right. The lengths
+ * of fixed vectors are checked against fixed matrices at compile time, but orientation is the runtime is_row and
+ * is_col state of ccomms::vector rather than part of its type, so a vector of the wrong orientation is only rejected
+ * when the product is evaluated, with std::invalid_argument.
+ */
+template<typename T, std::size_t R = 0, std::size_t C = 0, layout L = layout::row_major>
+class matrix {
+
+    static_assert((R == 0) == (C == 0), "\nERR: matrix dimensions must be both fixed or both dynamic\n");
+
+    static constexpr bool fixed = R != 0;
+
+    using container = typename std::conditional<fixed, std::array<T, R * C>, std::vector<T> >::type;
+
+    std::size_t n_rows;
+    std::size_t n_cols;
+    container elements;
+
+public:
+
+    using value_type = T;
+    using size_type = std::size_t;
+    using iterator = typename container::iterator;
+    using const_iterator = typename container::const_iterator;
+
+    static constexpr layout order = L;
+
+    //************************************************** CONSTRUCTORS **************************************************
+
+    matrix() : n_rows(R), n_cols(C), elements() {
+        if constexpr (fixed)
+            elements.fill(T(0));
+    }
+
+    matrix(const std::size_t &rows, const std::size_t &cols, const T &fill = T(0)) : n_rows(rows), n_cols(cols) {
+        if (fixed && (rows != R || cols != C))
+            throw std::invalid_argument("\nERR: fixed matrix dimensions must match its template parameters\n");
+
+        if constexpr (fixed)
+            elements.fill(fill);
+        else
+            elements.assign(rows * cols, fill);
+    }
+
+    /**
+     * @brief Constructs a matrix from a list of rows, regardless of the storage order.
+     */
+    matrix(std::initializer_list<std::initializer_list<T> > rows) :
+            matrix(rows.size(), rows.size() ? rows.begin()->size() : 0) {
+        std::size_t i = 0;
+        for (const auto &row: rows) {
+            if (row.size() != n_cols)
+                throw std::invalid_argument("\nERR: matrix rows must all have the same length\n");
+
+            std::size_t j = 0;
+            for (const auto &value: row)
+                (*this)(i, j++) = value;
+            i++;
+        }
+    }
+
+    static matrix identity(const std::size_t &n = R) {
+        matrix result(n, n);
+        for (std::size_t i = 0; i < n; i++)
+            result(i, i) = T(1);
+        return result;
+    }
+
+    //**************************************************** ACCESS ******************************************************
+
+    [[nodiscard]] std::size_t rows() const { return n_rows; }
+
+    [[nodiscard]] std::size_t cols() const { return n_cols; }
+
+    [[nodiscard]] std::size_t size() const { return n_rows * n_cols; }
+
+    [[nodiscard]] bool empty() const { return size() == 0; }
+
+    /**
+     * @brief Distance between the starts of consecutive rows (row-major) or columns (column-major).
+     */
+    [[nodiscard]] std::size_t leading_dimension() const { return L == layout::row_major ? n_cols : n_rows; }
+
+    T *data() { return elements.data(); }
+
+    const T *data() const { return elements.data(); }
+
+    T &operator()(const std::size_t &i, const std::size_t &j) { return elements[index(i, j)]; }
+
+    const T &operator()(const std::size_t &i, const std::size_t &j) const { return elements[index(i, j)]; }
+
+    T &at(const std::size_t &i, const std::size_t &j) {
+        if (i >= n_rows || j >= n_cols)
+            throw std::out_of_range("\nERR: matrix index out of range\n");
+        return (*this)(i, j);
+    }
+
+    const T &at(const std::size_t &i, const std::size_t &j) const {
+        if (i >= n_rows || j >= n_cols)
+            throw std::out_of_range("\nERR: matrix index out of range\n");
+        return (*this)(i, j);
+    }
+
+    iterator begin() { return elements.begin(); }
+
+    const_iterator begin() const { return elements.begin(); }
+
+    iterator end() { return elements.end(); }
+
+    const_iterator end() const { return elements.end(); }
+
+    vector<T, C> row(const std::size_t &i) const {
+        vector<T, C> result(n_cols, T(0), 'r');
+        for (std::size_t j = 0; j < n_cols; j++)
+            result[j] = (*this)(i, j);
+        return result;
+    }
+
+    vector<T, R> col(const std::size_t &j) const {
+        vector<T, R> result(n_rows, T(0), 'c');
+        for (std::size_t i = 0; i < n_rows; i++)
+            result[i] = (*this)(i, j);
+        return result;
+    }
+
+    matrix<T, C, R, L> transpose() const {
+        matrix<T, C, R, L> result(n_cols, n_rows);
+        for (std::size_t i = 0; i < n_rows; i++)
+            for (std::size_t j = 0; j < n_cols; j++)
+                result(j, i) = (*this)(i, j);
+        return result;
+    }
+
+    //************************************************** MATRIX MATH ***************************************************
+
+    matrix operator+(const matrix &other) const {
+        check_same_shape(other, "addition");
+        matrix result(*this);
+        for (std::size_t i = 0; i < size(); i++)
+            result.elements[i] += other.elements[i];
+        return result;
+    }
+
+    matrix operator-(const matrix &other) const {
+        check_same_shape(other, "subtraction");
+        matrix result(*this);
+        for (std::size_t i = 0; i < size(); i++)
+            result.elements[i] -= other.elements[i];
+        return result;
+    }
+
+    matrix operator*(const T &alpha) const {
+        matrix result(*this);
+        for (auto &value: result.elements)
+            value *= alpha;
+        return result;
+    }
+
+    /**
+     * @brief Matrix product. Fixed operands yield a fixed result and have their inner dimensions checked at compile
+     * time; any dynamic operand yields a dynamic result.
+     */
+    template<std::size_t R2, std::size_t C2>
+    auto operator*(const matrix<T, R2, C2, L> &other) const {
+        static_assert(!fixed || R2 == 0 || C == R2, "\nERR: matrix product requires inner dimensions to agree\n");
+
+        if (n_cols != other.rows())
+            throw std::invalid_argument("\nERR: matrix product requires inner dimensions to agree\n");
+
+        constexpr bool fixed_result = fixed && R2 != 0;
+        matrix<T, fixed_result ? R : 0, fixed_result ? C2 : 0, L> result(n_rows, other.cols());
+
+        // A column-major product is the row-major product of the transposes with the operands swapped
+        if constexpr (L == layout::row_major)
+            gemm(n_rows, other.cols(), n_cols, data(), n_cols, other.data(), other.cols(), result.data(),
+                 other.cols());
+        else
+            gemm(other.cols(), n_rows, n_cols, other.data(), other.rows(), data(), n_rows, result.data(), n_rows);
+
+        return result;
+    }
+
+    /**
+     * @brief Matrix-vector product with a column vector; a row vector throws std::invalid_argument.
+     */
+    template<std::size_t N, typename Policy, typename Alloc, std::size_t Inline>
+    vector<T, R, Policy> operator*(const vector<T, N, Policy, Alloc, Inline> &x) const {
+        static_assert(!fixed || N == 0 || N == C,
+                      "\nERR: matrix-vector product requires vector length equal to columns\n");
+
+        if (!x.col_vector())
+            throw std::invalid_argument("\nERR: matrix-vector product requires a column vector\n");
+        if (x.size() != n_cols)
+            throw std::invalid_argument("\nERR: matrix-vector product requires vector length equal to columns\n");
+
+        vector<T, R, Policy> y(n_rows, T(0), 'c');
+        column_product(x.data(), y.data());
+        return y;
+    }
+
+    /**
+     * @brief Matrix-vector product with a contiguous view, taken as a column vector.
+     */
+    template<typename U, std::size_t E>
+    requires std::is_same_v<std::remove_const_t<U>, T>
+    vector<T, R> operator*(const vector_view<U, E> &x) const {
+        if (x.size() != n_cols)
+            throw std::invalid_argument("\nERR: matrix-vector product requires vector length equal to columns\n");
+
+        vector<T, R> y(n_rows, T(0), 'c');
+        column_product(x.data(), y.data());
+        return y;
+    }
+
+    /**
+     * @brief Vector-matrix product with a row vector; a column vector throws std::invalid_argument.
+     */
+    template<std::size_t N, typename Policy, typename Alloc, std::size_t Inline>
+    friend vector<T, C, Policy> operator*(const vector<T, N, Policy, Alloc, Inline> &x, const matrix &a) {
+        static_assert(!fixed || N == 0 || N == R,
+                      "\nERR: vector-matrix product requires vector length equal to rows\n");
+
+        if (!x.row_vector())
+            throw std::invalid_argument("\nERR: vector-matrix product requires a row vector\n");
+        if (x.size() != a.n_rows)
+            throw std::invalid_argument("\nERR: vector-matrix product requires vector length equal to rows\n");
+
+        vector<T, C, Policy> y(a.n_cols, T(0), 'r');
+        if constexpr (L == layout::row_major)
+            axpy_lines(a.data(), a.n_cols, a.n_rows, a.n_cols, x.data(), y.data());
+        else
+            dot_lines(a.data(), a.n_rows, a.n_cols, a.n_rows, x.data(), y.data());
+        return y;
+    }
+
+private:
+
+    [[nodiscard]] std::size_t index(const std::size_t &i, const std::size_t &j) const {
+        if constexpr (L == layout::row_major)
+            return i * n_cols + j;
+        else
+            return j * n_rows + i;
+    }
+
+    /**
+     * @brief y = this * x for contiguous x of length cols and y of length rows.
+     */
+    void column_product(const T *x, T *y) const {
+        if constexpr (L == layout::row_major)
+            dot_lines(data(), n_cols, n_rows, n_cols, x, y);
+        else
+            axpy_lines(data(), n_rows, n_cols, n_rows, x, y);
+    }
+
+    void check_same_shape(const matrix &other, const std::string &name) const {
+        if (other.n_rows != n_rows || other.n_cols != n_cols)
+            throw std::invalid_argument("\nERR: matrix " + name + " requires matrices of equal dimensions\n");
+    }
+
+    /**
+     * @brief c += a * b over row-major buffers, on the SIMD GEMM when T allows it.
+     */
+    static void gemm(const std::size_t &m, const std::size_t &n, const std::size_t &k, const T *a,
+                     const std::size_t &lda, const T *b, const std::size_t &ldb, T *c, const std::size_t &ldc) {
+        if constexpr (std::is_same_v<T, float> || std::is_same_v<T, double>)
+            simd::gemm(m, n, k, a, lda, b, ldb, c, ldc);
+        else
+            simd::scalar::gemm(m, n, k, a, lda, b, ldb, c, ldc);
+    }
+
+    /**
+     * @brief y[l] = sum over k of a[l * ld + k] * x[k], one inner product per contiguous line of a.
+     */
+    static void dot_lines(const T *a, const std::size_t &ld, const std::size_t &lines, const std::size_t &len,
+                          const T *x, T *y) {
+        for (std::size_t l = 0; l < lines; l++) {
+            if constexpr (simd::kernel_type<T>) {
+                y[l] = simd::dot(a + l * ld, x, len);
+            } else {
+                T sum = T(0);
+                for (std::size_t k = 0; k < len; k++)
+                    sum += a[l * ld + k] * x[k];
+                y[l] = sum;
+            }
+        }
+    }
+
+    /**
+     * @brief y[k] += x[l] * a[l * ld + k], one axpy per contiguous line of a.
+     */
+    static void axpy_lines(const T *a, const std::size_t &ld, const std::size_t &lines, const std::size_t &len,
+                           const T *x, T *y) {
+        for (std::size_t l = 0; l < lines; l++) {
+            if constexpr (simd::kernel_type<T> && !is_complex_v<T>) {
+                simd::axpy(y, x[l], a + l * ld, len);
+            } else {
+                for (std::size_t k = 0; k < len; k++)
+                    y[k] += x[l] * a[l * ld + k];
+            }
+        }
+    }
+};
+
+template<typename T, std::size_t R, std::size_t C, layout L>
+std::ostream &operator<<(std::ostream &os, const matrix<T, R, C, L> &mat) {
+    os << "[";
+    for (std::size_t i = 0; i < mat.rows(); i++) {
+        os << "[";
+        for (std::size_t j = 0; j < mat.cols(); j++) {
+            os << mat(i, j);
+            if (j != mat.cols() - 1) os << ", ";
+        }
+        os << "]";
+        if (i != mat.rows() - 1) os << ", ";
+    }
+    os << "]";
+    return os;
+}
+
+}
+
+#endif // CCOMMS_MODULES_TENSOR_MATRIX_HPP_
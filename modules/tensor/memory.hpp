@@ -0,0 +1,445 @@
+// Copyright(c) 2023, Matthew Petrin, All rights reserved.
+
+#ifndef CCOMMS_MODULES_TENSOR_MEMORY_HPP_
+#define CCOMMS_MODULES_TENSOR_MEMORY_HPP_
+
+#include <new>
+#include <array>
+#include <mutex>
+#include <atomic>
+#include <memory>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <algorithm>
+#include <memory_resource>
+
+namespace ccomms::memory {
+
+//*************************************************** STATISTICS ***************************************************
+
+/**
+ * @brief Per thread allocation counters. Allocations are the requests served by the arena and pool, heap allocations
+ * are the ones that had to reach the global heap. A steady state frame should leave heap_allocations unchanged.
+ */
+struct statistics {
+    std::size_t allocations = 0;
+    std::size_t deallocations = 0;
+    std::size_t bytes = 0;
+    std::size_t heap_allocations = 0;
+    std::size_t heap_bytes = 0;
+};
+
+inline statistics &stats() {
+    thread_local statistics counters;
+    return counters;
+}
+
+inline void reset_stats() {
+    stats() = statistics{};
+}
+
+//****************************************************** HEAP ******************************************************
+
+inline void *heap_allocate(const std::size_t &bytes, const std::size_t &alignment) {
+    stats().heap_allocations++;
+    stats().heap_bytes += bytes;
+    return ::operator new(bytes, std::align_val_t(alignment));
+}
+
+inline void heap_deallocate(void *p, const std::size_t &bytes, const std::size_t &alignment) {
+    ::operator delete(p, bytes, std::align_val_t(alignment));
+}
+
+//****************************************************** ARENA *****************************************************
+
+/**
+ * @class arena
+ *
+ * @brief A monotonic memory resource that hands out memory by bumping a pointer and releases it all at once.
+ *
+ * @ingroup tensor
+ *
+ * @details Memory is carved from a list of chunks obtained from the heap. Deallocation is a no-op; instead the arena
+ * is rewound to a previously taken position in O(1). Chunks are kept when rewinding, so once the arena has grown to
+ * the high water mark of a frame, later frames are served without touching the heap.
+ */
+class arena : public std::pmr::memory_resource {
+
+    struct chunk {
+        std::byte *data;
+        std::size_t capacity;
+        std::size_t alignment;
+    };
+
+    static constexpr std::size_t alignment = 64;
+
+    std::vector<chunk> chunks;
+    std::size_t index = 0;
+    std::size_t offset = 0;
+
+public:
+
+    /**
+     * @brief A position in the arena that can later be rewound to.
+     */
+    struct marker {
+        std::size_t index;
+        std::size_t offset;
+    };
+
+    static constexpr std::size_t initial_capacity = std::size_t(1) << 16;
+
+    arena() = default;
+
+    arena(const arena &) = delete;
+
+    arena &operator=(const arena &) = delete;
+
+    ~arena() override {
+        for (const auto &c: chunks)
+            heap_deallocate(c.data, c.capacity, c.alignment);
+    }
+
+    [[nodiscard]] marker position() const { return {index, offset}; }
+
+    void rewind(const marker &mark) {
+        index = mark.index;
+        offset = mark.offset;
+    }
+
+    /**
+     * @brief Total bytes held by the arena, used or not.
+     */
+    [[nodiscard]] std::size_t capacity() const {
+        std::size_t total = 0;
+        for (const auto &c: chunks)
+            total += c.capacity;
+        return total;
+    }
+
+private:
+
+    void *do_allocate(std::size_t bytes, std::size_t align) override {
+        stats().allocations++;
+        stats().bytes += bytes;
+
+        for (; index < chunks.size(); index++, offset = 0) {
+            const std::size_t start = (offset + align - 1) / align * align;
+            if (align <= chunks[index].alignment && start + bytes <= chunks[index].capacity) {
+                offset = start + bytes;
+                return chunks[index].data + start;
+            }
+        }
+
+        const std::size_t last = chunks.empty() ? initial_capacity / 2 : chunks.back().capacity;
+        const std::size_t capacity = std::max(2 * last, (bytes + align - 1) / align * align);
+        const std::size_t chunk_alignment = std::max(align, alignment);
+        auto *data = static_cast<std::byte *>(heap_allocate(capacity, chunk_alignment));
+        chunks.push_back({data, capacity, chunk_alignment});
+
+        index = chunks.size() - 1;
+        offset = bytes;
+        return data;
+    }
+
+    void do_deallocate(void *, std::size_t, std::size_t) override {
+        stats().deallocations++;
+    }
+
+    [[nodiscard]] bool do_is_equal(const std::pmr::memory_resource &other) const noexcept override {
+        return this == &other;
+    }
+};
+
+//****************************************************** POOL ******************************************************
+
+/**
+ * @class pool
+ *
+ * @brief A size class memory resource with one free list per power of two block size.
+ *
+ * @ingroup tensor
+ *
+ * @details Blocks of 16 bytes up to 32 KiB are carved from slabs and returned to their free list on deallocation, so
+ * a loop that repeatedly creates and destroys vectors of similar sizes stops reaching the heap after its first pass.
+ * Larger or over-aligned requests go straight to the heap.
+ *
+ * Each thread owns one pool, reached through thread_local_pool(), and only the owner touches its free lists. Slabs
+ * are aligned to their size and start with a header naming the pool that carved them, so a block is always returned
+ * to that pool: directly when freed on its thread, and through a lock free list the owner drains on its next
+ * allocation when freed on another. Allocations are served by the calling thread's pool whichever pool the allocator
+ * names, which makes all pools interchangeable. Pools live in a process wide registry rather than in thread storage:
+ * when a thread exits its pool is kept, slabs and all, for the next thread to take over, so vectors that outlive the
+ * thread that allocated them stay valid.
+ */
+class pool : public std::pmr::memory_resource {
+
+    struct node {
+        node *next;
+    };
+
+    struct slab_header {
+        pool *owner;
+    };
+
+    static constexpr std::size_t min_block = 16;
+    static constexpr std::size_t classes = 12;
+    static constexpr std::size_t slab_size = std::size_t(1) << 17;
+    static constexpr std::size_t header_size = 64;
+
+    std::array<node *, classes> free{};
+    std::array<std::atomic<node *>, classes> remote{};
+    std::vector<std::byte *> slabs;
+
+    struct registry {
+        std::mutex lock;
+        std::vector<std::unique_ptr<pool> > pools;
+        std::vector<pool *> idle;
+    };
+
+    static registry &shared() {
+        static registry instance;
+        return instance;
+    }
+
+    static std::size_t size_class(const std::size_t &bytes) {
+        std::size_t c = 0;
+        while ((min_block << c) < bytes)
+            c++;
+        return c;
+    }
+
+    static pool *owner_of(void *p) {
+        const auto address = reinterpret_cast<std::uintptr_t>(p) & ~(slab_size - 1);
+        return reinterpret_cast<slab_header *>(address)->owner;
+    }
+
+    void refill(const std::size_t &c) {
+        free[c] = remote[c].exchange(nullptr, std::memory_order_acquire);
+        if (free[c])
+            return;
+
+        const std::size_t block = min_block << c;
+        auto *slab = static_cast<std::byte *>(heap_allocate(slab_size, slab_size));
+        new(slab) slab_header{this};
+        slabs.push_back(slab);
+
+        for (std::size_t i = (slab_size - header_size) / block; i-- > 0;)
+            free[c] = new(slab + header_size + i * block) node{free[c]};
+    }
+
+    pool() = default;
+
+public:
+
+    static constexpr std::size_t max_block = min_block << (classes - 1);
+
+    /**
+     * @brief Hands a pool to a thread for as long as it runs: one left idle by an exited thread if there is one, a
+     * new one otherwise.
+     */
+    class lease {
+
+        pool *resource;
+
+    public:
+
+        lease() {
+            auto &r = shared();
+            std::lock_guard guard(r.lock);
+            if (r.idle.empty()) {
+                r.pools.emplace_back(new pool());
+                resource = r.pools.back().get();
+            } else {
+                resource = r.idle.back();
+                r.idle.pop_back();
+            }
+        }
+
+        lease(const lease &) = delete;
+
+        lease &operator=(const lease &) = delete;
+
+        ~lease() {
+            auto &r = shared();
+            std::lock_guard guard(r.lock);
+            r.idle.push_back(resource);
+        }
+
+        [[nodiscard]] pool &get() const { return *resource; }
+    };
+
+    pool(const pool &) = delete;
+
+    pool &operator=(const pool &) = delete;
+
+    ~pool() override {
+        for (auto *slab: slabs)
+            heap_deallocate(slab, slab_size, slab_size);
+    }
+
+private:
+
+    void *do_allocate(std::size_t bytes, std::size_t align) override;
+
+    void do_deallocate(void *p, std::size_t bytes, std::size_t align) override;
+
+    [[nodiscard]] bool do_is_equal(const std::pmr::memory_resource &other) const noexcept override {
+        return dynamic_cast<const pool *>(&other) != nullptr;
+    }
+};
+
+//************************************************** THREAD STATE **************************************************
+
+inline arena &thread_arena() {
+    thread_local arena resource;
+    return resource;
+}
+
+inline pool &thread_local_pool() {
+    thread_local pool::lease resource;
+    return resource.get();
+}
+
+inline void *pool::do_allocate(std::size_t bytes, std::size_t align) {
+    stats().allocations++;
+    stats().bytes += bytes;
+
+    if (bytes > max_block || align > alignof(std::max_align_t))
+        return heap_allocate(bytes, align);
+
+    pool &local = thread_local_pool();
+    const std::size_t c = size_class(bytes);
+    if (!local.free[c])
+        local.refill(c);
+
+    node *head = local.free[c];
+    local.free[c] = head->next;
+    return head;
+}
+
+inline void pool::do_deallocate(void *p, std::size_t bytes, std::size_t align) {
+    stats().deallocations++;
+
+    if (bytes > max_block || align > alignof(std::max_align_t))
+        return heap_deallocate(p, bytes, align);
+
+    pool *owner = owner_of(p);
+    const std::size_t c = size_class(bytes);
+    if (owner == &thread_local_pool()) {
+        owner->free[c] = new(p) node{owner->free[c]};
+        return;
+    }
+
+    auto *block = new(p) node{owner->remote[c].load(std::memory_order_relaxed)};
+    while (!owner->remote[c].compare_exchange_weak(block->next, block, std::memory_order_release,
+                                                   std::memory_order_relaxed));
+}
+
+inline std::pmr::memory_resource *&current_resource() {
+    thread_local std::pmr::memory_resource *resource = nullptr;
+    return resource;
+}
+
+/**
+ * @brief The resource new ccomms::memory::allocator instances draw from on this thread: the arena inside a frame and
+ * the pool otherwise.
+ */
+inline std::pmr::memory_resource *current() {
+    auto *resource = current_resource();
+    return resource ? resource : &thread_local_pool();
+}
+
+/**
+ * @class frame
+ *
+ * @brief Scope guard that routes this thread's allocations to its arena and releases them in O(1) when it ends.
+ *
+ * @ingroup tensor
+ *
+ * @details Frames nest; each one rewinds the arena to where it stood when the frame began. Vectors allocated inside
+ * a frame must not be read after the frame ends. Destroying them later is harmless since arena deallocation is a
+ * no-op.
+ */
+class frame {
+
+    arena::marker mark;
+    std::pmr::memory_resource *previous;
+
+public:
+
+    frame() : mark(thread_arena().position()), previous(std::exchange(current_resource(), &thread_arena())) {}
+
+    frame(const frame &) = delete;
+
+    frame &operator=(const frame &) = delete;
+
+    ~frame() {
+        thread_arena().rewind(mark);
+        current_resource() = previous;
+    }
+};
+
+//**************************************************** ALLOCATOR ***************************************************
+
+/**
+ * @class allocator
+ *
+ * @brief A standard allocator bound to the resource that was current on its thread when it was constructed.
+ *
+ * @tparam T: Allocated element type
+ *
+ * @ingroup tensor
+ *
+ * @details Copies made by containers pick up the resource current at the time of the copy, so a vector copied or
+ * produced inside a frame lives in the arena. Move assignment does not propagate the allocator: moving a frame
+ * vector into a longer lived one copies the elements rather than handing over arena memory. Swapping exchanges the
+ * allocators along with the buffers, so each buffer stays with the resource it came from. Allocators bound to
+ * different thread pools compare equal, since any pool can release blocks carved by another.
+ */
+template<typename T>
+class allocator {
+
+    std::pmr::memory_resource *source;
+
+    template<typename U>
+    friend class allocator;
+
+public:
+
+    using value_type = T;
+    using propagate_on_container_copy_assignment = std::false_type;
+    using propagate_on_container_move_assignment = std::false_type;
+    using propagate_on_container_swap = std::true_type;
+    using is_always_equal = std::false_type;
+
+    allocator() noexcept : source(current()) {}
+
+    explicit allocator(std::pmr::memory_resource *resource) noexcept : source(resource) {}
+
+    template<typename U>
+    allocator(const allocator<U> &other) noexcept : source(other.source) {}
+
+    T *allocate(const std::size_t &n) {
+        return static_cast<T *>(source->allocate(n * sizeof(T), alignof(T)));
+    }
+
+    void deallocate(T *p, const std::size_t &n) {
+        source->deallocate(p, n * sizeof(T), alignof(T));
+    }
+
+    [[nodiscard]] allocator select_on_container_copy_construction() const { return allocator(); }
+
+    [[nodiscard]] std::pmr::memory_resource *resource() const { return source; }
+
+    template<typename U>
+    bool operator==(const allocator<U> &other) const {
+        return source == other.source || source->is_equal(*other.source);
+    }
+};
+
+}
+
+#endif // CCOMMS_MODULES_TENSOR_MEMORY_HPP_
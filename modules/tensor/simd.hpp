@@ -0,0 +1,1454 @@
+// Copyright(c) 2023, Matthew Petrin, All rights reserved.
+
+#ifndef CCOMMS_MODULES_TENSOR_SIMD_HPP_
+#define CCOMMS_MODULES_TENSOR_SIMD_HPP_
+
+#include <bit>
+#include <atomic>
+#include <cmath>
+#include <limits>
+#include <cstdint>
+#include <complex>
+#include <cstddef>
+#include <vector>
+#include <algorithm>
+#include <type_traits>
+
+#include "expression.hpp"
+
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#define CCOMMS_SIMD_X86 1
+#include <immintrin.h>
+#else
+#define CCOMMS_SIMD_X86 0
+#endif
+
+namespace ccomms::simd {
+
+/**
+ * @brief Instruction sets with dedicated kernels, ordered from least to most capable.
+ */
+enum class level {
+    scalar = 0,
+    sse2 = 1,
+    avx2 = 2,
+    avx512 = 3
+};
+
+/**
+ * @brief Element types with dedicated kernels.
+ */
+template<typename T>
+concept kernel_type = std::is_same_v<T, float> || std::is_same_v<T, double> || std::is_same_v<T, std::int32_t> ||
+                      std::is_same_v<T, std::complex<float> >;
+
+/**
+ * @brief Number of elements reduced in registers before being folded into the compensated running sum.
+ */
+inline constexpr std::size_t block = 512;
+
+/**
+ * @brief Accuracy tiers of the math kernels.
+ *
+ * @details precise keeps errors within a few ULP of the element type, except sine and cosine whose error is bounded
+ * in absolute terms. fast trades that for float level accuracy: double evaluates the float polynomials, for errors
+ * around 1e-8, and float square roots use the hardware reciprocal square root estimate refined by one Newton step,
+ * within a few ULP. The other float kernels are the same in both tiers.
+ */
+enum class accuracy {
+    precise,
+    fast
+};
+
+//*************************************************** DETECTION ****************************************************
+
+/**
+ * @brief Returns the most capable instruction set supported by the running CPU.
+ */
+inline level detect() {
+#if CCOMMS_SIMD_X86
+    static const level detected = [] {
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx512f"))
+            return level::avx512;
+        if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma"))
+            return level::avx2;
+        if (__builtin_cpu_supports("sse2"))
+            return level::sse2;
+        return level::scalar;
+    }();
+    return detected;
+#else
+    return level::scalar;
+#endif
+}
+
+inline std::atomic<level> &active_level() {
+    static std::atomic<level> active{detect()};
+    return active;
+}
+
+/**
+ * @brief Returns the instruction set the dispatchers currently use.
+ */
+inline level active() {
+    return active_level().load(std::memory_order_relaxed);
+}
+
+/**
+ * @brief Restricts dispatch to at most the given instruction set, clamped to what the CPU supports.
+ */
+inline void restrict_to(const level &max) {
+    active_level().store(std::min(max, detect()), std::memory_order_relaxed);
+}
+
+/**
+ * @brief Neumaier compensated summation step used to fold per-block partial sums.
+ */
+template<typename T>
+inline void compensated_add(T &sum, T &comp, const T &value) {
+    if constexpr (std::is_floating_point_v<T>) {
+        const T total = sum + value;
+        if (std::abs(sum) >= std::abs(value))
+            comp += (sum - total) + value;
+        else
+            comp += (value - total) + sum;
+        sum = total;
+    } else {
+        sum += value;
+    }
+}
+
+//************************************************* MATH CONSTANTS *************************************************
+
+/**
+ * @brief Constants of the sincos kernels: pi / 2 split into parts whose products with a quadrant count are exact,
+ * the constant that rounds to an integer when added and subtracted again, and minimax polynomials for sine and
+ * cosine on [-pi / 4, pi / 4] with the highest order coefficient first.
+ */
+template<typename T>
+struct sincos_coefficients;
+
+template<>
+struct sincos_coefficients<float> {
+    static constexpr float two_over_pi = 0.636619772367581343f;
+    static constexpr float pio2[3] = {1.5703125f, 4.837512969970703125e-4f, 7.54978995489188216e-8f};
+    static constexpr float round = 12582912.0f;
+    static constexpr float sin[3] = {-1.9515295891e-4f, 8.3321608736e-3f, -1.6666654611e-1f};
+    static constexpr float cos[3] = {2.443315711809948e-5f, -1.388731625493765e-3f, 4.166664568298827e-2f};
+};
+
+template<>
+struct sincos_coefficients<double> {
+    static constexpr double two_over_pi = 0.636619772367581343076;
+    static constexpr double pio2[3] = {1.57079625129699707031, 7.54978941586159635335e-8,
+                                       5.39030285815811905290e-15};
+    static constexpr double round = 6755399441055744.0;
+    static constexpr double sin[6] = {1.58962301576546568060e-10, -2.50507477628578072866e-8,
+                                      2.75573136213857245213e-6, -1.98412698295895385996e-4,
+                                      8.33333333332211858878e-3, -1.66666666666666307295e-1};
+    static constexpr double cos[6] = {-1.13585365213876817300e-11, 2.08757008419747316778e-9,
+                                      -2.75573141792967388112e-7, 2.48015872888517045348e-5,
+                                      -1.38888888888730564116e-3, 4.16666666666665929218e-2};
+};
+
+/**
+ * @brief Constants of the exp kernels: ln 2 split into parts whose products with an exponent are exact, the inputs
+ * beyond which the result leaves the normal range, and the polynomial p with exp(r) = 1 + r + r^2 p(r) on
+ * [-ln 2 / 2, ln 2 / 2].
+ */
+template<typename T>
+struct exp_coefficients;
+
+template<>
+struct exp_coefficients<float> {
+    static constexpr float log2e = 1.44269504088896341f;
+    static constexpr float ln2[2] = {0.693359375f, -2.12194440e-4f};
+    static constexpr float round = 12582912.0f;
+    static constexpr float min = -87.3365447505f;
+    static constexpr float max = 88.7228391117f;
+    static constexpr float poly[6] = {1.9875691500e-4f, 1.3981999507e-3f, 8.3334519073e-3f, 4.1665795894e-2f,
+                                      1.6666665459e-1f, 5.0000001201e-1f};
+};
+
+template<>
+struct exp_coefficients<double> {
+    static constexpr double log2e = 1.44269504088896340736;
+    static constexpr double ln2[2] = {6.93145751953125e-1, 1.42860682030941723212e-6};
+    static constexpr double round = 6755399441055744.0;
+    static constexpr double min = -708.396418532264106;
+    static constexpr double max = 709.782712893383973;
+    static constexpr double poly[12] = {1.6059043836821614e-10, 2.0876756987868099e-9, 2.5052108385441719e-8,
+                                        2.7557319223985891e-7, 2.7557319223985893e-6, 2.4801587301587302e-5,
+                                        1.9841269841269841e-4, 1.3888888888888889e-3, 8.3333333333333332e-3,
+                                        4.1666666666666664e-2, 1.6666666666666666e-1, 0.5};
+};
+
+/**
+ * @brief Constants of the log kernels. The mantissa m is reduced to [sqrt(1 / 2), sqrt(2)) and f = m - 1. Float
+ * evaluates log(1 + f) = f - f^2 / 2 + f^3 p(f); double evaluates it from s = f / (2 + f) with the series in s^2.
+ */
+template<typename T>
+struct log_coefficients;
+
+template<>
+struct log_coefficients<float> {
+    static constexpr float sqrt_half = 0.707106781186547524f;
+    static constexpr float ln2[2] = {0.693359375f, -2.12194440e-4f};
+    static constexpr float poly[9] = {7.0376836292e-2f, -1.1514610310e-1f, 1.1676998740e-1f, -1.2420140846e-1f,
+                                      1.4249322787e-1f, -1.6668057665e-1f, 2.0000714765e-1f, -2.4999993993e-1f,
+                                      3.3333331174e-1f};
+};
+
+template<>
+struct log_coefficients<double> {
+    static constexpr double sqrt_half = 0.707106781186547524401;
+    static constexpr double ln2[2] = {6.93147180369123816490e-1, 1.90821492927058770002e-10};
+    static constexpr double poly[7] = {1.479819860511658591e-1, 1.531383769920937332e-1, 1.818357216161805012e-1,
+                                       2.222219843214978396e-1, 2.857142874366239149e-1, 3.999999999940941908e-1,
+                                       6.666666666666735130e-1};
+};
+
+/**
+ * @brief Constants of the atan2 kernels: the polynomial p with atan(t) = t + t^3 p(t^2) on
+ * [-tan(pi / 8), tan(pi / 8)].
+ */
+template<typename T>
+struct atan_coefficients;
+
+template<>
+struct atan_coefficients<float> {
+    static constexpr float poly[4] = {8.05374449538e-2f, -1.38776856032e-1f, 1.99777106478e-1f, -3.33329491539e-1f};
+};
+
+template<>
+struct atan_coefficients<double> {
+    static constexpr double poly[11] = {-1.62858201153657823623e-2, 3.65315727442169155270e-2,
+                                        -4.97687799461593236017e-2, 5.83357013379057348645e-2,
+                                        -6.66107313738753120669e-2, 7.69187620504482999495e-2,
+                                        -9.09088713343650656196e-2, 1.11111104054623557880e-1,
+                                        -1.42857142725034663711e-1, 1.99999999998764832476e-1,
+                                        -3.33333333333329318027e-1};
+};
+
+/**
+ * @brief Coefficients a kernel evaluates at a tier: the fast tier uses the float polynomials whatever the precision.
+ */
+template<template<typename> class K, accuracy A, typename T>
+using tier_coefficients = std::conditional_t<A == accuracy::fast, K<float>, K<T> >;
+
+//***************************************************** SCALAR *****************************************************
+
+namespace scalar {
+
+template<typename T>
+T dot(const T *a, const T *b, const std::size_t &n) {
+    T sum = 0;
+    T comp = 0;
+    std::size_t i = 0;
+
+    while (i < n) {
+        const std::size_t end = i + std::min(block, n - i);
+
+        T acc[4] = {0, 0, 0, 0};
+        for (; i + 4 <= end; i += 4) {
+            acc[0] += a[i] * b[i];
+            acc[1] += a[i + 1] * b[i + 1];
+            acc[2] += a[i + 2] * b[i + 2];
+            acc[3] += a[i + 3] * b[i + 3];
+        }
+        for (; i < end; i++)
+            acc[0] += a[i] * b[i];
+
+        compensated_add(sum, comp, (acc[0] + acc[1]) + (acc[2] + acc[3]));
+    }
+
+    return sum + comp;
+}
+
+template<bool Conj>
+std::complex<float> cdot(const std::complex<float> *a, const std::complex<float> *b, const std::size_t &n) {
+    float re = 0, re_comp = 0;
+    float im = 0, im_comp = 0;
+    std::size_t i = 0;
+
+    while (i < n) {
+        const std::size_t end = i + std::min(block, n - i);
+
+        std::complex<float> acc = 0;
+        for (; i < end; i++)
+            acc += (Conj ? std::conj(a[i]) : a[i]) * b[i];
+
+        compensated_add(re, re_comp, acc.real());
+        compensated_add(im, im_comp, acc.imag());
+    }
+
+    return {re + re_comp, im + im_comp};
+}
+
+template<typename Op, bool LS, bool RS, typename T>
+void transform(T *dst, const T *a, const T *b, const std::size_t &n) {
+    for (std::size_t i = 0; i < n; i++)
+        dst[i] = static_cast<T>(Op{}(a[LS ? 0 : i], b[RS ? 0 : i]));
+}
+
+template<typename T>
+void axpy(T *dst, const T &alpha, const T *x, const std::size_t &n) {
+    for (std::size_t i = 0; i < n; i++)
+        dst[i] += alpha * x[i];
+}
+
+template<typename T>
+void fma(T *dst, const T *a, const T *b, const std::size_t &n) {
+    for (std::size_t i = 0; i < n; i++)
+        dst[i] += a[i] * b[i];
+}
+
+inline void conj(std::complex<float> *dst, const std::complex<float> *src, const std::size_t &n) {
+    for (std::size_t i = 0; i < n; i++)
+        dst[i] = std::conj(src[i]);
+}
+
+inline void norm(float *dst, const std::complex<float> *src, const std::size_t &n) {
+    for (std::size_t i = 0; i < n; i++)
+        dst[i] = src[i].real() * src[i].real() + src[i].imag() * src[i].imag();
+}
+
+template<typename T>
+std::complex<T> split_dotc(const T *a_re, const T *a_im, const T *b_re, const T *b_im, const std::size_t &n) {
+    T re = 0, re_comp = 0;
+    T im = 0, im_comp = 0;
+    std::size_t i = 0;
+
+    while (i < n) {
+        const std::size_t end = i + std::min(block, n - i);
+
+        T part_re = 0, part_im = 0;
+        for (; i < end; i++) {
+            part_re += a_re[i] * b_re[i] + a_im[i] * b_im[i];
+            part_im += a_re[i] * b_im[i] - a_im[i] * b_re[i];
+        }
+
+        compensated_add(re, re_comp, part_re);
+        compensated_add(im, im_comp, part_im);
+    }
+
+    return {re + re_comp, im + im_comp};
+}
+
+template<typename T>
+void split_norm(T *dst, const T *re, const T *im, const std::size_t &n) {
+    for (std::size_t i = 0; i < n; i++)
+        dst[i] = re[i] * re[i] + im[i] * im[i];
+}
+
+template<typename T>
+void affine3(const T *m, const T *pre, const T *post, const T *x, const T *y, const T *z, T *ox, T *oy, T *oz,
+             const std::size_t &n) {
+    for (std::size_t i = 0; i < n; i++) {
+        const T dx = x[i] - pre[0], dy = y[i] - pre[1], dz = z[i] - pre[2];
+        ox[i] = m[0] * dx + m[1] * dy + m[2] * dz + post[0];
+        oy[i] = m[3] * dx + m[4] * dy + m[5] * dz + post[1];
+        oz[i] = m[6] * dx + m[7] * dy + m[8] * dz + post[2];
+    }
+}
+
+template<typename T>
+void gemm(const std::size_t &m, const std::size_t &n, const std::size_t &k, const T *a, const std::size_t &lda,
+          const T *b, const std::size_t &ldb, T *c, const std::size_t &ldc) {
+    for (std::size_t i = 0; i < m; i++)
+        for (std::size_t p = 0; p < k; p++) {
+            const T aip = a[i * lda + p];
+            for (std::size_t j = 0; j < n; j++)
+                c[i * ldc + j] += aip * b[p * ldb + j];
+        }
+}
+
+template<bool Conj, typename T>
+void split_mul(T *dst_re, T *dst_im, const T *a_re, const T *a_im, const T *b_re, const T *b_im,
+               const std::size_t &n) {
+    for (std::size_t i = 0; i < n; i++) {
+        const T ar = a_re[i], ai = Conj ? -a_im[i] : a_im[i];
+        const T br = b_re[i], bi = b_im[i];
+        dst_re[i] = ar * br - ai * bi;
+        dst_im[i] = ar * bi + ai * br;
+    }
+}
+
+// Complex product without the inf and nan recovery of std::complex operator*
+template<typename T>
+inline std::complex<T> cmul(const std::complex<T> &a, const std::complex<T> &b) {
+    return {a.real() * b.real() - a.imag() * b.imag(), a.real() * b.imag() + a.imag() * b.real()};
+}
+
+template<bool Inverse, typename T>
+inline std::complex<T> twiddle(const std::complex<T> &w) {
+    return Inverse ? std::conj(w) : w;
+}
+
+template<typename T>
+inline void butterfly2(const std::complex<T> &a, const std::complex<T> &b, const std::complex<T> &w,
+                       std::complex<T> &y0, std::complex<T> &y1) {
+    y0 = a + b;
+    y1 = cmul(a - b, w);
+}
+
+template<bool Inverse, typename T>
+inline void butterfly4(const std::complex<T> &a0, const std::complex<T> &a1, const std::complex<T> &a2,
+                       const std::complex<T> &a3, const std::complex<T> *w, std::complex<T> &y0,
+                       std::complex<T> &y1, std::complex<T> &y2, std::complex<T> &y3) {
+    const std::complex<T> t0 = a0 + a2, t1 = a0 - a2, t2 = a1 + a3, d = a1 - a3;
+    // d multiplied by -i for the forward transform and by i for the inverse
+    const std::complex<T> t3 = Inverse ? std::complex<T>(-d.imag(), d.real()) : std::complex<T>(d.imag(), -d.real());
+    y0 = t0 + t2;
+    y1 = cmul(t1 + t3, w[0]);
+    y2 = cmul(t0 - t2, w[1]);
+    y3 = cmul(t1 - t3, w[2]);
+}
+
+template<bool Inverse, typename T>
+void fft_radix2(const std::complex<T> *x, std::complex<T> *y, const std::size_t &n, const std::size_t &s,
+                const std::complex<T> *tw) {
+    const std::size_t m = n / 2;
+    for (std::size_t p = 0; p < m; p++) {
+        const std::complex<T> w = twiddle<Inverse>(tw[p]);
+        const std::complex<T> *a = x + s * p, *b = x + s * (p + m);
+        std::complex<T> *y0 = y + s * 2 * p, *y1 = y0 + s;
+        for (std::size_t q = 0; q < s; q++)
+            butterfly2(a[q], b[q], w, y0[q], y1[q]);
+    }
+}
+
+template<bool Inverse, typename T>
+void fft_radix4(const std::complex<T> *x, std::complex<T> *y, const std::size_t &n, const std::size_t &s,
+                const std::complex<T> *tw) {
+    const std::size_t m = n / 4;
+    for (std::size_t p = 0; p < m; p++) {
+        const std::complex<T> w[3] = {twiddle<Inverse>(tw[3 * p]), twiddle<Inverse>(tw[3 * p + 1]),
+                                      twiddle<Inverse>(tw[3 * p + 2])};
+        const std::complex<T> *a0 = x + s * p, *a1 = x + s * (p + m), *a2 = x + s * (p + 2 * m),
+                *a3 = x + s * (p + 3 * m);
+        std::complex<T> *y0 = y + s * 4 * p, *y1 = y0 + s, *y2 = y1 + s, *y3 = y2 + s;
+        for (std::size_t q = 0; q < s; q++)
+            butterfly4<Inverse>(a0[q], a1[q], a2[q], a3[q], w, y0[q], y1[q], y2[q], y3[q]);
+    }
+}
+
+template<bool Accumulate, typename T>
+inline void fir_store(T *y, const T &value) {
+    if constexpr (Accumulate)
+        *y += value;
+    else
+        *y = value;
+}
+
+template<bool Accumulate, typename T>
+void fir(const T *h, const std::size_t &taps, const T *x, const std::size_t &step, T *y, const std::size_t &stride,
+         const std::size_t &n) {
+    for (std::size_t t = 0; t < n; t++) {
+        const T *window = x + t * step;
+        T sum = 0;
+        for (std::size_t k = 0; k < taps; k++)
+            sum += h[k] * window[k];
+        fir_store<Accumulate>(y + t * stride, sum);
+    }
+}
+
+/**
+ * @brief A single lane batch, so that the math kernels evaluate the same approximations at every level.
+ */
+template<typename T>
+struct batch {
+    using reg = T;
+    using mask = bool;
+    using bits = std::conditional_t<sizeof(T) == 4, std::uint32_t, std::uint64_t>;
+    static constexpr std::size_t lanes = 1;
+
+    static reg load(const T *p) { return *p; }
+    static void store(T *p, const reg &r) { *p = r; }
+    static reg set1(const T &x) { return x; }
+    static reg zero() { return T(0); }
+    static reg add(const reg &a, const reg &b) { return a + b; }
+    static reg sub(const reg &a, const reg &b) { return a - b; }
+    static reg mul(const reg &a, const reg &b) { return a * b; }
+    static reg div(const reg &a, const reg &b) { return a / b; }
+    static reg sqrt(const reg &a) { return std::sqrt(a); }
+    static reg rsqrt_estimate(const reg &a) { return T(1) / std::sqrt(a); }
+    static reg fmadd(const reg &a, const reg &b, const reg &c) { return a * b + c; }
+    static reg abs(const reg &a) { return std::abs(a); }
+    static reg min(const reg &a, const reg &b) { return b < a ? b : a; }
+    static reg max(const reg &a, const reg &b) { return a < b ? b : a; }
+    static mask lt(const reg &a, const reg &b) { return a < b; }
+    static mask le(const reg &a, const reg &b) { return a <= b; }
+    static mask eq(const reg &a, const reg &b) { return a == b; }
+    static reg select(const mask &m, const reg &a, const reg &b) { return m ? a : b; }
+    static reg bit_and(const reg &a, const reg &b) { return std::bit_cast<T>(as_bits(a) & as_bits(b)); }
+    static reg bit_or(const reg &a, const reg &b) { return std::bit_cast<T>(as_bits(a) | as_bits(b)); }
+    static reg bit_xor(const reg &a, const reg &b) { return std::bit_cast<T>(as_bits(a) ^ as_bits(b)); }
+
+    template<int N>
+    static reg shift_left(const reg &a) { return std::bit_cast<T>(as_bits(a) << N); }
+
+    template<int N>
+    static reg shift_right(const reg &a) { return std::bit_cast<T>(as_bits(a) >> N); }
+
+private:
+    static bits as_bits(const reg &a) { return std::bit_cast<bits>(a); }
+};
+
+#include "simd_math.inl"
+
+}
+
+#if CCOMMS_SIMD_X86
+
+//****************************************************** SSE2 ******************************************************
+
+#if defined(__clang__)
+#pragma clang attribute push(__attribute__((target("sse2"))), apply_to = function)
+#else
+#pragma GCC push_options
+#pragma GCC target("sse2")
+#endif
+
+namespace sse2 {
+
+template<typename T>
+struct batch;
+
+template<>
+struct batch<float> {
+    using reg = __m128;
+    using mask = __m128;
+    static constexpr std::size_t lanes = 4;
+
+    static reg load(const float *p) { return _mm_loadu_ps(p); }
+    static void store(float *p, const reg &r) { _mm_storeu_ps(p, r); }
+    static reg set1(const float &x) { return _mm_set1_ps(x); }
+    static reg set_pair(const float &re, const float &im) { return _mm_setr_ps(re, im, re, im); }
+    static reg zero() { return _mm_setzero_ps(); }
+    static reg add(const reg &a, const reg &b) { return _mm_add_ps(a, b); }
+    static reg sub(const reg &a, const reg &b) { return _mm_sub_ps(a, b); }
+    static reg mul(const reg &a, const reg &b) { return _mm_mul_ps(a, b); }
+    static reg div(const reg &a, const reg &b) { return _mm_div_ps(a, b); }
+    static reg sqrt(const reg &a) { return _mm_sqrt_ps(a); }
+    static reg fmadd(const reg &a, const reg &b, const reg &c) { return _mm_add_ps(_mm_mul_ps(a, b), c); }
+    static reg rsqrt_estimate(const reg &a) { return _mm_rsqrt_ps(a); }
+    static reg abs(const reg &a) { return _mm_andnot_ps(_mm_set1_ps(-0.0f), a); }
+    static reg min(const reg &a, const reg &b) { return _mm_min_ps(a, b); }
+    static reg max(const reg &a, const reg &b) { return _mm_max_ps(a, b); }
+    static mask lt(const reg &a, const reg &b) { return _mm_cmplt_ps(a, b); }
+    static mask le(const reg &a, const reg &b) { return _mm_cmple_ps(a, b); }
+    static mask eq(const reg &a, const reg &b) { return _mm_cmpeq_ps(a, b); }
+
+    static reg select(const mask &m, const reg &a, const reg &b) {
+        return _mm_or_ps(_mm_and_ps(m, a), _mm_andnot_ps(m, b));
+    }
+
+    static reg bit_and(const reg &a, const reg &b) { return _mm_and_ps(a, b); }
+    static reg bit_or(const reg &a, const reg &b) { return _mm_or_ps(a, b); }
+    static reg bit_xor(const reg &a, const reg &b) { return _mm_xor_ps(a, b); }
+    static reg dup_even(const reg &a) { return _mm_shuffle_ps(a, a, _MM_SHUFFLE(2, 2, 0, 0)); }
+    static reg dup_odd(const reg &a) { return _mm_shuffle_ps(a, a, _MM_SHUFFLE(3, 3, 1, 1)); }
+    static reg swap_pairs(const reg &a) { return _mm_shuffle_ps(a, a, _MM_SHUFFLE(2, 3, 0, 1)); }
+    static reg negate_even(const reg &a) { return _mm_xor_ps(a, _mm_setr_ps(-0.0f, 0.0f, -0.0f, 0.0f)); }
+    static reg negate_odd(const reg &a) { return _mm_xor_ps(a, _mm_setr_ps(0.0f, -0.0f, 0.0f, -0.0f)); }
+
+    static reg pair_sum(const reg &a, const reg &b) {
+        return _mm_add_ps(_mm_shuffle_ps(a, b, _MM_SHUFFLE(2, 0, 2, 0)), _mm_shuffle_ps(a, b, _MM_SHUFFLE(3, 1, 3, 1)));
+    }
+
+    static float reduce(const reg &a) {
+        auto t = _mm_add_ps(a, _mm_movehl_ps(a, a));
+        t = _mm_add_ss(t, _mm_shuffle_ps(t, t, 1));
+        return _mm_cvtss_f32(t);
+    }
+
+    template<int N>
+    static reg shift_left(const reg &a) { return _mm_castsi128_ps(_mm_slli_epi32(_mm_castps_si128(a), N)); }
+
+    template<int N>
+    static reg shift_right(const reg &a) { return _mm_castsi128_ps(_mm_srli_epi32(_mm_castps_si128(a), N)); }
+};
+
+template<>
+struct batch<double> {
+    using reg = __m128d;
+    using mask = __m128d;
+    static constexpr std::size_t lanes = 2;
+
+    static reg load(const double *p) { return _mm_loadu_pd(p); }
+    static void store(double *p, const reg &r) { _mm_storeu_pd(p, r); }
+    static reg set1(const double &x) { return _mm_set1_pd(x); }
+    static reg zero() { return _mm_setzero_pd(); }
+    static reg add(const reg &a, const reg &b) { return _mm_add_pd(a, b); }
+    static reg sub(const reg &a, const reg &b) { return _mm_sub_pd(a, b); }
+    static reg mul(const reg &a, const reg &b) { return _mm_mul_pd(a, b); }
+    static reg div(const reg &a, const reg &b) { return _mm_div_pd(a, b); }
+    static reg sqrt(const reg &a) { return _mm_sqrt_pd(a); }
+    static reg fmadd(const reg &a, const reg &b, const reg &c) { return _mm_add_pd(_mm_mul_pd(a, b), c); }
+    static reg abs(const reg &a) { return _mm_andnot_pd(_mm_set1_pd(-0.0), a); }
+    static reg min(const reg &a, const reg &b) { return _mm_min_pd(a, b); }
+    static reg max(const reg &a, const reg &b) { return _mm_max_pd(a, b); }
+    static mask lt(const reg &a, const reg &b) { return _mm_cmplt_pd(a, b); }
+    static mask le(const reg &a, const reg &b) { return _mm_cmple_pd(a, b); }
+    static mask eq(const reg &a, const reg &b) { return _mm_cmpeq_pd(a, b); }
+
+    static reg select(const mask &m, const reg &a, const reg &b) {
+        return _mm_or_pd(_mm_and_pd(m, a), _mm_andnot_pd(m, b));
+    }
+
+    static reg bit_and(const reg &a, const reg &b) { return _mm_and_pd(a, b); }
+    static reg bit_or(const reg &a, const reg &b) { return _mm_or_pd(a, b); }
+    static reg bit_xor(const reg &a, const reg &b) { return _mm_xor_pd(a, b); }
+    static double reduce(const reg &a) { return _mm_cvtsd_f64(_mm_add_sd(a, _mm_unpackhi_pd(a, a))); }
+
+    template<int N>
+    static reg shift_left(const reg &a) { return _mm_castsi128_pd(_mm_slli_epi64(_mm_castpd_si128(a), N)); }
+
+    template<int N>
+    static reg shift_right(const reg &a) { return _mm_castsi128_pd(_mm_srli_epi64(_mm_castpd_si128(a), N)); }
+};
+
+template<>
+struct batch<std::int32_t> {
+    using reg = __m128i;
+    static constexpr std::size_t lanes = 4;
+
+    static reg load(const std::int32_t *p) { return _mm_loadu_si128(reinterpret_cast<const __m128i *>(p)); }
+    static void store(std::int32_t *p, const reg &r) { _mm_storeu_si128(reinterpret_cast<__m128i *>(p), r); }
+    static reg set1(const std::int32_t &x) { return _mm_set1_epi32(x); }
+    static reg zero() { return _mm_setzero_si128(); }
+    static reg add(const reg &a, const reg &b) { return _mm_add_epi32(a, b); }
+    static reg sub(const reg &a, const reg &b) { return _mm_sub_epi32(a, b); }
+    static reg fmadd(const reg &a, const reg &b, const reg &c) { return _mm_add_epi32(mul(a, b), c); }
+
+    static reg mul(const reg &a, const reg &b) {
+        auto even = _mm_mul_epu32(a, b);
+        auto odd = _mm_mul_epu32(_mm_srli_si128(a, 4), _mm_srli_si128(b, 4));
+        return _mm_unpacklo_epi32(_mm_shuffle_epi32(even, _MM_SHUFFLE(0, 0, 2, 0)),
+                                  _mm_shuffle_epi32(odd, _MM_SHUFFLE(0, 0, 2, 0)));
+    }
+
+    static std::int32_t reduce(const reg &a) {
+        auto t = _mm_add_epi32(a, _mm_shuffle_epi32(a, _MM_SHUFFLE(1, 0, 3, 2)));
+        t = _mm_add_epi32(t, _mm_shuffle_epi32(t, _MM_SHUFFLE(2, 3, 0, 1)));
+        return _mm_cvtsi128_si32(t);
+    }
+};
+
+#include "simd_kernels.inl"
+#include "simd_math.inl"
+
+}
+
+#if defined(__clang__)
+#pragma clang attribute pop
+#else
+#pragma GCC pop_options
+#endif
+
+//****************************************************** AVX2 ******************************************************
+
+#if defined(__clang__)
+#pragma clang attribute push(__attribute__((target("avx2,fma"))), apply_to = function)
+#else
+#pragma GCC push_options
+#pragma GCC target("avx2,fma")
+#endif
+
+namespace avx2 {
+
+template<typename T>
+struct batch;
+
+template<>
+struct batch<float> {
+    using reg = __m256;
+    using mask = __m256;
+    static constexpr std::size_t lanes = 8;
+
+    static reg load(const float *p) { return _mm256_loadu_ps(p); }
+    static void store(float *p, const reg &r) { _mm256_storeu_ps(p, r); }
+    static reg set1(const float &x) { return _mm256_set1_ps(x); }
+    static reg set_pair(const float &re, const float &im) { return _mm256_setr_ps(re, im, re, im, re, im, re, im); }
+    static reg zero() { return _mm256_setzero_ps(); }
+    static reg add(const reg &a, const reg &b) { return _mm256_add_ps(a, b); }
+    static reg sub(const reg &a, const reg &b) { return _mm256_sub_ps(a, b); }
+    static reg mul(const reg &a, const reg &b) { return _mm256_mul_ps(a, b); }
+    static reg div(const reg &a, const reg &b) { return _mm256_div_ps(a, b); }
+    static reg sqrt(const reg &a) { return _mm256_sqrt_ps(a); }
+    static reg fmadd(const reg &a, const reg &b, const reg &c) { return _mm256_fmadd_ps(a, b, c); }
+    static reg rsqrt_estimate(const reg &a) { return _mm256_rsqrt_ps(a); }
+    static reg abs(const reg &a) { return _mm256_andnot_ps(_mm256_set1_ps(-0.0f), a); }
+    static reg min(const reg &a, const reg &b) { return _mm256_min_ps(a, b); }
+    static reg max(const reg &a, const reg &b) { return _mm256_max_ps(a, b); }
+    static mask lt(const reg &a, const reg &b) { return _mm256_cmp_ps(a, b, _CMP_LT_OQ); }
+    static mask le(const reg &a, const reg &b) { return _mm256_cmp_ps(a, b, _CMP_LE_OQ); }
+    static mask eq(const reg &a, const reg &b) { return _mm256_cmp_ps(a, b, _CMP_EQ_OQ); }
+    static reg select(const mask &m, const reg &a, const reg &b) { return _mm256_blendv_ps(b, a, m); }
+    static reg bit_and(const reg &a, const reg &b) { return _mm256_and_ps(a, b); }
+    static reg bit_or(const reg &a, const reg &b) { return _mm256_or_ps(a, b); }
+    static reg bit_xor(const reg &a, const reg &b) { return _mm256_xor_ps(a, b); }
+    static reg dup_even(const reg &a) { return _mm256_moveldup_ps(a); }
+    static reg dup_odd(const reg &a) { return _mm256_movehdup_ps(a); }
+    static reg swap_pairs(const reg &a) { return _mm256_permute_ps(a, 0xB1); }
+    static reg negate_even(const reg &a) { return _mm256_xor_ps(a, set_pair(-0.0f, 0.0f)); }
+    static reg negate_odd(const reg &a) { return _mm256_xor_ps(a, set_pair(0.0f, -0.0f)); }
+
+    static reg pair_sum(const reg &a, const reg &b) {
+        return _mm256_castpd_ps(_mm256_permute4x64_pd(_mm256_castps_pd(_mm256_hadd_ps(a, b)), 0xD8));
+    }
+
+    static float reduce(const reg &a) {
+        auto t = _mm_add_ps(_mm256_castps256_ps128(a), _mm256_extractf128_ps(a, 1));
+        t = _mm_add_ps(t, _mm_movehl_ps(t, t));
+        t = _mm_add_ss(t, _mm_shuffle_ps(t, t, 1));
+        return _mm_cvtss_f32(t);
+    }
+
+    template<int N>
+    static reg shift_left(const reg &a) { return _mm256_castsi256_ps(_mm256_slli_epi32(_mm256_castps_si256(a), N)); }
+
+    template<int N>
+    static reg shift_right(const reg &a) { return _mm256_castsi256_ps(_mm256_srli_epi32(_mm256_castps_si256(a), N)); }
+};
+
+template<>
+struct batch<double> {
+    using reg = __m256d;
+    using mask = __m256d;
+    static constexpr std::size_t lanes = 4;
+
+    static reg load(const double *p) { return _mm256_loadu_pd(p); }
+    static void store(double *p, const reg &r) { _mm256_storeu_pd(p, r); }
+    static reg set1(const double &x) { return _mm256_set1_pd(x); }
+    static reg zero() { return _mm256_setzero_pd(); }
+    static reg add(const reg &a, const reg &b) { return _mm256_add_pd(a, b); }
+    static reg sub(const reg &a, const reg &b) { return _mm256_sub_pd(a, b); }
+    static reg mul(const reg &a, const reg &b) { return _mm256_mul_pd(a, b); }
+    static reg div(const reg &a, const reg &b) { return _mm256_div_pd(a, b); }
+    static reg sqrt(const reg &a) { return _mm256_sqrt_pd(a); }
+    static reg fmadd(const reg &a, const reg &b, const reg &c) { return _mm256_fmadd_pd(a, b, c); }
+    static reg abs(const reg &a) { return _mm256_andnot_pd(_mm256_set1_pd(-0.0), a); }
+    static reg min(const reg &a, const reg &b) { return _mm256_min_pd(a, b); }
+    static reg max(const reg &a, const reg &b) { return _mm256_max_pd(a, b); }
+    static mask lt(const reg &a, const reg &b) { return _mm256_cmp_pd(a, b, _CMP_LT_OQ); }
+    static mask le(const reg &a, const reg &b) { return _mm256_cmp_pd(a, b, _CMP_LE_OQ); }
+    static mask eq(const reg &a, const reg &b) { return _mm256_cmp_pd(a, b, _CMP_EQ_OQ); }
+    static reg select(const mask &m, const reg &a, const reg &b) { return _mm256_blendv_pd(b, a, m); }
+    static reg bit_and(const reg &a, const reg &b) { return _mm256_and_pd(a, b); }
+    static reg bit_or(const reg &a, const reg &b) { return _mm256_or_pd(a, b); }
+    static reg bit_xor(const reg &a, const reg &b) { return _mm256_xor_pd(a, b); }
+
+    static double reduce(const reg &a) {
+        auto t = _mm_add_pd(_mm256_castpd256_pd128(a), _mm256_extractf128_pd(a, 1));
+        return _mm_cvtsd_f64(_mm_add_sd(t, _mm_unpackhi_pd(t, t)));
+    }
+
+    template<int N>
+    static reg shift_left(const reg &a) { return _mm256_castsi256_pd(_mm256_slli_epi64(_mm256_castpd_si256(a), N)); }
+
+    template<int N>
+    static reg shift_right(const reg &a) { return _mm256_castsi256_pd(_mm256_srli_epi64(_mm256_castpd_si256(a), N)); }
+};
+
+template<>
+struct batch<std::int32_t> {
+    using reg = __m256i;
+    static constexpr std::size_t lanes = 8;
+
+    static reg load(const std::int32_t *p) { return _mm256_loadu_si256(reinterpret_cast<const __m256i *>(p)); }
+    static void store(std::int32_t *p, const reg &r) { _mm256_storeu_si256(reinterpret_cast<__m256i *>(p), r); }
+    static reg set1(const std::int32_t &x) { return _mm256_set1_epi32(x); }
+    static reg zero() { return _mm256_setzero_si256(); }
+    static reg add(const reg &a, const reg &b) { return _mm256_add_epi32(a, b); }
+    static reg sub(const reg &a, const reg &b) { return _mm256_sub_epi32(a, b); }
+    static reg mul(const reg &a, const reg &b) { return _mm256_mullo_epi32(a, b); }
+    static reg fmadd(const reg &a, const reg &b, const reg &c) { return _mm256_add_epi32(mul(a, b), c); }
+
+    static std::int32_t reduce(const reg &a) {
+        auto t = _mm_add_epi32(_mm256_castsi256_si128(a), _mm256_extracti128_si256(a, 1));
+        t = _mm_add_epi32(t, _mm_shuffle_epi32(t, _MM_SHUFFLE(1, 0, 3, 2)));
+        t = _mm_add_epi32(t, _mm_shuffle_epi32(t, _MM_SHUFFLE(2, 3, 0, 1)));
+        return _mm_cvtsi128_si32(t);
+    }
+};
+
+#include "simd_kernels.inl"
+#include "simd_math.inl"
+
+}
+
+#if defined(__clang__)
+#pragma clang attribute pop
+#else
+#pragma GCC pop_options
+#endif
+
+//***************************************************** AVX512 *****************************************************
+
+#if defined(__clang__)
+#pragma clang attribute push(__attribute__((target("avx512f"))), apply_to = function)
+#else
+#pragma GCC push_options
+#pragma GCC target("avx512f")
+#endif
+
+namespace avx512 {
+
+// GCC's unmasked AVX-512 intrinsics merge into an undefined register, which -Wmaybe-uninitialized reports once they
+// are inlined. Shuffles, square roots and reductions use the merge masked forms with every lane set instead, which
+// compile to the same instructions.
+
+template<typename T>
+struct batch;
+
+template<>
+struct batch<float> {
+    using reg = __m512;
+    using mask = __mmask16;
+    static constexpr std::size_t lanes = 16;
+
+    static reg load(const float *p) { return _mm512_loadu_ps(p); }
+    static void store(float *p, const reg &r) { _mm512_storeu_ps(p, r); }
+    static reg set1(const float &x) { return _mm512_set1_ps(x); }
+    static reg set_pair(const float &re, const float &im) { return _mm512_set4_ps(im, re, im, re); }
+    static reg zero() { return _mm512_setzero_ps(); }
+    static reg add(const reg &a, const reg &b) { return _mm512_add_ps(a, b); }
+    static reg sub(const reg &a, const reg &b) { return _mm512_sub_ps(a, b); }
+    static reg mul(const reg &a, const reg &b) { return _mm512_mul_ps(a, b); }
+    static reg div(const reg &a, const reg &b) { return _mm512_div_ps(a, b); }
+    static reg sqrt(const reg &a) { return _mm512_mask_sqrt_ps(a, 0xFFFF, a); }
+    static reg fmadd(const reg &a, const reg &b, const reg &c) { return _mm512_fmadd_ps(a, b, c); }
+    static reg rsqrt_estimate(const reg &a) { return _mm512_mask_rsqrt14_ps(a, 0xFFFF, a); }
+    static reg abs(const reg &a) { return _mm512_abs_ps(a); }
+    static reg min(const reg &a, const reg &b) { return _mm512_mask_min_ps(a, 0xFFFF, a, b); }
+    static reg max(const reg &a, const reg &b) { return _mm512_mask_max_ps(a, 0xFFFF, a, b); }
+    static mask lt(const reg &a, const reg &b) { return _mm512_cmp_ps_mask(a, b, _CMP_LT_OQ); }
+    static mask le(const reg &a, const reg &b) { return _mm512_cmp_ps_mask(a, b, _CMP_LE_OQ); }
+    static mask eq(const reg &a, const reg &b) { return _mm512_cmp_ps_mask(a, b, _CMP_EQ_OQ); }
+    static reg select(const mask &m, const reg &a, const reg &b) { return _mm512_mask_blend_ps(m, b, a); }
+    static reg dup_even(const reg &a) { return _mm512_mask_moveldup_ps(a, 0xFFFF, a); }
+    static reg dup_odd(const reg &a) { return _mm512_mask_movehdup_ps(a, 0xFFFF, a); }
+    static reg swap_pairs(const reg &a) { return _mm512_mask_permute_ps(a, 0xFFFF, a, 0xB1); }
+
+    static float reduce(const reg &a) {
+        auto t = _mm512_add_ps(a, _mm512_mask_shuffle_f32x4(a, 0xFFFF, a, a, 0x4E));
+        t = _mm512_add_ps(t, _mm512_mask_shuffle_f32x4(t, 0xFFFF, t, t, 0xB1));
+        t = _mm512_add_ps(t, _mm512_mask_permute_ps(t, 0xFFFF, t, 0x4E));
+        return _mm512_cvtss_f32(_mm512_add_ps(t, _mm512_mask_permute_ps(t, 0xFFFF, t, 0xB1)));
+    }
+
+    static reg negate_even(const reg &a) {
+        return _mm512_castsi512_ps(_mm512_xor_si512(_mm512_castps_si512(a),
+                                                    _mm512_castps_si512(set_pair(-0.0f, 0.0f))));
+    }
+
+    static reg negate_odd(const reg &a) {
+        return _mm512_castsi512_ps(_mm512_xor_si512(_mm512_castps_si512(a),
+                                                    _mm512_castps_si512(set_pair(0.0f, -0.0f))));
+    }
+
+    static reg pair_sum(const reg &a, const reg &b) {
+        const auto even = _mm512_setr_epi32(0, 2, 4, 6, 8, 10, 12, 14, 16, 18, 20, 22, 24, 26, 28, 30);
+        const auto odd = _mm512_setr_epi32(1, 3, 5, 7, 9, 11, 13, 15, 17, 19, 21, 23, 25, 27, 29, 31);
+        return _mm512_add_ps(_mm512_permutex2var_ps(a, even, b), _mm512_permutex2var_ps(a, odd, b));
+    }
+
+    // Bitwise operations on float lanes need AVX512DQ, so they go through the integer forms
+    static reg bit_and(const reg &a, const reg &b) {
+        return _mm512_castsi512_ps(_mm512_and_si512(_mm512_castps_si512(a), _mm512_castps_si512(b)));
+    }
+
+    static reg bit_or(const reg &a, const reg &b) {
+        return _mm512_castsi512_ps(_mm512_or_si512(_mm512_castps_si512(a), _mm512_castps_si512(b)));
+    }
+
+    static reg bit_xor(const reg &a, const reg &b) {
+        return _mm512_castsi512_ps(_mm512_xor_si512(_mm512_castps_si512(a), _mm512_castps_si512(b)));
+    }
+
+    template<int N>
+    static reg shift_left(const reg &a) {
+        const auto x = _mm512_castps_si512(a);
+        return _mm512_castsi512_ps(_mm512_mask_slli_epi32(x, 0xFFFF, x, N));
+    }
+
+    template<int N>
+    static reg shift_right(const reg &a) {
+        const auto x = _mm512_castps_si512(a);
+        return _mm512_castsi512_ps(_mm512_mask_srli_epi32(x, 0xFFFF, x, N));
+    }
+};
+
+template<>
+struct batch<double> {
+    using reg = __m512d;
+    using mask = __mmask8;
+    static constexpr std::size_t lanes = 8;
+
+    static reg load(const double *p) { return _mm512_loadu_pd(p); }
+    static void store(double *p, const reg &r) { _mm512_storeu_pd(p, r); }
+    static reg set1(const double &x) { return _mm512_set1_pd(x); }
+    static reg zero() { return _mm512_setzero_pd(); }
+    static reg add(const reg &a, const reg &b) { return _mm512_add_pd(a, b); }
+    static reg sub(const reg &a, const reg &b) { return _mm512_sub_pd(a, b); }
+    static reg mul(const reg &a, const reg &b) { return _mm512_mul_pd(a, b); }
+    static reg div(const reg &a, const reg &b) { return _mm512_div_pd(a, b); }
+    static reg sqrt(const reg &a) { return _mm512_mask_sqrt_pd(a, 0xFF, a); }
+    static reg fmadd(const reg &a, const reg &b, const reg &c) { return _mm512_fmadd_pd(a, b, c); }
+    static reg abs(const reg &a) { return _mm512_abs_pd(a); }
+    static reg min(const reg &a, const reg &b) { return _mm512_mask_min_pd(a, 0xFF, a, b); }
+    static reg max(const reg &a, const reg &b) { return _mm512_mask_max_pd(a, 0xFF, a, b); }
+    static mask lt(const reg &a, const reg &b) { return _mm512_cmp_pd_mask(a, b, _CMP_LT_OQ); }
+    static mask le(const reg &a, const reg &b) { return _mm512_cmp_pd_mask(a, b, _CMP_LE_OQ); }
+    static mask eq(const reg &a, const reg &b) { return _mm512_cmp_pd_mask(a, b, _CMP_EQ_OQ); }
+    static reg select(const mask &m, const reg &a, const reg &b) { return _mm512_mask_blend_pd(m, b, a); }
+
+    static double reduce(const reg &a) {
+        auto t = _mm512_add_pd(a, _mm512_mask_shuffle_f64x2(a, 0xFF, a, a, 0x4E));
+        t = _mm512_add_pd(t, _mm512_mask_shuffle_f64x2(t, 0xFF, t, t, 0xB1));
+        return _mm512_cvtsd_f64(_mm512_add_pd(t, _mm512_mask_permute_pd(t, 0xFF, t, 0x55)));
+    }
+
+    static reg bit_and(const reg &a, const reg &b) {
+        return _mm512_castsi512_pd(_mm512_and_si512(_mm512_castpd_si512(a), _mm512_castpd_si512(b)));
+    }
+
+    static reg bit_or(const reg &a, const reg &b) {
+        return _mm512_castsi512_pd(_mm512_or_si512(_mm512_castpd_si512(a), _mm512_castpd_si512(b)));
+    }
+
+    static reg bit_xor(const reg &a, const reg &b) {
+        return _mm512_castsi512_pd(_mm512_xor_si512(_mm512_castpd_si512(a), _mm512_castpd_si512(b)));
+    }
+
+    template<int N>
+    static reg shift_left(const reg &a) {
+        const auto x = _mm512_castpd_si512(a);
+        return _mm512_castsi512_pd(_mm512_mask_slli_epi64(x, 0xFF, x, N));
+    }
+
+    template<int N>
+    static reg shift_right(const reg &a) {
+        const auto x = _mm512_castpd_si512(a);
+        return _mm512_castsi512_pd(_mm512_mask_srli_epi64(x, 0xFF, x, N));
+    }
+};
+
+template<>
+struct batch<std::int32_t> {
+    using reg = __m512i;
+    static constexpr std::size_t lanes = 16;
+
+    static reg load(const std::int32_t *p) { return _mm512_loadu_si512(p); }
+    static void store(std::int32_t *p, const reg &r) { _mm512_storeu_si512(p, r); }
+    static reg set1(const std::int32_t &x) { return _mm512_set1_epi32(x); }
+    static reg zero() { return _mm512_setzero_si512(); }
+    static reg add(const reg &a, const reg &b) { return _mm512_add_epi32(a, b); }
+    static reg sub(const reg &a, const reg &b) { return _mm512_sub_epi32(a, b); }
+    static reg mul(const reg &a, const reg &b) { return _mm512_mullo_epi32(a, b); }
+    static reg fmadd(const reg &a, const reg &b, const reg &c) { return _mm512_add_epi32(mul(a, b), c); }
+
+    static std::int32_t reduce(const reg &a) {
+        auto t = _mm512_add_epi32(a, _mm512_mask_shuffle_i32x4(a, 0xFFFF, a, a, 0x4E));
+        t = _mm512_add_epi32(t, _mm512_mask_shuffle_i32x4(t, 0xFFFF, t, t, 0xB1));
+        t = _mm512_add_epi32(t, _mm512_mask_shuffle_epi32(t, 0xFFFF, t, _MM_PERM_BADC));
+        return _mm512_cvtsi512_si32(_mm512_add_epi32(t, _mm512_mask_shuffle_epi32(t, 0xFFFF, t, _MM_PERM_CDAB)));
+    }
+};
+
+#include "simd_kernels.inl"
+#include "simd_math.inl"
+
+}
+
+#if defined(__clang__)
+#pragma clang attribute pop
+#else
+#pragma GCC pop_options
+#endif
+
+#endif
+
+//*************************************************** DISPATCHERS **************************************************
+
+/**
+ * @brief Inner product of two contiguous buffers of length n.
+ *
+ * @details Each block of elements is accumulated across several independent registers and the block sums are folded
+ * into a compensated running sum, so the error does not grow with n the way a naive sequential sum does.
+ */
+template<kernel_type T>
+T dot(const T *a, const T *b, const std::size_t &n) {
+    if constexpr (std::is_same_v<T, std::complex<float> >) {
+        switch (active()) {
+#if CCOMMS_SIMD_X86
+            case level::avx512: return avx512::cdot<false>(a, b, n);
+            case level::avx2: return avx2::cdot<false>(a, b, n);
+            case level::sse2: return sse2::cdot<false>(a, b, n);
+#endif
+            default: return scalar::cdot<false>(a, b, n);
+        }
+    } else {
+        switch (active()) {
+#if CCOMMS_SIMD_X86
+            case level::avx512: return avx512::dot(a, b, n);
+            case level::avx2: return avx2::dot(a, b, n);
+            case level::sse2: return sse2::dot(a, b, n);
+#endif
+            default: return scalar::dot(a, b, n);
+        }
+    }
+}
+
+/**
+ * @brief Fused dst[i] += alpha * x[i] over contiguous buffers of length n.
+ */
+template<kernel_type T>
+requires (!is_complex_v<T>)
+void axpy(T *dst, const T &alpha, const T *x, const std::size_t &n) {
+    switch (active()) {
+#if CCOMMS_SIMD_X86
+        case level::avx512: return avx512::axpy(dst, alpha, x, n);
+        case level::avx2: return avx2::axpy(dst, alpha, x, n);
+        case level::sse2: return sse2::axpy(dst, alpha, x, n);
+#endif
+        default: return scalar::axpy(dst, alpha, x, n);
+    }
+}
+
+/**
+ * @brief Fused dst[i] += a[i] * b[i] over contiguous buffers of length n.
+ */
+template<kernel_type T>
+requires (!is_complex_v<T>)
+void fma(T *dst, const T *a, const T *b, const std::size_t &n) {
+    switch (active()) {
+#if CCOMMS_SIMD_X86
+        case level::avx512: return avx512::fma(dst, a, b, n);
+        case level::avx2: return avx2::fma(dst, a, b, n);
+        case level::sse2: return sse2::fma(dst, a, b, n);
+#endif
+        default: return scalar::fma(dst, a, b, n);
+    }
+}
+
+/**
+ * @brief Hermitian inner product, the sum of conj(a[i]) * b[i], of two contiguous complex buffers of length n.
+ */
+inline std::complex<float> dotc(const std::complex<float> *a, const std::complex<float> *b, const std::size_t &n) {
+    switch (active()) {
+#if CCOMMS_SIMD_X86
+        case level::avx512: return avx512::cdot<true>(a, b, n);
+        case level::avx2: return avx2::cdot<true>(a, b, n);
+        case level::sse2: return sse2::cdot<true>(a, b, n);
+#endif
+        default: return scalar::cdot<true>(a, b, n);
+    }
+}
+
+/**
+ * @brief Elementwise complex conjugate of an interleaved complex buffer. dst may alias src.
+ */
+inline void conj(std::complex<float> *dst, const std::complex<float> *src, const std::size_t &n) {
+    switch (active()) {
+#if CCOMMS_SIMD_X86
+        case level::avx512: return avx512::conj(dst, src, n);
+        case level::avx2: return avx2::conj(dst, src, n);
+        case level::sse2: return sse2::conj(dst, src, n);
+#endif
+        default: return scalar::conj(dst, src, n);
+    }
+}
+
+/**
+ * @brief Elementwise magnitude squared of an interleaved complex buffer.
+ */
+inline void norm(float *dst, const std::complex<float> *src, const std::size_t &n) {
+    switch (active()) {
+#if CCOMMS_SIMD_X86
+        case level::avx512: return avx512::norm(dst, src, n);
+        case level::avx2: return avx2::norm(dst, src, n);
+        case level::sse2: return sse2::norm(dst, src, n);
+#endif
+        default: return scalar::norm(dst, src, n);
+    }
+}
+
+/**
+ * @brief Hermitian inner product of two split (structure of arrays) complex buffers of length n.
+ */
+template<typename T>
+requires std::is_same_v<T, float> || std::is_same_v<T, double>
+std::complex<T> split_dotc(const T *a_re, const T *a_im, const T *b_re, const T *b_im, const std::size_t &n) {
+    switch (active()) {
+#if CCOMMS_SIMD_X86
+        case level::avx512: return avx512::split_dotc(a_re, a_im, b_re, b_im, n);
+        case level::avx2: return avx2::split_dotc(a_re, a_im, b_re, b_im, n);
+        case level::sse2: return sse2::split_dotc(a_re, a_im, b_re, b_im, n);
+#endif
+        default: return scalar::split_dotc(a_re, a_im, b_re, b_im, n);
+    }
+}
+
+/**
+ * @brief Elementwise magnitude squared of a split complex buffer. dst may alias either input.
+ */
+template<typename T>
+requires std::is_same_v<T, float> || std::is_same_v<T, double>
+void split_norm(T *dst, const T *re, const T *im, const std::size_t &n) {
+    switch (active()) {
+#if CCOMMS_SIMD_X86
+        case level::avx512: return avx512::split_norm(dst, re, im, n);
+        case level::avx2: return avx2::split_norm(dst, re, im, n);
+        case level::sse2: return sse2::split_norm(dst, re, im, n);
+#endif
+        default: return scalar::split_norm(dst, re, im, n);
+    }
+}
+
+/**
+ * @brief Elementwise product of split complex buffers, conjugating a when Conj is set. dst may alias either input.
+ */
+template<bool Conj, typename T>
+requires std::is_same_v<T, float> || std::is_same_v<T, double>
+void split_mul(T *dst_re, T *dst_im, const T *a_re, const T *a_im, const T *b_re, const T *b_im,
+               const std::size_t &n) {
+    switch (active()) {
+#if CCOMMS_SIMD_X86
+        case level::avx512: return avx512::split_mul<Conj>(dst_re, dst_im, a_re, a_im, b_re, b_im, n);
+        case level::avx2: return avx2::split_mul<Conj>(dst_re, dst_im, a_re, a_im, b_re, b_im, n);
+        case level::sse2: return sse2::split_mul<Conj>(dst_re, dst_im, a_re, a_im, b_re, b_im, n);
+#endif
+        default: return scalar::split_mul<Conj>(dst_re, dst_im, a_re, a_im, b_re, b_im, n);
+    }
+}
+
+/**
+ * @brief One radix-2 Stockham FFT stage: s interleaved transforms of length n read from x and written to y, with the
+ * stage twiddles tw[p] = exp(-2 pi i p / n), conjugated when Inverse is set. y must not alias x.
+ */
+template<bool Inverse, typename T>
+requires std::is_same_v<T, float> || std::is_same_v<T, double>
+void fft_radix2(const std::complex<T> *x, std::complex<T> *y, const std::size_t &n, const std::size_t &s,
+                const std::complex<T> *tw) {
+    if constexpr (std::is_same_v<T, float>) {
+        switch (active()) {
+#if CCOMMS_SIMD_X86
+            case level::avx512: return avx512::fft_radix2<Inverse>(x, y, n, s, tw);
+            case level::avx2: return avx2::fft_radix2<Inverse>(x, y, n, s, tw);
+            case level::sse2: return sse2::fft_radix2<Inverse>(x, y, n, s, tw);
+#endif
+            default: break;
+        }
+    }
+    scalar::fft_radix2<Inverse>(x, y, n, s, tw);
+}
+
+/**
+ * @brief One radix-4 Stockham FFT stage, with twiddles tw[3 p + k - 1] = exp(-2 pi i p k / n) for k = 1, 2, 3. y must
+ * not alias x.
+ */
+template<bool Inverse, typename T>
+requires std::is_same_v<T, float> || std::is_same_v<T, double>
+void fft_radix4(const std::complex<T> *x, std::complex<T> *y, const std::size_t &n, const std::size_t &s,
+                const std::complex<T> *tw) {
+    if constexpr (std::is_same_v<T, float>) {
+        switch (active()) {
+#if CCOMMS_SIMD_X86
+            case level::avx512: return avx512::fft_radix4<Inverse>(x, y, n, s, tw);
+            case level::avx2: return avx2::fft_radix4<Inverse>(x, y, n, s, tw);
+            case level::sse2: return sse2::fft_radix4<Inverse>(x, y, n, s, tw);
+#endif
+            default: break;
+        }
+    }
+    scalar::fft_radix4<Inverse>(x, y, n, s, tw);
+}
+
+/**
+ * @brief Correlates taps with n windows of a signal: y[t * stride] = sum of h[k] * x[t * step + k] for k < taps, or
+ * adds the sums to y when Accumulate is set. The sums are plain, uncompensated ones, meant for filter lengths.
+ *
+ * @details With step 1 neighbouring windows overlap, so each register accumulates lanes outputs at once from
+ * broadcast taps and unaligned loads of the signal; other steps take one inner product per output.
+ */
+template<bool Accumulate = false, typename T>
+requires std::is_same_v<T, float> || std::is_same_v<T, double>
+void fir(const T *h, const std::size_t &taps, const T *x, const std::size_t &step, T *y, const std::size_t &stride,
+         const std::size_t &n) {
+    switch (active()) {
+#if CCOMMS_SIMD_X86
+        case level::avx512: return avx512::fir<Accumulate>(h, taps, x, step, y, stride, n);
+        case level::avx2: return avx2::fir<Accumulate>(h, taps, x, step, y, stride, n);
+        case level::sse2: return sse2::fir<Accumulate>(h, taps, x, step, y, stride, n);
+#endif
+        default: return scalar::fir<Accumulate>(h, taps, x, step, y, stride, n);
+    }
+}
+
+/**
+ * @brief Sine and cosine of n angles in radians: s[i] = sin(x[i]) and c[i] = cos(x[i]). Either output may alias x.
+ *
+ * @details The angle is reduced by the nearest multiple of pi / 2 in three exact parts and both functions are
+ * evaluated as minimax polynomials on [-pi / 4, pi / 4], then swapped and negated by quadrant with arithmetic rather
+ * than branches, so every lane runs the same instructions. The absolute error is about 1e-7 in float for |x| up to
+ * 1e4 and about 2e-16 in double for |x| up to 1e9; the reduction loses accuracy beyond that. The fast tier evaluates
+ * the float polynomials in double, for an absolute error of about 1e-8.
+ */
+template<accuracy A = accuracy::precise, typename T>
+requires std::is_same_v<T, float> || std::is_same_v<T, double>
+void sincos(T *s, T *c, const T *x, const std::size_t &n) {
+    switch (active()) {
+#if CCOMMS_SIMD_X86
+        case level::avx512: return avx512::sincos<A>(s, c, x, n);
+        case level::avx2: return avx2::sincos<A>(s, c, x, n);
+        case level::sse2: return sse2::sincos<A>(s, c, x, n);
+#endif
+        default: return scalar::sincos<A>(s, c, x, n);
+    }
+}
+
+/**
+ * @brief Elementwise square root over contiguous buffers of length n. dst may alias src.
+ *
+ * @details The precise tier is the correctly rounded hardware root. The fast float tier multiplies by the refined
+ * reciprocal root estimate, within 4 ULP; fast double is the same as precise.
+ */
+template<accuracy A = accuracy::precise, typename T>
+requires std::is_same_v<T, float> || std::is_same_v<T, double>
+void sqrt(T *dst, const T *src, const std::size_t &n) {
+    switch (active()) {
+#if CCOMMS_SIMD_X86
+        case level::avx512: return avx512::sqrt<A>(dst, src, n);
+        case level::avx2: return avx2::sqrt<A>(dst, src, n);
+        case level::sse2: return sse2::sqrt<A>(dst, src, n);
+#endif
+        default: return scalar::sqrt<A>(dst, src, n);
+    }
+}
+
+/**
+ * @brief Elementwise reciprocal square root over contiguous buffers of length n. dst may alias src.
+ *
+ * @details The fast float tier refines the hardware estimate by one Newton step instead of dividing by the root.
+ */
+template<accuracy A = accuracy::precise, typename T>
+requires std::is_same_v<T, float> || std::is_same_v<T, double>
+void rsqrt(T *dst, const T *src, const std::size_t &n) {
+    switch (active()) {
+#if CCOMMS_SIMD_X86
+        case level::avx512: return avx512::rsqrt<A>(dst, src, n);
+        case level::avx2: return avx2::rsqrt<A>(dst, src, n);
+        case level::sse2: return sse2::rsqrt<A>(dst, src, n);
+#endif
+        default: return scalar::rsqrt<A>(dst, src, n);
+    }
+}
+
+/**
+ * @brief Elementwise natural exponential over contiguous buffers of length n. dst may alias src.
+ *
+ * @details x is split as n ln 2 + r with |r| <= ln 2 / 2 and exp(r) evaluated as a polynomial, then scaled by 2^n
+ * built directly in the exponent bits. Results above the largest finite value are infinite and results below the
+ * smallest normal value flush to zero.
+ */
+template<accuracy A = accuracy::precise, typename T>
+requires std::is_same_v<T, float> || std::is_same_v<T, double>
+void exp(T *dst, const T *src, const std::size_t &n) {
+    switch (active()) {
+#if CCOMMS_SIMD_X86
+        case level::avx512: return avx512::exp<A>(dst, src, n);
+        case level::avx2: return avx2::exp<A>(dst, src, n);
+        case level::sse2: return sse2::exp<A>(dst, src, n);
+#endif
+        default: return scalar::exp<A>(dst, src, n);
+    }
+}
+
+/**
+ * @brief Elementwise natural logarithm over contiguous buffers of length n. dst may alias src.
+ *
+ * @details x is split as m 2^e with m in [sqrt(1 / 2), sqrt(2)) straight from its bits and log(m) evaluated as a
+ * polynomial. Negative inputs give NaN, and zero and subnormal inputs give -inf.
+ */
+template<accuracy A = accuracy::precise, typename T>
+requires std::is_same_v<T, float> || std::is_same_v<T, double>
+void log(T *dst, const T *src, const std::size_t &n) {
+    switch (active()) {
+#if CCOMMS_SIMD_X86
+        case level::avx512: return avx512::log<A>(dst, src, n);
+        case level::avx2: return avx2::log<A>(dst, src, n);
+        case level::sse2: return sse2::log<A>(dst, src, n);
+#endif
+        default: return scalar::log<A>(dst, src, n);
+    }
+}
+
+/**
+ * @brief Elementwise four quadrant arctangent over contiguous buffers of length n: dst[i] = atan2(y[i], x[i]) in
+ * [-pi, pi]. dst may alias either input.
+ *
+ * @details The ratio of the smaller to the larger magnitude is reduced below tan(pi / 8) and its arctangent
+ * evaluated as a polynomial, then mirrored into the quadrant given by the signs, including those of zeros.
+ */
+template<accuracy A = accuracy::precise, typename T>
+requires std::is_same_v<T, float> || std::is_same_v<T, double>
+void atan2(T *dst, const T *y, const T *x, const std::size_t &n) {
+    switch (active()) {
+#if CCOMMS_SIMD_X86
+        case level::avx512: return avx512::atan2<A>(dst, y, x, n);
+        case level::avx2: return avx2::atan2<A>(dst, y, x, n);
+        case level::sse2: return sse2::atan2<A>(dst, y, x, n);
+#endif
+        default: return scalar::atan2<A>(dst, y, x, n);
+    }
+}
+
+/**
+ * @brief Affine transform of n points held as separate x, y and z arrays: out = m * (in - pre) + post, with m a
+ * row-major 3 x 3 matrix. The outputs may alias the inputs.
+ */
+template<typename T>
+requires std::is_same_v<T, float> || std::is_same_v<T, double>
+void affine3(const T *m, const T *pre, const T *post, const T *x, const T *y, const T *z, T *ox, T *oy, T *oz,
+             const std::size_t &n) {
+    switch (active()) {
+#if CCOMMS_SIMD_X86
+        case level::avx512: return avx512::affine3(m, pre, post, x, y, z, ox, oy, oz, n);
+        case level::avx2: return avx2::affine3(m, pre, post, x, y, z, ox, oy, oz, n);
+        case level::sse2: return sse2::affine3(m, pre, post, x, y, z, ox, oy, oz, n);
+#endif
+        default: return scalar::affine3(m, pre, post, x, y, z, ox, oy, oz, n);
+    }
+}
+
+/**
+ * @brief Accumulating matrix product c += a * b of a row-major m x k matrix a and k x n matrix b into the row-major
+ * m x n matrix c, with leading dimensions lda, ldb and ldc.
+ *
+ * @details Operands are split into blocks sized to stay in cache: a kc x nc panel of b and an mc x kc block of a are
+ * packed into contiguous strips, and a register-blocked micro-kernel computes 4 x (2 * lanes) tiles of c from them.
+ * Column-major operands are handled by the caller through the transposed product. c must not alias a or b.
+ */
+template<typename T>
+requires std::is_same_v<T, float> || std::is_same_v<T, double>
+void gemm(const std::size_t &m, const std::size_t &n, const std::size_t &k, const T *a, const std::size_t &lda,
+          const T *b, const std::size_t &ldb, T *c, const std::size_t &ldc) {
+    switch (active()) {
+#if CCOMMS_SIMD_X86
+        case level::avx512: return avx512::gemm(m, n, k, a, lda, b, ldb, c, ldc);
+        case level::avx2: return avx2::gemm(m, n, k, a, lda, b, ldb, c, ldc);
+        case level::sse2: return sse2::gemm(m, n, k, a, lda, b, ldb, c, ldc);
+#endif
+        default: return scalar::gemm(m, n, k, a, lda, b, ldb, c, ldc);
+    }
+}
+
+/**
+ * @brief Elementwise dst[i] = Op(a[i], b[i]) over contiguous buffers of length n. When LS or RS is set the
+ * corresponding operand points to a single value that is broadcast. dst may alias either operand.
+ */
+template<typename Op, bool LS, bool RS, kernel_type T>
+void transform(T *dst, const T *a, const T *b, const std::size_t &n) {
+    switch (active()) {
+#if CCOMMS_SIMD_X86
+        case level::avx512: return avx512::transform<Op, LS, RS>(dst, a, b, n);
+        case level::avx2: return avx2::transform<Op, LS, RS>(dst, a, b, n);
+        case level::sse2: return sse2::transform<Op, LS, RS>(dst, a, b, n);
+#endif
+        default: return scalar::transform<Op, LS, RS>(dst, a, b, n);
+    }
+}
+
+//*************************************************** EXPRESSIONS **************************************************
+
+template<typename V>
+concept contiguous = requires(const V &v) {
+    { v.data() } -> std::convertible_to<const typename V::value_type *>;
+};
+
+template<typename V, typename T>
+concept kernel_leaf = std::is_same_v<typename V::value_type, T> && (is_scalar_v<V> || contiguous<V>);
+
+template<typename Op>
+concept kernel_op = std::is_same_v<Op, ops::add> || std::is_same_v<Op, ops::sub> || std::is_same_v<Op, ops::mul> ||
+                    std::is_same_v<Op, ops::div>;
+
+template<typename V>
+const typename V::value_type *leaf_data(const V &leaf) {
+    if constexpr (is_scalar_v<V>)
+        return &leaf[0];
+    else
+        return leaf.data();
+}
+
+/**
+ * @brief Evaluates elements [first, first + count) of a single binary expression over contiguous operands of type T
+ * with a dedicated kernel.
+ *
+ * @return false if the expression shape has no kernel, in which case dst is untouched
+ */
+template<typename T, typename Op, typename L, typename R>
+bool evaluate(T *dst, const expression<Op, L, R> &expr, const std::size_t &first, const std::size_t &count) {
+    using lhs_type = std::remove_cvref_t<L>;
+    using rhs_type = std::remove_cvref_t<R>;
+
+    if constexpr (kernel_type<T> && kernel_op<Op> && kernel_leaf<lhs_type, T> && kernel_leaf<rhs_type, T>) {
+        if (expr.broadcasts())
+            return false;
+
+        transform<Op, is_scalar_v<lhs_type>, is_scalar_v<rhs_type> >(
+                dst + first, leaf_data(expr.left()) + (is_scalar_v<lhs_type> ? 0 : first),
+                leaf_data(expr.right()) + (is_scalar_v<rhs_type> ? 0 : first), count);
+        return true;
+    } else {
+        return false;
+    }
+}
+
+/**
+ * @brief Evaluates a single binary expression over contiguous operands of type T with a dedicated kernel.
+ *
+ * @return false if the expression shape has no kernel, in which case dst is untouched
+ */
+template<typename T, typename Op, typename L, typename R>
+bool evaluate(T *dst, const expression<Op, L, R> &expr) {
+    return evaluate(dst, expr, 0, expr.size());
+}
+
+/**
+ * @brief Evaluates elements [first, first + count) of conj or norm of a contiguous complex<float> operand with a
+ * dedicated kernel.
+ *
+ * @return false if the expression shape has no kernel, in which case dst is untouched
+ */
+template<typename T, typename Op, typename E>
+bool evaluate(T *dst, const unary_expression<Op, E> &expr, const std::size_t &first, const std::size_t &count) {
+    using operand_type = std::remove_cvref_t<E>;
+
+    if constexpr (contiguous<operand_type> && std::is_same_v<typename operand_type::value_type, std::complex<float> >) {
+        if constexpr (std::is_same_v<Op, ops::conj> && std::is_same_v<T, std::complex<float> >) {
+            conj(dst + first, expr.argument().data() + first, count);
+            return true;
+        } else if constexpr (std::is_same_v<Op, ops::norm> && std::is_same_v<T, float>) {
+            norm(dst + first, expr.argument().data() + first, count);
+            return true;
+        } else {
+            return false;
+        }
+    } else {
+        return false;
+    }
+}
+
+template<typename T, typename Op, typename E>
+bool evaluate(T *dst, const unary_expression<Op, E> &expr) {
+    return evaluate(dst, expr, 0, expr.size());
+}
+
+}
+
+#endif // CCOMMS_MODULES_TENSOR_SIMD_HPP_
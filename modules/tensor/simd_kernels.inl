@@ -0,0 +1,563 @@
+// Copyright(c) 2023, Matthew Petrin, All rights reserved.
+
+// Instruction set independent kernel bodies. This file is included once per instruction set by simd.hpp, inside that
+// instruction set's namespace and target region, after batch<float>, batch<double> and batch<std::int32_t> have been
+// defined. It intentionally has no include guard.
+
+//***************************************************** HELPERS ****************************************************
+
+template<typename Op, typename B>
+inline typename B::reg apply(const typename B::reg &a, const typename B::reg &b) {
+    if constexpr (std::is_same_v<Op, ops::add>)
+        return B::add(a, b);
+    else if constexpr (std::is_same_v<Op, ops::sub>)
+        return B::sub(a, b);
+    else if constexpr (std::is_same_v<Op, ops::mul>)
+        return B::mul(a, b);
+    else
+        return B::div(a, b);
+}
+
+template<typename B>
+inline typename B::reg cmul(const typename B::reg &a, const typename B::reg &b) {
+    auto re = B::mul(B::dup_even(a), b);
+    auto im = B::mul(B::dup_odd(a), B::swap_pairs(b));
+    return B::add(re, B::negate_even(im));
+}
+
+//**************************************************** INNER PRODUCT ***********************************************
+
+template<typename T>
+T dot(const T *a, const T *b, const std::size_t &n) {
+    using B = batch<T>;
+    constexpr std::size_t step = 4 * B::lanes;
+
+    T sum = 0;
+    T comp = 0;
+    std::size_t i = 0;
+
+    while (n - i >= step) {
+        const std::size_t end = i + std::min(block, (n - i) / step * step);
+
+        auto acc0 = B::zero();
+        auto acc1 = B::zero();
+        auto acc2 = B::zero();
+        auto acc3 = B::zero();
+        for (; i < end; i += step) {
+            acc0 = B::fmadd(B::load(a + i), B::load(b + i), acc0);
+            acc1 = B::fmadd(B::load(a + i + B::lanes), B::load(b + i + B::lanes), acc1);
+            acc2 = B::fmadd(B::load(a + i + 2 * B::lanes), B::load(b + i + 2 * B::lanes), acc2);
+            acc3 = B::fmadd(B::load(a + i + 3 * B::lanes), B::load(b + i + 3 * B::lanes), acc3);
+        }
+        compensated_add(sum, comp, B::reduce(B::add(B::add(acc0, acc1), B::add(acc2, acc3))));
+    }
+
+    T tail = 0;
+    for (; i < n; i++)
+        tail += a[i] * b[i];
+    compensated_add(sum, comp, tail);
+
+    return sum + comp;
+}
+
+template<bool Conj>
+std::complex<float> cdot(const std::complex<float> *a, const std::complex<float> *b, const std::size_t &n) {
+    using B = batch<float>;
+    constexpr std::size_t pairs = B::lanes / 2;
+
+    const auto *x = reinterpret_cast<const float *>(a);
+    const auto *y = reinterpret_cast<const float *>(b);
+
+    float re = 0, re_comp = 0;
+    float im = 0, im_comp = 0;
+    std::size_t i = 0;
+
+    while (n - i >= pairs * 2) {
+        const std::size_t end = i + std::min(block, (n - i) / (pairs * 2) * (pairs * 2));
+
+        // acc_r holds (ar * br, ar * bi) and acc_i holds (ai * bi, ai * br) for every element pair
+        auto acc_r0 = B::zero();
+        auto acc_r1 = B::zero();
+        auto acc_i0 = B::zero();
+        auto acc_i1 = B::zero();
+        for (; i < end; i += pairs * 2) {
+            auto a0 = B::load(x + 2 * i);
+            auto a1 = B::load(x + 2 * i + B::lanes);
+            auto b0 = B::load(y + 2 * i);
+            auto b1 = B::load(y + 2 * i + B::lanes);
+            acc_r0 = B::fmadd(B::dup_even(a0), b0, acc_r0);
+            acc_r1 = B::fmadd(B::dup_even(a1), b1, acc_r1);
+            acc_i0 = B::fmadd(B::dup_odd(a0), B::swap_pairs(b0), acc_i0);
+            acc_i1 = B::fmadd(B::dup_odd(a1), B::swap_pairs(b1), acc_i1);
+        }
+
+        alignas(64) float acc_r[B::lanes];
+        alignas(64) float acc_i[B::lanes];
+        B::store(acc_r, B::add(acc_r0, acc_r1));
+        B::store(acc_i, B::add(acc_i0, acc_i1));
+
+        float part_re = 0, part_im = 0;
+        for (std::size_t k = 0; k < B::lanes; k += 2) {
+            if constexpr (Conj) {
+                part_re += acc_r[k] + acc_i[k];
+                part_im += acc_r[k + 1] - acc_i[k + 1];
+            } else {
+                part_re += acc_r[k] - acc_i[k];
+                part_im += acc_r[k + 1] + acc_i[k + 1];
+            }
+        }
+        compensated_add(re, re_comp, part_re);
+        compensated_add(im, im_comp, part_im);
+    }
+
+    std::complex<float> tail = 0;
+    for (; i < n; i++)
+        tail += (Conj ? std::conj(a[i]) : a[i]) * b[i];
+    compensated_add(re, re_comp, tail.real());
+    compensated_add(im, im_comp, tail.imag());
+
+    return {re + re_comp, im + im_comp};
+}
+
+//************************************************** ELEMENTWISE **************************************************
+
+template<typename Op, bool LS, bool RS, typename T>
+void transform(T *dst, const T *a, const T *b, const std::size_t &n) {
+    using B = batch<T>;
+    std::size_t i = 0;
+
+    if (n == 0)
+        return;
+
+    if constexpr (!(std::is_same_v<Op, ops::div> && std::is_integral_v<T>)) {
+        const auto sa = LS ? B::set1(*a) : B::zero();
+        const auto sb = RS ? B::set1(*b) : B::zero();
+
+        for (; i + B::lanes <= n; i += B::lanes) {
+            auto x = LS ? sa : B::load(a + i);
+            auto y = RS ? sb : B::load(b + i);
+            B::store(dst + i, apply<Op, B>(x, y));
+        }
+    }
+
+    for (; i < n; i++)
+        dst[i] = static_cast<T>(Op{}(a[LS ? 0 : i], b[RS ? 0 : i]));
+}
+
+template<typename Op, bool LS, bool RS>
+void transform(std::complex<float> *dst, const std::complex<float> *a, const std::complex<float> *b,
+               const std::size_t &n) {
+    using B = batch<float>;
+    constexpr std::size_t pairs = B::lanes / 2;
+    std::size_t i = 0;
+
+    if (n == 0)
+        return;
+
+    if constexpr (!std::is_same_v<Op, ops::div>) {
+        auto *z = reinterpret_cast<float *>(dst);
+        const auto *x = reinterpret_cast<const float *>(a);
+        const auto *y = reinterpret_cast<const float *>(b);
+        const auto sa = LS ? B::set_pair(a->real(), a->imag()) : B::zero();
+        const auto sb = RS ? B::set_pair(b->real(), b->imag()) : B::zero();
+
+        for (; i + pairs <= n; i += pairs) {
+            auto u = LS ? sa : B::load(x + 2 * i);
+            auto v = RS ? sb : B::load(y + 2 * i);
+            if constexpr (std::is_same_v<Op, ops::mul>)
+                B::store(z + 2 * i, cmul<B>(u, v));
+            else
+                B::store(z + 2 * i, apply<Op, B>(u, v));
+        }
+    }
+
+    for (; i < n; i++)
+        dst[i] = Op{}(a[LS ? 0 : i], b[RS ? 0 : i]);
+}
+
+template<typename T>
+void axpy(T *dst, const T &alpha, const T *x, const std::size_t &n) {
+    using B = batch<T>;
+
+    const auto a = B::set1(alpha);
+
+    std::size_t i = 0;
+    for (; i + B::lanes <= n; i += B::lanes)
+        B::store(dst + i, B::fmadd(a, B::load(x + i), B::load(dst + i)));
+
+    for (; i < n; i++)
+        dst[i] += alpha * x[i];
+}
+
+template<typename T>
+void fma(T *dst, const T *a, const T *b, const std::size_t &n) {
+    using B = batch<T>;
+
+    std::size_t i = 0;
+    for (; i + B::lanes <= n; i += B::lanes)
+        B::store(dst + i, B::fmadd(B::load(a + i), B::load(b + i), B::load(dst + i)));
+
+    for (; i < n; i++)
+        dst[i] += a[i] * b[i];
+}
+
+template<typename T>
+void affine3(const T *m, const T *pre, const T *post, const T *x, const T *y, const T *z, T *ox, T *oy, T *oz,
+             const std::size_t &n) {
+    using B = batch<T>;
+
+    const auto m00 = B::set1(m[0]), m01 = B::set1(m[1]), m02 = B::set1(m[2]);
+    const auto m10 = B::set1(m[3]), m11 = B::set1(m[4]), m12 = B::set1(m[5]);
+    const auto m20 = B::set1(m[6]), m21 = B::set1(m[7]), m22 = B::set1(m[8]);
+    const auto p0 = B::set1(pre[0]), p1 = B::set1(pre[1]), p2 = B::set1(pre[2]);
+    const auto q0 = B::set1(post[0]), q1 = B::set1(post[1]), q2 = B::set1(post[2]);
+
+    std::size_t i = 0;
+    for (; i + B::lanes <= n; i += B::lanes) {
+        const auto dx = B::sub(B::load(x + i), p0);
+        const auto dy = B::sub(B::load(y + i), p1);
+        const auto dz = B::sub(B::load(z + i), p2);
+        B::store(ox + i, B::fmadd(m00, dx, B::fmadd(m01, dy, B::fmadd(m02, dz, q0))));
+        B::store(oy + i, B::fmadd(m10, dx, B::fmadd(m11, dy, B::fmadd(m12, dz, q1))));
+        B::store(oz + i, B::fmadd(m20, dx, B::fmadd(m21, dy, B::fmadd(m22, dz, q2))));
+    }
+
+    for (; i < n; i++) {
+        const T dx = x[i] - pre[0], dy = y[i] - pre[1], dz = z[i] - pre[2];
+        ox[i] = m[0] * dx + m[1] * dy + m[2] * dz + post[0];
+        oy[i] = m[3] * dx + m[4] * dy + m[5] * dz + post[1];
+        oz[i] = m[6] * dx + m[7] * dy + m[8] * dz + post[2];
+    }
+}
+
+//****************************************************** GEMM *****************************************************
+
+template<typename T, std::size_t MR, std::size_t NR>
+inline void gemm_tile(const std::size_t &kb, const T *pa, const T *pb, T *c, const std::size_t &ldc,
+                      const std::size_t &rows, const std::size_t &cols) {
+    using B = batch<T>;
+
+    typename B::reg acc[MR][2];
+    for (std::size_t r = 0; r < MR; r++)
+        acc[r][0] = acc[r][1] = B::zero();
+
+    for (std::size_t p = 0; p < kb; p++) {
+        const auto b0 = B::load(pb + p * NR);
+        const auto b1 = B::load(pb + p * NR + B::lanes);
+        for (std::size_t r = 0; r < MR; r++) {
+            const auto a = B::set1(pa[p * MR + r]);
+            acc[r][0] = B::fmadd(a, b0, acc[r][0]);
+            acc[r][1] = B::fmadd(a, b1, acc[r][1]);
+        }
+    }
+
+    if (rows == MR && cols == NR) {
+        for (std::size_t r = 0; r < MR; r++) {
+            B::store(c + r * ldc, B::add(B::load(c + r * ldc), acc[r][0]));
+            B::store(c + r * ldc + B::lanes, B::add(B::load(c + r * ldc + B::lanes), acc[r][1]));
+        }
+        return;
+    }
+
+    alignas(64) T tile[MR * NR];
+    for (std::size_t r = 0; r < MR; r++) {
+        B::store(tile + r * NR, acc[r][0]);
+        B::store(tile + r * NR + B::lanes, acc[r][1]);
+    }
+    for (std::size_t r = 0; r < rows; r++)
+        for (std::size_t j = 0; j < cols; j++)
+            c[r * ldc + j] += tile[r * NR + j];
+}
+
+template<typename T>
+void gemm(const std::size_t &m, const std::size_t &n, const std::size_t &k, const T *a, const std::size_t &lda,
+          const T *b, const std::size_t &ldb, T *c, const std::size_t &ldc) {
+    using B = batch<T>;
+    constexpr std::size_t mr = 4;
+    constexpr std::size_t nr = 2 * B::lanes;
+    constexpr std::size_t kc = 256;
+    constexpr std::size_t mc = 128;
+    constexpr std::size_t nc = 2048;
+
+    thread_local std::vector<T> packed_a(mc * kc);
+    thread_local std::vector<T> packed_b(kc * nc);
+
+    for (std::size_t jc = 0; jc < n; jc += nc) {
+        const std::size_t nb = std::min(nc, n - jc);
+
+        for (std::size_t pc = 0; pc < k; pc += kc) {
+            const std::size_t kb = std::min(kc, k - pc);
+
+            // The B panel is stored as nr wide column strips, each laid out row by row and zero padded
+            for (std::size_t jr = 0; jr < nb; jr += nr) {
+                const std::size_t cols = std::min(nr, nb - jr);
+                T *dst = packed_b.data() + jr * kb;
+                for (std::size_t p = 0; p < kb; p++) {
+                    const T *src = b + (pc + p) * ldb + jc + jr;
+                    for (std::size_t j = 0; j < nr; j++)
+                        dst[p * nr + j] = j < cols ? src[j] : T(0);
+                }
+            }
+
+            for (std::size_t ic = 0; ic < m; ic += mc) {
+                const std::size_t mb = std::min(mc, m - ic);
+
+                // The A block is stored as mr tall row strips, each laid out column by column and zero padded
+                for (std::size_t ir = 0; ir < mb; ir += mr) {
+                    const std::size_t rows = std::min(mr, mb - ir);
+                    T *dst = packed_a.data() + ir * kb;
+                    for (std::size_t p = 0; p < kb; p++)
+                        for (std::size_t r = 0; r < mr; r++)
+                            dst[p * mr + r] = r < rows ? a[(ic + ir + r) * lda + pc + p] : T(0);
+                }
+
+                for (std::size_t jr = 0; jr < nb; jr += nr)
+                    for (std::size_t ir = 0; ir < mb; ir += mr)
+                        gemm_tile<T, mr, nr>(kb, packed_a.data() + ir * kb, packed_b.data() + jr * kb,
+                                             c + (ic + ir) * ldc + jc + jr, ldc,
+                                             std::min(mr, mb - ir), std::min(nr, nb - jr));
+            }
+        }
+    }
+}
+
+//***************************************************** COMPLEX ****************************************************
+
+inline void conj(std::complex<float> *dst, const std::complex<float> *src, const std::size_t &n) {
+    using B = batch<float>;
+    constexpr std::size_t pairs = B::lanes / 2;
+
+    auto *z = reinterpret_cast<float *>(dst);
+    const auto *x = reinterpret_cast<const float *>(src);
+
+    std::size_t i = 0;
+    for (; i + pairs <= n; i += pairs)
+        B::store(z + 2 * i, B::negate_odd(B::load(x + 2 * i)));
+
+    for (; i < n; i++)
+        dst[i] = std::conj(src[i]);
+}
+
+inline void norm(float *dst, const std::complex<float> *src, const std::size_t &n) {
+    using B = batch<float>;
+
+    const auto *x = reinterpret_cast<const float *>(src);
+
+    std::size_t i = 0;
+    for (; i + B::lanes <= n; i += B::lanes) {
+        auto lo = B::load(x + 2 * i);
+        auto hi = B::load(x + 2 * i + B::lanes);
+        B::store(dst + i, B::pair_sum(B::mul(lo, lo), B::mul(hi, hi)));
+    }
+
+    for (; i < n; i++)
+        dst[i] = src[i].real() * src[i].real() + src[i].imag() * src[i].imag();
+}
+
+template<typename T>
+std::complex<T> split_dotc(const T *a_re, const T *a_im, const T *b_re, const T *b_im, const std::size_t &n) {
+    using B = batch<T>;
+
+    T re = 0, re_comp = 0;
+    T im = 0, im_comp = 0;
+    std::size_t i = 0;
+
+    while (n - i >= B::lanes) {
+        const std::size_t end = i + std::min(block, (n - i) / B::lanes * B::lanes);
+
+        auto acc_re = B::zero();
+        auto acc_im = B::zero();
+        for (; i < end; i += B::lanes) {
+            auto ar = B::load(a_re + i);
+            auto ai = B::load(a_im + i);
+            auto br = B::load(b_re + i);
+            auto bi = B::load(b_im + i);
+            acc_re = B::fmadd(ar, br, B::fmadd(ai, bi, acc_re));
+            acc_im = B::fmadd(ar, bi, B::sub(acc_im, B::mul(ai, br)));
+        }
+
+        compensated_add(re, re_comp, B::reduce(acc_re));
+        compensated_add(im, im_comp, B::reduce(acc_im));
+    }
+
+    T part_re = 0, part_im = 0;
+    for (; i < n; i++) {
+        part_re += a_re[i] * b_re[i] + a_im[i] * b_im[i];
+        part_im += a_re[i] * b_im[i] - a_im[i] * b_re[i];
+    }
+    compensated_add(re, re_comp, part_re);
+    compensated_add(im, im_comp, part_im);
+
+    return {re + re_comp, im + im_comp};
+}
+
+template<typename T>
+void split_norm(T *dst, const T *re, const T *im, const std::size_t &n) {
+    using B = batch<T>;
+
+    std::size_t i = 0;
+    for (; i + B::lanes <= n; i += B::lanes) {
+        auto r = B::load(re + i);
+        auto j = B::load(im + i);
+        B::store(dst + i, B::fmadd(r, r, B::mul(j, j)));
+    }
+
+    for (; i < n; i++)
+        dst[i] = re[i] * re[i] + im[i] * im[i];
+}
+
+template<bool Conj, typename T>
+void split_mul(T *dst_re, T *dst_im, const T *a_re, const T *a_im, const T *b_re, const T *b_im,
+               const std::size_t &n) {
+    using B = batch<T>;
+
+    std::size_t i = 0;
+    for (; i + B::lanes <= n; i += B::lanes) {
+        auto ar = B::load(a_re + i);
+        auto ai = B::load(a_im + i);
+        auto br = B::load(b_re + i);
+        auto bi = B::load(b_im + i);
+        if constexpr (Conj) {
+            B::store(dst_re + i, B::fmadd(ar, br, B::mul(ai, bi)));
+            B::store(dst_im + i, B::sub(B::mul(ar, bi), B::mul(ai, br)));
+        } else {
+            B::store(dst_re + i, B::sub(B::mul(ar, br), B::mul(ai, bi)));
+            B::store(dst_im + i, B::fmadd(ar, bi, B::mul(ai, br)));
+        }
+    }
+
+    for (; i < n; i++) {
+        const T ar = a_re[i], ai = Conj ? -a_im[i] : a_im[i];
+        const T br = b_re[i], bi = b_im[i];
+        dst_re[i] = ar * br - ai * bi;
+        dst_im[i] = ar * bi + ai * br;
+    }
+}
+
+//*************************************************** FFT STAGES ***************************************************
+
+// Stockham stages vectorize across the s independent transforms of a stage, which all share a twiddle. Stages with
+// fewer transforms than a register holds, the first one or two of every plan, run on the scalar kernels.
+
+template<bool Inverse, typename B>
+inline typename B::reg twiddle(const std::complex<float> &w) {
+    return B::set_pair(w.real(), Inverse ? -w.imag() : w.imag());
+}
+
+template<bool Inverse>
+void fft_radix2(const std::complex<float> *x, std::complex<float> *y, const std::size_t &n, const std::size_t &s,
+                const std::complex<float> *tw) {
+    using B = batch<float>;
+    constexpr std::size_t pairs = B::lanes / 2;
+
+    if (s < pairs)
+        return scalar::fft_radix2<Inverse>(x, y, n, s, tw);
+
+    const std::size_t m = n / 2;
+    const std::size_t vec = s / pairs * pairs;
+    for (std::size_t p = 0; p < m; p++) {
+        const auto w = twiddle<Inverse, B>(tw[p]);
+        const std::complex<float> *a = x + s * p, *b = x + s * (p + m);
+        std::complex<float> *y0 = y + s * 2 * p, *y1 = y0 + s;
+
+        for (std::size_t q = 0; q < vec; q += pairs) {
+            const auto u = B::load(reinterpret_cast<const float *>(a + q));
+            const auto v = B::load(reinterpret_cast<const float *>(b + q));
+            B::store(reinterpret_cast<float *>(y0 + q), B::add(u, v));
+            B::store(reinterpret_cast<float *>(y1 + q), cmul<B>(B::sub(u, v), w));
+        }
+        for (std::size_t q = vec; q < s; q++)
+            scalar::butterfly2(a[q], b[q], scalar::twiddle<Inverse>(tw[p]), y0[q], y1[q]);
+    }
+}
+
+template<bool Inverse>
+void fft_radix4(const std::complex<float> *x, std::complex<float> *y, const std::size_t &n, const std::size_t &s,
+                const std::complex<float> *tw) {
+    using B = batch<float>;
+    constexpr std::size_t pairs = B::lanes / 2;
+
+    if (s < pairs)
+        return scalar::fft_radix4<Inverse>(x, y, n, s, tw);
+
+    const std::size_t m = n / 4;
+    const std::size_t vec = s / pairs * pairs;
+    for (std::size_t p = 0; p < m; p++) {
+        const auto w1 = twiddle<Inverse, B>(tw[3 * p]);
+        const auto w2 = twiddle<Inverse, B>(tw[3 * p + 1]);
+        const auto w3 = twiddle<Inverse, B>(tw[3 * p + 2]);
+        const std::complex<float> *a0 = x + s * p, *a1 = x + s * (p + m), *a2 = x + s * (p + 2 * m),
+                *a3 = x + s * (p + 3 * m);
+        std::complex<float> *y0 = y + s * 4 * p, *y1 = y0 + s, *y2 = y1 + s, *y3 = y2 + s;
+
+        for (std::size_t q = 0; q < vec; q += pairs) {
+            const auto u0 = B::load(reinterpret_cast<const float *>(a0 + q));
+            const auto u1 = B::load(reinterpret_cast<const float *>(a1 + q));
+            const auto u2 = B::load(reinterpret_cast<const float *>(a2 + q));
+            const auto u3 = B::load(reinterpret_cast<const float *>(a3 + q));
+
+            const auto t0 = B::add(u0, u2), t1 = B::sub(u0, u2), t2 = B::add(u1, u3);
+            const auto d = B::swap_pairs(B::sub(u1, u3));
+            const auto t3 = Inverse ? B::negate_even(d) : B::negate_odd(d);
+
+            B::store(reinterpret_cast<float *>(y0 + q), B::add(t0, t2));
+            B::store(reinterpret_cast<float *>(y1 + q), cmul<B>(B::add(t1, t3), w1));
+            B::store(reinterpret_cast<float *>(y2 + q), cmul<B>(B::sub(t0, t2), w2));
+            B::store(reinterpret_cast<float *>(y3 + q), cmul<B>(B::sub(t1, t3), w3));
+        }
+
+        const std::complex<float> w[3] = {scalar::twiddle<Inverse>(tw[3 * p]), scalar::twiddle<Inverse>(tw[3 * p + 1]),
+                                          scalar::twiddle<Inverse>(tw[3 * p + 2])};
+        for (std::size_t q = vec; q < s; q++)
+            scalar::butterfly4<Inverse>(a0[q], a1[q], a2[q], a3[q], w, y0[q], y1[q], y2[q], y3[q]);
+    }
+}
+
+//****************************************************** FIR *******************************************************
+
+template<bool Accumulate, typename T>
+void fir(const T *h, const std::size_t &taps, const T *x, const std::size_t &step, T *y, const std::size_t &stride,
+         const std::size_t &n) {
+    using B = batch<T>;
+    constexpr std::size_t width = 2 * B::lanes;
+    std::size_t t = 0;
+
+    if (step == 1) {
+        alignas(64) T sums[width];
+        for (; t + width <= n; t += width) {
+            const T *window = x + t;
+            auto acc0 = B::zero();
+            auto acc1 = B::zero();
+            for (std::size_t k = 0; k < taps; k++) {
+                const auto tap = B::set1(h[k]);
+                acc0 = B::fmadd(tap, B::load(window + k), acc0);
+                acc1 = B::fmadd(tap, B::load(window + k + B::lanes), acc1);
+            }
+
+            if (stride == 1 && !Accumulate) {
+                B::store(y + t, acc0);
+                B::store(y + t + B::lanes, acc1);
+            } else {
+                B::store(sums, acc0);
+                B::store(sums + B::lanes, acc1);
+                for (std::size_t i = 0; i < width; i++)
+                    scalar::fir_store<Accumulate>(y + (t + i) * stride, sums[i]);
+            }
+        }
+    } else if (taps >= B::lanes) {
+        for (; t < n; t++) {
+            const T *window = x + t * step;
+            auto acc = B::zero();
+            std::size_t k = 0;
+            for (; k + B::lanes <= taps; k += B::lanes)
+                acc = B::fmadd(B::load(h + k), B::load(window + k), acc);
+
+            T sum = B::reduce(acc);
+            for (; k < taps; k++)
+                sum += h[k] * window[k];
+            scalar::fir_store<Accumulate>(y + t * stride, sum);
+        }
+    }
+
+    scalar::fir<Accumulate>(h, taps, x + t * step, step, y + t * stride, stride, n - t);
+}
@@ -0,0 +1,272 @@
+// Copyright(c) 2023, Matthew Petrin, All rights reserved.
+
+// Instruction set independent bodies of the math kernels. Like simd_kernels.inl this file is included once per
+// instruction set after the batch types have been defined, and once more in the scalar namespace over a single lane
+// batch, so every level evaluates the same approximations. It intentionally has no include guard.
+
+//***************************************************** HELPERS ****************************************************
+
+// Horner evaluation of the polynomial with coefficients c at x, highest order first
+template<typename T, typename C, std::size_t N>
+inline typename batch<T>::reg polynomial(const typename batch<T>::reg &x, const C (&c)[N]) {
+    using B = batch<T>;
+    auto p = B::set1(static_cast<T>(c[0]));
+    for (std::size_t k = 1; k < N; k++)
+        p = B::fmadd(p, x, B::set1(static_cast<T>(c[k])));
+    return p;
+}
+
+// 2^n for integral n in the normal exponent range: adding 2^mantissa places the biased exponent in the low mantissa
+// bits, from where a shift moves it into the exponent field
+template<typename T>
+inline typename batch<T>::reg pow2(const typename batch<T>::reg &n) {
+    using B = batch<T>;
+    constexpr int mantissa = std::numeric_limits<T>::digits - 1;
+    constexpr T bias = static_cast<T>(std::numeric_limits<T>::max_exponent - 1);
+    return B::template shift_left<mantissa>(B::add(n, B::set1(static_cast<T>(std::uint64_t(1) << mantissa) + bias)));
+}
+
+// dst[i] = f(src[i]) a batch at a time, the tail through a padded batch so that every element takes the same path
+template<typename T, typename batch<T>::reg (*f)(const typename batch<T>::reg &)>
+inline void map_batches(T *dst, const T *src, const std::size_t &n) {
+    using B = batch<T>;
+    std::size_t i = 0;
+    for (; i + B::lanes <= n; i += B::lanes)
+        B::store(dst + i, f(B::load(src + i)));
+
+    if (i < n) {
+        alignas(64) T buffer[B::lanes] = {};
+        std::copy(src + i, src + n, buffer);
+        B::store(buffer, f(B::load(buffer)));
+        std::copy(buffer, buffer + (n - i), dst + i);
+    }
+}
+
+//***************************************************** SINCOS *****************************************************
+
+template<accuracy A, typename T>
+inline void sincos_batch(const typename batch<T>::reg &x, typename batch<T>::reg &s, typename batch<T>::reg &c) {
+    using B = batch<T>;
+    using K = sincos_coefficients<T>;
+    using P = tier_coefficients<sincos_coefficients, A, T>;
+    const auto one = B::set1(T(1));
+    const auto round = B::set1(K::round);
+
+    // Nearest quadrant count and the remainder in [-pi / 4, pi / 4]
+    const auto q = B::sub(B::add(B::mul(x, B::set1(K::two_over_pi)), round), round);
+    auto r = B::fmadd(q, B::set1(-K::pio2[0]), x);
+    r = B::fmadd(q, B::set1(-K::pio2[1]), r);
+    r = B::fmadd(q, B::set1(-K::pio2[2]), r);
+    const auto z = B::mul(r, r);
+
+    const auto sr = B::fmadd(B::mul(polynomial<T>(z, P::sin), z), r, r);
+    const auto cr = B::fmadd(B::mul(polynomial<T>(z, P::cos), z), z, B::fmadd(z, B::set1(T(-0.5)), one));
+
+    // Quadrant q mod 4 split into its bits; every product below is by 0 or 1, so the selection is exact
+    const auto quarter = B::sub(B::add(B::fmadd(q, B::set1(T(0.25)), B::set1(T(-0.375))), round), round);
+    const auto j = B::fmadd(quarter, B::set1(T(-4)), q);
+    const auto half = B::sub(B::add(B::fmadd(j, B::set1(T(0.5)), B::set1(T(-0.25))), round), round);
+    const auto odd = B::fmadd(half, B::set1(T(-2)), j);
+    const auto even = B::sub(one, odd);
+    const auto flip = B::fmadd(B::mul(odd, half), B::set1(T(-2)), B::add(odd, half));
+
+    s = B::mul(B::fmadd(half, B::set1(T(-2)), one), B::fmadd(odd, cr, B::mul(even, sr)));
+    c = B::mul(B::fmadd(flip, B::set1(T(-2)), one), B::fmadd(odd, sr, B::mul(even, cr)));
+}
+
+template<accuracy A, typename T>
+void sincos(T *s, T *c, const T *x, const std::size_t &n) {
+    using B = batch<T>;
+    typename B::reg vs, vc;
+    std::size_t i = 0;
+    for (; i + B::lanes <= n; i += B::lanes) {
+        sincos_batch<A, T>(B::load(x + i), vs, vc);
+        B::store(s + i, vs);
+        B::store(c + i, vc);
+    }
+
+    if (i < n) {
+        alignas(64) T buffer[3 * B::lanes] = {};
+        std::copy(x + i, x + n, buffer);
+        sincos_batch<A, T>(B::load(buffer), vs, vc);
+        B::store(buffer + B::lanes, vs);
+        B::store(buffer + 2 * B::lanes, vc);
+        std::copy(buffer + B::lanes, buffer + B::lanes + (n - i), s + i);
+        std::copy(buffer + 2 * B::lanes, buffer + 2 * B::lanes + (n - i), c + i);
+    }
+}
+
+//****************************************************** ATAN2 *****************************************************
+
+template<accuracy A, typename T>
+inline typename batch<T>::reg atan2_batch(const typename batch<T>::reg &y, const typename batch<T>::reg &x) {
+    using B = batch<T>;
+    using P = tier_coefficients<atan_coefficients, A, T>;
+    const auto one = B::set1(T(1));
+    const auto zero = B::zero();
+
+    // atan of t = min / max in [0, 1], taken around pi / 4 as atan((min - max) / (min + max)) above tan(pi / 8)
+    const auto ax = B::abs(x);
+    const auto ay = B::abs(y);
+    const auto large = B::max(ax, ay);
+    const auto small = B::min(ax, ay);
+    const auto reduce = B::lt(B::mul(large, B::set1(T(0.414213562373095048802))), small);
+    const auto num = B::select(reduce, B::sub(small, large), small);
+    auto den = B::select(reduce, B::add(small, large), large);
+    den = B::select(B::eq(den, zero), one, den);
+
+    const auto t = B::div(num, den);
+    const auto z = B::mul(t, t);
+    auto a = B::fmadd(B::mul(t, z), polynomial<T>(z, P::poly), t);
+    a = B::add(a, B::select(reduce, B::set1(T(0.785398163397448309616)), zero));
+
+    // Both infinite: the quotient is undefined but the angle is the diagonal
+    a = B::select(B::eq(small, B::set1(std::numeric_limits<T>::infinity())), B::set1(T(0.785398163397448309616)), a);
+
+    // Back to the full circle: mirror about pi / 4 when |y| > |x|, about pi / 2 when x is negative (including -0),
+    // and take the sign of y
+    a = B::select(B::lt(ax, ay), B::sub(B::set1(T(1.57079632679489661923)), a), a);
+    const auto sign = B::set1(T(-0.0));
+    a = B::select(B::lt(B::bit_or(B::bit_and(x, sign), one), zero), B::sub(B::set1(T(3.14159265358979323846)), a), a);
+    a = B::bit_xor(a, B::bit_and(y, sign));
+
+    a = B::select(B::eq(x, x), a, x);
+    return B::select(B::eq(y, y), a, y);
+}
+
+template<accuracy A, typename T>
+void atan2(T *dst, const T *y, const T *x, const std::size_t &n) {
+    using B = batch<T>;
+    std::size_t i = 0;
+    for (; i + B::lanes <= n; i += B::lanes)
+        B::store(dst + i, atan2_batch<A, T>(B::load(y + i), B::load(x + i)));
+
+    if (i < n) {
+        alignas(64) T buffer[2 * B::lanes] = {};
+        std::copy(y + i, y + n, buffer);
+        std::copy(x + i, x + n, buffer + B::lanes);
+        B::store(buffer, atan2_batch<A, T>(B::load(buffer), B::load(buffer + B::lanes)));
+        std::copy(buffer, buffer + (n - i), dst + i);
+    }
+}
+
+//******************************************************* EXP ******************************************************
+
+template<accuracy A, typename T>
+inline typename batch<T>::reg exp_batch(const typename batch<T>::reg &x) {
+    using B = batch<T>;
+    using K = exp_coefficients<T>;
+    using P = tier_coefficients<exp_coefficients, A, T>;
+    const auto one = B::set1(T(1));
+    const auto round = B::set1(K::round);
+
+    // x = n ln 2 + r with |r| <= ln 2 / 2
+    const auto n = B::sub(B::fmadd(x, B::set1(K::log2e), round), round);
+    auto r = B::fmadd(n, B::set1(-K::ln2[0]), x);
+    r = B::fmadd(n, B::set1(-K::ln2[1]), r);
+    const auto p = B::fmadd(B::mul(r, r), polynomial<T>(r, P::poly), B::add(r, one));
+
+    // Scaled as p 2^(n - b) 2^b with b = 1 for positive n, so the largest exponent stays finite
+    const auto b = B::select(B::lt(B::zero(), n), one, B::zero());
+    auto result = B::mul(B::mul(p, pow2<T>(B::sub(n, b))), B::add(b, one));
+
+    result = B::select(B::lt(B::set1(K::max), x), B::set1(std::numeric_limits<T>::infinity()), result);
+    return B::select(B::lt(x, B::set1(K::min)), B::zero(), result);
+}
+
+template<accuracy A, typename T>
+void exp(T *dst, const T *src, const std::size_t &n) {
+    map_batches<T, exp_batch<A, T> >(dst, src, n);
+}
+
+//******************************************************* LOG ******************************************************
+
+template<accuracy A, typename T>
+inline typename batch<T>::reg log_batch(const typename batch<T>::reg &x) {
+    using B = batch<T>;
+    using K = log_coefficients<T>;
+    using P = tier_coefficients<log_coefficients, A, T>;
+    using limits = std::numeric_limits<T>;
+    constexpr int mantissa = limits::digits - 1;
+    const auto one = B::set1(T(1));
+    const auto half = B::set1(T(0.5));
+
+    // x = m 2^e with m in [0.5, 1), both read straight from the bits; e is recovered by placing the biased exponent
+    // in the mantissa of 2^mantissa
+    const auto magic = static_cast<T>(std::uint64_t(1) << mantissa);
+    using bits = std::conditional_t<sizeof(T) == 4, std::uint32_t, std::uint64_t>;
+    const auto fraction = std::bit_cast<T>((bits(1) << mantissa) - 1);
+    const auto m = B::bit_or(B::bit_and(x, B::set1(fraction)), half);
+    auto e = B::sub(B::bit_or(B::template shift_right<mantissa>(x), B::set1(magic)),
+                    B::set1(magic + static_cast<T>(limits::max_exponent - 2)));
+
+    // Reduce m to [sqrt(1 / 2), sqrt(2)) and f = m - 1
+    const auto low = B::lt(m, B::set1(K::sqrt_half));
+    e = B::sub(e, B::select(low, one, B::zero()));
+    const auto f = B::sub(B::add(m, B::select(low, m, B::zero())), one);
+
+    typename B::reg result;
+    if constexpr (std::is_same_v<P, log_coefficients<double> >) {
+        const auto s = B::div(f, B::add(f, B::set1(T(2))));
+        const auto z = B::mul(s, s);
+        const auto hfsq = B::mul(B::mul(half, f), f);
+        const auto tail = B::fmadd(s, B::add(hfsq, B::mul(z, polynomial<T>(z, P::poly))),
+                                   B::mul(e, B::set1(K::ln2[1])));
+        result = B::fmadd(e, B::set1(K::ln2[0]), B::sub(f, B::sub(hfsq, tail)));
+    } else {
+        const auto z = B::mul(f, f);
+        auto y = B::mul(B::mul(f, z), polynomial<T>(f, P::poly));
+        y = B::fmadd(e, B::set1(static_cast<T>(P::ln2[1])), y);
+        y = B::fmadd(z, B::set1(T(-0.5)), y);
+        result = B::fmadd(e, B::set1(static_cast<T>(P::ln2[0])), B::add(f, y));
+    }
+
+    // Negative inputs give NaN, zero and subnormal inputs -inf, and infinity and NaN pass through
+    const auto special = B::select(B::lt(x, B::zero()), B::set1(limits::quiet_NaN()), B::set1(-limits::infinity()));
+    result = B::select(B::lt(x, B::set1(limits::min())), special, result);
+    return B::select(B::lt(x, B::set1(limits::infinity())), result, x);
+}
+
+template<accuracy A, typename T>
+void log(T *dst, const T *src, const std::size_t &n) {
+    map_batches<T, log_batch<A, T> >(dst, src, n);
+}
+
+//****************************************************** ROOTS *****************************************************
+
+template<accuracy A, typename T>
+inline typename batch<T>::reg rsqrt_batch(const typename batch<T>::reg &x) {
+    using B = batch<T>;
+    if constexpr (A == accuracy::fast && std::is_same_v<T, float>) {
+        // One Newton step y (1.5 - 0.5 x y^2). Zero and infinity keep the estimate, where the step gives 0 * inf.
+        const auto y = B::rsqrt_estimate(x);
+        const auto refined = B::mul(y, B::fmadd(B::mul(B::mul(x, B::set1(-0.5f)), y), y, B::set1(1.5f)));
+        const auto inf = B::set1(std::numeric_limits<float>::infinity());
+        return B::select(B::eq(x, B::zero()), y, B::select(B::eq(x, inf), y, refined));
+    } else {
+        return B::div(B::set1(T(1)), B::sqrt(x));
+    }
+}
+
+template<accuracy A, typename T>
+void rsqrt(T *dst, const T *src, const std::size_t &n) {
+    map_batches<T, rsqrt_batch<A, T> >(dst, src, n);
+}
+
+template<accuracy A, typename T>
+inline typename batch<T>::reg sqrt_batch(const typename batch<T>::reg &x) {
+    using B = batch<T>;
+    if constexpr (A == accuracy::fast && std::is_same_v<T, float>) {
+        // x / sqrt(x) through the refined estimate; zero and infinity are their own roots
+        const auto root = B::mul(x, rsqrt_batch<A, T>(x));
+        const auto inf = B::set1(std::numeric_limits<float>::infinity());
+        return B::select(B::eq(x, B::zero()), x, B::select(B::eq(x, inf), x, root));
+    } else {
+        return B::sqrt(x);
+    }
+}
+
+template<accuracy A, typename T>
+void sqrt(T *dst, const T *src, const std::size_t &n) {
+    map_batches<T, sqrt_batch<A, T> >(dst, src, n);
+}
@@ -4,16 +4,36 @@
 #define CCOMMS_MODULES_TENSOR_VECTOR_HPP_
 
 #include <array>
+#include <memory>
 #include <vector>
 #include <ostream>
-#include <iostream>
+#include <string>
+#include <utility>
 #include <stdexcept>
 #include <algorithm>
 #include <type_traits>
 
+#include "simd.hpp"
+#include "conversion.hpp"
+#include "inline_vector.hpp"
+#include "expression.hpp"
+
 namespace ccomms {
 
-// TODO: implement complex inner product and ensure complex functionality
+/**
+ * @brief Container backing a ccomms::vector: std::array when N is fixed, otherwise std::vector, or an inline_vector
+ * when an inline capacity is given.
+ */
+template<typename T, std::size_t N, typename Alloc, std::size_t Inline>
+using vector_storage_t = std::conditional_t<N != 0, std::array<T, N>, std::conditional_t<
+        Inline == 0, std::vector<T, Alloc>, inline_vector<T, Inline, Alloc> > >;
+
+/**
+ * @brief Longest fixed vector whose elementwise operations and inner product are fully unrolled at compile time
+ * rather than looped or dispatched to the SIMD kernels.
+ */
+inline constexpr std::size_t unroll_limit = 16;
+
 /**
  * @class vector
  *
@@ -21,6 +41,9 @@ namespace ccomms {
  *
  * @tparam T: Container element type
  * @tparam N: Static container length
+ * @tparam Policy: Element type conversion policy from ccomms::conversion
+ * @tparam Alloc: Allocator of the dynamic (N == 0) container, ignored for fixed-length vectors
+ * @tparam Inline: Number of elements a dynamic vector stores without allocating, 0 to always use std::vector
  *
  * @ingroup tensor
  *
@@ -28,13 +51,24 @@ namespace ccomms {
  * both std::vector and optionally std::array. Can be used as a fixed-length array when speed is required by specifying
  * the N template parameter (defaults to 0 for std::vector). It also features overloaded methods allowing for element
  * insertion in a way that automatically handles copying and moving. For vectors of arithmetic types, automatic type
- * conversion is implemented. Mathematical operators are also overloaded for both element-wise and scalar operations as
- * well as inner and cross product.
+ * conversion is implemented and governed at compile time by the Policy parameter, which can allow conversions
+ * silently, report each source and destination type pair once, or reject them. Mathematical operators are also
+ * overloaded for both element-wise and scalar operations as well as inner and cross product. For complex element types
+ * the inner product is Hermitian, conjugating the left operand. Element-wise and scalar operators are lazy and return a
+ * ccomms::expression which is evaluated in a single pass when it is assigned to or used to construct a vector. Inner
+ * products and single binary operations on contiguous float, double, int32 and complex<float> operands run on SIMD
+ * kernels chosen at runtime. Dynamic vectors take an allocator; with ccomms::memory::allocator, vectors created inside
+ * a ccomms::memory::frame are served from a per-thread arena and released together when the frame ends. Giving an
+ * Inline capacity keeps short dynamic vectors inside the object and only spills to the heap past that capacity; the
+ * small_vector alias selects this mode with the default allocator.
+ * Fixed-length vectors are usable in constant expressions, and length mismatches between operands whose lengths are
+ * both static are rejected at compile time.
  */
-template<typename T, std::size_t N = 0>
-class vector : public std::conditional<N == 0, std::vector<T>, std::array<T, N> >::type {
+template<typename T, std::size_t N = 0, typename Policy = conversion::warn_once, typename Alloc = std::allocator<T>,
+        std::size_t Inline = 0>
+class vector : public vector_storage_t<T, N, Alloc, Inline> {
 
-    using container = typename std::conditional<N == 0, std::vector<T>, std::array<T, N> >::type;
+    using container = vector_storage_t<T, N, Alloc, Inline>;
 
     bool is_row;
     bool is_col;
@@ -43,28 +77,30 @@ public:
 
     //************************************************** CONSTRUCTORS **************************************************
 
-    explicit vector(const char &vectype = 'c') :
+    constexpr explicit vector(const char &vectype = 'c') :
             container(),
             is_row(vectype == 'r'),
             is_col(vectype == 'c') {}
 
     template<typename U>
-    vector(const size_t &len, const U &fill, const char &vectype = 'c') :
+    constexpr vector(const size_t &len, const U &fill, const char &vectype = 'c') :
             container(),
             is_row(vectype == 'r'),
             is_col(vectype == 'c') {
         if constexpr (!N)
             container::assign(len, fill);
 
-        if constexpr (N)
+        if constexpr (N) {
+            if (len > N)
+                throw std::invalid_argument("\nERR: fixed vector cannot be filled past its length\n");
             std::fill(container::begin(), std::next(container::begin(), len), fill);
+        }
 
-        if constexpr (!std::is_same_v<U, T>)
-            std::cerr << "\nWARNING: vector fill constructor performing type conversion\n";
+        conversion::check<Policy, U, T>("\nWARNING: vector fill constructor performing type conversion\n");
     }
 
     template<typename U>
-    vector(std::initializer_list<U> list, const char &vectype = 'c') :
+    constexpr vector(std::initializer_list<U> list, const char &vectype = 'c') :
             container(),
             is_row(vectype == 'r'),
             is_col(vectype == 'c') {
@@ -77,176 +113,246 @@ public:
         if constexpr (N)
             std::copy(list.begin(), list.end(), container::begin());
 
-        if constexpr (!std::is_same_v<U, T>)
-            std::cerr << "\nWARNING: vector list constructor performing type conversion\n";
+        conversion::check<Policy, U, T>("\nWARNING: vector list constructor performing type conversion\n");
     }
 
     template<typename V, typename U = typename V::value_type>
-    explicit vector(const V &other, const char &vectype = 'c') :
+    requires (!is_expression_v<V>) && fits_extent<V, N>
+    constexpr explicit vector(const V &other, const char &vectype = 'c') :
             container(),
             is_row(vectype == 'r'),
             is_col(vectype == 'c') {
         init_copy(other, "constructor");
 
-        if constexpr (!std::is_same_v<U, T>)
-            std::cerr << "\nWARNING: vector copy constructor performing type conversion\n";
+        conversion::check<Policy, U, T>("\nWARNING: vector copy constructor performing type conversion\n");
     }
 
     template<typename V, typename U = typename V::value_type>
-    explicit vector(V &&other, const char &vectype = 'c') :
+    requires (!is_expression_v<V>) && (!std::is_lvalue_reference_v<V>) && fits_extent<V, N>
+    constexpr explicit vector(V &&other, const char &vectype = 'c') :
             container(),
             is_row(vectype == 'r'),
             is_col(vectype == 'c') {
         init_move(other, "constructor");
 
-        if constexpr (!std::is_same_v<U, T>)
-            std::cerr << "\nWARNING: vector move constructor performing type conversion\n";
+        conversion::check<Policy, U, T>("\nWARNING: vector move constructor performing type conversion\n");
+    }
+
+    template<typename E>
+    requires is_expression_v<E> && (!std::is_lvalue_reference_v<E>) && fits_extent<E, N>
+    constexpr vector(E &&expr, const char &vectype = 'c') :
+            container(),
+            is_row(vectype == 'r'),
+            is_col(vectype == 'c') {
+        if (!steal(expr))
+            init_copy(expr, "constructor");
+        conversion::check<Policy, typename E::value_type, T>(
+                "\nWARNING: vector expression constructor performing type conversion\n");
+    }
+
+    template<typename E>
+    requires is_expression_v<E> && fits_extent<E, N>
+    constexpr vector(const E &expr, const char &vectype = 'c') :
+            container(),
+            is_row(vectype == 'r'),
+            is_col(vectype == 'c') {
+        init_copy(expr, "constructor");
+        conversion::check<Policy, typename E::value_type, T>(
+                "\nWARNING: vector expression constructor performing type conversion\n");
     }
 
     //*************************************************** ASSIGNMENT ***************************************************
 
     template<typename V, typename U = typename V::value_type>
-    vector<T, N> &operator=(const V &other) {
+    requires (!is_expression_v<V>) && fits_extent<V, N>
+    constexpr vector<T, N, Policy, Alloc, Inline> &operator=(const V &other) {
         init_copy(other, "assignment");
 
-        if constexpr (!std::is_same_v<U, T>)
-            std::cerr << "\nWARNING: vector copy assignment performed on vectors of different types\n";
+        conversion::check<Policy, U, T>("\nWARNING: vector copy assignment performed on vectors of different types\n");
 
         return *this;
     }
 
     template<typename V, typename U = typename V::value_type>
-    vector<T, N> &operator=(const V &&other) {
+    requires (!is_expression_v<V>) && fits_extent<V, N>
+    constexpr vector<T, N, Policy, Alloc, Inline> &operator=(const V &&other) {
         init_move(other, "assignment");
 
-        if constexpr (!std::is_same_v<U, T>)
-            std::cerr << "\nWARNING: vector move assignment performed on vectors of different types\n";
+        conversion::check<Policy, U, T>("\nWARNING: vector move assignment performed on vectors of different types\n");
 
         return *this;
     }
 
-    //************************************************** VECTOR MATH ***************************************************
+    template<typename E>
+    requires is_expression_v<E> && fits_extent<E, N>
+    constexpr vector<T, N, Policy, Alloc, Inline> &operator=(E &&expr) {
+        if constexpr (std::is_lvalue_reference_v<E>)
+            init_copy(expr, "assignment");
+        else if (!steal(expr))
+            init_copy(expr, "assignment");
+        conversion::check<Policy, typename std::remove_cvref_t<E>::value_type, T>(
+                "\nWARNING: vector expression assignment performed on vectors of different types\n");
 
-    template<typename V, typename U = typename V::value_type>
-    vector<std::common_type_t<T, U>, N> operator&(const V &other) const {
-        if (other.size() != 3 || this->size() != 3)
-            throw std::invalid_argument("\nERR: cross product requires two 3D vectors\n");
-
-        auto x = (*this)[1] * other[2] - (*this)[2] * other[1];
-        auto y = (*this)[2] * other[0] - (*this)[0] * other[2];
-        auto z = (*this)[0] * other[1] - (*this)[1] * other[0];
-        return {x, y, z};
+        return *this;
     }
 
-    template<typename V, typename U = typename V::value_type>
-    std::common_type_t<T, U> operator|(const V &other) const {
-        if (other.size() != this->size())
-            throw std::invalid_argument("\nERR: inner product requires vectors of the same length\n");
+    //********************************************* COMPOUND ASSIGNMENT ************************************************
 
-        std::common_type_t<T, U> result = 0;
-        for (std::size_t i = 0; i < this->size(); i++)
-            result += (*this)[i] * other[i];
-
-        return result;
+    template<typename V>
+    requires matching_extents<vector<T, N, Policy, Alloc, Inline>, V, ops::add::broadcast>
+    constexpr vector<T, N, Policy, Alloc, Inline> &operator+=(V &&other) {
+        return compound(make_expression<ops::add>(*this, std::forward<V>(other)),
+                        "\nWARNING: vector compound assignment performed on vectors of different types\n");
     }
 
-    //********************************************** ELEMENTWISE OVERLOADS *********************************************
-
-    template<typename V, typename U = typename V::value_type>
-    vector<std::common_type_t<T, U>, N> operator+(const V &other) const {
-        if (other.size() != this->size())
-            throw std::invalid_argument("\nERR: elementwise addition requires vectors of equal length\n");
-
-        vector<std::common_type_t<T, U>, N> result(this->size(), 0);
-        for (std::size_t i = 0; i < this->size(); i++)
-            result[i] = (*this)[i] + other[i];
-        return result;
+    template<typename V>
+    requires matching_extents<vector<T, N, Policy, Alloc, Inline>, V, ops::sub::broadcast>
+    constexpr vector<T, N, Policy, Alloc, Inline> &operator-=(V &&other) {
+        return compound(make_expression<ops::sub>(*this, std::forward<V>(other)),
+                        "\nWARNING: vector compound assignment performed on vectors of different types\n");
     }
 
-    template<typename V, typename U = typename V::value_type>
-    vector<std::common_type_t<T, U>, N> operator-(const V &other) const {
-        if (other.size() != this->size())
-            throw std::invalid_argument("\nERR: elementwise subtraction requires vectors of equal length\n");
+    template<typename V>
+    requires matching_extents<vector<T, N, Policy, Alloc, Inline>, V, ops::mul::broadcast>
+    constexpr vector<T, N, Policy, Alloc, Inline> &operator*=(V &&other) {
+        return compound(make_expression<ops::mul>(*this, std::forward<V>(other)),
+                        "\nWARNING: vector compound assignment performed on vectors of different types\n");
+    }
 
-        vector<std::common_type_t<T, U>, N> result(this->size(), 0);
-        for (std::size_t i = 0; i < this->size(); i++)
-            result[i] = (*this)[i] - other[i];
-        return result;
+    template<typename V>
+    requires matching_extents<vector<T, N, Policy, Alloc, Inline>, V, ops::div::broadcast>
+    constexpr vector<T, N, Policy, Alloc, Inline> &operator/=(V &&other) {
+        return compound(make_expression<ops::div>(*this, std::forward<V>(other)),
+                        "\nWARNING: vector compound assignment performed on vectors of different types\n");
     }
 
-    template<typename V, typename U = typename V::value_type>
-    vector<std::common_type_t<T, U>, N> operator*(const V &other) const {
-        if (other.size() != this->size() && other.size() != 1 && this->size() != 1)
-            throw std::invalid_argument("\nERR: elementwise multiplication requires vectors of equal length\n");
+    /**
+     * @brief Fused this[i] += alpha * x[i], evaluated in place.
+     */
+    template<typename U, typename V>
+    requires scalar_operand<U> && indexable<V> && fits_extent<V, N>
+    constexpr vector<T, N, Policy, Alloc, Inline> &axpy(const U &alpha, const V &x) {
+        if (!statically_sized<V> && x.size() != this->size())
+            throw std::invalid_argument("\nERR: axpy requires vectors of equal length\n");
+
+        if constexpr (!unrolled && std::is_same_v<U, T> && std::is_same_v<typename V::value_type, T> &&
+                      simd::kernel_type<T> && !is_complex_v<T> && simd::contiguous<V>) {
+            if (!std::is_constant_evaluated()) {
+                simd::axpy(this->data(), alpha, x.data(), this->size());
+                return *this;
+            }
+        }
 
-        vector<std::common_type_t<T, U>, N> result(this->size(), 0);
-        for (std::size_t i = 0; i < this->size(); i++)
-            result[i] = (*this)[i] * other[i];
-        return result;
+        return compound(make_expression<ops::add>(*this, make_expression<ops::mul>(alpha, x)),
+                        "\nWARNING: vector axpy performing type conversion\n");
     }
 
-    template<typename V, typename U = typename V::value_type>
-    vector<std::common_type_t<T, U>, N> operator/(const V &other) const {
-        if (other.size() != this->size() && other.size() != 1 && this->size() != 1)
-            throw std::invalid_argument("\nERR: elementwise division requires vectors of equal length\n");
+    /**
+     * @brief Fused this[i] += a[i] * b[i], evaluated in place.
+     */
+    template<typename V, typename W>
+    requires indexable<V> && indexable<W> && fits_extent<V, N> && fits_extent<W, N>
+    constexpr vector<T, N, Policy, Alloc, Inline> &fma(const V &a, const W &b) {
+        if (!(statically_sized<V> && statically_sized<W>) && (a.size() != this->size() || b.size() != this->size()))
+            throw std::invalid_argument("\nERR: fused multiply-add requires vectors of equal length\n");
+
+        if constexpr (!unrolled && std::is_same_v<typename V::value_type, T> &&
+                      std::is_same_v<typename W::value_type, T> && simd::kernel_type<T> && !is_complex_v<T> &&
+                      simd::contiguous<V> && simd::contiguous<W>) {
+            if (!std::is_constant_evaluated()) {
+                simd::fma(this->data(), a.data(), b.data(), this->size());
+                return *this;
+            }
+        }
 
-        vector<std::common_type_t<T, U>, N> result(this->size(), 0);
-        for (std::size_t i = 0; i < this->size(); i++)
-            result[i] = (*this)[i] / other[i];
-        return result;
+        return compound(make_expression<ops::add>(*this, make_expression<ops::mul>(a, b)),
+                        "\nWARNING: vector fused multiply-add performing type conversion\n");
     }
 
-    //*********************************************** SCALARS OVERLOADS ************************************************
+    //************************************************** ORIENTATION ***************************************************
 
-    template<typename U>
-    vector<std::common_type_t<T, U>, N> operator+(const U &scalar) const {
-        vector<std::common_type_t<T, U>, N> result(this->size());
+    /**
+     * @brief 'r' for a row vector and 'c' for a column vector, as given by the vectype constructor argument.
+     */
+    [[nodiscard]] constexpr char orientation() const { return is_row ? 'r' : 'c'; }
 
-        for (std::size_t i = 0; i < this->size(); i++)
-            result[i] = (*this)[i] + scalar;
+    [[nodiscard]] constexpr bool row_vector() const { return is_row; }
 
-        return result;
+    [[nodiscard]] constexpr bool col_vector() const { return is_col; }
+
+    /**
+     * @brief Changes the orientation in place, exchanging a row vector for a column vector and vice versa.
+     */
+    constexpr vector<T, N, Policy, Alloc, Inline> &transpose() {
+        std::swap(is_row, is_col);
+        return *this;
     }
 
-    template<typename U>
-    vector<std::common_type_t<T, U>, N> operator-(const U &scalar) const {
-        vector<std::common_type_t<T, U>, N> result(this->size());
+    //************************************************** VECTOR MATH ***************************************************
 
-        for (std::size_t i = 0; i < this->size(); i++)
-            result[i] = (*this)[i] - scalar;
+    template<typename V, typename U = typename V::value_type, typename C = std::common_type_t<T, U> >
+    requires fits_extent<vector<T, N, Policy, Alloc, Inline>, 3> && fits_extent<V, 3>
+    constexpr auto operator&(const V &other) const {
+        if (!(N == 3 && static_extent_v<V> == 3) && (other.size() != 3 || this->size() != 3))
+            throw std::invalid_argument("\nERR: cross product requires two 3D vectors\n");
 
-        return result;
+        auto x = (*this)[1] * other[2] - (*this)[2] * other[1];
+        auto y = (*this)[2] * other[0] - (*this)[0] * other[2];
+        auto z = (*this)[0] * other[1] - (*this)[1] * other[0];
+        return vector<C, N, Policy, typename std::allocator_traits<Alloc>::template rebind_alloc<C>, Inline>{x, y, z};
     }
 
-    template<typename U>
-    vector<std::common_type_t<T, U>, N> operator*(const U &scalar) const {
-        vector<std::common_type_t<T, U>, N> result(this->size());
+    template<typename V, typename U = typename V::value_type>
+    requires fits_extent<V, N>
+    constexpr std::common_type_t<T, U> operator|(const V &other) const {
+        using C = std::common_type_t<T, U>;
 
-        for (std::size_t i = 0; i < this->size(); i++)
-            result[i] = (*this)[i] * scalar;
+        if (!statically_sized<V> && other.size() != this->size())
+            throw std::invalid_argument("\nERR: inner product requires vectors of the same length\n");
 
-        return result;
-    }
+        if constexpr (unrolled) {
+            return [&]<std::size_t... I>(std::index_sequence<I...>) {
+                return (C(0) + ... + (ops::conj{}(static_cast<C>((*this)[I])) * static_cast<C>(other[I])));
+            }(std::make_index_sequence<N>{});
+        }
 
-    template<typename U>
-    vector<std::common_type_t<T, U>, N> operator/(const U &scalar) const {
-        vector<std::common_type_t<T, U>, N> result(this->size());
+        if constexpr (std::is_same_v<T, U> && simd::kernel_type<T> && simd::contiguous<V>) {
+            if (!std::is_constant_evaluated()) {
+                if constexpr (is_complex_v<T>)
+                    return simd::dotc(this->data(), other.data(), this->size());
+                else
+                    return simd::dot(this->data(), other.data(), this->size());
+            }
+        }
 
+        std::common_type_t<T, U> result = 0;
         for (std::size_t i = 0; i < this->size(); i++)
-            result[i] = (*this)[i] / scalar;
+            result += ops::conj{}(static_cast<std::common_type_t<T, U> >((*this)[i])) *
+                      static_cast<std::common_type_t<T, U> >(other[i]);
 
         return result;
     }
 
 private:
 
+    /**
+     * @brief Fixed vectors short enough to evaluate element by element without a loop.
+     */
+    static constexpr bool unrolled = N != 0 && N <= unroll_limit;
+
+    /**
+     * @brief True when the length of V is known at compile time to equal N, so no runtime length check is needed.
+     */
+    template<typename V>
+    static constexpr bool statically_sized = N != 0 && static_extent_v<V> == N;
+
     //***************************************************** INITS ******************************************************
 
     template<typename V>
-    void init_copy(const V &other, const std::string &logic) {
-        if (N && other.size() != N)
+    constexpr void init_copy(const V &other, const char *logic) {
+        if (!statically_sized<V> && N && other.size() != N)
             throw std::invalid_argument(
-                    "\nERR: fixed vector" + logic + " requires # of elements equal to its length");
+                    std::string("\nERR: fixed vector ") + logic + " requires # of elements equal to its length");
 
         if constexpr (!N) {
             container::clear();
@@ -257,11 +363,105 @@ private:
         }
     }
 
+    template<typename E>
+    requires is_expression_v<E>
+    constexpr void init_copy(const E &expr, const char *logic) {
+        if (!statically_sized<E> && N && expr.size() != N)
+            throw std::invalid_argument(
+                    std::string("\nERR: fixed vector ") + logic + " requires # of elements equal to its length");
+
+        // A reallocation would invalidate the expression if it references this vector
+        if constexpr (!N) {
+            if (this->size() != expr.size()) {
+                container result(expr.size(), T(), container::get_allocator());
+                evaluate(result, expr);
+                container::swap(result);
+                return;
+            }
+        }
+
+        evaluate(*this, expr);
+    }
+
+    template<typename E>
+    constexpr vector<T, N, Policy, Alloc, Inline> &compound(const E &expr, const char *message) {
+        if (!statically_sized<E> && expr.size() != this->size())
+            throw std::invalid_argument("\nERR: compound assignment cannot change the length of a vector\n");
+
+        evaluate(*this, expr);
+        conversion::check<Policy, typename E::value_type, T>(message);
+        return *this;
+    }
+
+    template<typename S>
+    static constexpr bool owns_buffer() {
+        if constexpr (!std::is_reference_v<S> && is_vector_v<S> && static_extent_v<S> == 0)
+            return std::is_base_of_v<container, S>;
+        else
+            return false;
+    }
+
+    /**
+     * @brief Takes over the heap buffer of a vector operand the expression owns, such as the a in std::move(a) + b,
+     * and evaluates the expression in place in that buffer. The buffer is only swapped in once evaluated, so the other
+     * operand may still reference this vector.
+     *
+     * @return false if the expression owns no reusable buffer, in which case nothing is modified
+     */
+    template<typename E>
+    constexpr bool steal(E &expr) {
+        if constexpr (!N && is_expression_v<E> && requires { typename E::lhs_storage; }) {
+            using Op = typename E::operation;
+            using lhs_type = std::remove_cvref_t<typename E::lhs_storage>;
+            using rhs_type = std::remove_cvref_t<typename E::rhs_storage>;
+
+            if constexpr (std::is_same_v<typename E::value_type, T> && owns_buffer<typename E::lhs_storage>()) {
+                if (expr.broadcasts() || expr.left().get_allocator() != container::get_allocator())
+                    return false;
+
+                container buffer(static_cast<container &&>(expr.take_left()));
+                evaluate(buffer, expression<Op, const container &, const rhs_type &>(buffer, expr.right()));
+                container::swap(buffer);
+                return true;
+            } else if constexpr (std::is_same_v<typename E::value_type, T> &&
+                                 owns_buffer<typename E::rhs_storage>()) {
+                if (expr.broadcasts() || expr.right().get_allocator() != container::get_allocator())
+                    return false;
+
+                container buffer(static_cast<container &&>(expr.take_right()));
+                evaluate(buffer, expression<Op, const lhs_type &, const container &>(expr.left(), buffer));
+                container::swap(buffer);
+                return true;
+            } else {
+                return false;
+            }
+        } else {
+            return false;
+        }
+    }
+
+    template<typename E>
+    static constexpr void evaluate(container &dst, const E &expr) {
+        if constexpr (unrolled) {
+            [&]<std::size_t... I>(std::index_sequence<I...>) {
+                ((dst[I] = static_cast<T>(expr[I])), ...);
+            }(std::make_index_sequence<N>{});
+            return;
+        }
+
+        if constexpr (simd::kernel_type<T>)
+            if (!std::is_constant_evaluated() && simd::evaluate(dst.data(), expr))
+                return;
+
+        for (std::size_t i = 0; i < expr.size(); i++)
+            dst[i] = static_cast<T>(expr[i]);
+    }
+
     template<typename V>
-    void init_move(const V &other, const std::string &logic) {
-        if (N && other.size() != N)
+    constexpr void init_move(const V &other, const char *logic) {
+        if (!statically_sized<V> && N && other.size() != N)
             throw std::invalid_argument(
-                    "\nERR: fixed vector" + logic + " requires # of elements equal to its length");
+                    std::string("\nERR: fixed vector ") + logic + " requires # of elements equal to its length");
 
         if constexpr (!N) {
             container::clear();
@@ -279,8 +479,14 @@ private:
     }
 };
 
-template<typename T, size_t N>
-std::ostream &operator<<(std::ostream &os, const vector<T, N> &vec) {
+/**
+ * @brief Dynamic vector storing up to Inline elements without allocating.
+ */
+template<typename T, std::size_t Inline = 16, typename Policy = conversion::warn_once>
+using small_vector = vector<T, 0, Policy, std::allocator<T>, Inline>;
+
+template<typename T, size_t N, typename Policy, typename Alloc, std::size_t Inline>
+std::ostream &operator<<(std::ostream &os, const vector<T, N, Policy, Alloc, Inline> &vec) {
     os << "[";
     for (std::size_t i = 0; i < vec.size(); i++) {
         os << vec[i];
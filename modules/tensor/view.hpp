@@ -0,0 +1,418 @@
+// Copyright(c) 2023, Matthew Petrin, All rights reserved.
+
+#ifndef CCOMMS_MODULES_TENSOR_VIEW_HPP_
+#define CCOMMS_MODULES_TENSOR_VIEW_HPP_
+
+#include <string>
+#include <cstddef>
+#include <ostream>
+#include <utility>
+#include <iterator>
+#include <concepts>
+#include <stdexcept>
+#include <algorithm>
+#include <type_traits>
+
+#include "simd.hpp"
+#include "vector.hpp"
+#include "conversion.hpp"
+#include "expression.hpp"
+
+namespace ccomms {
+
+//**************************************************** ITERATOR ****************************************************
+
+/**
+ * @brief Random access iterator stepping through memory with a fixed element stride. Positions are kept as an index
+ * so that the end iterator never points past the viewed buffer.
+ */
+template<typename T>
+class strided_iterator {
+
+    T *base = nullptr;
+    std::ptrdiff_t pos = 0;
+    std::ptrdiff_t step = 1;
+
+public:
+
+    using iterator_category = std::random_access_iterator_tag;
+    using value_type = std::remove_cv_t<T>;
+    using difference_type = std::ptrdiff_t;
+    using pointer = T *;
+    using reference = T &;
+
+    strided_iterator() = default;
+
+    constexpr strided_iterator(T *base, const std::ptrdiff_t &pos, const std::ptrdiff_t &step) :
+            base(base), pos(pos), step(step) {}
+
+    constexpr T &operator*() const { return base[pos * step]; }
+
+    constexpr T &operator[](const difference_type &n) const { return base[(pos + n) * step]; }
+
+    constexpr strided_iterator &operator++() { ++pos; return *this; }
+
+    constexpr strided_iterator &operator--() { --pos; return *this; }
+
+    constexpr strided_iterator operator++(int) { auto it = *this; ++pos; return it; }
+
+    constexpr strided_iterator operator--(int) { auto it = *this; --pos; return it; }
+
+    constexpr strided_iterator &operator+=(const difference_type &n) { pos += n; return *this; }
+
+    constexpr strided_iterator &operator-=(const difference_type &n) { pos -= n; return *this; }
+
+    constexpr strided_iterator operator+(const difference_type &n) const { return {base, pos + n, step}; }
+
+    constexpr strided_iterator operator-(const difference_type &n) const { return {base, pos - n, step}; }
+
+    friend constexpr strided_iterator operator+(const difference_type &n, const strided_iterator &it) {
+        return it + n;
+    }
+
+    constexpr difference_type operator-(const strided_iterator &other) const { return pos - other.pos; }
+
+    constexpr bool operator==(const strided_iterator &other) const { return pos == other.pos; }
+
+    constexpr auto operator<=>(const strided_iterator &other) const { return pos <=> other.pos; }
+};
+
+//****************************************************** VIEW ******************************************************
+
+/**
+ * @class vector_view
+ *
+ * @brief A non-owning view of a vector stored in an external buffer.
+ *
+ * @tparam T: Element type, const for a read-only view
+ * @tparam Extent: Static view length, 0 for a length given at runtime
+ * @tparam Strided: Whether consecutive elements are separated by a runtime stride rather than adjacent in memory
+ *
+ * @ingroup tensor
+ *
+ * @details Lets buffers that the library does not own, such as DMA or memory-mapped sample rings, take part in vector
+ * math without being copied first. A view is an operand of the same lazy elementwise operators, complex functions,
+ * inner and cross products as ccomms::vector, and a mutable view is also a destination: assigning an expression or
+ * applying a compound operator evaluates straight into the viewed buffer. Contiguous views expose data() and so run
+ * on the same SIMD kernels as vectors; strided views, such as one component of an interleaved buffer, fall back to
+ * the scalar loop. Like std::span, copying a view copies the reference rather than the elements; the elements are
+ * written through expression assignment, assign and fill. A destination must not partially overlap the operands it
+ * is computed from.
+ */
+template<typename T, std::size_t Extent = 0, bool Strided = false>
+class vector_view {
+
+    template<typename, std::size_t, bool>
+    friend class vector_view;
+
+    T *first = nullptr;
+    std::size_t len = Extent;
+    std::ptrdiff_t step = 1;
+
+public:
+
+    using element_type = T;
+    using value_type = std::remove_cv_t<T>;
+    using size_type = std::size_t;
+    using difference_type = std::ptrdiff_t;
+    using reference = T &;
+    using pointer = T *;
+    using iterator = std::conditional_t<Strided, strided_iterator<T>, T *>;
+    using const_iterator = iterator;
+
+    static constexpr std::size_t extent = Extent;
+    static constexpr bool strided = Strided;
+
+    //************************************************** CONSTRUCTORS **************************************************
+
+    constexpr vector_view() requires (Extent == 0) = default;
+
+    constexpr vector_view(T *data, const std::size_t &len) requires (!Strided) : first(data), len(len) {
+        check_extent(len);
+    }
+
+    constexpr vector_view(T *data, const std::size_t &len, const std::ptrdiff_t &stride) requires Strided :
+            first(data), len(len), step(stride) {
+        check_extent(len);
+    }
+
+    constexpr vector_view(const vector_view &) = default;
+
+    /**
+     * @brief Views the elements of a contiguous container such as a vector, std::vector or std::array.
+     */
+    template<typename C>
+    requires (!is_view_v<C>) && fits_extent<C, Extent> && requires(C &c) {
+        { c.data() } -> std::convertible_to<T *>;
+        { c.size() } -> std::convertible_to<std::size_t>;
+    }
+    constexpr explicit vector_view(C &container) : first(container.data()), len(container.size()) {
+        check_extent(len);
+    }
+
+    /**
+     * @brief Converts to a view of const elements, a runtime length or a strided view.
+     */
+    template<typename U, std::size_t E, bool S>
+    requires std::is_convertible_v<U (*)[], T (*)[]> && fits_extent<vector_view<U, E, S>, Extent> && (Strided || !S)
+    constexpr vector_view(const vector_view<U, E, S> &other) : first(other.first), len(other.len), step(other.step) {
+        check_extent(len);
+    }
+
+    //**************************************************** ACCESS ******************************************************
+
+    [[nodiscard]] constexpr std::size_t size() const { return len; }
+
+    [[nodiscard]] constexpr bool empty() const { return len == 0; }
+
+    /**
+     * @brief Distance in elements between consecutive elements of the view.
+     */
+    [[nodiscard]] constexpr std::ptrdiff_t stride() const { return step; }
+
+    constexpr T *data() const requires (!Strided) { return first; }
+
+    constexpr T &operator[](const std::size_t &i) const {
+        if constexpr (Strided)
+            return first[static_cast<std::ptrdiff_t>(i) * step];
+        else
+            return first[i];
+    }
+
+    constexpr T &at(const std::size_t &i) const {
+        if (i >= len)
+            throw std::out_of_range("\nERR: vector_view index out of range\n");
+        return (*this)[i];
+    }
+
+    constexpr T &front() const { return (*this)[0]; }
+
+    constexpr T &back() const { return (*this)[len - 1]; }
+
+    constexpr iterator begin() const {
+        if constexpr (Strided)
+            return {first, 0, step};
+        else
+            return first;
+    }
+
+    constexpr iterator end() const { return begin() + static_cast<std::ptrdiff_t>(len); }
+
+    /**
+     * @brief View of count elements starting at offset.
+     */
+    constexpr vector_view<T, 0, Strided> subview(const std::size_t &offset, const std::size_t &count) const {
+        if (offset + count > len)
+            throw std::out_of_range("\nERR: vector_view subview out of range\n");
+
+        if constexpr (Strided)
+            return {count ? &(*this)[offset] : first, count, step};
+        else
+            return {first + offset, count};
+    }
+
+    /**
+     * @brief Strided view of count elements starting at offset, taking one element out of every given number.
+     */
+    constexpr vector_view<T, 0, true> slice(const std::size_t &offset, const std::size_t &count,
+                                            const std::size_t &every) const {
+        if (count && (every == 0 || offset + (count - 1) * every >= len))
+            throw std::out_of_range("\nERR: vector_view slice out of range\n");
+
+        return {count ? &(*this)[offset] : first, count, step * static_cast<std::ptrdiff_t>(every)};
+    }
+
+    /**
+     * @brief Copies the viewed elements into a vector, fixed-length if the view has a static extent.
+     */
+    constexpr auto eval() const { return vector<value_type, Extent>(*this); }
+
+    //*************************************************** ASSIGNMENT ***************************************************
+
+    constexpr vector_view &operator=(const vector_view &) = default;
+
+    /**
+     * @brief Evaluates an expression into the viewed elements.
+     */
+    template<typename E>
+    requires is_expression_v<E> && fits_extent<E, Extent> && (!std::is_const_v<T>)
+    constexpr vector_view &operator=(const E &expr) {
+        return write(expr, "assignment");
+    }
+
+    /**
+     * @brief Copies the elements of an equal length container or view into the viewed elements.
+     */
+    template<typename V>
+    requires indexable<V> && fits_extent<V, Extent> && (!std::is_const_v<T>)
+    constexpr vector_view &assign(const V &source) {
+        return write(source, "assignment");
+    }
+
+    constexpr vector_view &fill(const value_type &value) requires (!std::is_const_v<T>) {
+        for (std::size_t i = 0; i < len; i++)
+            (*this)[i] = value;
+        return *this;
+    }
+
+    //********************************************* COMPOUND ASSIGNMENT ************************************************
+
+    template<typename V>
+    requires matching_extents<vector_view, V, ops::add::broadcast> && (!std::is_const_v<T>)
+    constexpr vector_view &operator+=(V &&other) {
+        return write(make_expression<ops::add>(*this, std::forward<V>(other)), "compound assignment");
+    }
+
+    template<typename V>
+    requires matching_extents<vector_view, V, ops::sub::broadcast> && (!std::is_const_v<T>)
+    constexpr vector_view &operator-=(V &&other) {
+        return write(make_expression<ops::sub>(*this, std::forward<V>(other)), "compound assignment");
+    }
+
+    template<typename V>
+    requires matching_extents<vector_view, V, ops::mul::broadcast> && (!std::is_const_v<T>)
+    constexpr vector_view &operator*=(V &&other) {
+        return write(make_expression<ops::mul>(*this, std::forward<V>(other)), "compound assignment");
+    }
+
+    template<typename V>
+    requires matching_extents<vector_view, V, ops::div::broadcast> && (!std::is_const_v<T>)
+    constexpr vector_view &operator/=(V &&other) {
+        return write(make_expression<ops::div>(*this, std::forward<V>(other)), "compound assignment");
+    }
+
+    /**
+     * @brief Fused this[i] += alpha * x[i], evaluated in place.
+     */
+    template<typename U, typename V>
+    requires scalar_operand<U> && indexable<V> && fits_extent<V, Extent> && (!std::is_const_v<T>)
+    constexpr vector_view &axpy(const U &alpha, const V &x) {
+        if (x.size() != len)
+            throw std::invalid_argument("\nERR: axpy requires vectors of equal length\n");
+
+        if constexpr (!Strided && std::is_same_v<U, value_type> && std::is_same_v<typename V::value_type, value_type> &&
+                      simd::kernel_type<value_type> && !is_complex_v<value_type> && simd::contiguous<V>) {
+            if (!std::is_constant_evaluated()) {
+                simd::axpy(first, alpha, x.data(), len);
+                return *this;
+            }
+        }
+
+        return write(make_expression<ops::add>(*this, make_expression<ops::mul>(alpha, x)), "axpy");
+    }
+
+    /**
+     * @brief Fused this[i] += a[i] * b[i], evaluated in place.
+     */
+    template<typename V, typename W>
+    requires indexable<V> && indexable<W> && fits_extent<V, Extent> && fits_extent<W, Extent> &&
+             (!std::is_const_v<T>)
+    constexpr vector_view &fma(const V &a, const W &b) {
+        if (a.size() != len || b.size() != len)
+            throw std::invalid_argument("\nERR: fused multiply-add requires vectors of equal length\n");
+
+        if constexpr (!Strided && std::is_same_v<typename V::value_type, value_type> &&
+                      std::is_same_v<typename W::value_type, value_type> && simd::kernel_type<value_type> &&
+                      !is_complex_v<value_type> && simd::contiguous<V> && simd::contiguous<W>) {
+            if (!std::is_constant_evaluated()) {
+                simd::fma(first, a.data(), b.data(), len);
+                return *this;
+            }
+        }
+
+        return write(make_expression<ops::add>(*this, make_expression<ops::mul>(a, b)), "fused multiply-add");
+    }
+
+    //************************************************** VECTOR MATH ***************************************************
+
+    template<typename V, typename U = typename V::value_type, typename C = std::common_type_t<value_type, U> >
+    requires fits_extent<vector_view, 3> && fits_extent<V, 3>
+    constexpr auto operator&(const V &other) const {
+        if (other.size() != 3 || len != 3)
+            throw std::invalid_argument("\nERR: cross product requires two 3D vectors\n");
+
+        auto x = (*this)[1] * other[2] - (*this)[2] * other[1];
+        auto y = (*this)[2] * other[0] - (*this)[0] * other[2];
+        auto z = (*this)[0] * other[1] - (*this)[1] * other[0];
+        return vector<C, Extent>{x, y, z};
+    }
+
+    template<typename V, typename U = typename V::value_type>
+    requires fits_extent<V, Extent>
+    constexpr std::common_type_t<value_type, U> operator|(const V &other) const {
+        using C = std::common_type_t<value_type, U>;
+
+        if (other.size() != len)
+            throw std::invalid_argument("\nERR: inner product requires vectors of the same length\n");
+
+        if constexpr (!Strided && std::is_same_v<value_type, U> && simd::kernel_type<value_type> &&
+                      simd::contiguous<V>) {
+            if (!std::is_constant_evaluated()) {
+                if constexpr (is_complex_v<value_type>)
+                    return simd::dotc(first, other.data(), len);
+                else
+                    return simd::dot(first, other.data(), len);
+            }
+        }
+
+        C result = 0;
+        for (std::size_t i = 0; i < len; i++)
+            result += ops::conj{}(static_cast<C>((*this)[i])) * static_cast<C>(other[i]);
+
+        return result;
+    }
+
+private:
+
+    constexpr void check_extent(const std::size_t &count) const {
+        if (Extent && count != Extent)
+            throw std::invalid_argument("\nERR: fixed vector_view requires # of elements equal to its length\n");
+    }
+
+    template<typename E>
+    constexpr vector_view &write(const E &source, const char *logic) {
+        if (source.size() != len)
+            throw std::invalid_argument(std::string("\nERR: vector_view ") + logic + " requires equal lengths\n");
+
+        conversion::check<conversion::warn_once, typename E::value_type, value_type>(
+                "\nWARNING: vector_view assignment performing type conversion\n");
+
+        if constexpr (!Strided && simd::kernel_type<value_type> && is_expression_v<E>)
+            if (!std::is_constant_evaluated() && simd::evaluate(first, source))
+                return *this;
+
+        for (std::size_t i = 0; i < len; i++)
+            (*this)[i] = static_cast<value_type>(source[i]);
+        return *this;
+    }
+};
+
+/**
+ * @brief Strided view, such as one component of an interleaved buffer.
+ */
+template<typename T, std::size_t Extent = 0>
+using strided_view = vector_view<T, Extent, true>;
+
+template<typename C>
+vector_view(C &) -> vector_view<std::remove_pointer_t<decltype(std::declval<C &>().data())>, static_extent_v<C> >;
+
+template<typename T>
+vector_view(T *, std::size_t) -> vector_view<T>;
+
+template<typename T>
+vector_view(T *, std::size_t, std::ptrdiff_t) -> vector_view<T, 0, true>;
+
+template<typename T, std::size_t Extent, bool Strided>
+std::ostream &operator<<(std::ostream &os, const vector_view<T, Extent, Strided> &view) {
+    os << "[";
+    for (std::size_t i = 0; i < view.size(); i++) {
+        os << view[i];
+        if (i != view.size() - 1) os << ", ";
+    }
+    os << "]";
+    return os;
+}
+
+}
+
+#endif // CCOMMS_MODULES_TENSOR_VIEW_HPP_
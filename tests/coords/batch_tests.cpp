@@ -0,0 +1,100 @@
+#include <cmath>
+#include <vector>
+#include <cassert>
+#include "../../include/coords.hpp"
+
+using namespace ccomms;
+
+int main() {
+    {
+        // Test bulk construction from and back to interleaved buffers
+        std::vector<double> xyz{1, 2, 3, 4, 5, 6, 7, 8, 9};
+        cartesian_batch<double> b(xyz.data(), 3);
+        assert(b.size() == 3 && b.x()[1] == 4 && b.y()[2] == 8 && b.z()[0] == 3);
+
+        auto back = b.interleave();
+        for (std::size_t i = 0; i < xyz.size(); i++)
+            assert(back[i] == xyz[i]);
+
+        auto p = b[2];
+        assert(p[0] == 7 && p[1] == 8 && p[2] == 9);
+    }
+
+    {
+        // Test construction from points and incremental growth
+        std::vector<cartesian<float> > points{{1.0f, 0.0f, 0.0f}, {0.0f, 2.0f, 0.0f}};
+        cartesian_batch<float> b(points);
+        b.push_back(0.0f, 0.0f, 3.0f);
+        b.push_back(cartesian<float>(3.0f, 4.0f, 0.0f));
+        assert(b.size() == 4 && b.z()[2] == 3.0f && b.y()[3] == 4.0f);
+    }
+
+    {
+        // Test pointwise operations against per point references on a batch spanning SIMD tails
+        const std::size_t n = 1001;
+        cartesian_batch<double> a(n), b(n);
+        for (std::size_t i = 0; i < n; i++) {
+            a.set(i, std::sin(0.1 * i), std::cos(0.2 * i), 0.5 * (i % 5));
+            b.set(i, 1.0 - 0.01 * i, 0.25 * (i % 3), std::sin(0.3 * i));
+        }
+
+        auto sum = a + b;
+        auto diff = a - b;
+        auto scaled = a * 2.0;
+        auto dot = a.dot(b);
+        auto cross = a.cross(b);
+        auto norm = a.norm();
+        auto dist = a.distance(b);
+        auto from_origin = a.distance(cartesian<double>(1.0, 1.0, 1.0));
+
+        for (std::size_t i = 0; i < n; i++) {
+            const double ax = a.x()[i], ay = a.y()[i], az = a.z()[i];
+            const double bx = b.x()[i], by = b.y()[i], bz = b.z()[i];
+            assert(sum.x()[i] == ax + bx && diff.z()[i] == az - bz && scaled.y()[i] == 2 * ay);
+            assert(std::abs(dot[i] - (ax * bx + ay * by + az * bz)) < 1e-12);
+            assert(std::abs(cross.x()[i] - (ay * bz - az * by)) < 1e-12);
+            assert(std::abs(cross.z()[i] - (ax * by - ay * bx)) < 1e-12);
+            assert(std::abs(norm[i] - std::sqrt(ax * ax + ay * ay + az * az)) < 1e-12);
+            assert(std::abs(dist[i] - std::hypot(ax - bx, ay - by, az - bz)) < 1e-12);
+            assert(std::abs(from_origin[i] - std::hypot(ax - 1, ay - 1, az - 1)) < 1e-12);
+        }
+
+        bool caught_exception = false;
+        try {
+            auto bad = a + cartesian_batch<double>(3);
+        } catch (const std::invalid_argument &e) {
+            caught_exception = true;
+        }
+        assert(caught_exception);
+    }
+
+    {
+        // Test spherical and geodetic batches
+        spherical_batch<double> s;
+        s.push_back(spherical<double>(45.0, 10.0), 1000.0);
+        assert(s.size() == 1 && s.range()[0] == 1000.0 && s[0][0] == 45.0);
+
+        std::vector<double> lla{45.0, -120.0, 100.0, -33.0, 151.0, 20.0};
+        geodetic_batch<double> g(lla.data(), 2);
+        assert(g.lat()[1] == -33.0 && g.lon()[0] == -120.0 && g.alt()[1] == 20.0);
+
+        bool caught_exception = false;
+        try {
+            g.push_back(91.0, 0.0, 0.0);
+        } catch (const std::invalid_argument &e) {
+            caught_exception = true;
+        }
+        assert(caught_exception && g.size() == 2);
+
+        caught_exception = false;
+        lla[3] = 200.0;
+        try {
+            geodetic_batch<double> bad(lla.data(), 2);
+        } catch (const std::invalid_argument &e) {
+            caught_exception = true;
+        }
+        assert(caught_exception);
+    }
+
+    return 0;
+}
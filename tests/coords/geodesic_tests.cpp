@@ -0,0 +1,180 @@
+#include <cmath>
+#include <random>
+#include <vector>
+#include <cassert>
+#include <numbers>
+#include <stdexcept>
+#include "../../include/coords.hpp"
+#include "../../include/tensor.hpp"
+
+using namespace ccomms;
+
+namespace {
+
+bool near(const double &a, const double &b, const double &tol) {
+    return std::abs(a - b) <= tol;
+}
+
+// Difference of two bearings in degrees across the wrap at north
+double bearing_error(const double &a, const double &b) {
+    const double d = std::abs(a - b);
+    return std::min(d, 360.0 - d);
+}
+
+// Great circle distance and bearing straight from the definition, in double precision
+double reference_haversine(const double &lat1, const double &lon1, const double &lat2, const double &lon2,
+                           double &bearing) {
+    const double p1 = lat1 * deg_to_rad, p2 = lat2 * deg_to_rad, dl = (lon2 - lon1) * deg_to_rad;
+    const double h = std::pow(std::sin((p2 - p1) / 2), 2) +
+                     std::cos(p1) * std::cos(p2) * std::pow(std::sin(dl / 2), 2);
+    bearing = std::atan2(std::sin(dl) * std::cos(p2), std::cos(p1) * std::sin(p2) -
+                                                       std::sin(p1) * std::cos(p2) * std::cos(dl)) * rad_to_deg;
+    bearing = bearing < 0 ? bearing + 360 : bearing;
+    return 2 * mean_earth_radius * std::asin(std::sqrt(h));
+}
+
+template<typename T>
+geodetic_batch<T> random_points(const std::size_t &count, const unsigned &seed) {
+    std::mt19937 gen(seed);
+    std::uniform_real_distribution<double> lat(-89.0, 89.0), lon(-180.0, 180.0);
+    geodetic_batch<T> result;
+    for (std::size_t i = 0; i < count; i++)
+        result.push_back(static_cast<T>(lat(gen)), static_cast<T>(lon(gen)), static_cast<T>(i));
+    return result;
+}
+
+// The tolerance is relative to the distance, the round trip bound absolute on top of it
+template<typename T>
+void check_batches(const geodesic_method &method, const double &tolerance, const double &round_trip) {
+    const geodetic_batch<T> a = random_points<T>(1100, 1), b = random_points<T>(1100, 2);
+
+    // One to one and one to many agree with the point functions
+    const auto d = geodesic_distance(a, b, method);
+    const auto bearing = initial_bearing(a, b, method);
+    const auto from_first = geodesic_distance(a[0], b, method);
+    const auto bearing_from_first = initial_bearing(a[0], b, method);
+    assert(d.size() == a.size() && from_first.size() == b.size());
+    for (std::size_t i = 0; i < a.size(); i += 7) {
+        assert(near(d[i], geodesic_distance(a[i], b[i], method), tolerance * (1 + d[i])));
+        assert(bearing_error(bearing[i], initial_bearing(a[i], b[i], method)) <= 1e-4);
+        assert(near(from_first[i], geodesic_distance(a[0], b[i], method), tolerance * (1 + d[i])));
+        assert(bearing_error(bearing_from_first[i], initial_bearing(a[0], b[i], method)) <= 1e-4);
+    }
+
+    // Destinations along the measured bearings come back to the second points
+    const geodetic_batch<T> reached = destination(a, bearing, d, method);
+    assert(reached.size() == a.size() && reached.alt()[5] == a.alt()[5]);
+    for (std::size_t i = 0; i < a.size(); i++)
+        assert(geodesic_distance(reached[i], b[i], method) <= round_trip + 4 * tolerance * d[i]);
+
+    // All pairs rows match one to many, identically under every policy
+    const geodetic_batch<T> few = random_points<T>(9, 3);
+    const matrix<T> m = distance_matrix(few, b, method);
+    assert(m.rows() == few.size() && m.cols() == b.size());
+    execution::thread_pool two(2);
+    const matrix<T> sequential = distance_matrix(execution::seq, few, b, method);
+    const matrix<T> pooled = distance_matrix(execution::par.on(two), few, b, method);
+    for (std::size_t r = 0; r < few.size(); r++) {
+        const auto row = geodesic_distance(execution::seq, few[r], b, method);
+        for (std::size_t c = 0; c < b.size(); c++)
+            assert(m(r, c) == row[c] && sequential(r, c) == row[c] && pooled(r, c) == row[c]);
+    }
+}
+
+}
+
+int main() {
+    for (int l = 0; l <= static_cast<int>(simd::detect()); l++) {
+        simd::restrict_to(static_cast<simd::level>(l));
+
+        {
+            // Test Vincenty against his published example, Flinders Peak to Buninyong
+            const geodetic<double> flinders(-(37 + 57.0 / 60 + 3.72030 / 3600), 144 + 25.0 / 60 + 29.52440 / 3600);
+            const geodetic<double> buninyong(-(37 + 39.0 / 60 + 10.15610 / 3600), 143 + 55.0 / 60 + 35.38390 / 3600);
+            assert(near(geodesic_distance(flinders, buninyong), 54972.271, 1e-3));
+            assert(near(initial_bearing(flinders, buninyong), 306 + 52.0 / 60 + 5.37 / 3600, 1e-6));
+
+            const geodetic<double> reached = destination(flinders, 306 + 52.0 / 60 + 5.37 / 3600, 54972.271);
+            assert(near(reached[0], buninyong[0], 1e-7) && near(reached[1], buninyong[1], 1e-7));
+
+            // Along the equator the geodesic is an arc of the equator, and along a meridian a quarter meridian
+            assert(near(geodesic_distance(geodetic<double>(0.0, 0.0), geodetic<double>(0.0, 1.0)),
+                        wgs84::a * deg_to_rad, 1e-6));
+            assert(near(geodesic_distance(geodetic<double>(0.0, 0.0), geodetic<double>(90.0, 0.0)), 10001965.729,
+                        1e-3));
+            assert(near(initial_bearing(geodetic<double>(0.0, 0.0), geodetic<double>(0.0, 1.0)), 90, 1e-9));
+            assert(near(initial_bearing(geodetic<double>(10.0, 179.5), geodetic<double>(10.0, -179.5)), 90, 0.1));
+
+            // Bearings just west of north stay below 360
+            for (const auto &method: {geodesic_method::haversine, geodesic_method::vincenty}) {
+                const double west = initial_bearing(geodetic<double>(0.0, 0.0), geodetic<double>(10.0, -1e-12), method);
+                const float west_f = initial_bearing(geodetic<float>(0.0f, 0.0f), geodetic<float>(10.0f, -1e-6f),
+                                                     method);
+                assert(west >= 0.0 && west < 360.0 && west_f >= 0.0f && west_f < 360.0f);
+            }
+
+            // Coincident points are zero apart, and nearly antipodal points where the iteration fails are NaN
+            assert(geodesic_distance(flinders, flinders) == 0);
+            assert(std::isnan(geodesic_distance(geodetic<double>(0.0, 0.0), geodetic<double>(0.5, 179.7))));
+            assert(near(geodesic_distance(geodetic<double>(0.0, 0.0), geodetic<double>(0.5, 179.7),
+                                          geodesic_method::haversine), mean_earth_radius * std::numbers::pi, 1e5));
+
+            // Single precision coordinates are solved in double
+            const float d = geodesic_distance(geodetic<float>(-37.95103f, 144.42487f),
+                                              geodetic<float>(-37.65282f, 143.92650f));
+            assert(near(d, 54972.271, 1.0));
+        }
+
+        {
+            // Test the haversine against the definition over random pairs, in both precisions
+            const geodetic_batch<double> a = random_points<double>(300, 4), b = random_points<double>(300, 5);
+            const geodetic_batch<float> af = random_points<float>(300, 4), bf = random_points<float>(300, 5);
+            const auto d = geodesic_distance(a, b, geodesic_method::haversine);
+            const auto bearing = initial_bearing(a, b, geodesic_method::haversine);
+            const auto df = geodesic_distance(af, bf, geodesic_method::haversine);
+            for (std::size_t i = 0; i < a.size(); i++) {
+                double expected_bearing;
+                const double expected = reference_haversine(a.lat()[i], a.lon()[i], b.lat()[i], b.lon()[i],
+                                                            expected_bearing);
+                assert(near(d[i], expected, 1e-6) && bearing_error(bearing[i], expected_bearing) <= 1e-9);
+
+                const double expected_float = reference_haversine(af.lat()[i], af.lon()[i], bf.lat()[i],
+                                                                  bf.lon()[i], expected_bearing);
+                assert(near(df[i], expected_float, 1e-6 * expected_float));
+            }
+
+            // The two models agree to the flattening
+            const auto dv = geodesic_distance(a, b);
+            for (std::size_t i = 0; i < a.size(); i++)
+                assert(std::abs(dv[i] - d[i]) <= 0.006 * d[i]);
+        }
+
+        check_batches<double>(geodesic_method::vincenty, 1e-9, 1e-3);
+        check_batches<double>(geodesic_method::haversine, 1e-9, 1e-3);
+        check_batches<float>(geodesic_method::vincenty, 1e-6, 10.0);
+        check_batches<float>(geodesic_method::haversine, 1e-6, 10.0);
+    }
+
+    {
+        // Test mismatched batches are rejected
+        const geodetic_batch<double> a = random_points<double>(3, 1), b = random_points<double>(4, 2);
+        bool caught_exception = false;
+        try {
+            geodesic_distance(a, b);
+        } catch (const std::invalid_argument &e) {
+            caught_exception = true;
+        }
+        assert(caught_exception);
+
+        caught_exception = false;
+        try {
+            destination(a, vector<double>(3, 0.0), vector<double>(2, 0.0));
+        } catch (const std::invalid_argument &e) {
+            caught_exception = true;
+        }
+        assert(caught_exception);
+    }
+
+    simd::restrict_to(simd::level::avx512);
+    return 0;
+}
@@ -0,0 +1,253 @@
+#include <cmath>
+#include <array>
+#include <string>
+#include <vector>
+#include <cassert>
+#include <numbers>
+#include <algorithm>
+#include <sstream>
+#include <stdexcept>
+#include "../../include/coords.hpp"
+
+using namespace ccomms;
+
+namespace {
+
+const std::string line1_00005 = "1 00005U 58002B   00179.78495062  .00000023  00000-0  28098-4 0  4753";
+const std::string line2_00005 = "2 00005  34.2682 348.7242 1859667 331.7664  19.3264 10.82419157413667";
+const std::string line1_06251 = "1 06251U 62025E   06176.82412014  .00008885  00000-0  12808-3 0  3985";
+const std::string line2_06251 = "2 06251  58.0579  54.0425 0030035 139.1568 221.1854 15.56387291  6774";
+
+// The first 68 columns of a TLE line with its checksum appended
+std::string with_checksum(const std::string &line) {
+    int sum = 0;
+    for (const char &c: line)
+        sum += c == '-' ? 1 : c >= '0' && c <= '9' ? c - '0' : 0;
+    return line + static_cast<char>('0' + sum % 10);
+}
+
+template<typename F>
+bool throws(F &&f) {
+    try {
+        f();
+    } catch (const std::invalid_argument &e) {
+        return true;
+    }
+    return false;
+}
+
+bool near(const double &a, const double &b, const double &tolerance) {
+    return std::abs(a - b) <= tolerance;
+}
+
+void check_parsing() {
+    const two_line_element tle = parse_tle(line1_00005, line2_00005, "VANGUARD 1");
+    assert(tle.name == "VANGUARD 1" && tle.catalog_number == 5 && tle.designator == "58002B");
+    assert(near(tle.bstar, 0.28098e-4, 1e-15) && tle.mean_motion_ddot == 0.0);
+    assert(near(tle.mean_motion_dot, 0.00000023, 1e-15) && near(tle.eccentricity, 0.1859667, 1e-15));
+    assert(tle.inclination == 34.2682 && tle.raan == 348.7242 && tle.arg_perigee == 331.7664);
+    assert(tle.mean_anomaly == 19.3264 && tle.mean_motion == 10.82419157 && tle.revolution == 41366);
+
+    // Day 179.78495062 of 2000 is June 27, 18:50:19.733568 UT
+    const julian_date expected = julian_date::from_calendar(2000, 6, 27, 18, 50, 19.733568);
+    assert(near(tle.epoch.days_since(expected) * 86400.0, 0.0, 1e-5));
+    assert(parse_tle(line1_06251, line2_06251).epoch.day == julian_date::from_calendar(2006, 6, 25).day);
+
+    // Corrupted checksums, short lines, swapped lines and mismatched catalog numbers
+    std::string corrupted = line2_00005;
+    corrupted[20] = '9';
+    assert(throws([&]() { parse_tle(line1_00005, corrupted); }));
+    assert(throws([&]() { parse_tle(line1_00005, line2_00005.substr(0, 60)); }));
+    assert(throws([&]() { parse_tle(line2_00005, line1_00005); }));
+    assert(throws([&]() { parse_tle(line1_00005, line2_06251); }));
+    const std::string garbled = with_checksum(line1_00005.substr(0, 33) + " .0000x023" + line1_00005.substr(43, 25));
+    assert(throws([&]() { parse_tle(garbled, line2_00005); }));
+
+    // Two and three line entries mixed, with blank lines and carriage returns
+    std::istringstream file("0 VANGUARD 1\r\n" + line1_00005 + "\r\n" + line2_00005 + "\r\n\n" + line1_06251 + "\n" +
+                            line2_06251 + "\nISS (ZARYA)\n" + line1_00005 + "\n" + line2_00005 + "\n");
+    const auto tles = parse_tles(file);
+    assert(tles.size() == 3 && tles[0].name == "VANGUARD 1" && tles[1].name.empty() && tles[2].name == "ISS (ZARYA)");
+    assert(tles[1].catalog_number == 6251 && tles[2].catalog_number == 5);
+    std::istringstream truncated(line1_00005 + "\n" + line2_00005 + "\n" + line1_06251 + "\n");
+    assert(throws([&]() { parse_tles(truncated); }));
+}
+
+// Published SGP4 verification states of catalog numbers 5 and 6251, in kilometers and kilometers per second
+void check_sgp4_reference() {
+    const std::vector<two_line_element> tles{parse_tle(line1_00005, line2_00005), parse_tle(line1_06251, line2_06251)};
+    const constellation sats(tles);
+    assert(sats.size() == 2 && sats.model() == orbit_model::sgp4);
+    struct reference {
+        std::size_t satellite;
+        double minutes;
+        std::array<double, 6> state;
+    };
+    const std::vector<reference> references{
+            {0, 0.0, {7022.46529266, -1400.08296755, 0.03995155, 1.893841015, 6.405893759, 4.534807250}},
+            {0, 360.0, {-7154.03120202, -3783.17682504, -3536.19412294, 4.741887409, -4.151817765, -2.093935425}},
+            {0, 720.0, {-7134.59340119, 6531.68641334, 3260.27186483, -4.113793027, -2.911922039, -2.557327851}},
+            {0, 1440.0, {-938.55923943, -6268.18748831, -4294.02924751, 7.536105209, -0.427127707, 0.989878080}},
+            {1, 0.0, {3988.31022699, 5498.96657235, 0.90055879, -3.290032738, 2.357652820, 6.496623475}},
+            {1, 360.0, {4993.62642836, 2890.54969900, -3600.40145627, 0.347333429, 5.707031557, 5.070699638}}};
+    for (const auto &[satellite, minutes, state]: references) {
+        cartesian_batch<double> position, velocity;
+        propagate(execution::seq, sats, tles[satellite].epoch + minutes * 60.0, position, velocity);
+        assert(position.size() == 2 && velocity.size() == 2);
+        for (std::size_t k = 0; k < 3; k++) {
+            assert(near(position.column(k)[satellite], state[k] * 1000.0, 1e-3));
+            assert(near(velocity.column(k)[satellite], state[k + 3] * 1000.0, 1e-5));
+        }
+    }
+
+    // Geostationary element sets are deep space, outside the near earth model
+    const std::string geo1 = with_checksum("1 26038U 00001A   06176.50000000 -.00000266  00000-0  10000-3 0  940");
+    const std::string geo2 = with_checksum("2 26038   0.0263 251.9020 0002613  87.0553 271.1522  1.00271245 2338");
+    assert(throws([&]() { constellation({tles[0], parse_tle(geo1, geo2)}); }));
+    const constellation kepler({tles[0], parse_tle(geo1, geo2)}, orbit_model::kepler);
+    assert(kepler.model() == orbit_model::kepler && kepler.size() == 2);
+}
+
+// Satellites spread over planes and slots from the elements of catalog number 6251, with epochs a few hours apart
+std::vector<two_line_element> sample_tles(const std::size_t &len) {
+    const two_line_element base = parse_tle(line1_06251, line2_06251);
+    std::vector<two_line_element> result(len, base);
+    for (std::size_t i = 0; i < len; i++) {
+        result[i].raan = std::fmod(static_cast<double>(i % 24) * 15.0 + 3.0, 360.0);
+        result[i].mean_anomaly = std::fmod(static_cast<double>(i) * 7.3, 360.0);
+        result[i].mean_motion = 14.5 + static_cast<double>(i % 9) * 0.1;
+        result[i].epoch = base.epoch + static_cast<double>(i % 5) * 3600.0;
+    }
+    return result;
+}
+
+// Satellites propagated together across blocks and threads agree with each satellite propagated alone
+void check_batching() {
+    const auto tles = sample_tles(1500);
+    const constellation sats(tles);
+    const julian_date start = tles[0].epoch + 600.0;
+    const auto grid = propagate(execution::par, sats, start, 30.0, 7, orbit_frame::ecef);
+    const auto serial = propagate(execution::seq, sats, start, 30.0, 7, orbit_frame::ecef);
+    assert(grid.position.size() == 7 * 1500 && grid.satellites == 1500 && grid.steps == 7);
+    for (std::size_t k = 0; k < 3; k++) {
+        assert(std::equal(grid.position.column(k).begin(), grid.position.column(k).end(),
+                          serial.position.column(k).begin()));
+        assert(std::equal(grid.velocity.column(k).begin(), grid.velocity.column(k).end(),
+                          serial.velocity.column(k).begin()));
+    }
+
+    for (std::size_t i = 0; i < 1500; i += 97) {
+        const constellation alone(std::vector<two_line_element>{tles[i]});
+        cartesian_batch<double> position, velocity;
+        propagate(execution::seq, alone, grid.time(5), position, velocity, orbit_frame::ecef);
+        for (std::size_t k = 0; k < 3; k++) {
+            assert(near(grid.position.column(k)[grid.index(5, i)], position.column(k)[0], 1e-6));
+            assert(near(grid.velocity.column(k)[grid.index(5, i)], velocity.column(k)[0], 1e-9));
+        }
+    }
+
+    // Streaming hands over the same states one step at a time, in order
+    std::size_t next = 0;
+    propagate(execution::par, sats, start, 30.0, 7, orbit_frame::ecef,
+              [&](std::size_t s, const julian_date &time, const cartesian_batch<double> &position,
+                  const cartesian_batch<double> &velocity) {
+                  assert(s == next++ && near(time.days_since(grid.time(s)), 0.0, 1e-12));
+                  assert(position.size() == 1500 && velocity.size() == 1500);
+                  for (std::size_t i = 0; i < 1500; i++)
+                      for (std::size_t k = 0; k < 3; k++) {
+                          assert(position.column(k)[i] == grid.position.column(k)[grid.index(s, i)]);
+                          assert(velocity.column(k)[i] == grid.velocity.column(k)[grid.index(s, i)]);
+                      }
+              });
+    assert(next == 7);
+
+    // Single precision output rounds the same states
+    const auto single = propagate<float>(execution::par, sats, start, 30.0, 7, orbit_frame::ecef);
+    for (std::size_t i = 0; i < single.position.size(); i++)
+        for (std::size_t k = 0; k < 3; k++)
+            assert(near(single.position.column(k)[i], grid.position.column(k)[i], 1.0));
+
+    // An empty constellation or grid propagates nothing
+    const auto none = propagate(constellation(), start, 30.0, 7);
+    assert(none.position.empty());
+    assert(propagate(sats, start, 30.0, 0).position.empty());
+}
+
+// The earth fixed frame is the inertial one turned by sidereal time, its velocity less the rotation of the earth
+void check_frames() {
+    const auto tles = sample_tles(40);
+    const constellation sats(tles);
+    const julian_date time = tles[0].epoch + 12345.0;
+    cartesian_batch<double> teme, teme_velocity, ecef, ecef_velocity;
+    propagate(sats, time, teme, teme_velocity);
+    propagate(sats, time, ecef, ecef_velocity, orbit_frame::ecef);
+    const double g = time.gmst(), w = wgs84::rotation_rate;
+    for (std::size_t i = 0; i < sats.size(); i++) {
+        const double x = std::cos(g) * teme.x()[i] + std::sin(g) * teme.y()[i];
+        const double y = -std::sin(g) * teme.x()[i] + std::cos(g) * teme.y()[i];
+        assert(near(ecef.x()[i], x, 1e-6) && near(ecef.y()[i], y, 1e-6) && ecef.z()[i] == teme.z()[i]);
+        const double vx = std::cos(g) * teme_velocity.x()[i] + std::sin(g) * teme_velocity.y()[i] + w * y;
+        const double vy = -std::sin(g) * teme_velocity.x()[i] + std::cos(g) * teme_velocity.y()[i] - w * x;
+        assert(near(ecef_velocity.x()[i], vx, 1e-9) && near(ecef_velocity.y()[i], vy, 1e-9));
+
+        // Low earth orbits stay between 100 and 2000 km up
+        const double r = std::hypot(teme.x()[i], teme.y()[i], teme.z()[i]);
+        assert(r > wgs84::a + 1e5 && r < wgs84::a + 2e6);
+    }
+
+    // Sidereal time at the J2000 epoch, 18.697374558 hours
+    assert(near(julian_date().gmst(), 18.697374558 / 24.0 * 2.0 * std::numbers::pi, 1e-9));
+}
+
+// Two body orbits keep their energy and angular momentum, and return to the start after one period
+void check_kepler() {
+    std::vector<keplerian_elements> elements;
+    for (std::size_t i = 0; i < 700; i++)
+        elements.push_back({7.0e6 + static_cast<double>(i % 13) * 1e5, static_cast<double>(i % 7) * 0.1,
+                            static_cast<double>(i % 180), static_cast<double>(i % 360), static_cast<double>(i % 90),
+                            static_cast<double>(i) * 0.5, julian_date::from_calendar(2024, 3, 1)});
+    const constellation sats(elements);
+    const auto start = propagate(sats, elements[0].epoch, 60.0, 50);
+    for (std::size_t i = 0; i < elements.size(); i++) {
+        const double a = elements[i].semi_major_axis, e = elements[i].eccentricity;
+        const double h = std::sqrt(wgs84::gm * a * (1.0 - e * e));
+        for (std::size_t s = 0; s < 50; s++) {
+            const std::size_t j = start.index(s, i);
+            const double r[3] = {start.position.x()[j], start.position.y()[j], start.position.z()[j]};
+            const double v[3] = {start.velocity.x()[j], start.velocity.y()[j], start.velocity.z()[j]};
+            const double energy = 0.5 * (v[0] * v[0] + v[1] * v[1] + v[2] * v[2]) -
+                                  wgs84::gm / std::hypot(r[0], r[1], r[2]);
+            assert(near(energy, -wgs84::gm / (2.0 * a), 1e-8 * wgs84::gm / a));
+            assert(near(std::hypot(r[1] * v[2] - r[2] * v[1], r[2] * v[0] - r[0] * v[2], r[0] * v[1] - r[1] * v[0]), h,
+                        1e-8 * h));
+            if (s == 0 && i == 0)
+                assert(near(std::hypot(r[0], r[1], r[2]), a * (1.0 - e), 1e-3));
+        }
+
+        const double period = 2.0 * std::numbers::pi * std::sqrt(a * a * a / wgs84::gm);
+        cartesian_batch<double> position, velocity;
+        const constellation alone(std::vector<keplerian_elements>{elements[i]});
+        propagate(alone, elements[0].epoch + period, position, velocity);
+        for (std::size_t k = 0; k < 3; k++)
+            assert(near(position.column(k)[0], start.position.column(k)[start.index(0, i)], 1e-3));
+    }
+
+    assert(throws([&]() { constellation(std::vector<keplerian_elements>{{7.0e6, 1.2, 0.0, 0.0, 0.0, 0.0, {}}}); }));
+    assert(throws([&]() { constellation(std::vector<keplerian_elements>{{-7.0e6, 0.0, 0.0, 0.0, 0.0, 0.0, {}}}); }));
+}
+
+}
+
+int main() {
+    check_parsing();
+    for (int l = 0; l <= static_cast<int>(simd::detect()); l++) {
+        simd::restrict_to(static_cast<simd::level>(l));
+        check_sgp4_reference();
+        check_batching();
+        check_frames();
+        check_kepler();
+    }
+
+    simd::restrict_to(simd::level::avx512);
+    return 0;
+}
@@ -0,0 +1,246 @@
+#include <map>
+#include <cmath>
+#include <random>
+#include <vector>
+#include <cassert>
+#include <algorithm>
+#include <stdexcept>
+#include "../../include/coords.hpp"
+
+using namespace ccomms;
+
+namespace {
+
+// Live points of an index under test, by id, and the brute force answers to its queries
+struct model {
+    std::map<point_id, std::array<double, 3> > points;
+
+    template<typename D>
+    std::vector<std::pair<double, point_id> > ranked(D &&distance) const {
+        std::vector<std::pair<double, point_id> > result;
+        for (const auto &[id, p]: points)
+            result.emplace_back(distance(p), id);
+        std::sort(result.begin(), result.end());
+        return result;
+    }
+};
+
+template<typename T>
+geodetic<T> random_geodetic(std::mt19937 &gen) {
+    std::uniform_real_distribution<double> z(-1.0, 1.0), lon(-180.0, 180.0);
+    return {static_cast<T>(std::asin(z(gen)) * rad_to_deg), static_cast<T>(lon(gen))};
+}
+
+// The index answers match brute force, allowing points within the rounding of the radius either way
+template<typename T>
+void check_matches(const std::vector<neighbor<T> > &found, const std::vector<std::pair<double, point_id> > &ranked,
+                   const double &radius, const double &tolerance) {
+    std::size_t inside = 0, certain = 0;
+    for (const auto &[d, id]: ranked) {
+        inside += d <= radius + tolerance;
+        certain += d <= radius - tolerance;
+    }
+    assert(found.size() >= certain && found.size() <= inside);
+    for (std::size_t i = 0; i < found.size(); i++) {
+        assert(std::abs(found[i].distance - ranked[i].first) <= tolerance);
+        assert(i == 0 || found[i - 1].distance <= found[i].distance);
+    }
+    for (std::size_t i = 0; i < certain; i++)
+        assert(std::any_of(found.begin(), found.end(), [&](const neighbor<T> &n) { return n.id == ranked[i].second; }));
+}
+
+template<typename T>
+void check_nearest(const std::vector<neighbor<T> > &found, const std::vector<std::pair<double, point_id> > &ranked,
+                   const std::size_t &k, const double &tolerance) {
+    assert(found.size() == std::min(k, ranked.size()));
+    for (std::size_t i = 0; i < found.size(); i++) {
+        assert(std::abs(found[i].distance - ranked[i].first) <= tolerance);
+        assert(found[i].id == ranked[i].second ||
+               (i + 1 < ranked.size() && std::abs(ranked[i].first - ranked[i + 1].first) <= tolerance) ||
+               (i > 0 && std::abs(ranked[i].first - ranked[i - 1].first) <= tolerance));
+    }
+}
+
+template<typename T>
+void check_kd_tree(const double &tolerance) {
+    std::mt19937 gen(7);
+    std::uniform_real_distribution<double> alt(0.0, 2e6);
+    geodetic_batch<T> batch;
+    model live;
+    for (std::size_t i = 0; i < 3000; i++)
+        batch.push_back(random_geodetic<T>(gen), static_cast<T>(i % 4 == 0 ? alt(gen) : 0.0));
+    kd_tree<T> index(batch);
+    const cartesian_batch<T> ecef = geodetic_to_ecef(batch);
+    for (std::size_t i = 0; i < ecef.size(); i++)
+        live.points[i] = {ecef.x()[i], ecef.y()[i], ecef.z()[i]};
+    assert(index.size() == 3000 && index.indexed() == 3000);
+
+    const auto check_queries = [&]() {
+        for (int q = 0; q < 40; q++) {
+            const cartesian<T> p = geodetic_to_ecef(random_geodetic<T>(gen), static_cast<T>(alt(gen) / 4));
+            const auto ranked = live.ranked([&](const std::array<double, 3> &x) {
+                return std::hypot(x[0] - p[0], x[1] - p[1], x[2] - p[2]);
+            });
+            check_nearest(index.nearest(p, 7), ranked, 7, tolerance);
+            check_nearest(index.nearest(p, 1), ranked, 1, tolerance);
+            const double radius = q % 2 ? 5e5 : 2e6;
+            check_matches(index.within(p, static_cast<T>(radius)), ranked, radius, tolerance);
+
+            const cartesian<T> lo(p[0] - T(1e6), p[1] - T(2e6), p[2] - T(1.5e6));
+            const cartesian<T> hi(p[0] + T(1e6), p[1] + T(5e5), p[2] + T(3e6));
+            std::vector<point_id> boxed = index.in_box(lo, hi), expected;
+            for (const auto &[id, x]: live.points)
+                if (x[0] >= lo[0] && x[0] <= hi[0] && x[1] >= lo[1] && x[1] <= hi[1] && x[2] >= lo[2] && x[2] <= hi[2])
+                    expected.push_back(id);
+            std::sort(boxed.begin(), boxed.end());
+            assert(boxed == expected);
+        }
+    };
+    check_queries();
+
+    // A few inserts are scanned directly without a rebuild, and stay correct
+    for (int i = 0; i < 20; i++) {
+        const cartesian<T> p = geodetic_to_ecef(random_geodetic<T>(gen));
+        const point_id id = index.insert(p);
+        assert(id == 3000 + static_cast<point_id>(i));
+        live.points[id] = {p[0], p[1], p[2]};
+    }
+    assert(index.indexed() == 3000 && index.size() == 3020);
+    check_queries();
+
+    // Moving objects: every third point moves, every seventh leaves, through several rebuilds
+    for (point_id id = 0; id < 3020; id++) {
+        if (id % 7 == 0) {
+            assert(index.remove(id) && !index.contains(id) && !index.remove(id));
+            live.points.erase(id);
+        } else if (id % 3 == 0) {
+            const geodetic<T> g = random_geodetic<T>(gen);
+            index.update(id, g, T(1000));
+            const cartesian<T> p = geodetic_to_ecef(g, T(1000));
+            live.points[id] = {p[0], p[1], p[2]};
+            assert(index.point(id)[0] == p[0] && index.point(id)[2] == p[2]);
+        }
+    }
+    assert(index.size() == live.points.size());
+    check_queries();
+    index.rebuild();
+    assert(index.indexed() == index.size());
+    check_queries();
+
+    // Fewer points than asked for, an empty tree, and unknown ids
+    kd_tree<T> small;
+    assert(small.nearest(cartesian<T>(T(0), T(0), T(0)), 3).empty());
+    small.insert(cartesian<T>(T(1), T(2), T(2)));
+    const auto one = small.nearest(cartesian<T>(T(0), T(0), T(0)), 3);
+    assert(one.size() == 1 && one[0].id == 0 && std::abs(one[0].distance - 3) <= tolerance);
+    bool caught_exception = false;
+    try {
+        small.update(5, cartesian<T>(T(0), T(0), T(0)));
+    } catch (const std::invalid_argument &e) {
+        caught_exception = true;
+    }
+    assert(caught_exception);
+}
+
+template<typename T>
+void check_geodetic_grid(const double &cell, const double &tolerance) {
+    std::mt19937 gen(11);
+    geodetic_batch<T> batch;
+    model live;
+    for (std::size_t i = 0; i < 3000; i++) {
+        const geodetic<T> g = random_geodetic<T>(gen);
+        batch.push_back(g, T(0));
+        live.points[i] = {g[0], g[1], 0.0};
+    }
+
+    // Clusters at the poles and on either side of the antimeridian
+    for (std::size_t i = 0; i < 200; i++) {
+        const double offset = static_cast<double>(i) * 0.01;
+        batch.push_back(static_cast<T>(i % 2 ? 89.9 - offset / 10 : -89.9 + offset / 10), static_cast<T>(offset - 1),
+                        T(0));
+        batch.push_back(static_cast<T>(offset - 1), static_cast<T>(i % 2 ? 179.99 - offset : -179.99 + offset), T(0));
+    }
+    for (std::size_t i = 3000; i < batch.size(); i++)
+        live.points[i] = {batch.lat()[i], batch.lon()[i], 0.0};
+    geodetic_grid<T> index(batch, cell);
+    assert(index.size() == batch.size() && index.cell_size() == cell);
+
+    std::vector<geodetic<T> > centers{geodetic<T>(T(89.95), T(0)), geodetic<T>(T(-90), T(120)),
+                                      geodetic<T>(T(0), T(180)), geodetic<T>(T(0.5), T(-179.9)),
+                                      geodetic<T>(T(60), T(179.5))};
+    for (int q = 0; q < 30; q++)
+        centers.push_back(random_geodetic<T>(gen));
+    const auto check_all = [&]() {
+        for (const auto &center: centers) {
+            const auto ranked = live.ranked([&](const std::array<double, 3> &x) {
+                return static_cast<double>(geodesic_distance(center, geodetic<T>(static_cast<T>(x[0]),
+                                                                                 static_cast<T>(x[1])),
+                                                             geodesic_method::haversine));
+            });
+            check_nearest(index.nearest(center, 9), ranked, 9, tolerance * 2e7);
+            for (const double &radius: {5e4, 8e5, 4e6, 2.1e7})
+                check_matches(index.within(center, static_cast<T>(radius)), ranked, radius, tolerance * radius);
+        }
+
+        // Boxes, including one across the antimeridian
+        const std::array<std::array<T, 4>, 3> boxes{{{T(-10), T(-30), T(25), T(40)}, {T(-5), T(170), T(5), T(-170)},
+                                                     {T(80), T(-180), T(90), T(180)}}};
+        for (const auto &b: boxes) {
+            std::vector<point_id> boxed = index.in_box(geodetic<T>(b[0], b[1]), geodetic<T>(b[2], b[3])), expected;
+            for (const auto &[id, x]: live.points) {
+                const bool lon_inside = b[1] <= b[3] ? x[1] >= b[1] && x[1] <= b[3] : x[1] >= b[1] || x[1] <= b[3];
+                if (x[0] >= b[0] && x[0] <= b[2] && lon_inside)
+                    expected.push_back(id);
+            }
+            std::sort(boxed.begin(), boxed.end());
+            assert(boxed == expected);
+        }
+    };
+    check_all();
+
+    // Moving objects through inserts, moves and removals
+    for (point_id id = 0; id < batch.size(); id += 5) {
+        if (id % 2) {
+            index.remove(id);
+            live.points.erase(id);
+        } else {
+            const geodetic<T> g = random_geodetic<T>(gen);
+            index.update(id, g, T(10));
+            live.points[id] = {g[0], g[1], 10.0};
+        }
+    }
+    for (int i = 0; i < 100; i++) {
+        const geodetic<T> g = random_geodetic<T>(gen);
+        live.points[index.insert(g)] = {g[0], g[1], 0.0};
+    }
+    assert(index.size() == live.points.size());
+    check_all();
+    index.rebuild();
+    check_all();
+
+    bool caught_exception = false;
+    try {
+        geodetic_grid<T> invalid(0.0);
+    } catch (const std::invalid_argument &e) {
+        caught_exception = true;
+    }
+    assert(caught_exception);
+    assert(geodetic_grid<T>(2.0).nearest(geodetic<T>(T(0), T(0)), 4).empty());
+}
+
+}
+
+int main() {
+    check_kd_tree<double>(1e-6);
+    check_kd_tree<float>(2.0);
+
+    for (int l = 0; l <= static_cast<int>(simd::detect()); l++) {
+        simd::restrict_to(static_cast<simd::level>(l));
+        check_geodetic_grid<double>(1.0, 1e-12);
+        check_geodetic_grid<double>(7.5, 1e-12);
+        check_geodetic_grid<float>(0.25, 1e-6);
+    }
+
+    simd::restrict_to(simd::level::avx512);
+    return 0;
+}
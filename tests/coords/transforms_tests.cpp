@@ -0,0 +1,128 @@
+#include <cmath>
+#include <vector>
+#include <cassert>
+#include "../../include/coords.hpp"
+
+using namespace ccomms;
+
+bool near(const double &a, const double &b, const double &tol) {
+    return std::abs(a - b) <= tol;
+}
+
+int main() {
+    {
+        // Test geodetic to ECEF at known points
+        auto equator = geodetic_to_ecef(geodetic<double>(0.0, 0.0));
+        assert(near(equator[0], wgs84::a, 1e-6) && near(equator[1], 0, 1e-6) && near(equator[2], 0, 1e-6));
+
+        auto pole = geodetic_to_ecef(geodetic<double>(90.0, 0.0), 100.0);
+        assert(near(pole[0], 0, 1e-6) && near(pole[2], wgs84::b + 100.0, 1e-6));
+
+        auto east = geodetic_to_ecef(geodetic<double>(0.0, 90.0), -50.0);
+        assert(near(east[1], wgs84::a - 50.0, 1e-6) && near(east[0], 0, 1e-6));
+    }
+
+    {
+        // Test the closed-form inverse round trips from below the surface out to geostationary altitude
+        for (double lat = -90; lat <= 90; lat += 7.5)
+            for (double lon = -180; lon <= 180; lon += 22.5)
+                for (const double alt: {-1000.0, 0.0, 1234.5, 400e3, 20200e3, 35786e3}) {
+                    auto ecef = geodetic_to_ecef(geodetic<double>(lat, lon), alt);
+                    double h;
+                    auto back = ecef_to_geodetic(ecef, h);
+                    assert(near(back[0], lat, 1e-9));
+                    if (std::abs(lat) < 90 && std::abs(lon) < 180)
+                        assert(near(back[1], lon, 1e-9));
+                    assert(near(h, alt, 1e-4));
+                }
+    }
+
+    {
+        // Test local frames relative to a reference point
+        geodetic<double> ref(37.0, -122.0);
+        auto above = geodetic_to_ecef(ref, 1000.0);
+        auto enu = ecef_to_enu(above, ref);
+        auto ned = ecef_to_ned(above, ref);
+        assert(near(enu[0], 0, 1e-6) && near(enu[1], 0, 1e-6) && near(enu[2], 1000.0, 1e-6));
+        assert(near(ned[0], 0, 1e-6) && near(ned[1], 0, 1e-6) && near(ned[2], -1000.0, 1e-6));
+
+        auto north = geodetic_to_ecef(geodetic<double>(37.001, -122.0));
+        auto n = ecef_to_enu(north, ref);
+        assert(n[1] > 100 && near(n[0], 0, 1e-6));
+
+        auto back = enu_to_ecef(enu, ref);
+        for (int i = 0; i < 3; i++)
+            assert(near(back[i], above[i], 1e-6));
+    }
+
+    {
+        // Test local cartesian to azimuth, elevation and range
+        double range;
+        auto s = cartesian_to_spherical(cartesian<double>(1.0, 1.0, 0.0), range);
+        assert(near(s[0], 45, 1e-12) && near(s[1], 0, 1e-12) && near(range, std::sqrt(2.0), 1e-12));
+
+        s = cartesian_to_spherical(cartesian<double>(0.0, -1.0, 1.0), range);
+        assert(near(s[0], 180, 1e-12) && near(s[1], 45, 1e-12));
+
+        s = cartesian_to_spherical(cartesian<double>(-1.0, 0.0, 0.0));
+        assert(near(s[0], 270, 1e-12));
+
+        auto c = spherical_to_cartesian(spherical<double>(30.0, 60.0), 2.0);
+        assert(near(c[0], 0.5, 1e-12) && near(c[1], std::sqrt(3.0) / 2, 1e-12) && near(c[2], std::sqrt(3.0), 1e-12));
+    }
+
+    for (int l = 0; l <= static_cast<int>(simd::detect()); l++) {
+        simd::restrict_to(static_cast<simd::level>(l));
+
+        // Test batch conversions agree with the point conversions
+        const std::size_t count = 257;
+        geodetic_batch<double> g;
+        for (std::size_t i = 0; i < count; i++)
+            g.push_back(-80.0 + 0.6 * i, -179.0 + 1.3 * i, 10.0 * (i % 17));
+
+        geodetic<double> ref(-33.9, 151.2);
+        auto ecef = geodetic_to_ecef(g);
+        auto enu = ecef_to_enu(ecef, ref, 50.0);
+        auto ned = ecef_to_ned(ecef, ref, 50.0);
+        auto look = cartesian_to_spherical(enu);
+        auto back_enu = spherical_to_cartesian(look);
+        auto back_ecef = enu_to_ecef(enu, ref, 50.0);
+        auto back = ecef_to_geodetic(back_ecef);
+
+        for (std::size_t i = 0; i < count; i++) {
+            auto p = geodetic_to_ecef(g[i], g.alt()[i]);
+            auto q = ecef_to_enu(p, ref, 50.0);
+            assert(near(ecef.x()[i], p[0], 1e-6) && near(ecef.z()[i], p[2], 1e-6));
+            assert(near(enu.x()[i], q[0], 1e-6) && near(enu.y()[i], q[1], 1e-6) && near(enu.z()[i], q[2], 1e-6));
+            assert(near(ned.x()[i], q[1], 1e-6) && near(ned.y()[i], q[0], 1e-6) && near(ned.z()[i], -q[2], 1e-6));
+
+            double range;
+            auto s = cartesian_to_spherical(q, range);
+            assert(near(look.az()[i], s[0], 1e-9) && near(look.el()[i], s[1], 1e-9));
+            assert(near(look.range()[i], range, 1e-6));
+            assert(near(back_enu.x()[i], q[0], 1e-6) && near(back_enu.z()[i], q[2], 1e-6));
+
+            assert(near(back.lat()[i], g.lat()[i], 1e-9) && near(back.lon()[i], g.lon()[i], 1e-9));
+            assert(near(back.alt()[i], g.alt()[i], 1e-4));
+        }
+
+        // Test azimuths just west of north stay below 360
+        for (const double &west: {-1e-300, -1e-14}) {
+            double range;
+            const auto s = cartesian_to_spherical(cartesian<double>(west, 1.0, 0.0), range);
+            assert(s[0] >= 0.0 && s[0] < 360.0);
+            const auto f = cartesian_to_spherical(cartesian<float>(static_cast<float>(west), 1.0f, 0.0f));
+            assert(f[0] >= 0.0f && f[0] < 360.0f);
+        }
+        assert(wrap_azimuth(-1e-14) == 0.0 && wrap_azimuth(-90.0) == 270.0 && wrap_azimuth(359.5) == 359.5);
+
+        // Test single precision batches
+        geodetic_batch<float> gf;
+        gf.push_back(10.0f, 20.0f, 0.0f);
+        auto ef = ecef_to_enu(geodetic_to_ecef(gf), geodetic<float>(10.0f, 20.0f));
+        assert(std::abs(ef.z()[0]) < 1.0f);
+    }
+
+    simd::restrict_to(simd::level::avx512);
+    return 0;
+}
@@ -0,0 +1,181 @@
+#include <cmath>
+#include <limits>
+#include <string>
+#include <vector>
+#include <cassert>
+#include <numbers>
+#include <stdexcept>
+#include "../../include/coords.hpp"
+
+using namespace ccomms;
+
+namespace {
+
+// Satellites over several planes and inclinations from the elements of catalog number 6251
+std::vector<two_line_element> sample_tles(const std::size_t &len) {
+    const two_line_element base = parse_tle("1 06251U 62025E   06176.82412014  .00008885  00000-0  12808-3 0  3985",
+                                            "2 06251  58.0579  54.0425 0030035 139.1568 221.1854 15.56387291  6774");
+    const double inclinations[4] = {20.0, 58.0579, 85.0, 97.5};
+    std::vector<two_line_element> result(len, base);
+    for (std::size_t i = 0; i < len; i++) {
+        result[i].inclination = inclinations[i % 4];
+        result[i].raan = std::fmod(static_cast<double>(i) * 47.0, 360.0);
+        result[i].mean_anomaly = std::fmod(static_cast<double>(i) * 71.3, 360.0);
+        result[i].mean_motion = 14.2 + static_cast<double>(i % 7) * 0.2;
+    }
+    return result;
+}
+
+template<typename T>
+geodetic_batch<T> sample_stations() {
+    geodetic_batch<T> result;
+    result.push_back(T(0), T(0), T(0));
+    result.push_back(T(-37.95), T(144.42), T(50));
+    result.push_back(T(78.23), T(15.39), T(450));
+    result.push_back(T(64.8), T(-147.7), T(200));
+    result.push_back(T(-89.5), T(10), T(2800));
+    result.push_back(T(33.1), T(-179.9), T(0));
+    return result;
+}
+
+double seconds(const julian_date &time, const julian_date &start) {
+    return time.days_since(start) * 86400.0;
+}
+
+// Runs of whole seconds at or above the mask from the elevation of every state of a one second ephemeris, against
+// the windows found from trajectories over the same span. Windows too short to hold a whole second are passed over.
+template<typename T>
+void check_against_samples(const std::vector<access_window> &windows, const geodetic_batch<T> &stations,
+                           const ephemeris<T> &dense, const double &mask, const double &tolerance) {
+    const double end = static_cast<double>(dense.steps - 1) * dense.step;
+    std::size_t matched = 0, runs = 0;
+    for (std::size_t j = 0; j < stations.size(); j++) {
+        const spherical_batch<T> look = cartesian_to_spherical(ecef_to_enu(dense.position, stations[j],
+                                                                           stations.alt()[j]));
+        for (std::size_t i = 0; i < dense.satellites; i++) {
+            std::vector<access_window> pair;
+            for (const auto &w: windows)
+                if (w.station == j && w.satellite == i)
+                    pair.push_back(w);
+
+            std::size_t next = 0;
+            for (std::size_t s = 0; s < dense.steps; s++) {
+                if (!(look.el()[dense.index(s, i)] >= mask))
+                    continue;
+                std::size_t last = s;
+                while (last + 1 < dense.steps && look.el()[dense.index(last + 1, i)] >= mask)
+                    last++;
+                runs++;
+                while (next < pair.size() && std::ceil(seconds(pair[next].rise, dense.start) - tolerance) >
+                                             std::floor(seconds(pair[next].set, dense.start) + tolerance))
+                    next++;
+                assert(next < pair.size());
+                const double rise = seconds(pair[next].rise, dense.start), set = seconds(pair[next].set, dense.start);
+                const auto up = static_cast<double>(s), down = static_cast<double>(last);
+                assert(s == 0 ? std::abs(rise) <= 1e-6 : rise > up - 1.0 - tolerance && rise <= up + tolerance);
+                assert(last + 1 == dense.steps ? std::abs(set - end) <= 1e-6 :
+                       set >= down - tolerance && set < down + 1.0 + tolerance);
+                next++;
+                matched++;
+                s = last;
+            }
+            for (; next < pair.size(); next++)
+                assert(std::ceil(seconds(pair[next].rise, dense.start) - tolerance) >
+                       std::floor(seconds(pair[next].set, dense.start) + tolerance));
+        }
+    }
+    assert(matched == runs && runs > 50);
+}
+
+void check_brent() {
+    const double root = brent_root([](const double &x) { return std::cos(x); }, 0.0, 3.0, 1.0, std::cos(3.0), 1e-12);
+    assert(std::abs(root - std::numbers::pi / 2.0) <= 1e-12);
+    const double cubic = brent_root([](const double &x) { return x * x * x - 2.0; }, 2.0, 0.0, 6.0, -2.0, 1e-9);
+    assert(std::abs(cubic - std::cbrt(2.0)) <= 1e-9);
+}
+
+template<typename T>
+void check_windows(const double &tolerance) {
+    const auto tles = sample_tles(40);
+    const constellation sats(tles);
+    const julian_date start = tles[0].epoch + 1800.0;
+    const geodetic_batch<T> stations = sample_stations<T>();
+    const auto dense = propagate<T>(sats, start, 1.0, 6 * 3600 + 1, orbit_frame::ecef);
+    const auto coarse = propagate<T>(sats, start, 60.0, 6 * 60 + 1, orbit_frame::ecef);
+
+    for (const double &mask: {0.0, 10.0}) {
+        const auto windows = access_windows(stations, coarse, mask);
+        check_against_samples(windows, stations, dense, mask, tolerance);
+        for (std::size_t i = 1; i < windows.size(); i++)
+            assert(windows[i - 1].rise.days_since(windows[i].rise) <= 0.0);
+        for (const auto &w: windows)
+            assert(w.set.days_since(w.rise) >= 0.0);
+
+        // The dense trajectories give the same windows, as do a single thread and coarse sampling
+        const auto from_dense = access_windows(execution::par, stations, dense, mask, 60.0);
+        check_against_samples(from_dense, stations, dense, mask, tolerance);
+        const auto serial = access_windows(execution::seq, stations, coarse, mask);
+        assert(serial.size() == windows.size());
+        for (std::size_t i = 0; i < windows.size(); i++)
+            assert(serial[i].station == windows[i].station && serial[i].satellite == windows[i].satellite &&
+                   serial[i].rise.days_since(windows[i].rise) == 0.0 &&
+                   serial[i].set.days_since(windows[i].set) == 0.0);
+        const auto sparse = access_windows(stations, coarse, mask, 150.0);
+        check_against_samples(sparse, stations, dense, mask, tolerance);
+    }
+
+    // Satellites with states that are not finite have no windows
+    auto decayed = coarse;
+    decayed.position.x()[decayed.index(100, 3)] = std::numeric_limits<T>::quiet_NaN();
+    for (const auto &w: access_windows(stations, decayed, 0.0))
+        assert(w.satellite != 3);
+
+    // Empty inputs and invalid arguments
+    assert(access_windows(geodetic_batch<T>(), coarse, 10.0).empty());
+    const auto invalid = [&](const auto &f) {
+        try {
+            f();
+        } catch (const std::invalid_argument &e) {
+            return true;
+        }
+        return false;
+    };
+    assert(invalid([&]() { access_windows(stations, coarse, 10.0, 0.0); }));
+    assert(invalid([&]() { access_windows(stations, coarse, 10.0, 60.0, -1.0); }));
+    auto truncated = coarse;
+    truncated.steps++;
+    assert(invalid([&]() { access_windows(stations, truncated, 10.0); }));
+}
+
+// A geostationary satellite stays over one side of the earth: always in view below it and never from the far side
+void check_geostationary() {
+    const julian_date start = julian_date::from_calendar(2024, 3, 20, 12);
+    keplerian_elements geo;
+    geo.semi_major_axis = std::cbrt(wgs84::gm / (wgs84::rotation_rate * wgs84::rotation_rate));
+    geo.epoch = start;
+    const constellation sats(std::vector<keplerian_elements>{geo});
+    const auto trajectory = propagate(sats, start, 300.0, 289, orbit_frame::ecef);
+    const double lon = std::atan2(trajectory.position.y()[0], trajectory.position.x()[0]) * rad_to_deg;
+
+    geodetic_batch<double> stations;
+    stations.push_back(10.0, wrap_longitude(lon + 20.0), 0.0);
+    stations.push_back(-5.0, wrap_longitude(lon + 180.0), 0.0);
+    const auto windows = access_windows(stations, trajectory, 5.0);
+    assert(windows.size() == 1 && windows[0].station == 0 && windows[0].satellite == 0);
+    assert(windows[0].rise.days_since(start) == 0.0 && std::abs(windows[0].set.days_since(start) - 1.0) <= 1e-12);
+
+    // A single instant is a window of no length when in view
+    const auto instant = propagate(sats, start, 0.0, 1, orbit_frame::ecef);
+    const auto now = access_windows(stations, instant, 5.0);
+    assert(now.size() == 1 && now[0].station == 0 && now[0].set.days_since(now[0].rise) == 0.0);
+}
+
+}
+
+int main() {
+    check_brent();
+    check_geostationary();
+    check_windows<double>(1e-2);
+    check_windows<float>(0.5);
+    return 0;
+}
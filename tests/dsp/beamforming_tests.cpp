@@ -0,0 +1,221 @@
+#include <cmath>
+#include <random>
+#include <cassert>
+#include <complex>
+#include <numbers>
+#include <stdexcept>
+#include "../../include/dsp.hpp"
+#include "../../include/coords.hpp"
+#include "../../include/tensor.hpp"
+
+using namespace ccomms;
+
+namespace {
+
+// Uniform rectangular array in the east-north plane with the given spacing in meters
+template<typename T>
+cartesian_batch<T> grid_array(const std::size_t &columns, const std::size_t &rows, const T &spacing) {
+    cartesian_batch<T> positions;
+    for (std::size_t r = 0; r < rows; r++)
+        for (std::size_t c = 0; c < columns; c++)
+            positions.push_back(static_cast<T>(c) * spacing, static_cast<T>(r) * spacing, T(0));
+    return positions;
+}
+
+// Steering vector straight from the definition, in double precision
+template<typename T>
+std::vector<std::complex<double> > reference_steering(const cartesian_batch<T> &positions, const double &wavelength,
+                                                      const double &az, const double &el) {
+    const double a = az * deg_to_rad, e = el * deg_to_rad;
+    const double de = std::cos(e) * std::sin(a), dn = std::cos(e) * std::cos(a), du = std::sin(e);
+    std::vector<std::complex<double> > result;
+    for (std::size_t i = 0; i < positions.size(); i++) {
+        const double phase = 2 * std::numbers::pi / wavelength *
+                             (positions.x()[i] * de + positions.y()[i] * dn + positions.z()[i] * du);
+        result.push_back(std::exp(std::complex<double>(0, phase)));
+    }
+    return result;
+}
+
+template<typename T>
+std::complex<double> response(const vector<std::complex<T> > &w, const std::vector<std::complex<double> > &a) {
+    std::complex<double> sum(0);
+    for (std::size_t i = 0; i < a.size(); i++)
+        sum += std::conj(std::complex<double>(w[i])) * a[i];
+    return sum;
+}
+
+template<typename T>
+void check_steering(const double &tolerance) {
+    cartesian_batch<T> positions = grid_array<T>(5, 4, T(0.3));
+    positions.push_back(T(-0.7), T(0.2), T(1.1));
+    const T wavelength = T(0.6);
+    dsp::antenna_array<T> array(positions, wavelength);
+    assert(array.size() == 21 && array.wavelength() == wavelength);
+
+    spherical_batch<T> directions;
+    for (int d = 0; d < 37; d++)
+        directions.push_back(static_cast<T>(d * 10 % 360), static_cast<T>(-90 + d * 5), T(1));
+    const matrix<std::complex<T> > a = array.steering(directions);
+    assert(a.rows() == directions.size() && a.cols() == array.size());
+
+    for (std::size_t d = 0; d < directions.size(); d++) {
+        const auto expected = reference_steering(positions, wavelength, directions.az()[d], directions.el()[d]);
+        for (std::size_t i = 0; i < array.size(); i++)
+            assert(std::abs(std::complex<double>(a(d, i)) - expected[i]) < tolerance);
+    }
+
+    // The single direction overload agrees with the batch
+    const vector<std::complex<T> > single = array.steering(directions[7]);
+    for (std::size_t i = 0; i < array.size(); i++)
+        assert(single[i] == a(7, i));
+}
+
+}
+
+int main() {
+    {
+        // Test steering vectors against the definition
+        check_steering<float>(1e-5);
+        check_steering<double>(1e-12);
+    }
+
+    {
+        // Test conventional weights have unit gain towards their direction and match the batch overload
+        dsp::antenna_array<double> array(grid_array<double>(8, 8, 0.5), 1.0);
+        const spherical<double> look(30.0, 20.0);
+        const vector<std::complex<double> > w = array.conventional_weights(look);
+        const auto a = reference_steering(grid_array<double>(8, 8, 0.5), 1.0, 30, 20);
+        assert(std::abs(response(w, a) - 1.0) < 1e-12);
+
+        spherical_batch<double> looks;
+        looks.push_back(look);
+        const matrix<std::complex<double> > batch = array.conventional_weights(looks);
+        for (std::size_t i = 0; i < array.size(); i++)
+            assert(std::abs(batch(0, i) - w[i]) < 1e-15);
+    }
+
+    {
+        // Test MVDR weights keep unit gain towards the look direction and null a strong interferer
+        const cartesian_batch<double> positions = grid_array<double>(6, 1, 0.5);
+        dsp::antenna_array<double> array(positions, 1.0);
+        const auto jammer = reference_steering(positions, 1.0, 60, 0);
+
+        const std::size_t k = array.size();
+        matrix<std::complex<double> > covariance(k, k);
+        for (std::size_t i = 0; i < k; i++)
+            for (std::size_t j = 0; j < k; j++)
+                covariance(i, j) = 1000.0 * jammer[i] * std::conj(jammer[j]) + (i == j ? 1.0 : 0.0);
+
+        const spherical<double> look(0.0, 0.0);
+        const vector<std::complex<double> > w = array.mvdr_weights(covariance, look);
+        assert(std::abs(response(w, reference_steering(positions, 1.0, 0, 0)) - 1.0) < 1e-9);
+        assert(std::abs(response(w, jammer)) < 1e-2);
+
+        const vector<std::complex<double> > conventional = array.conventional_weights(look);
+        assert(std::abs(response(conventional, jammer)) > 0.1);
+
+        // With white noise only MVDR reduces to the conventional beam, and loading does not move it
+        matrix<std::complex<double> > identity(k, k);
+        for (std::size_t i = 0; i < k; i++)
+            identity(i, i) = 1.0;
+        spherical_batch<double> looks;
+        looks.push_back(look);
+        looks.push_back(10.0, 5.0, 1.0);
+        const matrix<std::complex<double> > white = array.mvdr_weights(identity, looks, 0.5);
+        const matrix<std::complex<double> > delay_and_sum = array.conventional_weights(looks);
+        for (std::size_t d = 0; d < 2; d++)
+            for (std::size_t i = 0; i < k; i++)
+                assert(std::abs(white(d, i) - delay_and_sum(d, i)) < 1e-12);
+
+        bool caught_exception = false;
+        try {
+            array.mvdr_weights(matrix<std::complex<double> >(k, k), look);
+        } catch (const std::invalid_argument &e) {
+            caught_exception = true;
+        }
+        assert(caught_exception);
+    }
+
+    {
+        // Test beamforming passes a plane wave from the look direction and matches w^H X
+        const cartesian_batch<float> positions = grid_array<float>(4, 4, 0.5f);
+        dsp::antenna_array<float> array(positions, 1.0f);
+        const auto a = reference_steering(positions, 1.0, 45, 30);
+        const std::size_t samples = 50;
+
+        std::mt19937 gen(4);
+        std::normal_distribution<float> dist;
+        matrix<std::complex<float> > snapshots(array.size(), samples);
+        std::vector<std::complex<float> > signal(samples);
+        for (std::size_t t = 0; t < samples; t++) {
+            signal[t] = std::complex<float>(dist(gen), dist(gen));
+            for (std::size_t i = 0; i < array.size(); i++)
+                snapshots(i, t) = std::complex<float>(a[i]) * signal[t];
+        }
+
+        const vector<std::complex<float> > w = array.conventional_weights(spherical<float>(45.0f, 30.0f));
+        const vector<std::complex<float> > y = array.beamform(w, snapshots);
+        assert(y.size() == samples);
+        for (std::size_t t = 0; t < samples; t++)
+            assert(std::abs(y[t] - signal[t]) < 1e-4f * (1 + std::abs(signal[t])));
+    }
+
+    {
+        // Test the pattern against the response of the reference steering vectors, under every policy
+        const cartesian_batch<float> positions = grid_array<float>(8, 8, 0.5f);
+        dsp::antenna_array<float> array(positions, 1.0f);
+        const vector<std::complex<float> > w = array.conventional_weights(spherical<float>(120.0f, 40.0f));
+
+        vector<float> az(72, 0.0f), el(19, 0.0f);
+        for (std::size_t i = 0; i < az.size(); i++)
+            az[i] = 5.0f * static_cast<float>(i);
+        for (std::size_t i = 0; i < el.size(); i++)
+            el[i] = -90.0f + 10.0f * static_cast<float>(i);
+
+        const matrix<float> p = array.pattern(w, az, el);
+        assert(p.rows() == el.size() && p.cols() == az.size());
+        for (std::size_t r = 0; r < el.size(); r++)
+            for (std::size_t c = 0; c < az.size(); c++) {
+                const double expected = std::norm(response(w, reference_steering(positions, 1.0, az[c], el[r])));
+                assert(std::abs(p(r, c) - expected) < 1e-4);
+            }
+        assert(std::abs(p(13, 24) - 1.0f) < 1e-4f);
+
+        execution::thread_pool two(2);
+        const matrix<float> sequential = array.pattern(execution::seq, w, az, el);
+        const matrix<float> pooled = array.pattern(execution::par.on(two), w, az, el);
+        for (std::size_t i = 0; i < el.size() * az.size(); i++)
+            assert(sequential.data()[i] == p.data()[i] && pooled.data()[i] == p.data()[i]);
+    }
+
+    {
+        // Test invalid arrays and weights are rejected
+        bool caught_exception = false;
+        try {
+            dsp::antenna_array<float> array(cartesian_batch<float>(), 1.0f);
+        } catch (const std::invalid_argument &e) {
+            caught_exception = true;
+        }
+        assert(caught_exception);
+
+        caught_exception = false;
+        try {
+            dsp::antenna_array<float> array(grid_array<float>(2, 2, 0.5f), 0.0f);
+        } catch (const std::invalid_argument &e) {
+            caught_exception = true;
+        }
+        assert(caught_exception);
+
+        dsp::antenna_array<float> array(grid_array<float>(2, 2, 0.5f), 1.0f);
+        caught_exception = false;
+        try {
+            array.beamform(vector<std::complex<float> >(3, std::complex<float>(0)), matrix<std::complex<float> >(4, 8));
+        } catch (const std::invalid_argument &e) {
+            caught_exception = true;
+        }
+        assert(caught_exception);
+    }
+
+    return 0;
+}
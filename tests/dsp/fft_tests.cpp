@@ -0,0 +1,161 @@
+#include <cmath>
+#include <array>
+#include <vector>
+#include <complex>
+#include <cassert>
+#include <numbers>
+#include <stdexcept>
+#include "../../include/dsp.hpp"
+
+using namespace ccomms;
+
+template<typename T>
+std::vector<std::complex<T> > reference_dft(const std::vector<std::complex<T> > &x, const bool &inverse = false) {
+    const std::size_t n = x.size();
+    std::vector<std::complex<T> > result(n);
+    for (std::size_t k = 0; k < n; k++) {
+        std::complex<long double> sum = 0;
+        for (std::size_t j = 0; j < n; j++) {
+            const long double angle = (inverse ? 2 : -2) * std::numbers::pi_v<long double> *
+                                      static_cast<long double>((j * k) % n) / static_cast<long double>(n);
+            sum += std::complex<long double>(x[j].real(), x[j].imag()) *
+                   std::complex<long double>(std::cos(angle), std::sin(angle));
+        }
+        if (inverse)
+            sum /= static_cast<long double>(n);
+        result[k] = {static_cast<T>(sum.real()), static_cast<T>(sum.imag())};
+    }
+    return result;
+}
+
+template<typename T>
+std::vector<std::complex<T> > signal(const std::size_t &n) {
+    std::vector<std::complex<T> > x(n);
+    for (std::size_t i = 0; i < n; i++)
+        x[i] = {static_cast<T>(std::sin(0.37 * static_cast<double>(i)) + 0.1 * static_cast<double>(i % 5)),
+                static_cast<T>(std::cos(1.3 * static_cast<double>(i)))};
+    return x;
+}
+
+template<typename A, typename B>
+double max_error(const A &a, const B &b) {
+    double error = 0;
+    for (std::size_t i = 0; i < a.size(); i++)
+        error = std::max(error, static_cast<double>(std::abs(a[i] - b[i])));
+    return error;
+}
+
+template<typename T>
+void check_lengths(const double &tolerance) {
+    for (std::size_t n: {1, 2, 3, 4, 5, 6, 8, 12, 15, 16, 30, 32, 45, 64, 97, 100, 128, 210, 256, 1000, 1024}) {
+        const auto x = signal<T>(n);
+        const auto expected = reference_dft(x);
+        const double scale = std::sqrt(static_cast<double>(n));
+
+        vector<std::complex<T> > spectrum = dsp::fft(x);
+        assert(spectrum.size() == n);
+        assert(max_error(spectrum, expected) < tolerance * scale);
+
+        vector<std::complex<T> > restored = dsp::ifft(spectrum);
+        assert(max_error(restored, x) < tolerance);
+        assert(max_error(restored, reference_dft(expected, true)) < tolerance);
+    }
+}
+
+int main() {
+    {
+        // Test mixed radix transforms against a direct DFT
+        check_lengths<float>(1e-4);
+        check_lengths<double>(1e-11);
+
+        assert((dsp::fft_plan<float>(64).radices() == std::vector<std::size_t>{4, 4, 4}));
+        assert((dsp::fft_plan<float>(96).radices() == std::vector<std::size_t>{4, 4, 2, 3}));
+        assert((dsp::fft_plan<double>(35).radices() == std::vector<std::size_t>{5, 7}));
+        assert(dsp::fft_plan<float>::cached(48) == dsp::fft_plan<float>::cached(48));
+    }
+
+    {
+        // Test every instruction set gives the same spectrum as the scalar butterflies
+        const auto x = signal<float>(4096);
+        simd::restrict_to(simd::level::scalar);
+        const vector<std::complex<float> > expected = dsp::fft(x);
+        for (auto level: {simd::level::sse2, simd::level::avx2, simd::level::avx512}) {
+            simd::restrict_to(level);
+            assert(max_error(dsp::fft(x), expected) < 1e-3);
+            assert(max_error(dsp::ifft(dsp::fft(x)), x) < 1e-5);
+        }
+        simd::restrict_to(simd::level::avx512);
+    }
+
+    {
+        // Test in-place and out-of-place transforms on vectors and views
+        for (std::size_t n: {8, 16, 24, 48, 128}) {
+            const auto x = signal<float>(n);
+            const vector<std::complex<float> > expected = dsp::fft(x);
+
+            std::vector<std::complex<float> > buffer(x);
+            dsp::fft_in_place(vector_view<std::complex<float> >(buffer));
+            assert(max_error(buffer, expected) < 1e-4);
+            dsp::ifft_in_place(buffer);
+            assert(max_error(buffer, x) < 1e-5);
+
+            vector<std::complex<float> > out(n, std::complex<float>(0));
+            dsp::fft(vector_view<const std::complex<float> >(x), out);
+            assert(max_error(out, expected) < 1e-4);
+        }
+
+        vector<std::complex<double>, 8> fixed(8, std::complex<double>(1, 0));
+        auto impulse = dsp::fft(fixed);
+        static_assert(std::is_same_v<decltype(impulse), vector<std::complex<double>, 8> >);
+        assert(std::abs(impulse[0] - std::complex<double>(8, 0)) < 1e-12 && std::abs(impulse[3]) < 1e-12);
+
+        bool caught_exception = false;
+        try {
+            vector<std::complex<float> > wrong(3, std::complex<float>(0));
+            dsp::fft(signal<float>(4), wrong);
+        } catch (const std::invalid_argument &e) {
+            caught_exception = true;
+        }
+        assert(caught_exception);
+    }
+
+    {
+        // Test real input transforms against the complex transform, for even and odd lengths
+        for (std::size_t n: {1, 2, 3, 4, 7, 10, 16, 33, 64, 90, 1024}) {
+            std::vector<double> x(n);
+            std::vector<std::complex<double> > promoted(n);
+            for (std::size_t i = 0; i < n; i++) {
+                x[i] = std::sin(0.21 * static_cast<double>(i * i)) + 0.5;
+                promoted[i] = x[i];
+            }
+
+            const auto spectrum = dsp::rfft(x);
+            const auto expected = reference_dft(promoted);
+            assert(spectrum.size() == n / 2 + 1);
+            for (std::size_t k = 0; k < spectrum.size(); k++)
+                assert(std::abs(spectrum[k] - expected[k]) < 1e-10 * std::sqrt(static_cast<double>(n)));
+
+            const auto restored = dsp::irfft(spectrum, n);
+            assert(restored.size() == n);
+            for (std::size_t i = 0; i < n; i++)
+                assert(std::abs(restored[i] - x[i]) < 1e-12);
+        }
+
+        std::array<float, 16> tone{};
+        for (std::size_t i = 0; i < tone.size(); i++)
+            tone[i] = static_cast<float>(std::cos(2 * std::numbers::pi * 3 * static_cast<double>(i) / 16));
+        auto bins = dsp::rfft(vector_view<float, 16>(tone));
+        static_assert(std::is_same_v<decltype(bins), vector<std::complex<float>, 9> >);
+        assert(std::abs(bins[3] - std::complex<float>(8, 0)) < 1e-4f && std::abs(bins[2]) < 1e-4f);
+
+        bool caught_exception = false;
+        try {
+            dsp::irfft(vector<std::complex<float> >(4, std::complex<float>(0)), 10);
+        } catch (const std::invalid_argument &e) {
+            caught_exception = true;
+        }
+        assert(caught_exception);
+    }
+
+    return 0;
+}
@@ -0,0 +1,145 @@
+#include <cmath>
+#include <vector>
+#include <complex>
+#include <cassert>
+#include <stdexcept>
+#include "../../include/dsp.hpp"
+
+using namespace ccomms;
+
+// Direct form reference: upsample by zero stuffing, convolve, keep every down-th sample
+template<typename S, typename C>
+std::vector<std::complex<double> > reference(const std::vector<S> &x, const std::vector<C> &h, const std::size_t &up,
+                                             const std::size_t &down) {
+    std::vector<std::complex<double> > stuffed(x.size() * up, 0), result;
+    for (std::size_t i = 0; i < x.size(); i++)
+        stuffed[i * up] = x[i];
+    for (std::size_t u = 0; u < stuffed.size(); u += down) {
+        std::complex<double> sum = 0;
+        for (std::size_t k = 0; k < h.size() && k <= u; k++)
+            sum += std::complex<double>(h[k]) * stuffed[u - k];
+        result.push_back(sum);
+    }
+    return result;
+}
+
+template<typename S>
+std::vector<S> samples(const std::size_t &n) {
+    std::vector<S> x(n);
+    for (std::size_t i = 0; i < n; i++) {
+        const double t = static_cast<double>(i);
+        if constexpr (is_complex_v<S>)
+            x[i] = S(static_cast<float>(std::sin(0.05 * t)), static_cast<float>(std::cos(0.11 * t)));
+        else
+            x[i] = static_cast<S>(std::sin(0.05 * t) + 0.25 * std::sin(1.7 * t));
+    }
+    return x;
+}
+
+template<typename C>
+std::vector<C> taps(const std::size_t &n) {
+    std::vector<C> h(n);
+    for (std::size_t k = 0; k < n; k++) {
+        const double v = 1.0 / static_cast<double>(k + 1);
+        if constexpr (is_complex_v<C>)
+            h[k] = C(static_cast<float>(v), static_cast<float>(0.5 * v));
+        else
+            h[k] = static_cast<C>(v);
+    }
+    return h;
+}
+
+// Feeds x in uneven blocks and checks the concatenated output against the reference
+template<typename S, typename C>
+void check_stream(const std::size_t &ntaps, const std::size_t &up, const std::size_t &down, const std::size_t &block) {
+    const auto x = samples<S>(1000);
+    const auto h = taps<C>(ntaps);
+    const auto expected = reference(x, h, up, down);
+
+    dsp::resampler<S, C> filter(vector<C>(h), up, down, block);
+    assert(filter.output_size(x.size()) == expected.size());
+
+    std::vector<std::complex<double> > produced;
+    const std::size_t pieces[] = {1, 7, 64, 3, 250, 1, 500};
+    std::size_t first = 0;
+    for (std::size_t i = 0; first < x.size(); i++) {
+        const std::size_t len = std::min(pieces[i % 7], x.size() - first);
+        std::vector<S> chunk(x.begin() + static_cast<long>(first), x.begin() + static_cast<long>(first + len));
+        for (const auto &y: filter.process(chunk))
+            produced.emplace_back(y);
+        first += len;
+    }
+
+    assert(produced.size() == expected.size());
+    for (std::size_t i = 0; i < expected.size(); i++)
+        assert(std::abs(produced[i] - expected[i]) < 1e-4 * (1 + std::abs(expected[i])));
+}
+
+int main() {
+    {
+        // Test streaming filtering, decimation, interpolation and rational resampling against direct convolution
+        for (std::size_t block: {16, 1024}) {
+            check_stream<float, float>(31, 1, 1, block);
+            check_stream<double, double>(64, 1, 1, block);
+            check_stream<float, float>(33, 1, 4, block);
+            check_stream<float, float>(32, 3, 1, block);
+            check_stream<float, float>(48, 3, 2, block);
+            check_stream<double, double>(17, 2, 7, block);
+        }
+
+        // Complex samples and taps in every combination
+        check_stream<std::complex<float>, float>(24, 1, 3, 64);
+        check_stream<std::complex<float>, std::complex<float> >(24, 2, 3, 64);
+        check_stream<float, std::complex<float> >(15, 1, 1, 64);
+        check_stream<std::complex<double>, std::complex<double> >(40, 5, 4, 64);
+    }
+
+    {
+        // Test the convenience classes, output buffers, views and reset
+        dsp::fir_filter<float> smoother(vector<float>{0.25f, 0.5f, 0.25f});
+        vector<float> impulse(5, 0.0f);
+        impulse[0] = 1.0f;
+        vector<float> response = smoother.process(impulse);
+        assert(response.size() == 5 && response[0] == 0.25f && response[1] == 0.5f && response[2] == 0.25f);
+        assert(response[3] == 0.0f);
+
+        // History carries over: a second impulse overlapping the first call's tail
+        std::vector<float> out(5, -1.0f);
+        assert(smoother.process(std::vector<float>{1, 0}, vector_view<float>(out)) == 2);
+        assert(out[0] == 0.25f && out[1] == 0.5f && out[2] == -1.0f);
+
+        smoother.reset();
+        std::vector<float> interleaved{1, 9, 0, 9, 0, 9};
+        vector<float> strided = smoother.process(strided_view<float>(interleaved.data(), 3, 2));
+        assert(strided.size() == 3 && strided[0] == 0.25f && strided[2] == 0.25f);
+
+        dsp::decimator<std::complex<float> > ddc(vector<float>(8, 0.125f), 4);
+        assert(ddc.output_size(10) == 3);
+        assert(ddc.process(vector<std::complex<float> >(10, std::complex<float>(1, 1))).size() == 3);
+        assert(ddc.output_size(2) == 0 && ddc.output_size(3) == 1);
+
+        dsp::interpolator<double> upsampler(vector<double>{1.0, 1.0, 1.0}, 3);
+        vector<double> held = upsampler.process(vector<double>{2.0, 4.0});
+        assert(held.size() == 6 && held[0] == 2 && held[2] == 2 && held[3] == 4);
+        assert(upsampler.up() == 3 && upsampler.down() == 1 && upsampler.taps().size() == 3);
+
+        bool caught_exception = false;
+        try {
+            vector<float> small(1, 0.0f);
+            smoother.process(vector<float>(3, 1.0f), small);
+        } catch (const std::invalid_argument &e) {
+            caught_exception = true;
+        }
+        assert(caught_exception);
+
+        caught_exception = false;
+        try {
+            dsp::resampler<float> broken(vector<float>(4, 1.0f), 0, 1);
+        } catch (const std::invalid_argument &e) {
+            caught_exception = true;
+        }
+        assert(caught_exception);
+    }
+
+    return 0;
+}
@@ -0,0 +1,202 @@
+#include <string>
+#include <vector>
+#include <complex>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <filesystem>
+#include "../../include/io.hpp"
+
+using namespace ccomms;
+
+int main() {
+    const std::string path = (std::filesystem::temp_directory_path() / "ccomms_binary_tests.bin").string();
+
+    {
+        // Test vectors, views and batches round trip through a mapped file
+        vector<float> samples(1000, 0.0f, 'r');
+        for (std::size_t i = 0; i < samples.size(); i++)
+            samples[i] = static_cast<float>(i) * 0.5f;
+
+        std::vector<double> interleaved{1, 10, 2, 20, 3, 30};
+        strided_view<double> odd(interleaved.data() + 1, 3, 2);
+
+        cartesian_batch<double> points;
+        points.push_back(1, 2, 3);
+        points.push_back(4, 5, 6);
+
+        geodetic_batch<double> sites;
+        sites.push_back(45, -75, 100);
+
+        vector<std::complex<float> > iq{std::complex<float>(1, -1), std::complex<float>(2, -2)};
+
+        io::writer out(path);
+        out.write("samples", samples).write("odd", odd).write("points", points).write("sites", sites);
+        out.write("iq", iq).flush();
+
+        io::mapped_file file(path);
+        assert(file.size() == 5 && file.complete_size() == std::filesystem::file_size(path));
+        assert(file[0].name == "samples" && file[0].type == io::dtype::float32 && file[0].orientation == 'r');
+
+        auto view = file.view<float>("samples");
+        assert(view.size() == 1000 && view[999] == 499.5f);
+        assert(reinterpret_cast<std::uintptr_t>(view.data()) % io::alignment == 0);
+        assert((view | view) == (samples | samples));
+
+        vector<float> loaded = file.load<float>("samples");
+        assert(loaded.row_vector() && loaded[10] == 5.0f);
+
+        auto odd_view = file.view<double>("odd");
+        assert(odd_view.size() == 3 && odd_view[2] == 30);
+
+        auto columns = file.columns<double, 3>("points");
+        assert(columns[2][1] == 6 && reinterpret_cast<std::uintptr_t>(columns[1].data()) % io::alignment == 0);
+        auto loaded_points = file.load_batch<cartesian_batch<double> >("points");
+        assert(loaded_points.size() == 2 && loaded_points[1][0] == 4);
+
+        auto loaded_sites = file.load_batch<geodetic_batch<double> >("sites");
+        assert(loaded_sites.lat()[0] == 45 && loaded_sites.alt()[0] == 100);
+
+        assert(file.view<std::complex<float> >("iq")[1] == std::complex<float>(2, -2));
+
+        // Test mismatched types, kinds and names are rejected
+        bool caught_exception = false;
+        try {
+            file.view<double>("samples");
+        } catch (const std::invalid_argument &e) {
+            caught_exception = true;
+        }
+        assert(caught_exception);
+
+        caught_exception = false;
+        try {
+            file.load_batch<spherical_batch<double> >("points");
+        } catch (const std::invalid_argument &e) {
+            caught_exception = true;
+        }
+        assert(caught_exception);
+
+        caught_exception = false;
+        try {
+            file.at("missing");
+        } catch (const std::out_of_range &e) {
+            caught_exception = true;
+        }
+        assert(caught_exception);
+    }
+
+    {
+        // Test streaming append, refresh and recovery from an unfinished record
+        io::mapped_file file(path);
+        const std::size_t before = file.size();
+
+        {
+            io::writer out(path, io::writer::mode::append);
+            out.write("samples", vector<float>{1, 2, 3}).flush();
+        }
+
+        file.refresh();
+        assert(file.size() == before + 1 && file.view<float>("samples").size() == 3);
+
+        // A record whose payload never arrived is ignored by readers and dropped by the next writer
+        {
+            std::ofstream partial(path, std::ios::binary | std::ios::app);
+            io::record_header header{};
+            std::memcpy(header.tag, io::record_tag, sizeof(io::record_tag));
+            header.type = static_cast<std::uint8_t>(io::dtype::float32);
+            header.components = 1;
+            header.length = 1000;
+            header.stride = io::padded(1000 * sizeof(float));
+            partial.write(reinterpret_cast<const char *>(&header), sizeof(header));
+        }
+
+        file.refresh();
+        assert(file.size() == before + 1);
+
+        {
+            io::writer out(path, io::writer::mode::append);
+            out.write("tail", vector<std::int32_t>{7, 8});
+        }
+
+        file.refresh();
+        assert(file.size() == before + 2 && file.load<std::int32_t>("tail")[1] == 8);
+        assert(file.complete_size() == std::filesystem::file_size(path));
+    }
+
+    {
+        // Test damaged headers are reported as corrupt rather than read past the end of the image
+        {
+            io::writer out(path);
+            out.write("values", vector<double>{1, 2, 3, 4});
+        }
+        std::vector<std::byte> image(std::filesystem::file_size(path));
+        {
+            std::ifstream in(path, std::ios::binary);
+            in.read(reinterpret_cast<char *>(image.data()), static_cast<std::streamsize>(image.size()));
+        }
+        assert(io::parse(image.data(), image.size()).first.size() == 1);
+
+        const auto corrupt = [&](const std::size_t &at, const void *value, const std::size_t &len) {
+            std::vector<std::byte> damaged(image);
+            std::memcpy(damaged.data() + at, value, len);
+            try {
+                io::parse(damaged.data(), damaged.size());
+            } catch (const std::runtime_error &e) {
+                return true;
+            }
+            return false;
+        };
+        const std::size_t record = sizeof(io::file_header);
+        const std::uint16_t header_sizes[3] = {0, 65472, 65};
+        for (const auto &header_size: header_sizes)
+            assert(corrupt(offsetof(io::file_header, header_size), &header_size, sizeof(header_size)));
+        const std::uint8_t zero = 0, bad_type = 13, bad_kind = 6, four = 4;
+        assert(corrupt(record + offsetof(io::record_header, type), &zero, 1));
+        assert(corrupt(record + offsetof(io::record_header, type), &bad_type, 1));
+        assert(corrupt(record + offsetof(io::record_header, kind), &bad_kind, 1));
+        assert(corrupt(record + offsetof(io::record_header, orientation), &zero, 1));
+        const std::uint64_t unaligned = 72, long_length = 9;
+        assert(corrupt(record + offsetof(io::record_header, stride), &unaligned, sizeof(unaligned)));
+        assert(corrupt(record + offsetof(io::record_header, length), &long_length, sizeof(long_length)));
+
+        // Four components of 2^62 bytes would wrap around to an empty payload
+        std::vector<std::byte> wrapping(image);
+        const std::uint64_t huge = std::uint64_t(1) << 62;
+        std::memcpy(wrapping.data() + record + offsetof(io::record_header, components), &four, 1);
+        std::memcpy(wrapping.data() + record + offsetof(io::record_header, stride), &huge, sizeof(huge));
+        bool caught_exception = false;
+        try {
+            io::parse(wrapping.data(), wrapping.size());
+        } catch (const std::runtime_error &e) {
+            caught_exception = true;
+        }
+        assert(caught_exception);
+
+        // A truncated record is left out, however the file was cut
+        for (std::size_t cut = record; cut < image.size(); cut += 8) {
+            const auto parsed = io::parse(image.data(), cut);
+            assert(parsed.first.empty() && parsed.second == record);
+        }
+    }
+
+    {
+        // Test files that are not in the format are refused
+        {
+            std::ofstream junk(path, std::ios::binary | std::ios::trunc);
+            junk << "definitely not a ccomms binary file, but long enough to hold a header of sixty four bytes";
+        }
+
+        bool caught_exception = false;
+        try {
+            io::mapped_file file(path);
+        } catch (const std::runtime_error &e) {
+            caught_exception = true;
+        }
+        assert(caught_exception);
+    }
+
+    std::filesystem::remove(path);
+    return 0;
+}
@@ -0,0 +1,254 @@
+#include <vector>
+#include <cassert>
+#include <cstdint>
+#include <stdexcept>
+#include "../../include/dsp.hpp"
+#include "../../include/tensor.hpp"
+#include "../../include/stream.hpp"
+
+using namespace ccomms;
+
+namespace {
+
+// Source counting up from 0 in blocks until total samples have been written
+auto counter(const std::size_t &total) {
+    return [total, next = std::size_t(0)](vector_view<float> block) mutable {
+        const std::size_t n = std::min(block.size(), total - next);
+        for (std::size_t i = 0; i < n; i++)
+            block[i] = static_cast<float>(next++);
+        return n;
+    };
+}
+
+// Stage adding the blocks of two inputs of equal length
+class adder : public stream::stage {
+public:
+    stream::input<float> a{*this}, b{*this};
+    stream::output<float> sum{*this, 64};
+
+    adder() : stream::stage("adder") {}
+
+protected:
+    stream::step work() override {
+        const auto x = a.peek();
+        const auto y = b.peek();
+        if (!x || !y)
+            return a.drained() || b.drained() ? stream::step::finished : stream::step::starved;
+        const auto out = sum.reserve();
+        if (!out)
+            return stream::step::blocked;
+        vector_view<float> result = out->subview(0, x->size());
+        result = *x + *y;
+        sum.publish(x->size());
+        a.consume();
+        b.consume();
+        return stream::step::progressed;
+    }
+};
+
+// Runs source -> scale by 2 -> sink and checks every sample arrives once and in order
+template<typename R>
+void check_chain(R &&run, const std::size_t &depth) {
+    const std::size_t total = 10000;
+    stream::graph g;
+    auto &src = g.source<float>("source", 256, counter(total));
+    auto &scale = g.transform<float, float>("scale", 256, [](vector_view<const float> in, vector_view<float> out) {
+        out.subview(0, in.size()) = in * 2.0f;
+        return in.size();
+    });
+    std::vector<float> received;
+    auto &snk = g.sink<float>("sink", [&](vector_view<const float> in) {
+        received.insert(received.end(), in.begin(), in.end());
+    });
+    g.connect(src.out, scale.in, depth);
+    g.connect(scale.out, snk.in, depth);
+
+    run(g);
+
+    assert(received.size() == total);
+    for (std::size_t i = 0; i < total; i++)
+        assert(received[i] == 2.0f * static_cast<float>(i));
+    for (const auto &node: g.stages())
+        assert(node->finished());
+
+    const auto stats = scale.stats();
+    assert(stats.blocks_in == 40 && stats.blocks_out == 40 && stats.runs == 40);
+    assert(stats.samples_in == total && stats.samples_out == total);
+    assert(stats.max_latency_ns >= stats.mean_latency_ns() && stats.throughput() > 0);
+    assert(src.stats().samples_out == total && snk.stats().samples_in == total);
+}
+
+}
+
+int main() {
+    {
+        // Test every scheduler delivers the whole stream in order
+        execution::thread_pool none(0), two(2);
+        check_chain([&](stream::graph &g) { g.run(none); }, 8);
+        check_chain([&](stream::graph &g) { g.run(two); }, 8);
+        check_chain([](stream::graph &g) { g.run(); }, 1);
+        check_chain([](stream::graph &g) { g.run_pinned(); }, 2);
+        check_chain([](stream::graph &g) { g.run_pinned({0}); }, 4);
+    }
+
+    {
+        // Test a full connection pushes back on its producer
+        stream::graph g;
+        auto &src = g.source<float>("source", 16, counter(16 * 100));
+        std::size_t blocks = 0;
+        auto &snk = g.sink<float>("sink", [&](vector_view<const float>) { blocks++; });
+        g.connect(src.out, snk.in, 2);
+
+        execution::thread_pool none(0);
+        g.run(none);
+        assert(blocks == 100);
+        assert(src.stats().blocked > 0);
+    }
+
+    {
+        // Test a stage with two inputs, and a filter running inside a stage matches the filter run offline
+        const std::size_t total = 4096;
+        vector<float> taps{0.25f, 0.5f, 0.25f};
+        dsp::fir_filter<float> streaming(taps);
+
+        stream::graph g;
+        auto &left = g.source<float>("left", 64, counter(total));
+        auto &right = g.source<float>("right", 64, counter(total));
+        auto &sum = g.add<adder>();
+        auto &filter = g.transform<float, float>("filter", 64, [&](vector_view<const float> in,
+                                                                    vector_view<float> out) {
+            return streaming.process(in, out);
+        });
+        vector<float> received(total, 0.0f);
+        std::size_t at = 0;
+        auto &snk = g.sink<float>("sink", [&](vector_view<const float> in) {
+            for (const auto &x: in)
+                received[at++] = x;
+        });
+        g.connect(left.out, sum.a);
+        g.connect(right.out, sum.b);
+        g.connect(sum.sum, filter.in);
+        g.connect(filter.out, snk.in);
+
+        execution::thread_pool two(2);
+        g.run(two);
+
+        vector<float> doubled(total, 0.0f);
+        for (std::size_t i = 0; i < total; i++)
+            doubled[i] = 2.0f * static_cast<float>(i);
+        dsp::fir_filter<float> offline(taps);
+        const vector<float> expected = offline.process(doubled);
+        assert(at == total);
+        for (std::size_t i = 0; i < total; i++)
+            assert(received[i] == expected[i]);
+    }
+
+    {
+        // Test an endless source stops once its consumer has finished
+        stream::graph g;
+        auto &src = g.source<float>("endless", 32, [](vector_view<float> block) {
+            block.fill(1.0f);
+            return block.size();
+        });
+        std::size_t blocks = 0;
+        struct limited : stream::stage {
+            stream::input<float> in{*this};
+            std::size_t &count;
+
+            explicit limited(std::size_t &count) : stream::stage("limited"), count(count) {}
+
+            stream::step work() override {
+                if (count == 10)
+                    return stream::step::finished;
+                if (!in.peek())
+                    return stream::step::starved;
+                in.consume();
+                count++;
+                return stream::step::progressed;
+            }
+        };
+        auto &snk = g.add<limited>(blocks);
+        g.connect(src.out, snk.in, 4);
+
+        g.run();
+        assert(blocks == 10 && src.finished());
+    }
+
+    {
+        // Test a throwing stage stops the graph and the exception reaches the caller
+        stream::graph g;
+        auto &src = g.source<float>("source", 16, [](vector_view<float> block) { return block.size(); });
+        auto &snk = g.sink<float>("sink", [](vector_view<const float>) { throw std::runtime_error("sink failed"); });
+        g.connect(src.out, snk.in);
+
+        bool caught_exception = false;
+        try {
+            g.run();
+        } catch (const std::runtime_error &e) {
+            caught_exception = true;
+        }
+        assert(caught_exception);
+    }
+
+    {
+        // Test a cpu a stage thread cannot be pinned to fails the run, which can then be run again
+        stream::graph g;
+        auto &src = g.source<float>("source", 16, counter(16 * 100));
+        std::size_t blocks = 0;
+        auto &snk = g.sink<float>("sink", [&](vector_view<const float>) { blocks++; });
+        g.connect(src.out, snk.in);
+
+        for (const int &cpu: {-1, CPU_SETSIZE}) {
+            bool caught_exception = false;
+            try {
+                g.run_pinned({0, cpu});
+            } catch (const std::invalid_argument &e) {
+                caught_exception = true;
+            }
+            assert(caught_exception);
+        }
+
+        g.run_pinned();
+        assert(blocks == 100 && src.finished() && snk.finished());
+    }
+
+    {
+        // Test a stop requested before a run does not carry over into it
+        stream::graph g;
+        auto &src = g.source<float>("source", 16, counter(16 * 100));
+        std::size_t blocks = 0;
+        auto &snk = g.sink<float>("sink", [&](vector_view<const float>) { blocks++; });
+        g.connect(src.out, snk.in);
+
+        g.stop();
+        execution::thread_pool none(0);
+        g.run(none);
+        assert(blocks == 100);
+    }
+
+    {
+        // Test unconnected and doubly connected ports are rejected
+        stream::graph g;
+        auto &src = g.source<float>("source", 16, counter(16));
+        auto &snk = g.sink<float>("sink", [](vector_view<const float>) {});
+
+        bool caught_exception = false;
+        try {
+            g.run();
+        } catch (const std::invalid_argument &e) {
+            caught_exception = true;
+        }
+        assert(caught_exception);
+
+        g.connect(src.out, snk.in);
+        caught_exception = false;
+        try {
+            g.connect(src.out, snk.in);
+        } catch (const std::invalid_argument &e) {
+            caught_exception = true;
+        }
+        assert(caught_exception);
+    }
+
+    return 0;
+}
@@ -0,0 +1,224 @@
+#include <thread>
+#include <vector>
+#include <complex>
+#include <cassert>
+#include <cstdint>
+#include <stdexcept>
+#include "../../include/tensor.hpp"
+#include "../../include/stream.hpp"
+
+using namespace ccomms;
+
+int main() {
+    {
+        // Test claims stop at the wrap and the next claim continues from the start
+        stream::spsc_ring<float> ring(6);
+        assert(ring.capacity() == 8 && ring.empty());
+
+        vector_view<float> region = ring.claim_write(5);
+        assert(region.size() == 5);
+        for (std::size_t i = 0; i < 5; i++)
+            region[i] = static_cast<float>(i);
+        ring.commit_write(5);
+        assert(ring.size() == 5);
+
+        vector_view<const float> readable = ring.claim_read(4);
+        assert(readable.size() == 4 && readable[3] == 3.0f);
+        ring.commit_read(4);
+
+        region = ring.claim_write(6);
+        assert(region.size() == 3);
+        ring.commit_write(3);
+        region = ring.claim_write(6);
+        assert(region.size() == 4);
+        ring.commit_write(0);
+
+        // Test claimed regions are usable in vector math
+        vector<float> ones(3, 1.0f);
+        vector_view<float> tail = ring.claim_write(3);
+        tail = ones * 2.0f;
+        ring.commit_write(2);
+        assert(ring.size() == 6);
+
+        bool caught_exception = false;
+        try {
+            ring.commit_write(1);
+        } catch (const std::invalid_argument &e) {
+            caught_exception = true;
+        }
+        assert(caught_exception);
+    }
+
+    {
+        // Test copying writes and reads across the wrap, full and empty rings and statistics
+        stream::spsc_ring<std::complex<float> > ring(16);
+        vector<std::complex<float> > in(12, std::complex<float>(0)), out(12, std::complex<float>(0));
+        for (std::size_t i = 0; i < in.size(); i++)
+            in[i] = {static_cast<float>(i), -static_cast<float>(i)};
+
+        assert(ring.write(in) == 12);
+        assert(ring.read(vector_view(out.data(), 10)) == 10);
+        assert(ring.write(in) == 12);
+        assert(ring.write(in) == 2);
+        assert(ring.write(in) == 0);
+
+        auto stats = ring.stats();
+        assert(stats.capacity == 16 && stats.size == 16);
+        assert(stats.written == 26 && stats.consumed == 10);
+        assert(stats.high_watermark == 16 && stats.full == 2 && stats.empty == 0);
+
+        assert(ring.read(out) == 12);
+        assert(out[0] == in[10] && out[1] == in[11] && out[2] == in[0] && out[11] == in[9]);
+        assert(ring.read(out) == 4);
+        assert(ring.read(out) == 0);
+        assert(ring.stats().empty == 2);
+
+        ring.reset_watermark();
+        assert(ring.stats().high_watermark == 0);
+    }
+
+    {
+        // Test a producer and consumer thread pass every sample through in order
+        const std::uint32_t total = 1 << 20;
+        stream::spsc_ring<std::uint32_t> ring(1024);
+
+        std::thread producer([&] {
+            std::uint32_t next = 0;
+            while (next < total) {
+                vector_view<std::uint32_t> region = ring.claim_write(std::min<std::uint32_t>(300, total - next));
+                if (region.empty())
+                    std::this_thread::yield();
+                for (auto &sample: region)
+                    sample = next++;
+                ring.commit_write(region.size());
+            }
+        });
+
+        std::uint32_t expected = 0;
+        bool ordered = true;
+        while (expected < total) {
+            vector_view<const std::uint32_t> region = ring.claim_read(256);
+            if (region.empty())
+                std::this_thread::yield();
+            for (const auto &sample: region)
+                ordered = ordered && sample == expected++;
+            ring.commit_read(region.size());
+        }
+        producer.join();
+        assert(ordered && ring.empty());
+        assert(ring.stats().high_watermark <= 1024);
+    }
+
+    {
+        // Test blocks keep their lengths and order and the ring reports full and empty
+        stream::mpmc_ring<double> ring(3, 4);
+        assert(ring.capacity() == 4 && ring.block_size() == 4);
+
+        for (std::size_t b = 0; b < 4; b++)
+            assert(ring.try_push(vector<double>(b + 1, static_cast<double>(b))));
+        assert(!ring.try_push(vector<double>(1, 0.0)));
+        assert(ring.size() == 4);
+
+        vector<double> out(4, 0.0);
+        for (std::size_t b = 0; b < 4; b++) {
+            const std::optional<std::size_t> length = ring.try_pop(out);
+            assert(length && *length == b + 1 && out[b] == static_cast<double>(b));
+        }
+        assert(!ring.try_pop(out));
+
+        auto stats = ring.stats();
+        assert(stats.written == 4 && stats.consumed == 4 && stats.size == 0);
+        assert(stats.high_watermark == 4 && stats.full == 1 && stats.empty == 1);
+
+        // Test zero-copy claims
+        auto claim = ring.try_claim_write();
+        assert(claim && claim->samples.size() == 4);
+        claim->samples.fill(2.5);
+        ring.commit_write(*claim, 3);
+        auto block = ring.try_claim_read();
+        assert(block && block->samples.size() == 3 && (block->samples | block->samples) == 18.75);
+        ring.commit_read(*block);
+
+        bool caught_exception = false;
+        try {
+            ring.try_push(vector<double>(5, 0.0));
+        } catch (const std::invalid_argument &e) {
+            caught_exception = true;
+        }
+        assert(caught_exception);
+
+        // Test a ring asked for one block still holds two
+        stream::mpmc_ring<double> pair(1, 4);
+        assert(pair.capacity() == 2);
+        assert(pair.try_push(vector<double>(1, 1.0)) && pair.try_push(vector<double>(1, 2.0)));
+        assert(!pair.try_push(vector<double>(1, 3.0)));
+        assert(pair.try_pop(out) == 1 && out[0] == 1.0 && pair.try_pop(out) == 1 && out[0] == 2.0);
+    }
+
+    {
+        // Test several producers and consumers deliver every block exactly once
+        constexpr std::size_t producers = 3, consumers = 3, per_producer = 20000;
+        stream::mpmc_ring<std::uint64_t> ring(64, 2);
+        std::vector<std::atomic<int> > seen(producers * per_producer);
+
+        std::vector<std::thread> threads;
+        for (std::size_t p = 0; p < producers; p++)
+            threads.emplace_back([&, p] {
+                for (std::size_t i = 0; i < per_producer; i++) {
+                    const std::uint64_t id = p * per_producer + i;
+                    vector<std::uint64_t> block{id, ~id};
+                    while (!ring.try_push(block))
+                        std::this_thread::yield();
+                }
+            });
+
+        std::atomic<std::size_t> received{0};
+        std::atomic<bool> intact{true};
+        for (std::size_t c = 0; c < consumers; c++)
+            threads.emplace_back([&] {
+                while (received.load() < producers * per_producer) {
+                    auto block = ring.try_claim_read();
+                    if (!block) {
+                        std::this_thread::yield();
+                        continue;
+                    }
+                    const std::uint64_t id = block->samples[0];
+                    if (block->samples.size() != 2 || block->samples[1] != ~id)
+                        intact = false;
+                    seen[id]++;
+                    ring.commit_read(*block);
+                    received++;
+                }
+            });
+
+        for (auto &thread: threads)
+            thread.join();
+        assert(intact);
+        for (const auto &count: seen)
+            assert(count == 1);
+        assert(ring.empty());
+    }
+
+    {
+        // Test a ring asked for one block passes a stream between two threads without deadlocking
+        stream::mpmc_ring<std::uint64_t> ring(1, 1);
+        constexpr std::uint64_t total = 10000;
+        std::thread producer([&] {
+            for (std::uint64_t i = 0; i < total; i++)
+                while (!ring.try_push(vector<std::uint64_t>(1, i)))
+                    std::this_thread::yield();
+        });
+
+        vector<std::uint64_t> out(1, std::uint64_t(0));
+        bool ordered = true;
+        for (std::uint64_t i = 0; i < total; i++) {
+            while (!ring.try_pop(out))
+                std::this_thread::yield();
+            ordered = ordered && out[0] == i;
+        }
+        producer.join();
+        assert(ordered && ring.empty());
+    }
+
+    return 0;
+}
@@ -0,0 +1,137 @@
+#include <cmath>
+#include <vector>
+#include <complex>
+#include <cassert>
+#include <type_traits>
+#include "../../include/tensor.hpp"
+
+using namespace ccomms;
+using cf = std::complex<float>;
+using cd = std::complex<double>;
+
+bool close(const cf &a, const cf &b, const float &tol = 1e-4f) {
+    return std::abs(a - b) <= tol * (1 + std::abs(b));
+}
+
+int main() {
+    {
+        // Test Hermitian inner product conjugates the left operand
+        vector<cf> a{cf(1, 1), cf(2, -1)};
+        vector<cf> b{cf(0, 1), cf(1, 1)};
+        assert((a | b) == cf(2, 4));
+        assert((b | a) == std::conj(a | b));
+
+        // Test inner product of a vector with itself is real and equals the squared norm
+        auto self = a | a;
+        assert(self.imag() == 0 && self.real() == 7);
+
+        // Test the generic path with double precision
+        vector<cd> c{cd(1, 1), cd(2, -1)};
+        vector<cd> d{cd(0, 1), cd(1, 1)};
+        assert((c | d) == cd(2, 4));
+    }
+
+    {
+        // Test lazy conjugate, magnitude squared, real and imaginary parts
+        vector<cf> a{cf(3, 4), cf(-1, 2), cf(0, -5)};
+
+        vector<cf> c = conj(a);
+        assert(c[0] == cf(3, -4) && c[1] == cf(-1, -2) && c[2] == cf(0, 5));
+
+        vector<float> n = norm(a);
+        static_assert(std::is_same_v<decltype(norm(a))::value_type, float>);
+        assert(n[0] == 25 && n[1] == 5 && n[2] == 25);
+
+        vector<float> r = real(a);
+        vector<float> i = imag(a);
+        assert(r[0] == 3 && r[1] == -1 && i[2] == -5);
+
+        // Test unary expressions nest with binary expressions
+        vector<cf> p = conj(a) * a;
+        assert(p[0] == cf(25, 0) && p[1] == cf(5, 0));
+
+        // Test real operands pass through conj unchanged
+        vector<double> x{1, -2};
+        vector<double> y = conj(x) + norm(x);
+        assert(y[0] == 2 && y[1] == 2);
+    }
+
+    for (int l = 0; l <= static_cast<int>(simd::detect()); l++) {
+        simd::restrict_to(static_cast<simd::level>(l));
+
+        for (const std::size_t n: {0ul, 1ul, 5ul, 16ul, 37ul, 1000ul}) {
+            vector<cf> a(n, cf(0));
+            vector<cf> b(n, cf(0));
+            for (std::size_t i = 0; i < n; i++) {
+                a[i] = cf(std::sin(0.1f * i), std::cos(0.3f * i));
+                b[i] = cf(0.5f * (i % 3), -0.25f * (i % 7));
+            }
+
+            cf expected = 0;
+            for (std::size_t i = 0; i < n; i++)
+                expected += std::conj(a[i]) * b[i];
+
+            // Test interleaved kernels
+            assert(close(a | b, expected));
+
+            vector<float> n2 = norm(a);
+            vector<cf> c = conj(a);
+            for (std::size_t i = 0; i < n; i++) {
+                assert(std::abs(n2[i] - std::norm(a[i])) < 1e-5f);
+                assert(c[i] == std::conj(a[i]));
+            }
+
+            // Test split storage kernels against the interleaved results
+            split_complex<float> sa(a);
+            split_complex<float> sb(b);
+            assert(sa.size() == n);
+            assert(close(sa | sb, expected));
+
+            auto sn = sa.norm();
+            auto sp = sa * sb;
+            auto sc = sa.conj_mul(sb);
+            for (std::size_t i = 0; i < n; i++) {
+                assert(std::abs(sn[i] - std::norm(a[i])) < 1e-5f);
+                assert(close(sp[i], a[i] * b[i]));
+                assert(close(sc[i], std::conj(a[i]) * b[i]));
+            }
+
+            auto back = sa.interleave();
+            for (std::size_t i = 0; i < n; i++)
+                assert(back[i] == a[i]);
+        }
+    }
+
+    {
+        // Test that narrowing interleaved data into split storage follows the conversion policy
+        const auto before = conversion::warnings();
+        vector<cd> wide{cd(1, 2), cd(3, 4)};
+        split_complex<double> same(wide);
+        assert(conversion::warnings() == before);
+
+        split_complex<float, conversion::allow> quiet(wide);
+        assert(quiet[1] == cf(3, 4) && conversion::warnings() == before);
+
+        split_complex<float> narrowed(wide);
+        split_complex<float> again(wide);
+        assert(narrowed[0] == cf(1, 2) && again[1] == cf(3, 4));
+        assert(conversion::warnings() == before + 1);
+    }
+
+    {
+        // Test split storage construction and mismatched lengths
+        split_complex<double> s(vector<double>{1, 2}, vector<double>{3, 4});
+        assert(s[1] == cd(2, 4));
+        assert(s.conj()[0] == cd(1, -3));
+
+        bool caught_exception = false;
+        try {
+            split_complex<double> t(vector<double>{1, 2}, vector<double>{3});
+        } catch (const std::invalid_argument &e) {
+            caught_exception = true;
+        }
+        assert(caught_exception);
+    }
+
+    return 0;
+}
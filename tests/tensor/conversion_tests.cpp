@@ -0,0 +1,95 @@
+#include <vector>
+#include <thread>
+#include <cassert>
+#include "../../include/tensor.hpp"
+#include "../../include/coords.hpp"
+
+using namespace ccomms;
+
+int main() {
+    {
+        // Test that allowed conversions are silent
+        const auto before = conversion::warnings();
+        std::vector<double> src{1.5, 2.5, 3.5};
+        for (int i = 0; i < 100; i++) {
+            vector<int, 0, conversion::allow> v(src);
+            vector<float, 3, conversion::allow> w{1, 2, 3};
+            assert(v[0] == 1 && w[2] == 3.0f);
+        }
+        assert(conversion::warnings() == before);
+    }
+
+    {
+        // Test that same type construction never reports
+        const auto before = conversion::warnings();
+        std::vector<long> src{1, 2, 3};
+        vector<long> v(src);
+        vector<long> w(3, 7L);
+        assert(conversion::warnings() == before);
+    }
+
+    {
+        // Test that warn_once reports each type pair once across threads
+        const auto before = conversion::warnings();
+        std::vector<std::thread> workers;
+        for (int t = 0; t < 8; t++)
+            workers.emplace_back([] {
+                std::vector<short> src{1, 2, 3};
+                for (int i = 0; i < 1000; i++) {
+                    vector<long long> v(src);
+                    assert(v[2] == 3);
+                }
+            });
+        for (auto &worker: workers)
+            worker.join();
+        assert(conversion::warnings() == before + 1);
+
+        // Test that a new type pair reports again
+        vector<long long> v(3, static_cast<unsigned char>(1));
+        assert(conversion::warnings() == before + 2);
+    }
+
+    {
+        // Test that compound assignment, axpy and fma report narrowing into the destination type
+        const auto before = conversion::warnings();
+        vector<int> a(3, 1), b(3, 2);
+        vector<double> x(3, 0.5);
+        a += b;
+        a *= 2;
+        a.axpy(2, b);
+        a.fma(b, b);
+        assert(a[0] == 14);
+        assert(conversion::warnings() == before);
+
+        vector<float> f(3, 1.0f);
+        f += x;
+        assert(f[0] == 1.5f && conversion::warnings() == before + 1);
+        f.axpy(2.0, x);
+        f.fma(x, x);
+        assert(f[0] == 2.75f && conversion::warnings() == before + 1);
+
+        a.axpy(1.5, x);
+        assert(a[0] == 14 && conversion::warnings() == before + 2);
+
+        // Test that widening into the destination type is silent
+        vector<double> y(3, 1.0);
+        y += vector<float>(3, 0.25f);
+        y.fma(vector<int>(3, 2), x);
+        assert(y[0] == 2.25 && conversion::warnings() == before + 2);
+    }
+
+    {
+        // Test that coordinate types take a policy
+        const auto before = conversion::warnings();
+        cartesian<double, conversion::allow> c(1, 2, 3);
+        spherical<float, conversion::allow> s(1.0, 2.0);
+        geodetic<double, conversion::allow> g(45, 90);
+        assert(c[2] == 3 && s[1] == 2.0f && g[0] == 45);
+        assert(conversion::warnings() == before);
+
+        cartesian<double> d;
+        assert(d.size() == 3 && d[0] == 0);
+    }
+
+    return 0;
+}
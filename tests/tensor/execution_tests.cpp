@@ -0,0 +1,110 @@
+#include <atomic>
+#include <vector>
+#include <complex>
+#include <cassert>
+#include <stdexcept>
+#include "../../include/tensor.hpp"
+
+using namespace ccomms;
+
+int main() {
+    {
+        // Test parallel_for visits every index once, nests, and runs without workers
+        execution::thread_pool pool(3);
+        std::vector<std::atomic<int> > visits(1000);
+        pool.parallel_for(visits.size(), [&](std::size_t i) { visits[i]++; });
+        for (const auto &count: visits)
+            assert(count == 1);
+
+        std::atomic<int> total{0};
+        pool.parallel_for(8, [&](std::size_t) { pool.parallel_for(8, [&](std::size_t) { total++; }); });
+        assert(total == 64);
+
+        execution::thread_pool inline_pool(0);
+        assert(inline_pool.concurrency() == 1);
+        int serial = 0;
+        inline_pool.parallel_for(10, [&](std::size_t) { serial++; });
+        assert(serial == 10);
+
+        bool caught_exception = false;
+        try {
+            pool.parallel_for(16, [](std::size_t i) {
+                if (i == 7)
+                    throw std::runtime_error("chunk failed");
+            });
+        } catch (const std::runtime_error &e) {
+            caught_exception = true;
+        }
+        assert(caught_exception);
+    }
+
+    {
+        // Test reductions are bitwise identical across policies and thread counts
+        const std::size_t len = 200003;
+        vector<float> a(len, 0.0f), b(len, 0.0f);
+        for (std::size_t i = 0; i < len; i++) {
+            a[i] = 1.0f / static_cast<float>(i + 1);
+            b[i] = static_cast<float>(i % 17) - 8.5f;
+        }
+
+        execution::thread_pool one(1), four(4);
+        const float expected = inner(execution::seq, a, b);
+        assert(inner(execution::par.on(one), a, b) == expected);
+        assert(inner(execution::par.on(four), a, b) == expected);
+        assert(inner(execution::par_unseq.on(four), a, b) == expected);
+        assert(inner(execution::par, a, b) == expected);
+
+        double reference = 0;
+        for (std::size_t i = 0; i < len; i++)
+            reference += static_cast<double>(a[i]) * static_cast<double>(b[i]);
+        assert(std::abs(expected - reference) < 1e-2);
+
+        std::vector<std::complex<double> > z(50000, std::complex<double>(1, 1));
+        auto norm = inner(execution::par_unseq.on(four), z, z);
+        assert(norm == std::complex<double>(100000, 0));
+        assert(inner(execution::seq, z, z) == norm);
+
+        bool caught_exception = false;
+        try {
+            inner(execution::par, a, vector<float>(3, 0.0f));
+        } catch (const std::invalid_argument &e) {
+            caught_exception = true;
+        }
+        assert(caught_exception);
+    }
+
+    {
+        // Test parallel assignment and evaluation of expressions
+        const std::size_t len = 100001;
+        vector<double> x(len, 0.0), y(len, 0.0);
+        for (std::size_t i = 0; i < len; i++) {
+            x[i] = static_cast<double>(i);
+            y[i] = 2.0;
+        }
+
+        execution::thread_pool pool(2);
+        vector<double> out(len, 0.0);
+        assign(execution::par.on(pool), out, x * y);
+        for (std::size_t i = 0; i < len; i++)
+            assert(out[i] == 2.0 * static_cast<double>(i));
+
+        vector<double> nested = eval(execution::par_unseq.on(pool), x + y * 3.0 - x);
+        assert(nested.size() == len && nested[len - 1] == 6.0);
+
+        std::vector<double> raw(len);
+        vector_view<double> view(raw);
+        assign(execution::seq, view, x + 1.0);
+        assert(raw[41] == 42.0);
+
+        bool caught_exception = false;
+        try {
+            vector<double> short_out(3, 0.0);
+            assign(execution::par, short_out, x + y);
+        } catch (const std::invalid_argument &e) {
+            caught_exception = true;
+        }
+        assert(caught_exception);
+    }
+
+    return 0;
+}
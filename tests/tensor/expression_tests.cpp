@@ -0,0 +1,109 @@
+#include <vector>
+#include <array>
+#include <cassert>
+#include <type_traits>
+#include "../../include/tensor.hpp"
+
+int main() {
+    using namespace ccomms;
+
+    {
+        // Test that chained operators are lazy and evaluate in one pass
+        vector<double> a{1, 2, 3};
+        vector<double> w{2, 2, 2};
+        vector<double> b{4, 5, 6};
+        vector<double> g{0.5, 0.5, 0.5};
+        vector<double> c{1, 1, 1};
+
+        auto e = a * w + b * g - c;
+        static_assert(is_expression_v<decltype(e)>);
+        assert(e.size() == 3);
+        assert(e[0] == 3 && e[1] == 5.5 && e[2] == 8);
+
+        vector<double> r = e;
+        assert(r.size() == 3);
+        assert(r[0] == 3 && r[1] == 5.5 && r[2] == 8);
+    }
+
+    {
+        // Test assignment reuses the destination and handles aliasing
+        vector<int> a{1, 2, 3};
+        vector<int> b{4, 5, 6};
+        a = a + b;
+        assert(a[0] == 5 && a[1] == 7 && a[2] == 9);
+
+        a = a * 2 - b;
+        assert(a[0] == 6 && a[1] == 9 && a[2] == 12);
+
+        // Test assignment from an expression of a different length
+        vector<int> c{1};
+        c = c * b;
+        assert(c.size() == 3);
+        assert(c[0] == 4 && c[1] == 5 && c[2] == 6);
+    }
+
+    {
+        // Test scalars on either side and type promotion
+        vector<int, 3> a{1, 2, 3};
+        auto e = 2.5 * a + 1;
+        static_assert(std::is_same_v<decltype(e)::value_type, double>);
+        assert(e[0] == 3.5 && e[1] == 6 && e[2] == 8.5);
+
+        auto f = 12 / a;
+        assert(f[0] == 12 && f[1] == 6 && f[2] == 4);
+    }
+
+    {
+        // Test fixed length is kept by eval
+        vector<int, 3> a{1, 2, 3};
+        std::vector<int> b{1, 1, 1};
+        auto r = (a + b).eval();
+        static_assert(std::is_same_v<decltype(r), vector<int, 3> >);
+        assert(r[0] == 2 && r[1] == 3 && r[2] == 4);
+
+        vector<int, 3> s = b - a;
+        assert(s[0] == 0 && s[1] == -1 && s[2] == -2);
+
+        // Test fixed length mismatch on materialization, at compile time when the expression length is static
+        static_assert(!std::is_constructible_v<vector<int, 2>, decltype(a + b)>);
+        bool caught_exception = false;
+        try {
+            [[maybe_unused]] vector<int, 2> t = vector<int>(b) + b;
+        } catch (const std::invalid_argument &e) {
+            caught_exception = true;
+        }
+        assert(caught_exception);
+    }
+
+    {
+        // Test broadcast of single element operands
+        vector<int> a{2};
+        vector<int> b{1, 2, 3};
+        vector<int> r = a * b;
+        assert(r.size() == 3 && r[0] == 2 && r[1] == 4 && r[2] == 6);
+
+        // Test that addition does not broadcast
+        bool caught_exception = false;
+        try {
+            [[maybe_unused]] auto e = a + b;
+        } catch (const std::invalid_argument &e) {
+            caught_exception = true;
+            assert(std::string(e.what()) == "\nERR: elementwise addition requires vectors of equal length\n");
+        }
+        assert(caught_exception);
+    }
+
+    {
+        // Test that temporaries are owned by the expression
+        vector<int> a{1, 2, 3};
+        auto e = a + vector<int>{10, 20, 30};
+        assert(e[0] == 11 && e[1] == 22 && e[2] == 33);
+
+        // Test iteration and inner product over an expression
+        std::vector<int> v(e.begin(), e.end());
+        assert(v.size() == 3 && v[2] == 33);
+        assert((a | (a + a)) == 28);
+    }
+
+    return 0;
+}
@@ -0,0 +1,150 @@
+#include <string>
+#include <vector>
+#include <complex>
+#include <cassert>
+#include "../../include/tensor.hpp"
+#include "../../include/coords.hpp"
+
+using namespace ccomms;
+
+int main() {
+    {
+        // Test contents stay inline up to the capacity and spill past it
+        inline_vector<int, 4> v;
+        assert(v.empty() && v.capacity() == 4 && v.is_inline());
+        for (int i = 0; i < 4; i++)
+            v.push_back(i);
+        assert(v.is_inline() && v.size() == 4);
+        v.push_back(4);
+        assert(!v.is_inline() && v.capacity() >= 5);
+        for (int i = 0; i < 5; i++)
+            assert(v[i] == i);
+
+        // Test shrinking back into the inline buffer
+        v.pop_back();
+        v.shrink_to_fit();
+        assert(v.is_inline() && v.back() == 3);
+    }
+
+    {
+        // Test insertion, erasure and resizing
+        inline_vector<int, 3> v{1, 2, 3};
+        std::vector<int> more{7, 8};
+        v.insert(v.begin() + 1, more.begin(), more.end());
+        assert(v.size() == 5 && v[0] == 1 && v[1] == 7 && v[2] == 8 && v[3] == 2 && v[4] == 3);
+        v.erase(v.begin(), v.begin() + 2);
+        assert(v.size() == 3 && v[0] == 8 && v[2] == 3);
+        v.resize(6, 9);
+        assert(v.size() == 6 && v[5] == 9);
+        v.resize(1);
+        assert(v.size() == 1 && v[0] == 8);
+
+        bool caught_exception = false;
+        try {
+            v.at(1);
+        } catch (const std::out_of_range &e) {
+            caught_exception = true;
+        }
+        assert(caught_exception);
+    }
+
+    {
+        // Test copy, move and swap for inline and heap contents with non-trivial elements
+        inline_vector<std::string, 2> a{"alpha", "beta"};
+        inline_vector<std::string, 2> b{"gamma", "delta", "epsilon"};
+        const std::string *heap = b.data();
+
+        inline_vector<std::string, 2> c(a);
+        assert(c == a && c.is_inline());
+
+        inline_vector<std::string, 2> d(std::move(b));
+        assert(d.data() == heap && d.size() == 3 && b.empty() && b.is_inline());
+
+        c.swap(d);
+        assert(c.size() == 3 && c[2] == "epsilon" && d.size() == 2 && d[1] == "beta");
+
+        a = std::move(c);
+        assert(a.size() == 3 && a.data() == heap);
+        a = d;
+        assert(a == d);
+    }
+
+    {
+        // Test small vectors keep the vector operator surface
+        small_vector<double> a{1, 2, 3};
+        small_vector<double> b{4, 5, 6};
+        small_vector<double> c = a + b * 2.0;
+        assert(c[0] == 9 && c[1] == 12 && c[2] == 15);
+        assert((a | b) == 32);
+
+        auto cross = a & b;
+        assert(cross[0] == -3 && cross[1] == 6 && cross[2] == -3);
+
+        c -= a;
+        c.axpy(0.5, a);
+        assert(c[0] == 8.5 && c[2] == 13.5);
+
+        // Test growing past the inline capacity through the vector interface
+        small_vector<float, 4> d(4, 1.0f);
+        d.push_back(2.0f);
+        small_vector<float, 4> e = d * d;
+        assert(e.size() == 5 && e[4] == 4.0f);
+
+        // Test complex elements take the Hermitian inner product path
+        using cf = std::complex<float>;
+        small_vector<cf> x{cf(1, 1), cf(2, -1)};
+        small_vector<cf> y{cf(0, 1), cf(1, 1)};
+        assert((x | y) == cf(2, 4));
+    }
+
+    {
+        // Test short vectors with a counting allocator never allocate
+        using inline_pooled = vector<float, 0, conversion::warn_once, memory::allocator<float>, 16>;
+        inline_pooled a(16, 1.0f);
+        inline_pooled b(16, 2.0f);
+
+        const auto before = memory::stats().allocations;
+        for (int i = 0; i < 100; i++) {
+            inline_pooled c = a + b;
+            inline_pooled d(c);
+            d *= c;
+            assert(d[15] == 9.0f);
+        }
+        assert(memory::stats().allocations == before);
+
+        inline_pooled large(17, 1.0f);
+        assert(memory::stats().allocations == before + 1);
+
+        // Test swapping with a vector from another resource exchanges the allocators with the buffers
+        using pooled_storage = inline_vector<float, 4, memory::allocator<float> >;
+        pooled_storage pooled(8, 1.0f);
+        const float *heap = pooled.data();
+        {
+            memory::frame scope;
+            for (const std::size_t &len: {std::size_t(8), std::size_t(2)}) {
+                pooled_storage scratch(len, 2.0f);
+                pooled.swap(scratch);
+                assert(pooled.size() == len && pooled[1] == 2.0f);
+                assert(pooled.get_allocator().resource() == &memory::thread_arena());
+                assert(scratch.data() == heap && scratch.get_allocator().resource() == &memory::thread_local_pool());
+                pooled.swap(scratch);
+            }
+        }
+        assert(pooled.data() == heap && pooled[7] == 1.0f);
+        assert(pooled.get_allocator().resource() == &memory::thread_local_pool());
+    }
+
+    {
+        // Test coordinate types are stored inline
+        cartesian<double> p(1.0, 2.0, 3.0);
+        spherical<double> s(0.5, 0.25);
+        geodetic<double> g(45.0, 90.0);
+        assert(p.is_inline() && s.is_inline() && g.is_inline());
+
+        cartesian<double> q = p;
+        vector<double> sum = p + q;
+        assert(q.is_inline() && sum[2] == 6.0);
+    }
+
+    return 0;
+}
@@ -0,0 +1,232 @@
+#include <cmath>
+#include <limits>
+#include <random>
+#include <vector>
+#include <cassert>
+#include <stdexcept>
+#include "../../include/tensor.hpp"
+#include "../../include/coords.hpp"
+
+using namespace ccomms;
+using simd::accuracy;
+
+namespace {
+
+// Distance from the reference in units of the spacing of T at the reference
+template<typename T>
+long double ulps(const T &value, const long double &reference) {
+    const T rounded = static_cast<T>(reference);
+    const T spacing = std::nextafter(std::abs(rounded), std::numeric_limits<T>::infinity()) - std::abs(rounded);
+    return std::abs(static_cast<long double>(value) - reference) / spacing;
+}
+
+template<typename T>
+bool same(const T &a, const T &b) {
+    return (std::isnan(a) && std::isnan(b)) || (a == b && std::signbit(a) == std::signbit(b));
+}
+
+// Bounds measured over these samples at every SIMD level, with some margin
+template<typename T, accuracy A>
+struct bounds {
+    static constexpr bool reduced = A == accuracy::fast && std::is_same_v<T, double>;
+    static constexpr long double exp = reduced ? 5e-9L : 2;
+    static constexpr long double log = reduced ? 3e-9L : 1;
+    static constexpr long double atan2 = reduced ? 2e-8L : 3;
+    static constexpr long double root = A == accuracy::fast && std::is_same_v<T, float> ? 4 : 2;
+    static constexpr long double trig = reduced ? 1e-8L : std::is_same_v<T, float> ? 2e-7L : 3e-16L;
+};
+
+template<typename T, accuracy A>
+void check_accuracy(const std::size_t &n) {
+    using limits = std::numeric_limits<T>;
+    using B = bounds<T, A>;
+    std::mt19937 gen(static_cast<unsigned>(n));
+    std::uniform_real_distribution<double> wide(-80, 80), octaves(-40, 40), plane(-1e3, 1e3);
+    std::vector<T> x(n), y(n), out(n), other(n);
+
+    // exp within a few ULP, or relative error for the reduced tier, up to the normal range
+    for (std::size_t i = 0; i < n; i++)
+        x[i] = static_cast<T>(wide(gen));
+    simd::exp<A>(out.data(), x.data(), n);
+    for (std::size_t i = 0; i < n; i++) {
+        const long double reference = std::exp(static_cast<long double>(x[i]));
+        if (B::reduced)
+            assert(std::abs(out[i] - reference) <= B::exp * reference);
+        else
+            assert(ulps(out[i], reference) <= B::exp);
+    }
+
+    // log including arguments close to 1, where the result is small, in place on the arguments
+    for (std::size_t i = 0; i < n; i++)
+        x[i] = static_cast<T>(i % 5 == 0 ? 1 + octaves(gen) * 1e-6 : std::exp(octaves(gen)));
+    out = x;
+    simd::log<A>(out.data(), out.data(), n);
+    for (std::size_t i = 0; i < n; i++) {
+        const long double reference = std::log(static_cast<long double>(x[i]));
+        if (B::reduced)
+            assert(std::abs(out[i] - reference) <= B::log);
+        else
+            assert(ulps(out[i], reference) <= B::log);
+    }
+
+    // atan2 over all four quadrants
+    for (std::size_t i = 0; i < n; i++) {
+        x[i] = static_cast<T>(plane(gen));
+        y[i] = static_cast<T>(i % 7 == 0 ? x[i] * T(1e-3) : plane(gen));
+    }
+    simd::atan2<A>(out.data(), y.data(), x.data(), n);
+    for (std::size_t i = 0; i < n; i++) {
+        const long double reference = std::atan2(static_cast<long double>(y[i]), static_cast<long double>(x[i]));
+        if (B::reduced)
+            assert(std::abs(out[i] - reference) <= B::atan2);
+        else
+            assert(ulps(out[i], reference) <= B::atan2);
+    }
+
+    // Square roots over many octaves
+    for (std::size_t i = 0; i < n; i++)
+        x[i] = static_cast<T>(std::exp(octaves(gen)));
+    simd::sqrt<A>(out.data(), x.data(), n);
+    simd::rsqrt<A>(other.data(), x.data(), n);
+    for (std::size_t i = 0; i < n; i++) {
+        const long double root = std::sqrt(static_cast<long double>(x[i]));
+        assert(ulps(out[i], root) <= B::root && ulps(other[i], 1 / root) <= B::root);
+        if (A == accuracy::precise)
+            assert(out[i] == std::sqrt(x[i]));
+    }
+
+    // Sine and cosine, bounded in absolute terms
+    for (std::size_t i = 0; i < n; i++)
+        x[i] = static_cast<T>(plane(gen) * 10);
+    simd::sincos<A>(out.data(), other.data(), x.data(), n);
+    for (std::size_t i = 0; i < n; i++) {
+        assert(std::abs(out[i] - std::sin(static_cast<long double>(x[i]))) <= B::trig);
+        assert(std::abs(other[i] - std::cos(static_cast<long double>(x[i]))) <= B::trig);
+    }
+
+    // Special values follow the standard library
+    const T inf = limits::infinity(), nan = limits::quiet_NaN();
+    const std::vector<T> specials{T(0), T(-0.0), T(1), T(-1), inf, -inf, nan, limits::denorm_min(), limits::max(),
+                                  T(1000), T(-1000)};
+    const std::size_t m = specials.size();
+    std::vector<T> result(m);
+
+    simd::exp<A>(result.data(), specials.data(), m);
+    for (std::size_t i = 0; i < m; i++)
+        if (!std::isfinite(specials[i]) || std::abs(specials[i]) > 1)
+            assert(same(result[i], std::exp(specials[i])));
+
+    simd::log<A>(result.data(), specials.data(), m);
+    for (std::size_t i = 0; i < m; i++) {
+        if (specials[i] == limits::denorm_min())
+            assert(result[i] == -inf);
+        else if (!std::isfinite(specials[i]) || specials[i] <= 1)
+            assert(same(result[i], std::log(specials[i])) || (std::isnan(result[i]) && specials[i] < 0));
+    }
+
+    simd::sqrt<A>(result.data(), specials.data(), m);
+    for (std::size_t i = 0; i < m; i++)
+        if (!std::isfinite(specials[i]) || specials[i] <= 0)
+            assert(same(result[i], std::sqrt(specials[i])) || (std::isnan(result[i]) && specials[i] < 0));
+
+    simd::rsqrt<A>(result.data(), specials.data(), m);
+    assert(result[0] == inf && result[4] == T(0) && std::isnan(result[3]) && std::isnan(result[6]));
+    assert(std::abs(result[2] - 1) <= 4 * limits::epsilon());
+
+    for (const T &a: specials)
+        for (const T &b: specials) {
+            T value;
+            simd::atan2<A>(&value, &a, &b, 1);
+            const T reference = std::atan2(a, b);
+            const T tolerance = B::reduced ? static_cast<T>(B::atan2) : 4 * limits::epsilon();
+            assert(same(value, reference) || std::abs(value - reference) <= tolerance);
+            assert(std::signbit(value) == std::signbit(reference));
+        }
+}
+
+template<typename T>
+void check_containers() {
+    vector<T> x(37, T(0));
+    for (std::size_t i = 0; i < x.size(); i++)
+        x[i] = T(0.1) * static_cast<T>(i) + T(0.05);
+
+    const vector<T> s = sin(x), c = cos(x), e = exp(x), l = log(x), r = sqrt(x), q = rsqrt(x), a = atan2(x, c);
+    vector<T> s2, c2;
+    sincos<accuracy::fast>(x, s2, c2);
+    const split_complex<T> phasors = expj(x);
+    assert(s.size() == x.size() && s2.size() == x.size() && phasors.size() == x.size());
+
+    const T tolerance = std::is_same_v<T, float> ? T(1e-6) : T(1e-12);
+    for (std::size_t i = 0; i < x.size(); i++) {
+        assert(std::abs(s[i] - std::sin(x[i])) <= tolerance && std::abs(c[i] - std::cos(x[i])) <= tolerance);
+        assert(std::abs(s2[i] - s[i]) <= T(1e-6) && std::abs(c2[i] - c[i]) <= T(1e-6));
+        assert(phasors.real()[i] == c[i] && phasors.imag()[i] == s[i]);
+        assert(std::abs(e[i] - std::exp(x[i])) <= tolerance * std::exp(x[i]));
+        assert(std::abs(l[i] - std::log(x[i])) <= tolerance);
+        assert(r[i] == std::sqrt(x[i]) && std::abs(q[i] * r[i] - 1) <= tolerance);
+        assert(std::abs(a[i] - std::atan2(x[i], c[i])) <= tolerance);
+    }
+
+    // Views run the same kernels
+    const vector_view<T> head(x.data(), 8);
+    const vector<T> partial = exp(head);
+    assert(partial.size() == 8);
+    for (std::size_t i = 0; i < 8; i++)
+        assert(partial[i] == e[i]);
+
+    bool caught_exception = false;
+    try {
+        atan2(x, head);
+    } catch (const std::invalid_argument &e) {
+        caught_exception = true;
+    }
+    assert(caught_exception);
+}
+
+template<accuracy A>
+void check_coords() {
+    // Look angles through the SIMD kernels agree with the definition, including the azimuth wrap
+    spherical_batch<float> look;
+    for (int i = 0; i < 1000; i++)
+        look.push_back(static_cast<float>(i % 360) + 0.25f, static_cast<float>(i % 179) - 89.0f,
+                       1.0f + static_cast<float>(i));
+
+    const cartesian_batch<float> enu = spherical_to_cartesian<A>(look);
+    const spherical_batch<float> back = cartesian_to_spherical<A>(enu);
+    for (std::size_t i = 0; i < look.size(); i++) {
+        const double a = look.az()[i] * deg_to_rad, e = look.el()[i] * deg_to_rad, r = look.range()[i];
+        assert(std::abs(enu.x()[i] - r * std::cos(e) * std::sin(a)) <= 1e-6 * r);
+        assert(std::abs(enu.y()[i] - r * std::cos(e) * std::cos(a)) <= 1e-6 * r);
+        assert(std::abs(enu.z()[i] - r * std::sin(e)) <= 1e-6 * r);
+
+        assert(back.az()[i] >= 0.0f && back.az()[i] < 360.0f);
+        assert(std::abs(back.az()[i] - look.az()[i]) <= 1e-3f || std::abs(look.el()[i]) > 88.0f);
+        assert(std::abs(back.el()[i] - look.el()[i]) <= 1e-3f);
+        assert(std::abs(back.range()[i] - look.range()[i]) <= 1e-5f * look.range()[i]);
+    }
+}
+
+}
+
+int main() {
+    const std::size_t sizes[] = {0, 1, 5, 16, 33, 4096 + 7};
+
+    for (int l = 0; l <= static_cast<int>(simd::detect()); l++) {
+        simd::restrict_to(static_cast<simd::level>(l));
+
+        for (const auto &n: sizes) {
+            check_accuracy<float, accuracy::precise>(n);
+            check_accuracy<float, accuracy::fast>(n);
+            check_accuracy<double, accuracy::precise>(n);
+            check_accuracy<double, accuracy::fast>(n);
+        }
+
+        check_containers<float>();
+        check_containers<double>();
+        check_coords<accuracy::precise>();
+        check_coords<accuracy::fast>();
+    }
+
+    simd::restrict_to(simd::level::avx512);
+    return 0;
+}
@@ -0,0 +1,173 @@
+#include <cmath>
+#include <vector>
+#include <complex>
+#include <cassert>
+#include "../../include/tensor.hpp"
+
+using namespace ccomms;
+
+template<typename M>
+void fill(M &m, const int &seed) {
+    for (std::size_t i = 0; i < m.rows(); i++)
+        for (std::size_t j = 0; j < m.cols(); j++)
+            m(i, j) = static_cast<typename M::value_type>(static_cast<int>((i * 7 + j * 3 + seed) % 13) - 6);
+}
+
+template<typename T, layout L>
+void check_gemm(const std::size_t &m, const std::size_t &n, const std::size_t &k) {
+    matrix<T, 0, 0, L> a(m, k), b(k, n);
+    fill(a, 1);
+    fill(b, 5);
+
+    auto c = a * b;
+    assert(c.rows() == m && c.cols() == n);
+    for (std::size_t i = 0; i < m; i++)
+        for (std::size_t j = 0; j < n; j++) {
+            T expected = 0;
+            for (std::size_t p = 0; p < k; p++)
+                expected += a(i, p) * b(p, j);
+            assert(std::abs(c(i, j) - expected) <= 1e-4 * (1 + std::abs(expected)));
+        }
+}
+
+int main() {
+    {
+        // Test construction, element access and storage order
+        matrix<int, 2, 3> a{{1, 2, 3}, {4, 5, 6}};
+        matrix<int, 2, 3, layout::col_major> b{{1, 2, 3}, {4, 5, 6}};
+        assert(a.rows() == 2 && a.cols() == 3 && a(1, 0) == 4 && b(1, 0) == 4);
+        assert(a.data()[1] == 2 && b.data()[1] == 4);
+        assert(a.leading_dimension() == 3 && b.leading_dimension() == 2);
+
+        auto t = a.transpose();
+        static_assert(std::is_same_v<decltype(t), matrix<int, 3, 2> >);
+        assert(t(2, 1) == 6 && t(0, 1) == 4);
+
+        auto r = a.row(1);
+        auto c = a.col(2);
+        assert(r.row_vector() && r[2] == 6 && c.col_vector() && c[1] == 6);
+
+        auto i = matrix<double>::identity(3);
+        assert(i.rows() == 3 && i(1, 1) == 1 && i(0, 1) == 0);
+
+        bool caught_exception = false;
+        try {
+            matrix<int> ragged{{1, 2}, {3}};
+        } catch (const std::invalid_argument &e) {
+            caught_exception = true;
+        }
+        assert(caught_exception);
+
+        caught_exception = false;
+        try {
+            a.at(2, 0);
+        } catch (const std::out_of_range &e) {
+            caught_exception = true;
+        }
+        assert(caught_exception);
+    }
+
+    {
+        // Test elementwise arithmetic
+        matrix<double> a{{1, 2}, {3, 4}};
+        matrix<double> b{{4, 3}, {2, 1}};
+        auto sum = a + b;
+        auto diff = a - b;
+        auto scaled = a * 2.0;
+        assert(sum(0, 0) == 5 && sum(1, 1) == 5 && diff(1, 0) == 1 && scaled(1, 1) == 8);
+
+        bool caught_exception = false;
+        try {
+            auto bad = a + matrix<double>(2, 3);
+        } catch (const std::invalid_argument &e) {
+            caught_exception = true;
+        }
+        assert(caught_exception);
+    }
+
+    {
+        // Test fixed products keep static dimensions and mixed products become dynamic
+        matrix<double, 2, 3> a{{1, 2, 3}, {4, 5, 6}};
+        matrix<double, 3, 2> b{{7, 8}, {9, 10}, {11, 12}};
+        auto c = a * b;
+        static_assert(std::is_same_v<decltype(c), matrix<double, 2, 2> >);
+        assert(c(0, 0) == 58 && c(0, 1) == 64 && c(1, 0) == 139 && c(1, 1) == 154);
+
+        matrix<double> d{{7, 8}, {9, 10}, {11, 12}};
+        auto e = a * d;
+        static_assert(std::is_same_v<decltype(e), matrix<double> >);
+        assert(e(1, 1) == 154);
+
+        bool caught_exception = false;
+        try {
+            auto bad = d * d;
+        } catch (const std::invalid_argument &e) {
+            caught_exception = true;
+        }
+        assert(caught_exception);
+    }
+
+    {
+        // Test matrix-vector products respect vector orientation
+        matrix<float> a{{1, 2, 3}, {4, 5, 6}};
+        matrix<float, 0, 0, layout::col_major> b{{1, 2, 3}, {4, 5, 6}};
+        vector<float> x{1, 1, 1};
+        vector<float> w({1, 2}, 'r');
+
+        auto y = a * x;
+        auto z = b * x;
+        assert(y.col_vector() && y.size() == 2 && y[0] == 6 && y[1] == 15);
+        assert(z[0] == 6 && z[1] == 15);
+
+        auto u = w * a;
+        auto v = w * b;
+        assert(u.row_vector() && u.size() == 3 && u[0] == 9 && u[2] == 15);
+        assert(v[0] == 9 && v[2] == 15);
+
+        bool caught_exception = false;
+        try {
+            auto bad = x * a;
+        } catch (const std::invalid_argument &e) {
+            caught_exception = true;
+        }
+        assert(caught_exception);
+
+        caught_exception = false;
+        try {
+            auto bad = a * vector<float>(x).transpose();
+        } catch (const std::invalid_argument &e) {
+            caught_exception = true;
+        }
+        assert(caught_exception);
+
+        // Test fixed operands, whose lengths are checked at compile time
+        matrix<float, 2, 3> f{{1, 2, 3}, {4, 5, 6}};
+        vector<float, 3> fx{1, 1, 1};
+        vector<float, 2> fw({1, 2}, 'r');
+        assert((f * fx)[1] == 15 && (fw * f)[2] == 15);
+
+        // Test complex matrix-vector product
+        using cf = std::complex<float>;
+        matrix<cf> h{{cf(1, 1), cf(0, 2)}, {cf(3, 0), cf(1, -1)}};
+        vector<cf> s{cf(1, 0), cf(0, 1)};
+        auto hs = h * s;
+        assert(hs[0] == cf(-1, 1) && hs[1] == cf(4, 1));
+    }
+
+    for (int l = 0; l <= static_cast<int>(simd::detect()); l++) {
+        simd::restrict_to(static_cast<simd::level>(l));
+
+        // Test the blocked GEMM against a reference on shapes that exercise every tile and block edge
+        for (const auto &shape: std::vector<std::array<std::size_t, 3> >{
+                {1, 1, 1}, {3, 5, 7}, {4, 32, 16}, {17, 33, 9}, {64, 64, 64}, {130, 70, 300}, {5, 2100, 3}}) {
+            check_gemm<float, layout::row_major>(shape[0], shape[1], shape[2]);
+            check_gemm<double, layout::row_major>(shape[0], shape[1], shape[2]);
+            check_gemm<double, layout::col_major>(shape[0], shape[1], shape[2]);
+        }
+        check_gemm<std::complex<float>, layout::row_major>(9, 11, 13);
+        check_gemm<int, layout::col_major>(9, 11, 13);
+    }
+
+    simd::restrict_to(simd::level::avx512);
+    return 0;
+}
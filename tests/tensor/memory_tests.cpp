@@ -0,0 +1,179 @@
+#include <vector>
+#include <cstdint>
+#include <thread>
+#include <cassert>
+#include "../../include/tensor.hpp"
+
+using namespace ccomms;
+
+template<typename T>
+using pooled = vector<T, 0, conversion::warn_once, memory::allocator<T> >;
+
+int main() {
+    {
+        // Test vectors draw from the thread pool outside a frame
+        pooled<double> a{1, 2, 3};
+        assert(a.get_allocator().resource() == &memory::thread_local_pool());
+
+        // Test pool blocks are reused once released
+        for (int i = 0; i < 3; i++)
+            pooled<float> warm(100, 1.0f);
+
+        const auto before = memory::stats().heap_allocations;
+        for (int i = 0; i < 1000; i++) {
+            pooled<float> v(100, 1.0f);
+            pooled<float> w(v);
+            assert(w[99] == 1.0f);
+        }
+        assert(memory::stats().heap_allocations == before);
+    }
+
+    {
+        // Test frames route allocations to the arena and release them on exit
+        pooled<float> a(256, 1.0f);
+        pooled<float> b(256, 2.0f);
+        const auto mark = memory::thread_arena().position();
+
+        for (int frame = 0; frame < 100; frame++) {
+            const auto before = memory::stats().heap_allocations;
+            {
+                memory::frame scope;
+                pooled<float> sum = a + b;
+                pooled<float> product = sum * a - b;
+                pooled<float> copy(product);
+                assert(sum.get_allocator().resource() == &memory::thread_arena());
+                assert(copy[255] == 1.0f);
+            }
+            if (frame > 0)
+                assert(memory::stats().heap_allocations == before);
+
+            assert(memory::thread_arena().position().index == mark.index);
+            assert(memory::thread_arena().position().offset == mark.offset);
+        }
+        assert(memory::current() == &memory::thread_local_pool());
+    }
+
+    {
+        // Test nested frames rewind to their own starting point
+        memory::frame outer;
+        pooled<int> kept(10, 7);
+        const auto mark = memory::thread_arena().position();
+        {
+            memory::frame inner;
+            pooled<int> scratch(1000, 1);
+        }
+        assert(memory::thread_arena().position().offset == mark.offset);
+        assert(kept[9] == 7);
+
+        // Test allocations larger than a chunk are served
+        pooled<double> large(memory::arena::initial_capacity, 1.0);
+        assert(large[memory::arena::initial_capacity - 1] == 1.0);
+    }
+
+    {
+        // Test over-aligned requests get chunks of their alignment, released with it
+        memory::arena scratch;
+        std::size_t grown = 0;
+        for (int i = 0; i < 3; i++) {
+            const memory::arena::marker mark = scratch.position();
+            void *wide = scratch.allocate(3 * memory::arena::initial_capacity, 128);
+            void *small = scratch.allocate(24, 128);
+            assert(reinterpret_cast<std::uintptr_t>(wide) % 128 == 0);
+            assert(reinterpret_cast<std::uintptr_t>(small) % 128 == 0);
+            scratch.rewind(mark);
+
+            // Rewound chunks serve the same over-aligned requests again
+            if (i == 0)
+                grown = scratch.capacity();
+            assert(scratch.capacity() == grown);
+        }
+    }
+
+    {
+        // Test moving a frame vector into a longer lived one does not hand over arena memory
+        pooled<double> result;
+        {
+            memory::frame scope;
+            pooled<double> temp(64, 3.0);
+            result = std::move(temp);
+        }
+        assert(result.get_allocator().resource() == &memory::thread_local_pool());
+        assert(result.size() == 64 && result[63] == 3.0);
+
+        // Test rvalue operands only lend their storage within the same resource
+        pooled<double> a(64, 1.0);
+        const double *storage = a.data();
+        pooled<double> b = std::move(a) + result;
+        assert(b.data() == storage && b[0] == 4.0);
+    }
+
+    {
+        // Test each thread has its own arena and counters
+        std::vector<std::thread> workers;
+        for (int t = 0; t < 4; t++)
+            workers.emplace_back([] {
+                memory::reset_stats();
+                for (int i = 0; i < 100; i++) {
+                    memory::frame scope;
+                    pooled<double> v(512, 1.0);
+                    pooled<double> w = v + v;
+                    assert(w[511] == 2.0);
+                }
+                assert(memory::stats().heap_allocations == 1);
+                assert(memory::stats().allocations == 200);
+            });
+        for (auto &worker: workers)
+            worker.join();
+    }
+
+    {
+        // Test vectors allocated on other threads outlive them and are released here
+        std::vector<pooled<double> > made(8);
+        std::vector<std::thread> workers;
+        for (std::size_t t = 0; t < made.size(); t++)
+            workers.emplace_back([&made, t] {
+                pooled<double> v(64 + t, static_cast<double>(t));
+                made[t].swap(v);
+                assert(made[t].get_allocator() == memory::allocator<double>());
+            });
+        for (auto &worker: workers)
+            worker.join();
+        for (std::size_t t = 0; t < made.size(); t++)
+            assert(made[t].size() == 64 + t && made[t][63] == static_cast<double>(t));
+        assert(made[0].get_allocator() == memory::allocator<double>());
+
+        // Test blocks freed here go back to their pools, which the next threads take over and reuse
+        made.clear();
+        for (int round = 0; round < 2; round++) {
+            workers.clear();
+            for (int t = 0; t < 4; t++)
+                workers.emplace_back([round] {
+                    if (round == 1)
+                        memory::reset_stats();
+                    for (int i = 0; i < 100; i++) {
+                        pooled<double> v(64, 1.0);
+                        assert(v[63] == 1.0);
+                    }
+                    if (round == 1)
+                        assert(memory::stats().heap_allocations == 0);
+                });
+            for (auto &worker: workers)
+                worker.join();
+        }
+
+        // Test swapping vectors from different resources keeps each buffer with its own resource
+        pooled<float> kept(32, 1.0f);
+        {
+            memory::frame scope;
+            pooled<float> scratch(16, 2.0f);
+            kept.swap(scratch);
+            assert(kept.get_allocator().resource() == &memory::thread_arena());
+            assert(scratch.get_allocator().resource() == &memory::thread_local_pool());
+            kept.swap(scratch);
+        }
+        assert(kept.size() == 32 && kept[31] == 1.0f);
+        assert(kept.get_allocator().resource() == &memory::thread_local_pool());
+    }
+
+    return 0;
+}
@@ -0,0 +1,150 @@
+#include <cmath>
+#include <vector>
+#include <complex>
+#include <cassert>
+#include <cstdint>
+#include "../../include/tensor.hpp"
+
+using namespace ccomms;
+
+template<typename T>
+T sample(const std::size_t &i) {
+    if constexpr (std::is_same_v<T, std::complex<float> >)
+        return {static_cast<float>(i % 7) - 3.0f, static_cast<float>(i % 5) * 0.5f};
+    else
+        return static_cast<T>(static_cast<int>(i % 11) - 5);
+}
+
+template<typename T>
+void check_kernels(const std::size_t &n) {
+    std::vector<T> a(n), b(n);
+    for (std::size_t i = 0; i < n; i++) {
+        a[i] = sample<T>(i);
+        b[i] = sample<T>(i * 3 + 1) == T(0) ? T(7) : sample<T>(i * 3 + 1);
+    }
+
+    // Test inner product against a sequential reference
+    T expected = 0;
+    for (std::size_t i = 0; i < n; i++)
+        expected += a[i] * b[i];
+    assert(std::abs(simd::dot(a.data(), b.data(), n) - expected) <= 1e-3 * (1 + std::abs(expected)));
+
+    // Test every elementwise operation including scalar broadcast and aliasing
+    std::vector<T> out(n);
+    simd::transform<ops::add, false, false>(out.data(), a.data(), b.data(), n);
+    for (std::size_t i = 0; i < n; i++)
+        assert(out[i] == a[i] + b[i]);
+
+    simd::transform<ops::sub, false, true>(out.data(), a.data(), b.data(), n);
+    for (std::size_t i = 0; i < n; i++)
+        assert(out[i] == a[i] - b[0]);
+
+    simd::transform<ops::mul, true, false>(out.data(), a.data(), b.data(), n);
+    for (std::size_t i = 0; i < n; i++)
+        assert(std::abs(out[i] - a[0] * b[i]) <= std::abs(a[0] * b[i]) * 1e-6);
+
+    if constexpr (!std::is_same_v<T, std::complex<float> >) {
+        simd::transform<ops::div, false, false>(out.data(), a.data(), b.data(), n);
+        for (std::size_t i = 0; i < n; i++)
+            assert(std::abs(out[i] - a[i] / b[i]) <= std::abs(a[i] / b[i]) * 1e-6);
+    }
+
+    out = a;
+    simd::transform<ops::add, false, false>(out.data(), out.data(), b.data(), n);
+    for (std::size_t i = 0; i < n; i++)
+        assert(out[i] == a[i] + b[i]);
+
+    // Test fused in place kernels
+    if constexpr (!std::is_same_v<T, std::complex<float> >) {
+        out = a;
+        simd::axpy(out.data(), T(3), b.data(), n);
+        for (std::size_t i = 0; i < n; i++)
+            assert(out[i] == a[i] + T(3) * b[i]);
+
+        out = a;
+        simd::fma(out.data(), a.data(), b.data(), n);
+        for (std::size_t i = 0; i < n; i++)
+            assert(out[i] == a[i] + a[i] * b[i]);
+    }
+
+    if constexpr (std::is_floating_point_v<T>) {
+        for (std::size_t i = 0; i < n; i++)
+            out[i] = std::abs(a[i]);
+        simd::sqrt(out.data(), out.data(), n);
+        for (std::size_t i = 0; i < n; i++)
+            assert(out[i] == std::sqrt(std::abs(a[i])));
+
+        // Test sliding inner products for adjacent, spaced and strided outputs
+        for (const std::size_t taps: {std::size_t(1), std::size_t(5), std::size_t(19)}) {
+            for (const std::size_t step: {std::size_t(1), std::size_t(3)}) {
+                if (n < taps)
+                    continue;
+                const std::size_t count = (n - taps) / step + 1;
+                std::vector<T> y(2 * count, T(1));
+                simd::fir(b.data(), taps, a.data(), step, y.data(), 1, count);
+                simd::fir<true>(b.data(), taps, a.data(), step, y.data() + count, 1, count);
+                for (std::size_t t = 0; t < count; t++) {
+                    T sum = 0;
+                    for (std::size_t k = 0; k < taps; k++)
+                        sum += b[k] * a[t * step + k];
+                    assert(y[t] == sum && y[count + t] == sum + T(1));
+                }
+
+                std::vector<T> z(2 * count, T(0));
+                simd::fir(b.data(), taps, a.data(), step, z.data() + 1, 2, count);
+                for (std::size_t t = 0; t < count; t++)
+                    assert(z[2 * t] == T(0) && z[2 * t + 1] == y[t]);
+            }
+        }
+
+        // Test sine and cosine against the standard library over a wide range of angles, in place on the angles
+        std::vector<T> x(n), s(n);
+        for (std::size_t i = 0; i < n; i++)
+            x[i] = a[i] * T(1.37) + static_cast<T>(i % 13) * T(0.7853981) + (i % 3 == 0 ? T(5000) * b[i] : T(0));
+        out = x;
+        simd::sincos(s.data(), out.data(), out.data(), n);
+        const T tolerance = std::is_same_v<T, float> ? T(5e-7) : T(1e-15);
+        for (std::size_t i = 0; i < n; i++) {
+            assert(std::abs(s[i] - std::sin(x[i])) <= tolerance);
+            assert(std::abs(out[i] - std::cos(x[i])) <= tolerance);
+        }
+    }
+}
+
+int main() {
+    const std::size_t sizes[] = {0, 1, 3, 7, 16, 33, 64, 257, 4096 + 13};
+
+    for (int l = 0; l <= static_cast<int>(simd::detect()); l++) {
+        simd::restrict_to(static_cast<simd::level>(l));
+        assert(simd::active() == static_cast<simd::level>(l));
+
+        for (const auto &n: sizes) {
+            check_kernels<float>(n);
+            check_kernels<double>(n);
+            check_kernels<std::int32_t>(n);
+            check_kernels<std::complex<float> >(n);
+        }
+
+        // Test compensated inner product on a long float vector
+        std::vector<float> ones(1 << 22, 1.0f);
+        std::vector<float> tenths(1 << 22, 0.1f);
+        const double exact = static_cast<double>(0.1f) * (1 << 22);
+        assert(std::abs(simd::dot(ones.data(), tenths.data(), ones.size()) - exact) / exact < 1e-5);
+
+        // Test kernels are used through vector operators
+        vector<float> a{1, 2, 3, 4, 5, 6, 7, 8, 9};
+        vector<float> b(9, 2.0f);
+        assert((a | b) == 90.0f);
+
+        vector<float> c = a * b;
+        assert(c[0] == 2 && c[8] == 18);
+
+        using cf = std::complex<float>;
+        vector<cf> x{cf(1, 1), cf(2, -1)};
+        vector<cf> y{cf(0, 1), cf(1, 1)};
+        assert((x | y) == cf(2, 4));
+    }
+
+    simd::restrict_to(simd::level::avx512);
+    return 0;
+}
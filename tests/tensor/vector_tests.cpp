@@ -2,8 +2,34 @@
 #include <vector>
 #include <array>
 #include <cassert>
+#include <complex>
+#include <type_traits>
 #include "../../include/tensor.hpp"
 
+template<typename A, typename B>
+concept addable = requires(const A &a, const B &b) { a + b; };
+
+template<typename A, typename B>
+concept cross_multipliable = requires(const A &a, const B &b) { a & b; };
+
+template<typename A, typename B>
+concept inner_multipliable = requires(const A &a, const B &b) { a | b; };
+
+constexpr ccomms::vector<double, 3> constexpr_cross() {
+    ccomms::vector<double, 3> x{1.0, 0.0, 0.0};
+    ccomms::vector<double, 3> y{0.0, 1.0, 0.0};
+    return x & y;
+}
+
+constexpr ccomms::vector<double, 4> constexpr_compound() {
+    ccomms::vector<double, 4> v{1.0, 2.0, 3.0, 4.0};
+    ccomms::vector<double, 4> w(4, 1.0);
+    v += w;
+    v *= 2.0;
+    v.axpy(0.5, w).fma(w, w);
+    return v;
+}
+
 int main() {
     using namespace ccomms;
     {
@@ -262,16 +288,8 @@ int main() {
         assert(v2.size() == 3);
         assert(v2[0] == 1.0 && v2[1] == 2.0 && v2[2] == 3.0);
 
-        // Test fixed vector copy assignment from std::array with different size (not allowed)
-        bool caught_exception = false;
-        try {
-            std::array<float, 2> arr3 = {1.0f, 2.0f};
-            vector<float, 3> v3;
-            v3 = arr3;
-        } catch (const std::invalid_argument &e) {
-            caught_exception = true;
-        }
-        assert(caught_exception);
+        // Test fixed vector copy assignment from std::array with different size (rejected at compile time)
+        static_assert(!std::is_assignable_v<vector<float, 3> &, const std::array<float, 2> &>);
 
         // Test type conversion in copy assignment
         std::array<int, 3> arr4 = {1, 2, 3};
@@ -298,16 +316,8 @@ int main() {
         assert(v2.size() == 3);
         assert(v2[0] == 1.0 && v2[1] == 2.0 && v2[2] == 3.0);
 
-        // Test fixed vector move assignment from std::array with different size (not allowed)
-        bool caught_exception = false;
-        try {
-            std::array<float, 2> arr3 = {1.0f, 2.0f};
-            vector<float, 3> v3;
-            v3 = std::move(arr3);
-        } catch (const std::invalid_argument &e) {
-            caught_exception = true;
-        }
-        assert(caught_exception);
+        // Test fixed vector move assignment from std::array with different size (rejected at compile time)
+        static_assert(!std::is_assignable_v<vector<float, 3> &, std::array<float, 2> &&>);
 
         // Test type conversion in move assignment
         std::array<int, 3> arr4 = {1, 2, 3};
@@ -357,7 +367,7 @@ int main() {
         // Invalid usage: vectors of different length
         std::vector<int> d{1, 2, 3, 4};
         try {
-            auto e = a | d;
+            [[maybe_unused]] auto e = a | d;
             assert(false);  // This line should not be reached
         } catch (const std::invalid_argument &e) {
             assert(std::string(e.what()) == "\nERR: inner product requires vectors of the same length\n");
@@ -376,7 +386,7 @@ int main() {
         // Invalid usage: vectors of different length
         std::vector<int> d{1, 2, 3, 4};
         try {
-            auto e = a | d;
+            [[maybe_unused]] auto e = a | d;
             assert(false);  // This line should not be reached
         } catch (const std::invalid_argument &e) {
             assert(std::string(e.what()) == "\nERR: inner product requires vectors of the same length\n");
@@ -396,11 +406,13 @@ int main() {
         auto result2 = v3 + v4;
         assert(result2[0] == 5 && result2[1] == 7 && result2[2] == 9);
 
-        // Test unequal vector lengths
-        vector<int, 3> v5{1, 2, 3};
-        vector<int, 4> v6{4, 5, 6, 7};
+        // Test unequal vector lengths, rejected at compile time when both are fixed
+        static_assert(!addable<vector<int, 3>, vector<int, 4> >);
+        vector<int> v5{1, 2, 3};
+        vector<int> v6{4, 5, 6, 7};
         try {
-            auto result3 = v5 + v6;
+            [[maybe_unused]] auto result3 = v5 + v6;
+            assert(false);
         } catch (std::invalid_argument &e) {
             assert(std::string(e.what()) == "\nERR: elementwise addition requires vectors of equal length\n");
         }
@@ -421,9 +433,10 @@ int main() {
 
         // Test unequal vector lengths
         vector<int, 3> v5{1, 2, 3};
-        vector<int, 4> v6{4, 5, 6, 7};
+        vector<int> v6{4, 5, 6, 7};
         try {
-            auto result3 = v5 - v6;
+            [[maybe_unused]] auto result3 = v5 - v6;
+            assert(false);
         } catch (std::invalid_argument &e) {
             assert(std::string(e.what()) == "\nERR: elementwise subtraction requires vectors of equal length\n");
         }
@@ -475,6 +488,125 @@ int main() {
         vector<int, 4> v7{4, 5, 6, 7};
     }
 
+    {
+        // Test compound assignment on fixed-size vectors
+        vector<int, 3> v1{1, 2, 3};
+        vector<int, 3> v2{4, 5, 6};
+        v1 += v2;
+        assert(v1[0] == 5 && v1[1] == 7 && v1[2] == 9);
+        v1 -= v2;
+        v1 *= 3;
+        assert(v1[0] == 3 && v1[1] == 6 && v1[2] == 9);
+        v1 /= v1;
+        assert(v1[0] == 1 && v1[1] == 1 && v1[2] == 1);
+
+        // Test compound assignment on dynamic-size vectors and expressions
+        vector<double> v3{1, 2, 3};
+        vector<double> v4{4, 5, 6};
+        v3 += v4 * 2.0;
+        assert(v3[0] == 9 && v3[1] == 12 && v3[2] == 15);
+        v3 -= v3;
+        assert(v3[0] == 0 && v3[2] == 0);
+
+        // Test compound assignment of unequal vector lengths
+        vector<double> v5{1, 2};
+        bool caught_exception = false;
+        try {
+            v5 += v4;
+        } catch (const std::invalid_argument &e) {
+            caught_exception = true;
+        }
+        assert(caught_exception && v5.size() == 2);
+    }
+
+    {
+        // Test fused axpy and multiply-add on both specializations
+        vector<float> y(37, 1.0f);
+        vector<float> x(37, 0.0f);
+        for (std::size_t i = 0; i < x.size(); i++)
+            x[i] = static_cast<float>(i);
+        y.axpy(2.0f, x);
+        for (std::size_t i = 0; i < y.size(); i++)
+            assert(y[i] == 1.0f + 2.0f * static_cast<float>(i));
+        y.fma(x, x);
+        for (std::size_t i = 0; i < y.size(); i++)
+            assert(y[i] == 1.0f + 2.0f * static_cast<float>(i) + static_cast<float>(i * i));
+
+        vector<long, 3> z{1, 2, 3};
+        vector<long, 3> w{2, 2, 2};
+        z.axpy(3L, w).fma(w, w);
+        assert(z[0] == 11 && z[1] == 12 && z[2] == 13);
+
+        bool caught_exception = false;
+        try {
+            y.axpy(1.0f, vector<float>{1, 2});
+        } catch (const std::invalid_argument &e) {
+            caught_exception = true;
+        }
+        assert(caught_exception);
+    }
+
+    {
+        // Test fixed vector math in constant expressions
+        constexpr vector<int, 3> a{1, 2, 3};
+        constexpr vector<int, 3> b{4, 5, 6};
+        static_assert((a | b) == 32);
+        static_assert((a & b)[0] == -3 && (a & b)[1] == 6 && (a & b)[2] == -3);
+
+        constexpr vector<int, 3> c = a * b + 1;
+        static_assert(c[0] == 5 && c[1] == 11 && c[2] == 19);
+        constexpr auto d = (a - b).eval();
+        static_assert(std::is_same_v<decltype(d), const vector<int, 3> >);
+        static_assert(d[0] == -3 && d[2] == -3);
+
+        constexpr vector<double, 3> e = constexpr_cross();
+        static_assert(e[0] == 0.0 && e[1] == 0.0 && e[2] == 1.0);
+        constexpr vector<double, 4> f = constexpr_compound();
+        static_assert(f[0] == 5.5 && f[3] == 11.5);
+
+        // Test a table of fixed vectors built at compile time with mixed element types
+        constexpr std::array<vector<double, 3>, 2> table{vector<double, 3>{1, 0, 0}, vector<double, 3>{0.5, 2.0, 0.0}};
+        static_assert((table[0] | table[1]) == 0.5);
+
+        constexpr vector<std::complex<double>, 2> g{std::complex<double>(1, 1), std::complex<double>(0, 2)};
+        static_assert((g | g) == std::complex<double>(6, 0));
+
+        // Test statically known length mismatches are rejected by the operators
+        static_assert(!cross_multipliable<vector<int, 4>, vector<int, 3> >);
+        static_assert(!cross_multipliable<vector<int, 3>, std::array<int, 2> >);
+        static_assert(!inner_multipliable<vector<int, 3>, std::array<int, 4> >);
+        static_assert(inner_multipliable<vector<int, 3>, std::vector<int> >);
+        static_assert(!std::is_constructible_v<vector<int, 3>, std::array<int, 4> >);
+
+        // Test fixed vectors past the unroll limit evaluate identically at runtime
+        vector<float, unroll_limit + 3> h(unroll_limit + 3, 2.0f);
+        vector<float, unroll_limit + 3> k = h * h + h;
+        assert(k[0] == 6.0f && k[unroll_limit + 2] == 6.0f);
+        assert((h | k) == 12.0f * static_cast<float>(unroll_limit + 3));
+    }
+
+    {
+        // Test rvalue operands lend their storage to the result
+        vector<double> a{1, 2, 3};
+        vector<double> b{4, 5, 6};
+        const double *storage = a.data();
+        vector<double> c = std::move(a) + b;
+        assert(c.data() == storage);
+        assert(c[0] == 5 && c[1] == 7 && c[2] == 9);
+
+        storage = c.data();
+        vector<double> d = b - std::move(c);
+        assert(d.data() == storage);
+        assert(d[0] == -1 && d[1] == -2 && d[2] == -3);
+
+        // Test assignment through a stolen buffer that aliases the destination
+        vector<double> e{1, 1, 1};
+        b = vector<double>{1, 2, 3} * b;
+        assert(b[0] == 4 && b[1] == 10 && b[2] == 18);
+        b = std::move(e) + b;
+        assert(b[0] == 5 && b[1] == 11 && b[2] == 19);
+    }
+
     return 0;
 }
 
@@ -0,0 +1,147 @@
+#include <array>
+#include <vector>
+#include <complex>
+#include <cassert>
+#include <type_traits>
+#include "../../include/tensor.hpp"
+
+using namespace ccomms;
+
+template<typename V>
+concept assignable_view = requires(V v, const vector<float> &a) { v = a + a; };
+
+constexpr float constexpr_view_sum() {
+    std::array<float, 4> buffer{1, 2, 3, 4};
+    vector_view<float, 4> v(buffer);
+    v *= 2.0f;
+    return v | vector<float, 4>(4, 1.0f);
+}
+
+int main() {
+    {
+        // Test views alias external buffers without copying
+        std::vector<float> samples{1, 2, 3, 4, 5, 6, 7, 8};
+        vector_view view(samples);
+        static_assert(std::is_same_v<decltype(view), vector_view<float> >);
+        assert(view.size() == 8 && view.data() == samples.data() && view.stride() == 1);
+        view[0] = 10;
+        assert(samples[0] == 10);
+
+        float raw[4] = {1, 2, 3, 4};
+        vector_view<float, 4> fixed(raw, 4);
+        assert(fixed.front() == 1 && fixed.back() == 4);
+
+        bool caught_exception = false;
+        try {
+            vector_view<float, 3> wrong(raw, 4);
+        } catch (const std::invalid_argument &e) {
+            caught_exception = true;
+        }
+        assert(caught_exception);
+
+        caught_exception = false;
+        try {
+            fixed.at(4);
+        } catch (const std::out_of_range &e) {
+            caught_exception = true;
+        }
+        assert(caught_exception);
+
+        // Copying a view copies the reference
+        vector_view<float> other(raw, 4);
+        other = view;
+        assert(other.data() == samples.data());
+    }
+
+    {
+        // Test views as expression sources and destinations on the SIMD path
+        std::vector<float> in(37), out(37, 0.0f);
+        for (std::size_t i = 0; i < in.size(); i++)
+            in[i] = static_cast<float>(i);
+
+        vector_view<const float> src(in);
+        vector_view<float> dst(out);
+        dst = src * 2.0f;
+        for (std::size_t i = 0; i < out.size(); i++)
+            assert(out[i] == 2.0f * static_cast<float>(i));
+
+        dst += src;
+        dst -= 1.0f;
+        assert(out[5] == 14.0f);
+        dst.axpy(1.0f, src).fma(src, src);
+        assert(out[5] == 14.0f + 5.0f + 25.0f);
+
+        vector<float> copy = src + dst;
+        assert(copy.size() == 37 && copy[1] == 1.0f + out[1]);
+        assert((src | src) == (vector<float>(src) | vector<float>(src)));
+
+        // Read only views cannot be written
+        static_assert(assignable_view<vector_view<float> >);
+        static_assert(!assignable_view<vector_view<const float> >);
+
+        bool caught_exception = false;
+        try {
+            dst = vector<float>{1, 2} + vector<float>{1, 2};
+        } catch (const std::invalid_argument &e) {
+            caught_exception = true;
+        }
+        assert(caught_exception);
+    }
+
+    {
+        // Test strided views over an interleaved IQ buffer
+        std::vector<double> iq{1, -1, 2, -2, 3, -3, 4, -4};
+        strided_view<double> i_part(iq.data(), 4, 2);
+        strided_view<double> q_part(iq.data() + 1, 4, 2);
+        assert(i_part[3] == 4 && q_part[3] == -4);
+        assert((i_part | q_part) == -30);
+
+        vector<double> magnitude = i_part * i_part + q_part * q_part;
+        assert(magnitude[2] == 18);
+
+        q_part = i_part * 0.5;
+        assert(iq[1] == 0.5 && iq[7] == 2.0);
+        q_part.fill(0.0);
+        assert(iq[3] == 0.0 && iq[2] == 2.0);
+
+        std::vector<double> gathered(i_part.begin(), i_part.end());
+        assert(gathered.size() == 4 && gathered[3] == 4);
+        assert(i_part.end() - i_part.begin() == 4);
+
+        auto evens = vector_view<double>(iq).slice(0, 2, 4);
+        assert(evens.size() == 2 && evens[1] == 3 && evens.stride() == 4);
+        auto tail = i_part.subview(1, 2);
+        assert(tail[0] == 2 && tail[1] == 3);
+        auto inner = vector_view<double>(iq).subview(2, 3);
+        assert(inner.data() == iq.data() + 2 && inner.size() == 3);
+
+        vector<double> from_strided(i_part);
+        assert(from_strided.size() == 4 && from_strided[2] == 3);
+    }
+
+    {
+        // Test complex views, cross product and matrix-vector products
+        std::vector<std::complex<float> > samples{{1, 1}, {0, 2}};
+        vector_view<std::complex<float> > z(samples);
+        assert((z | z) == std::complex<float>(6, 0));
+        vector<std::complex<float> > conjugated = conj(z);
+        assert(conjugated[1] == std::complex<float>(0, -2));
+
+        std::array<double, 3> x{1, 0, 0}, y{0, 1, 0};
+        vector_view<double, 3> vx(x);
+        auto cross = vx & y;
+        static_assert(std::is_same_v<decltype(cross), vector<double, 3> >);
+        assert(cross[2] == 1);
+
+        matrix<double> a{{1, 2, 3}, {4, 5, 6}};
+        vector<double> product = a * vector_view<const double, 3>(x);
+        assert(product.size() == 2 && product[0] == 1 && product[1] == 4);
+    }
+
+    {
+        // Test views in constant expressions
+        static_assert(constexpr_view_sum() == 20.0f);
+    }
+
+    return 0;
+}